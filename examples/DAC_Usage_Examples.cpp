@@ -100,6 +100,10 @@ void example6_advancedUsage() {
         
         // Use the codec directly for advanced configurations
         // (This gives you access to all the original library functions)
+        codec->configMicBias(false, false, TLV320_MICBIAS_2V);
+        
+        // Library writes bypass the register cache
+        dac.invalidateCache();
         
         Serial.println("DAC ready for advanced operations");
     }
@@ -42,16 +42,16 @@ void setup() {
     float defaultVolume = 0.2f; // 20%
     rotaryManager.setVolume(defaultVolume);
     
-    // Configure acceleration (optional)
-    rotaryManager.setAcceleration(250); // Medium acceleration
+    // Configure acceleration curve (optional): {min detents/s, steps per detent}
+    static const RotaryAccelerationStep curve[] = {{0, 1}, {15, 3}, {40, 6}};
+    rotaryManager.setAccelerationCurve(curve, 3);
     
     // Enable conservative mode to prevent encoder skipping
     rotaryManager.setConservativeMode(true);
     
     Serial.println("Rotary encoder ready! Turn to change volume.");
     Serial.printf("Initial volume: %.2f\n", rotaryManager.getVolume());
-    Serial.printf("Acceleration: %d (enabled: %s)\n", 
-                rotaryManager.getAcceleration(), 
+    Serial.printf("Acceleration enabled: %s\n", 
                 rotaryManager.isAccelerationEnabled() ? "Yes" : "No");
 }
 
@@ -81,6 +81,10 @@ void loop() {
  * // Get current encoder value (0-100)
  * int16_t encoderVal = rotaryManager.getEncoderValue();
  * 
+ * // Encoder event rate vs. coalesced volume updates
+ * Serial.printf("%lu events/s -> %lu updates/s\n",
+ *               rotaryManager.getEventsPerSecond(), rotaryManager.getCallbacksPerSecond());
+ * 
  * // Reset encoder to current volume
  * rotaryManager.reset();
  * 
@@ -2,11 +2,30 @@
 #define AUDIO_MANAGER_H
 
 #include <Arduino.h>
+#include <new>
+#include <utility>
 #include <vector>
 #include <AudioTools.h>
 #include "AudioTools/Disk/AudioSourceSDMMC.h"
 #include "AudioTools/AudioCodecs/CodecMP3Helix.h"
 #include "SD_MMC.h"
+#include "SeekableAudioSourceSDMMC.h"
+#include "Mp3FrameIndex.h"
+#include "GainRampStream.h"
+
+// Storage for one pipeline object: constructed in place once, never
+// destroyed, so the object never comes from (or returns to) the heap
+template <typename T>
+class PipelineSlot {
+public:
+    template <typename... Args>
+    T* construct(Args&&... args) {
+        return new (storage) T(std::forward<Args>(args)...);
+    }
+
+private:
+    alignas(T) uint8_t storage[sizeof(T)];
+};
 
 // File selection mode enum
 enum class FileSelectionMode {
@@ -16,18 +35,27 @@ enum class FileSelectionMode {
 
 class Audio_Manager {
 private:
-    // Audio pipeline components
-    AudioSourceSDMMC* source;
+    // Audio pipeline components. Built once into the slots below (the
+    // manager itself is a global) and re-targeted in place on a folder change.
+    SeekableAudioSourceSDMMC* source;
     I2SStream* i2s;
     VolumeStream* volume;
+    GainRampStream* ramp;
     MP3DecoderHelix* decoder;
     AudioPlayer* player;
     I2SConfig i2sCfg_;
+    PipelineSlot<SeekableAudioSourceSDMMC> sourceSlot;
+    PipelineSlot<I2SStream> i2sSlot;
+    PipelineSlot<VolumeStream> volumeSlot;
+    PipelineSlot<GainRampStream> rampSlot;
+    PipelineSlot<MP3DecoderHelix> decoderSlot;
+    PipelineSlot<AudioPlayer> playerSlot;
     
     // Configuration
     String audioFolder;       // Use String to own the memory (avoid dangling pointers)
     String fileExtension;     // Use String to own the memory
     float currentVolume;
+    float outputGain;         // Route-change gain (ramp target), applied after the volume
     bool audioInitialized;
     bool playerActive;
     
@@ -44,6 +72,12 @@ private:
     std::vector<String> audioFileList;
     int currentFileIndex;
     
+    // In-track position and seeking (indexed when a track starts)
+    Mp3FrameIndex frameIndex;
+    String indexRequestedFor;   // Track the index was last requested for, built or not
+    uint32_t lastSeekLatencyUs;
+    uint32_t seekCount;
+    
     // I2S configuration
     uint8_t i2sBckPin;
     uint8_t i2sWsPin;
@@ -93,6 +127,11 @@ public:
     bool isPlaybackHealthy() const;
     void setVolume(float volume);
     float getVolume() const;
+    void setOutputGain(float gain);
+    void rampOutputGain(float gain, uint16_t rampMs);   // Per frame, over rampMs of audio
+    float getOutputGain() const { return outputGain; }
+    bool isOutputRamping() const { return ramp && ramp->isRamping(); }
+    bool isOutputSilent() const;   // Gain zero and already played out of the I2S queue
     
     // File information
     String getCurrentFile() const;
@@ -116,6 +155,24 @@ public:
     // Dynamic audio source management
     bool changeAudioSource(const char* newFolder);
     
+    // Track position and seeking. update() loads or starts the MP3 frame
+    // index (cached on SD) once a new track is playing; the getters only
+    // read it and return 0 until the open track is indexed.
+    uint32_t getPositionMs() const;
+    uint32_t getDurationMs() const;
+    bool seekToMs(uint32_t positionMs);
+    bool seekRelativeMs(int32_t deltaMs);
+    uint32_t getLastSeekLatencyUs() const { return lastSeekLatencyUs; }
+    uint32_t getSeekCount() const { return seekCount; }
+    const Mp3FrameIndex& getFrameIndex() const { return frameIndex; }
+    
+    // Session resume: where playback currently is, and a way to start a
+    // folder at a given track and byte offset in one step
+    const String& getAudioFolder() const { return audioFolder; }
+    int getCurrentTrackIndex() const;
+    uint32_t getCurrentByteOffset() const;
+    bool resumeTrack(const char* folder, int trackIndex, uint32_t byteOffset);
+    
     // Debug and status
     void printAudioStatus() const;
     void printFileList() const;
@@ -126,6 +183,7 @@ private:
     bool findFirstAudioFile();
     bool validateAudioFile(const String& filename);
     void sendSilence(int frames);
+    void applyVolume();
     void clearAudioPipeline();
     
     // Custom file selection helpers
@@ -133,6 +191,9 @@ private:
     bool playFileByIndex(int index);
     int findFileIndex(const String& filename);
     
+    // Seek helpers
+    bool ensureFrameIndex();
+    
     // Error handling
     void setLastError(const char* error) const; // Make const-correct
     mutable char lastError[128]; // Make mutable so it can be modified in const functions
@@ -3,40 +3,92 @@
 
 #include <Arduino.h>
 #include <Wire.h>
+#include <atomic>
 #include <SparkFun_MAX1704x_Fuel_Gauge_Arduino_Library.h>
 
+// One fuel gauge reading (12 bytes)
+struct BatterySample {
+    uint32_t timeS;        // Seconds since boot
+    uint16_t millivolts;
+    uint16_t socCenti;     // State of charge in 0.01 %
+    uint8_t decodeLoad;    // Share of the interval spent decoding (0-255)
+};
+
 class Battery_Manager {
+public:
+    static constexpr uint8_t HISTORY_SIZE = 120;          // 2 h at the default 1 min interval
+    static constexpr uint8_t MIN_ESTIMATE_INTERVALS = 2;  // Discharging intervals needed for a fit
+
 private:
     SFE_MAX1704X lipo; // SparkFun MAX1704x Fuel Gauge object
-    bool initialized;
+    std::atomic<bool> initialized;   // Set last in begin(); read from the main loop
     uint8_t sdaPin;
     uint8_t sclPin;
-    
+
     // Battery readings
     float batteryVoltage;
     float batteryPercentage;
-    
+
     // Timing
     unsigned long lastReadingTime;
-    const unsigned long READING_INTERVAL = 5000; // 5 seconds
-    
+    unsigned long readingInterval;               // Default 5 seconds
+    const uint32_t RESET_TIMEOUT_MS = 250;       // Max wait for the gauge after reset
+
+    // Sample ring (oldest at historyHead once full). Appends and
+    // copySamples() hold historyMux so other tasks get a consistent copy.
+    BatterySample history[HISTORY_SIZE];
+    uint8_t historyHead;
+    uint8_t historyCount;
+    mutable portMUX_TYPE historyMux;
+
+    // Decode time since the last reading
+    unsigned long lastUpdateTime;
+    unsigned long decodeMs;
+
+    // Discharge model: rate (%/h) = idleRate + (playRate - idleRate) * load
+    bool estimateValid;
+    float idleRatePerHour;
+    float playRatePerHour;
+
+    // Poll until the gauge answers on I2C
+    bool waitForGauge(uint32_t timeoutMs);
+
+    // Read the gauge, append to the ring and refit the discharge model
+    void takeReading(unsigned long now);
+    void updateEstimate();
+
 public:
     Battery_Manager(uint8_t sda = 22, uint8_t scl = 21);
-    
+
     // Initialization
     bool begin();
     bool isInitialized() const { return initialized; }
-    
-    // Main update function - call this in main loop
-    void update();
-    
+
+    // Main update function - call this in main loop. decoding = audio is
+    // being decoded right now (weights the discharge estimate).
+    void update(bool decoding = false);
+
     // Battery information
     float getBatteryVoltage() const { return batteryVoltage; }
     float getBatteryPercentage() const { return batteryPercentage; }
+
+    // Sample history, index 0 = oldest
+    uint8_t getSampleCount() const { return historyCount; }
+    const BatterySample& getSample(uint8_t index) const;
     
+    // Copy the history oldest first (safe from other tasks, e.g. the web server)
+    uint8_t copySamples(BatterySample* out, uint8_t maxCount) const;
+
+    // Discharge estimate (false/negative until enough discharging samples)
+    bool hasEstimate() const { return estimateValid; }
+    float getDischargeRatePerHour(float decodeLoad) const;
+    float getRemainingMinutes(float decodeLoad = 1.0f) const;
+
     // Configuration
     void setI2CPins(uint8_t sda, uint8_t scl);
-    
+    void setReadingInterval(unsigned long intervalMs);
+    unsigned long getReadingInterval() const { return readingInterval; }
+
     // Debug and status
     void printBatteryStatus();
     bool testConnection();
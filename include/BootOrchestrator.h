@@ -0,0 +1,108 @@
+#ifndef BOOT_ORCHESTRATOR_H
+#define BOOT_ORCHESTRATOR_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+
+// ============================================================================
+// BOOT ORCHESTRATOR
+// ============================================================================
+// Runs independent boot stages concurrently, one FreeRTOS task per stage, and
+// waits for all of them. Stages may share a bus (Wire locks per transaction),
+// but a device that needs several transactions in a row (the codec's page
+// select, then its registers) must only be used by one stage; other tasks
+// touch it after waiting for that stage. Stages can be started in waves:
+// critical-path stages are waited on individually, later stages finish in the
+// background while the main loop runs. Per-stage durations, time-to-audio and
+// time-to-ready are recorded.
+// ============================================================================
+
+class BootOrchestrator {
+public:
+    typedef bool (*StageFunction)();
+
+    static constexpr uint8_t MAX_STAGES = 6;
+    static constexpr uint32_t DEFAULT_STACK_SIZE = 4096;
+
+    struct Stage {
+        const char* name;
+        StageFunction function;
+        uint32_t stackSize;
+        bool required;       // Failure of a required stage fails run()/waitAll()
+        bool started;
+        bool success;
+        bool finished;
+        uint32_t durationMs;
+    };
+
+    BootOrchestrator();
+    ~BootOrchestrator();
+
+    // Register a stage (may be called again after start() for a later wave)
+    bool addStage(const char* name, StageFunction function, bool required = true,
+                  uint32_t stackSize = DEFAULT_STACK_SIZE);
+
+    // Start every registered stage that is not running yet (non-blocking)
+    bool start();
+
+    // Block until the named stage finishes. Returns the stage result
+    // (false on timeout or unknown name).
+    bool waitFor(const char* name, uint32_t timeoutMs);
+
+    // Block until every started stage finishes or the timeout expires.
+    // Returns true if every required stage succeeded.
+    bool waitAll(uint32_t timeoutMs);
+
+    // True once every started stage has finished (non-blocking)
+    bool isFinished() const;
+
+    // True once the named stage has finished (non-blocking; false if unknown
+    // or not started)
+    bool isStageFinished(const char* name) const;
+
+    // start() + waitAll()
+    bool run(uint32_t timeoutMs);
+
+    // Mark the first audible output (resume path)
+    void markFirstAudio();
+
+    // Mark boot as complete (call once the device is ready for input)
+    void markReady();
+
+    // Results
+    uint8_t getStageCount() const { return stageCount; }
+    const Stage& getStage(uint8_t index) const { return stages[index]; }
+    uint32_t getParallelMs() const { return parallelMs; }
+    uint32_t getTimeToAudioMs() const { return timeToAudioMs; }
+    uint32_t getTimeToReadyMs() const { return timeToReadyMs; }
+    void printReport() const;
+    const char* getLastError() const;
+
+private:
+    Stage stages[MAX_STAGES];
+    uint8_t stageCount;
+    EventGroupHandle_t doneBits;
+    EventBits_t startedBits;
+    uint32_t firstStartMs;
+    uint32_t parallelMs;
+    uint32_t timeToAudioMs;
+    uint32_t timeToReadyMs;
+
+    int findStage(const char* name) const;
+
+    // Error handling
+    void setLastError(const char* error) const;
+    mutable char lastError[128];
+
+    // Task entry point
+    struct TaskContext {
+        BootOrchestrator* owner;
+        uint8_t index;
+    };
+    TaskContext contexts[MAX_STAGES];
+    static void stageTask(void* param);
+    void runStage(uint8_t index);   // Stage body, also used inline
+};
+
+#endif // BOOT_ORCHESTRATOR_H
@@ -33,6 +33,39 @@ private:
     // Default configuration
     static constexpr uint8_t kDefaultHeadphoneVolume = 6;
     static constexpr uint8_t kDefaultSpeakerVolume = 0;
+    static constexpr uint32_t RESET_TIMEOUT_MS = 50;     // Max wait for ACK after reset
+    static constexpr uint32_t DAC_POWER_TIMEOUT_MS = 50; // Max wait for PLL lock + DAC power-up
+    
+    // Page 1 registers written directly (bypassing the library)
+    static constexpr uint8_t REG_PAGE_SELECT = 0x00;
+    static constexpr uint8_t REG_SPK_AMP = 0x20;        // D7 = class-D amp powered
+    static constexpr uint8_t REG_HPL_VOLUME = 0x24;     // D7 = route, D6-0 = attenuation
+    static constexpr uint8_t REG_HPR_VOLUME = 0x25;
+    static constexpr uint8_t REG_SPK_VOLUME = 0x26;
+    static constexpr uint8_t ROUTE_ENABLE = 0x80;
+    
+    // Shadow register cache for pages 0 and 1. Writes that would not change a
+    // cached value are skipped and the page select is only sent on change.
+    static constexpr uint8_t CACHED_PAGES = 2;
+    static constexpr uint8_t PAGE_UNKNOWN = 0xFF;
+    uint8_t shadowValues[CACHED_PAGES][128];
+    uint8_t shadowValid[CACHED_PAGES][16];   // One bit per register
+    uint8_t currentPage;
+    
+    // Transaction accounting: actual transfers vs. what one page select plus
+    // one write per register (the library's pattern) would have cost
+    uint32_t i2cTransactions;
+    uint32_t naiveTransactions;
+    
+    // Raw register access
+    bool selectPage(uint8_t page);
+    bool readRegister(uint8_t page, uint8_t reg, uint8_t& value);
+    bool writeRegister(uint8_t page, uint8_t reg, uint8_t value);
+    bool writeRegisters(uint8_t page, uint8_t firstReg, const uint8_t* values, uint8_t count);
+    bool updateRegister(uint8_t page, uint8_t reg, uint8_t mask, uint8_t bits);
+    bool isCached(uint8_t page, uint8_t reg, uint8_t value) const;
+    void setCached(uint8_t page, uint8_t reg, uint8_t value);
+    void clearCached(uint8_t page, uint8_t reg);
     
     // Remove complex headphone routing state - now handled in main.cpp
     // tlv320_headset_status_t hp_lastRaw = TLV320_HEADSET_NONE;
@@ -70,9 +103,19 @@ public:
     // tlv320_headset_status_t getHeadphoneStatusRaw();
     // hp_route_t getCurrentRoute() const { return hp_filtered ? HP_ROUTE_HEADPHONES : HP_ROUTE_SPEAKER; }
     
-    // Get DAC object for advanced operations
+    // Get DAC object for advanced operations. The library writes registers
+    // behind the shadow cache, so call invalidateCache() afterwards.
     Adafruit_TLV320DAC3100* getCodec() { return &codec; }
     
+    // Forget all cached register values and the current page
+    void invalidateCache();
+    
+    // I2C statistics
+    uint32_t getI2CTransactionCount() const { return i2cTransactions; }
+    uint32_t getSavedTransactionCount() const;
+    void resetStats();
+    void printStats() const;
+    
     // Check if DAC is initialized
     bool isInitialized() const { return initialized; }
     
@@ -81,6 +124,13 @@ public:
     
     // Reset DAC
     void reset();
+    
+    // Poll until the codec ACKs on I2C (replaces fixed settle delays)
+    bool waitForAck(uint32_t timeoutMs, unsigned long* waitedMs = nullptr);
+    
+    // Poll until both DAC channels report powered up. The PLL runs from BCLK,
+    // so this only succeeds once I2S is running.
+    bool waitForDacPowerUp(uint32_t timeoutMs = DAC_POWER_TIMEOUT_MS);
 };
 
 #endif // DAC_MANAGER_H 
\ No newline at end of file
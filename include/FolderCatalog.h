@@ -0,0 +1,63 @@
+#ifndef FOLDER_CATALOG_H
+#define FOLDER_CATALOG_H
+
+#include <Arduino.h>
+#include <vector>
+#include "MappingStore.h"
+#include "SdScanner.h"
+
+// ============================================================================
+// FOLDER CATALOG
+// ============================================================================
+// Audio folders of the content root, sorted, each with an "assigned" flag.
+// The SD card is scanned once and reused until a rescan is asked for. The
+// flags come from a linear merge against MappingStore::sortedPaths(), redone
+// only when the store's revision moved; a single assignment made through
+// applyChange() flips its flags in place (binary search + O(1) update)
+// instead of merging again.
+// ============================================================================
+
+class FolderCatalog {
+public:
+    FolderCatalog();
+
+    // Folder list (cached per root; force rescans the card)
+    bool scan(SdScanner& scanner, fs::FS& fs, const String& root, bool force = false);
+    void setFolders(const String& root, std::vector<String>& paths);   // Takes paths over
+    bool isScanned(const String& root) const { return scanned && root == scannedRoot; }
+
+    // Bring the flags up to date with the store (merge only if it changed)
+    void refresh(const MappingStore& store);
+
+    // Store changed path (and oldPath on a reassign) by one mutation
+    void applyChange(const MappingStore& store, const String& path, const String& oldPath = "");
+
+    // Unassigned folders
+    size_t unassignedCount() const { return unassigned; }
+    size_t folderCount() const { return folders.size(); }
+    bool nextUnassigned(size_t& cursor, String& out) const;   // Start with cursor = 0
+    void copyUnassigned(std::vector<String>& out) const;
+
+    void clear();
+
+    // Statistics
+    uint32_t getMergeCount() const { return mergeCount; }
+    uint32_t getIncrementalCount() const { return incrementalCount; }
+
+private:
+    std::vector<String> folders;   // Sorted by pathLess
+    std::vector<bool> assigned;    // Parallel to folders
+    size_t unassigned;
+    String scannedRoot;
+    bool scanned;
+    bool merged;
+    uint32_t mergedRevision;       // Store revision the flags reflect
+
+    uint32_t mergeCount;
+    uint32_t incrementalCount;
+
+    void merge(const MappingStore& store);
+    void updateFlag(const MappingStore& store, const String& path);
+};
+
+#endif // FOLDER_CATALOG_H
@@ -0,0 +1,99 @@
+#ifndef GAIN_RAMP_STREAM_H
+#define GAIN_RAMP_STREAM_H
+
+#include <Arduino.h>
+#include <AudioTools.h>
+
+// Last stage before I2S: scales 16-bit PCM by a gain that moves toward its
+// target one frame at a time, so a ramp lasts the same number of samples
+// however often the main loop gets to copy a block. It also counts the
+// frames written since the gain reached zero: once a whole DMA queue of them
+// has gone out, the DAC is playing silence and the speaker can be switched.
+class GainRampStream : public AudioStream {
+public:
+    explicit GainRampStream(Print& out)
+        : output(&out), gain(1.0f), target(1.0f), step(0.0f), channels(2), channel(0),
+          sampleRate(44100), queueFrames(0), silentFrames(0) {}
+
+    // Format of the PCM passing through and size of the I2S DMA queue
+    void begin(int rate, int channelCount, uint32_t dmaFrames) {
+        sampleRate = rate > 0 ? rate : 44100;
+        channels = channelCount > 0 ? channelCount : 2;
+        channel = 0;
+        queueFrames = dmaFrames;
+    }
+
+    // Jump to a gain (no ramp)
+    void setGain(float value) {
+        gain = target = constrain(value, 0.0f, 1.0f);
+        step = 0.0f;
+        silentFrames = gain > 0.0f ? 0 : queueFrames;
+    }
+
+    // Move to a gain over the next rampMs of audio
+    void rampTo(float value, uint16_t rampMs) {
+        target = constrain(value, 0.0f, 1.0f);
+        const uint32_t frames = (uint32_t)sampleRate * rampMs / 1000;
+        step = frames > 0 ? fabsf(target - gain) / frames : 1.0f;
+        if (target > 0.0f) {
+            silentFrames = 0;
+        }
+    }
+
+    float getGain() const { return gain; }
+    bool isRamping() const { return gain != target; }
+
+    // Gain is zero and the DMA queue holds nothing written before that
+    bool isSilentAtOutput() const { return gain == 0.0f && silentFrames >= queueFrames; }
+
+    size_t write(const uint8_t* data, size_t len) override {
+        if (gain == 1.0f && target == 1.0f) {
+            return output->write(data, len);
+        }
+
+        int16_t scaled[256];
+        const size_t samples = len / sizeof(int16_t);
+        size_t done = 0;
+        while (done < samples) {
+            const size_t count = min(samples - done, sizeof(scaled) / sizeof(scaled[0]));
+            memcpy(scaled, data + done * sizeof(int16_t), count * sizeof(int16_t));
+            for (size_t i = 0; i < count; i++) {
+                scaled[i] = (int16_t)(scaled[i] * gain);
+                if (++channel >= channels) {
+                    channel = 0;
+                    advanceFrame();
+                }
+            }
+            output->write((const uint8_t*)scaled, count * sizeof(int16_t));
+            done += count;
+        }
+        return len;
+    }
+    using AudioStream::write;
+
+    int availableForWrite() override { return output->availableForWrite(); }
+
+private:
+    Print* output;
+    float gain;
+    float target;
+    float step;               // Gain change per frame
+    int channels;
+    int channel;              // Next sample's channel within its frame
+    int sampleRate;
+    uint32_t queueFrames;
+    uint32_t silentFrames;    // Frames written at zero gain, capped at queueFrames
+
+    void advanceFrame() {
+        if (gain < target) {
+            gain = min(gain + step, target);
+        } else if (gain > target) {
+            gain = max(gain - step, target);
+        }
+        if (gain == 0.0f && silentFrames < queueFrames) {
+            silentFrames++;
+        }
+    }
+};
+
+#endif // GAIN_RAMP_STREAM_H
@@ -0,0 +1,82 @@
+#ifndef JSON_STREAM_WRITER_H
+#define JSON_STREAM_WRITER_H
+
+#include <Arduino.h>
+
+// ============================================================================
+// JSON STREAM WRITER
+// ============================================================================
+// Writes JSON to any Print sink (an HTTP response stream, a chunk staging
+// buffer, Serial). Output is collected in a fixed BUFFER_SIZE buffer and handed
+// to the sink whenever it fills, so the writer itself never grows. Commas are
+// inserted automatically and strings are escaped.
+//
+//   JsonStreamWriter json(*response);
+//   json.beginObject();
+//   json.beginArray("folders");
+//   for (...) json.add(nullptr, path);
+//   json.endArray();
+//   json.endObject();
+//   json.flush();
+//
+// Keys are ignored inside arrays (pass nullptr). setPretty(true) puts each
+// value on its own line with two-space indentation (for files people edit).
+// ============================================================================
+
+class JsonStreamWriter {
+public:
+    static constexpr size_t BUFFER_SIZE = 512;
+    static constexpr uint8_t MAX_DEPTH = 16;
+
+    explicit JsonStreamWriter(Print& out);
+    ~JsonStreamWriter();
+
+    // Containers
+    void beginObject(const char* key = nullptr);
+    void endObject();
+    void beginArray(const char* key = nullptr);
+    void endArray();
+
+    // Values
+    void add(const char* key, const char* value);
+    void add(const char* key, const String& value) { add(key, value.c_str()); }
+    void add(const char* key, int value);
+    void add(const char* key, unsigned int value);
+    void add(const char* key, long value);
+    void add(const char* key, unsigned long value);
+    void add(const char* key, double value, uint8_t decimals = 2);
+    void add(const char* key, bool value);
+    void addNull(const char* key);
+
+    // Hand the buffered bytes to the sink (also done by the destructor)
+    void flush();
+
+    // Line breaks and indentation (set before the first value)
+    void setPretty(bool enable) { pretty = enable; }
+
+    // Statistics
+    size_t getBytesWritten() const { return bytesWritten; }
+    uint32_t getChunkCount() const { return chunkCount; }   // Writes to the sink
+
+private:
+    Print& out;
+    char buffer[BUFFER_SIZE];
+    size_t used;
+    uint8_t depth;
+    uint32_t hasItems;    // Bit per depth: a value was already written at that level
+    bool pretty;
+
+    size_t bytesWritten;
+    uint32_t chunkCount;
+
+    void beginValue(const char* key);
+    void closeContainer(char bracket);
+    void newLine(uint8_t level);
+    void write(const char* text, size_t length);
+    void write(const char* text) { write(text, strlen(text)); }
+    void write(char c);
+    void writeEscaped(const char* text);
+    void writeNumber(const char* key, const char* format, ...);
+};
+
+#endif // JSON_STREAM_WRITER_H
@@ -0,0 +1,92 @@
+#ifndef LED_RENDERER_H
+#define LED_RENDERER_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+// ============================================================================
+// LED RENDERER
+// ============================================================================
+// Status LED driven by declarative patterns instead of writes to leds[] and
+// delay(). Callers state what the LED should show (base pattern, battery
+// level, one-shot flashes); render() is called every main loop iteration,
+// works out the colour for the current time and calls FastLED.show() only
+// when a pixel actually changes. On the ESP32 show() is an RMT transfer that
+// briefly masks interrupts, so an unchanged LED must cost nothing.
+//
+// Layers, highest first:
+//   flash    - N on/off cycles of one colour (e.g. unknown card), then gone
+//   battery  - below BATTERY_LOW_PERCENT every other BATTERY_BLINK_MS shows
+//              yellow (red below BATTERY_CRITICAL_PERCENT)
+//   base     - solid, blink or pulse
+// ============================================================================
+
+struct LedPattern {
+    enum Kind : uint8_t {
+        SOLID,
+        BLINK,      // On for half the period, off for the other half
+        PULSE       // Triangle fade in PULSE_STEPS brightness steps
+    };
+
+    Kind kind;
+    CRGB color;
+    uint16_t periodMs;
+
+    static LedPattern solid(const CRGB& color) { return LedPattern{ SOLID, color, 0 }; }
+    static LedPattern blink(const CRGB& color, uint16_t periodMs) { return LedPattern{ BLINK, color, periodMs }; }
+    static LedPattern pulse(const CRGB& color, uint16_t periodMs) { return LedPattern{ PULSE, color, periodMs }; }
+    static LedPattern off() { return solid(CRGB::Black); }
+};
+
+class LedRenderer {
+public:
+    static constexpr uint8_t PULSE_STEPS = 16;              // Frames per pulse ramp
+    static constexpr uint32_t BATTERY_BLINK_MS = 2000;
+    static constexpr float BATTERY_LOW_PERCENT = 50.0f;
+    static constexpr float BATTERY_CRITICAL_PERCENT = 20.0f;
+
+    LedRenderer(CRGB* leds, uint8_t count);
+
+    // What to show
+    void setBase(const LedPattern& pattern);
+    void setBatteryLevel(float percent);                   // < 0 = no battery indication
+    void flash(const CRGB& color, uint8_t times = 3, uint16_t onMs = 200, uint16_t offMs = 150);
+    bool isFlashing() const { return flashTimes > 0; }
+
+    // Evaluate the patterns and push a frame if a pixel changed
+    void render(uint32_t nowMs);
+    void render() { render(millis()); }
+
+    // Turn the LED off now (deep sleep, fatal errors)
+    void blank();
+
+    // Statistics
+    uint32_t getFrameCount() const { return frameCount; }   // render() calls
+    uint32_t getShowCount() const { return showCount; }     // FastLED.show() calls
+    void printStats() const;
+
+private:
+    CRGB* leds;
+    uint8_t count;
+
+    LedPattern base;
+    uint32_t baseStartMs;
+    float batteryPercent;
+
+    CRGB flashColor;
+    uint8_t flashTimes;
+    uint16_t flashOnMs;
+    uint16_t flashOffMs;
+    uint32_t flashStartMs;
+    bool flashPending;       // Start time is taken at the next render()
+
+    bool framePushed;        // First frame is always sent (LED state after reset is unknown)
+    uint32_t frameCount;
+    uint32_t showCount;
+
+    CRGB evaluate(uint32_t nowMs);
+    CRGB evaluateBase(uint32_t nowMs) const;
+    void push(const CRGB& color);
+};
+
+#endif // LED_RENDERER_H
@@ -2,6 +2,7 @@
 #define LOGGER_H
 
 #include <Arduino.h>
+#include <type_traits>
 
 // ============================================================================
 // LOGGING SYSTEM
@@ -15,84 +16,246 @@ enum class LogLevel {
     DEBUG = 3
 };
 
+// Most verbose level compiled into the firmware (0 = ERROR ... 3 = DEBUG).
+// Log statements above it are constant-folded away together with their
+// arguments. Set with -DLOG_COMPILE_LEVEL=N in platformio.ini.
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL 3
+#endif
+
+// Components with their own runtime log level
+enum class LogComponent : uint8_t {
+    GENERAL = 0,
+    AUDIO,
+    RFID,
+    SETUP,
+    DAC,
+    SD,
+    BATTERY,
+    BUTTON,
+    ROTARY,
+    SETTINGS,
+    MAPPING,
+    SCANNER,
+    SESSION,
+    POWER,
+    COUNT
+};
+
 // Global log level (can be changed at runtime)
 extern LogLevel currentLogLevel;
 
-// Initialize logging system
+// Per-component levels (GENERAL mirrors currentLogLevel)
+extern LogLevel componentLogLevels[(size_t)LogComponent::COUNT];
+
+// Initialize logging system (also starts the deferred log task)
 void initLogger(LogLevel level = LogLevel::INFO);
 
-// Set log level at runtime
+// Set log level at runtime (applies to every component)
 void setLogLevel(LogLevel level);
 
 // Get current log level
 LogLevel getLogLevel();
 
+// Override the level of a single component
+void setComponentLogLevel(LogComponent component, LogLevel level);
+LogLevel getComponentLogLevel(LogComponent component);
+const char* getComponentName(LogComponent component);
+
+// Compile-time level check first so disabled levels cost nothing
+#define LOG_ENABLED(level, component) \
+    ((int)(level) <= LOG_COMPILE_LEVEL && componentLogLevels[(size_t)(component)] >= (level))
+
+#define LOG_AT(level, component, prefix, fmt, ...) \
+    do { if (LOG_ENABLED(level, component)) { Serial.printf(prefix fmt "\n", ##__VA_ARGS__); } } while(0)
+
+#define LOG_MSG_AT(level, component, prefix, msg) \
+    do { if (LOG_ENABLED(level, component)) { Serial.println(prefix msg); } } while(0)
+
 // Logging macros with automatic level checking
-#define LOG_ERROR(fmt, ...)   do { if (currentLogLevel >= LogLevel::ERROR) { Serial.printf("[ERROR] " fmt "\n", ##__VA_ARGS__); } } while(0)
-#define LOG_WARN(fmt, ...)    do { if (currentLogLevel >= LogLevel::WARN)  { Serial.printf("[WARN]  " fmt "\n", ##__VA_ARGS__); } } while(0)
-#define LOG_INFO(fmt, ...)    do { if (currentLogLevel >= LogLevel::INFO)  { Serial.printf("[INFO]  " fmt "\n", ##__VA_ARGS__); } } while(0)
-#define LOG_DEBUG(fmt, ...)   do { if (currentLogLevel >= LogLevel::DEBUG) { Serial.printf("[DEBUG] " fmt "\n", ##__VA_ARGS__); } } while(0)
+#define LOG_ERROR(fmt, ...)   LOG_AT(LogLevel::ERROR, LogComponent::GENERAL, "[ERROR] ", fmt, ##__VA_ARGS__)
+#define LOG_WARN(fmt, ...)    LOG_AT(LogLevel::WARN,  LogComponent::GENERAL, "[WARN]  ", fmt, ##__VA_ARGS__)
+#define LOG_INFO(fmt, ...)    LOG_AT(LogLevel::INFO,  LogComponent::GENERAL, "[INFO]  ", fmt, ##__VA_ARGS__)
+#define LOG_DEBUG(fmt, ...)   LOG_AT(LogLevel::DEBUG, LogComponent::GENERAL, "[DEBUG] ", fmt, ##__VA_ARGS__)
 
 // Simple logging macros without formatting
-#define LOG_ERROR_MSG(msg)    do { if (currentLogLevel >= LogLevel::ERROR) { Serial.println("[ERROR] " msg); } } while(0)
-#define LOG_WARN_MSG(msg)     do { if (currentLogLevel >= LogLevel::WARN)  { Serial.println("[WARN]  " msg); } } while(0)
-#define LOG_INFO_MSG(msg)     do { if (currentLogLevel >= LogLevel::INFO)  { Serial.println("[INFO]  " msg); } } while(0)
-#define LOG_DEBUG_MSG(msg)    do { if (currentLogLevel >= LogLevel::DEBUG) { Serial.println("[DEBUG] " msg); } } while(0)
+#define LOG_ERROR_MSG(msg)    LOG_MSG_AT(LogLevel::ERROR, LogComponent::GENERAL, "[ERROR] ", msg)
+#define LOG_WARN_MSG(msg)     LOG_MSG_AT(LogLevel::WARN,  LogComponent::GENERAL, "[WARN]  ", msg)
+#define LOG_INFO_MSG(msg)     LOG_MSG_AT(LogLevel::INFO,  LogComponent::GENERAL, "[INFO]  ", msg)
+#define LOG_DEBUG_MSG(msg)    LOG_MSG_AT(LogLevel::DEBUG, LogComponent::GENERAL, "[DEBUG] ", msg)
+
+// Component macros: same output as the generic ones plus a "[TAG] " prefix
+#define LOG_COMPONENT_ERROR(c, fmt, ...) LOG_AT(LogLevel::ERROR, LogComponent::c, "[ERROR] [" #c "] ", fmt, ##__VA_ARGS__)
+#define LOG_COMPONENT_WARN(c, fmt, ...)  LOG_AT(LogLevel::WARN,  LogComponent::c, "[WARN]  [" #c "] ", fmt, ##__VA_ARGS__)
+#define LOG_COMPONENT_INFO(c, fmt, ...)  LOG_AT(LogLevel::INFO,  LogComponent::c, "[INFO]  [" #c "] ", fmt, ##__VA_ARGS__)
+#define LOG_COMPONENT_DEBUG(c, fmt, ...) LOG_AT(LogLevel::DEBUG, LogComponent::c, "[DEBUG] [" #c "] ", fmt, ##__VA_ARGS__)
 
 // Specialized logging macros for different components
-#define LOG_AUDIO_ERROR(fmt, ...)   LOG_ERROR("[AUDIO] " fmt, ##__VA_ARGS__)
-#define LOG_AUDIO_WARN(fmt, ...)    LOG_WARN("[AUDIO] " fmt, ##__VA_ARGS__)
-#define LOG_AUDIO_INFO(fmt, ...)    LOG_INFO("[AUDIO] " fmt, ##__VA_ARGS__)
-#define LOG_AUDIO_DEBUG(fmt, ...)   LOG_DEBUG("[AUDIO] " fmt, ##__VA_ARGS__)
-
-#define LOG_RFID_ERROR(fmt, ...)    LOG_ERROR("[RFID] " fmt, ##__VA_ARGS__)
-#define LOG_RFID_WARN(fmt, ...)     LOG_WARN("[RFID] " fmt, ##__VA_ARGS__)
-#define LOG_RFID_INFO(fmt, ...)     LOG_INFO("[RFID] " fmt, ##__VA_ARGS__)
-#define LOG_RFID_DEBUG(fmt, ...)    LOG_DEBUG("[RFID] " fmt, ##__VA_ARGS__)
-
-#define LOG_SETUP_ERROR(fmt, ...)   LOG_ERROR("[SETUP] " fmt, ##__VA_ARGS__)
-#define LOG_SETUP_WARN(fmt, ...)    LOG_WARN("[SETUP] " fmt, ##__VA_ARGS__)
-#define LOG_SETUP_INFO(fmt, ...)    LOG_INFO("[SETUP] " fmt, ##__VA_ARGS__)
-#define LOG_SETUP_DEBUG(fmt, ...)   LOG_DEBUG("[SETUP] " fmt, ##__VA_ARGS__)
-
-#define LOG_DAC_ERROR(fmt, ...)     LOG_ERROR("[DAC] " fmt, ##__VA_ARGS__)
-#define LOG_DAC_WARN(fmt, ...)      LOG_WARN("[DAC] " fmt, ##__VA_ARGS__)
-#define LOG_DAC_INFO(fmt, ...)      LOG_INFO("[DAC] " fmt, ##__VA_ARGS__)
-#define LOG_DAC_DEBUG(fmt, ...)     LOG_DEBUG("[DAC] " fmt, ##__VA_ARGS__)
-
-#define LOG_SD_ERROR(fmt, ...)      LOG_ERROR("[SD] " fmt, ##__VA_ARGS__)
-#define LOG_SD_WARN(fmt, ...)       LOG_WARN("[SD] " fmt, ##__VA_ARGS__)
-#define LOG_SD_INFO(fmt, ...)       LOG_INFO("[SD] " fmt, ##__VA_ARGS__)
-#define LOG_SD_DEBUG(fmt, ...)      LOG_DEBUG("[SD] " fmt, ##__VA_ARGS__)
-
-#define LOG_BATTERY_ERROR(fmt, ...) LOG_ERROR("[BATTERY] " fmt, ##__VA_ARGS__)
-#define LOG_BATTERY_WARN(fmt, ...)  LOG_WARN("[BATTERY] " fmt, ##__VA_ARGS__)
-#define LOG_BATTERY_INFO(fmt, ...)  LOG_INFO("[BATTERY] " fmt, ##__VA_ARGS__)
-#define LOG_BATTERY_DEBUG(fmt, ...) LOG_DEBUG("[BATTERY] " fmt, ##__VA_ARGS__)
-
-#define LOG_BUTTON_ERROR(fmt, ...)  LOG_ERROR("[BUTTON] " fmt, ##__VA_ARGS__)
-#define LOG_BUTTON_WARN(fmt, ...)   LOG_WARN("[BUTTON] " fmt, ##__VA_ARGS__)
-#define LOG_BUTTON_INFO(fmt, ...)   LOG_INFO("[BUTTON] " fmt, ##__VA_ARGS__)
-#define LOG_BUTTON_DEBUG(fmt, ...)  LOG_DEBUG("[BUTTON] " fmt, ##__VA_ARGS__)
-
-#define LOG_ROTARY_ERROR(fmt, ...)  LOG_ERROR("[ROTARY] " fmt, ##__VA_ARGS__)
-#define LOG_ROTARY_WARN(fmt, ...)   LOG_WARN("[ROTARY] " fmt, ##__VA_ARGS__)
-#define LOG_ROTARY_INFO(fmt, ...)   LOG_INFO("[ROTARY] " fmt, ##__VA_ARGS__)
-#define LOG_ROTARY_DEBUG(fmt, ...)  LOG_DEBUG("[ROTARY] " fmt, ##__VA_ARGS__)
-
-#define LOG_SETTINGS_ERROR(fmt, ...) LOG_ERROR("[SETTINGS] " fmt, ##__VA_ARGS__)
-#define LOG_SETTINGS_WARN(fmt, ...)  LOG_WARN("[SETTINGS] " fmt, ##__VA_ARGS__)
-#define LOG_SETTINGS_INFO(fmt, ...)  LOG_INFO("[SETTINGS] " fmt, ##__VA_ARGS__)
-#define LOG_SETTINGS_DEBUG(fmt, ...) LOG_DEBUG("[SETTINGS] " fmt, ##__VA_ARGS__)
-
-#define LOG_MAPPING_ERROR(fmt, ...) LOG_ERROR("[MAPPING] " fmt, ##__VA_ARGS__)
-#define LOG_MAPPING_WARN(fmt, ...)  LOG_WARN("[MAPPING] " fmt, ##__VA_ARGS__)
-#define LOG_MAPPING_INFO(fmt, ...)  LOG_INFO("[MAPPING] " fmt, ##__VA_ARGS__)
-#define LOG_MAPPING_DEBUG(fmt, ...) LOG_DEBUG("[MAPPING] " fmt, ##__VA_ARGS__)
-
-#define LOG_SCANNER_ERROR(fmt, ...) LOG_ERROR("[SCANNER] " fmt, ##__VA_ARGS__)
-#define LOG_SCANNER_WARN(fmt, ...)  LOG_WARN("[SCANNER] " fmt, ##__VA_ARGS__)
-#define LOG_SCANNER_INFO(fmt, ...)  LOG_INFO("[SCANNER] " fmt, ##__VA_ARGS__)
-#define LOG_SCANNER_DEBUG(fmt, ...) LOG_DEBUG("[SCANNER] " fmt, ##__VA_ARGS__)
+#define LOG_AUDIO_ERROR(fmt, ...)   LOG_COMPONENT_ERROR(AUDIO, fmt, ##__VA_ARGS__)
+#define LOG_AUDIO_WARN(fmt, ...)    LOG_COMPONENT_WARN(AUDIO, fmt, ##__VA_ARGS__)
+#define LOG_AUDIO_INFO(fmt, ...)    LOG_COMPONENT_INFO(AUDIO, fmt, ##__VA_ARGS__)
+#define LOG_AUDIO_DEBUG(fmt, ...)   LOG_COMPONENT_DEBUG(AUDIO, fmt, ##__VA_ARGS__)
+
+#define LOG_RFID_ERROR(fmt, ...)    LOG_COMPONENT_ERROR(RFID, fmt, ##__VA_ARGS__)
+#define LOG_RFID_WARN(fmt, ...)     LOG_COMPONENT_WARN(RFID, fmt, ##__VA_ARGS__)
+#define LOG_RFID_INFO(fmt, ...)     LOG_COMPONENT_INFO(RFID, fmt, ##__VA_ARGS__)
+#define LOG_RFID_DEBUG(fmt, ...)    LOG_COMPONENT_DEBUG(RFID, fmt, ##__VA_ARGS__)
+
+#define LOG_SETUP_ERROR(fmt, ...)   LOG_COMPONENT_ERROR(SETUP, fmt, ##__VA_ARGS__)
+#define LOG_SETUP_WARN(fmt, ...)    LOG_COMPONENT_WARN(SETUP, fmt, ##__VA_ARGS__)
+#define LOG_SETUP_INFO(fmt, ...)    LOG_COMPONENT_INFO(SETUP, fmt, ##__VA_ARGS__)
+#define LOG_SETUP_DEBUG(fmt, ...)   LOG_COMPONENT_DEBUG(SETUP, fmt, ##__VA_ARGS__)
+
+#define LOG_DAC_ERROR(fmt, ...)     LOG_COMPONENT_ERROR(DAC, fmt, ##__VA_ARGS__)
+#define LOG_DAC_WARN(fmt, ...)      LOG_COMPONENT_WARN(DAC, fmt, ##__VA_ARGS__)
+#define LOG_DAC_INFO(fmt, ...)      LOG_COMPONENT_INFO(DAC, fmt, ##__VA_ARGS__)
+#define LOG_DAC_DEBUG(fmt, ...)     LOG_COMPONENT_DEBUG(DAC, fmt, ##__VA_ARGS__)
+
+#define LOG_SD_ERROR(fmt, ...)      LOG_COMPONENT_ERROR(SD, fmt, ##__VA_ARGS__)
+#define LOG_SD_WARN(fmt, ...)       LOG_COMPONENT_WARN(SD, fmt, ##__VA_ARGS__)
+#define LOG_SD_INFO(fmt, ...)       LOG_COMPONENT_INFO(SD, fmt, ##__VA_ARGS__)
+#define LOG_SD_DEBUG(fmt, ...)      LOG_COMPONENT_DEBUG(SD, fmt, ##__VA_ARGS__)
+
+#define LOG_BATTERY_ERROR(fmt, ...) LOG_COMPONENT_ERROR(BATTERY, fmt, ##__VA_ARGS__)
+#define LOG_BATTERY_WARN(fmt, ...)  LOG_COMPONENT_WARN(BATTERY, fmt, ##__VA_ARGS__)
+#define LOG_BATTERY_INFO(fmt, ...)  LOG_COMPONENT_INFO(BATTERY, fmt, ##__VA_ARGS__)
+#define LOG_BATTERY_DEBUG(fmt, ...) LOG_COMPONENT_DEBUG(BATTERY, fmt, ##__VA_ARGS__)
+
+#define LOG_BUTTON_ERROR(fmt, ...)  LOG_COMPONENT_ERROR(BUTTON, fmt, ##__VA_ARGS__)
+#define LOG_BUTTON_WARN(fmt, ...)   LOG_COMPONENT_WARN(BUTTON, fmt, ##__VA_ARGS__)
+#define LOG_BUTTON_INFO(fmt, ...)   LOG_COMPONENT_INFO(BUTTON, fmt, ##__VA_ARGS__)
+#define LOG_BUTTON_DEBUG(fmt, ...)  LOG_COMPONENT_DEBUG(BUTTON, fmt, ##__VA_ARGS__)
+
+#define LOG_ROTARY_ERROR(fmt, ...)  LOG_COMPONENT_ERROR(ROTARY, fmt, ##__VA_ARGS__)
+#define LOG_ROTARY_WARN(fmt, ...)   LOG_COMPONENT_WARN(ROTARY, fmt, ##__VA_ARGS__)
+#define LOG_ROTARY_INFO(fmt, ...)   LOG_COMPONENT_INFO(ROTARY, fmt, ##__VA_ARGS__)
+#define LOG_ROTARY_DEBUG(fmt, ...)  LOG_COMPONENT_DEBUG(ROTARY, fmt, ##__VA_ARGS__)
+
+#define LOG_SETTINGS_ERROR(fmt, ...) LOG_COMPONENT_ERROR(SETTINGS, fmt, ##__VA_ARGS__)
+#define LOG_SETTINGS_WARN(fmt, ...)  LOG_COMPONENT_WARN(SETTINGS, fmt, ##__VA_ARGS__)
+#define LOG_SETTINGS_INFO(fmt, ...)  LOG_COMPONENT_INFO(SETTINGS, fmt, ##__VA_ARGS__)
+#define LOG_SETTINGS_DEBUG(fmt, ...) LOG_COMPONENT_DEBUG(SETTINGS, fmt, ##__VA_ARGS__)
+
+#define LOG_MAPPING_ERROR(fmt, ...) LOG_COMPONENT_ERROR(MAPPING, fmt, ##__VA_ARGS__)
+#define LOG_MAPPING_WARN(fmt, ...)  LOG_COMPONENT_WARN(MAPPING, fmt, ##__VA_ARGS__)
+#define LOG_MAPPING_INFO(fmt, ...)  LOG_COMPONENT_INFO(MAPPING, fmt, ##__VA_ARGS__)
+#define LOG_MAPPING_DEBUG(fmt, ...) LOG_COMPONENT_DEBUG(MAPPING, fmt, ##__VA_ARGS__)
+
+#define LOG_SCANNER_ERROR(fmt, ...) LOG_COMPONENT_ERROR(SCANNER, fmt, ##__VA_ARGS__)
+#define LOG_SCANNER_WARN(fmt, ...)  LOG_COMPONENT_WARN(SCANNER, fmt, ##__VA_ARGS__)
+#define LOG_SCANNER_INFO(fmt, ...)  LOG_COMPONENT_INFO(SCANNER, fmt, ##__VA_ARGS__)
+#define LOG_SCANNER_DEBUG(fmt, ...) LOG_COMPONENT_DEBUG(SCANNER, fmt, ##__VA_ARGS__)
+
+#define LOG_SESSION_ERROR(fmt, ...) LOG_COMPONENT_ERROR(SESSION, fmt, ##__VA_ARGS__)
+#define LOG_SESSION_WARN(fmt, ...)  LOG_COMPONENT_WARN(SESSION, fmt, ##__VA_ARGS__)
+#define LOG_SESSION_INFO(fmt, ...)  LOG_COMPONENT_INFO(SESSION, fmt, ##__VA_ARGS__)
+#define LOG_SESSION_DEBUG(fmt, ...) LOG_COMPONENT_DEBUG(SESSION, fmt, ##__VA_ARGS__)
+
+#define LOG_POWER_ERROR(fmt, ...) LOG_COMPONENT_ERROR(POWER, fmt, ##__VA_ARGS__)
+#define LOG_POWER_WARN(fmt, ...)  LOG_COMPONENT_WARN(POWER, fmt, ##__VA_ARGS__)
+#define LOG_POWER_INFO(fmt, ...)  LOG_COMPONENT_INFO(POWER, fmt, ##__VA_ARGS__)
+#define LOG_POWER_DEBUG(fmt, ...) LOG_COMPONENT_DEBUG(POWER, fmt, ##__VA_ARGS__)
+
+// ============================================================================
+// DEFERRED LOGGING
+// ============================================================================
+// For hot paths (audio loop, button/encoder handling). The call site only
+// copies the format-string pointer, a timestamp and up to four numeric or
+// static-string arguments into a ring buffer; formatting and the serial write
+// happen later in a low-priority task. Arguments are therefore restricted to
+// integers, enums, floats and pointers to strings that outlive the call
+// (literals, static tables) - an Arduino String will not compile.
+//
+//   LOG_DEFER(INFO, BUTTON, "Button pressed: %s", getButtonName(b));
+
+#ifndef LOG_DEFERRED_RING_SIZE
+#define LOG_DEFERRED_RING_SIZE 64
+#endif
+
+static constexpr uint8_t LOG_DEFERRED_MAX_ARGS = 4;
+
+enum class LogArgType : uint8_t {
+    INT,
+    UINT,
+    FLOAT,
+    STR,
+    PTR
+};
+
+union LogArg {
+    int32_t i;
+    uint32_t u;
+    float f;
+    const char* s;
+    const void* p;
+};
+
+struct LogRecord {
+    const char* fmt;
+    uint32_t timestampMs;
+    LogLevel level;
+    uint8_t argCount;
+    LogArgType types[LOG_DEFERRED_MAX_ARGS];
+    LogArg args[LOG_DEFERRED_MAX_ARGS];
+};
+
+// Ring buffer access (implemented in Logger.cpp)
+void logDeferredPush(const LogRecord& record);
+void flushDeferredLogs();                // Drain the ring synchronously
+uint32_t getDeferredLogDropped();         // Records lost to a full ring
+
+// Argument packing
+inline void logPackArg(LogRecord& r, const char* value) {
+    r.types[r.argCount] = LogArgType::STR;
+    r.args[r.argCount++].s = value;
+}
+inline void logPackArg(LogRecord& r, char* value) {
+    logPackArg(r, (const char*)value);
+}
+inline void logPackArg(LogRecord& r, double value) {
+    r.types[r.argCount] = LogArgType::FLOAT;
+    r.args[r.argCount++].f = (float)value;
+}
+inline void logPackArg(LogRecord& r, const void* value) {
+    r.types[r.argCount] = LogArgType::PTR;
+    r.args[r.argCount++].p = value;
+}
+void logPackArg(LogRecord& r, const String& value) = delete;   // must not be deferred
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+logPackArg(LogRecord& r, T value) {
+    if (std::is_signed<T>::value) {
+        r.types[r.argCount] = LogArgType::INT;
+        r.args[r.argCount++].i = (int32_t)value;
+    } else {
+        r.types[r.argCount] = LogArgType::UINT;
+        r.args[r.argCount++].u = (uint32_t)value;
+    }
+}
+
+inline void logPackArgs(LogRecord&) {}
+
+template <typename T, typename... Rest>
+inline void logPackArgs(LogRecord& r, T first, Rest... rest) {
+    logPackArg(r, first);
+    logPackArgs(r, rest...);
+}
+
+template <typename... Args>
+inline void logDeferred(LogLevel level, const char* fmt, Args... args) {
+    static_assert(sizeof...(Args) <= LOG_DEFERRED_MAX_ARGS, "Too many arguments for a deferred log");
+    LogRecord record;
+    record.fmt = fmt;
+    record.timestampMs = millis();
+    record.level = level;
+    record.argCount = 0;
+    logPackArgs(record, args...);
+    logDeferredPush(record);
+}
+
+#define LOG_DEFER(level, component, fmt, ...) \
+    do { if (LOG_ENABLED(LogLevel::level, LogComponent::component)) { \
+        logDeferred(LogLevel::level, "[" #component "] " fmt, ##__VA_ARGS__); } } while(0)
 
 #endif // LOGGER_H
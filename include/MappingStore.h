@@ -23,6 +23,11 @@ namespace std {
     };
 }
 
+// Order of the sorted path lists (MappingStore::sortedPaths, FolderCatalog)
+inline bool pathLess(const String& a, const String& b) {
+    return strcmp(a.c_str(), b.c_str()) < 0;
+}
+
 // Mapping structure for UID to path relationships
 struct Mapping {
     String uid;   // uppercase hex
@@ -36,6 +41,31 @@ struct Mapping {
     }
 };
 
+// Outcome of one entry in MappingStore::commitBatch()
+enum class BatchStatus : uint8_t {
+    ASSIGNED,        // New mapping
+    REASSIGNED,      // UID moved to a new path (force)
+    UNCHANGED,       // Already mapped exactly like this
+    INVALID,         // Empty UID or path
+    UID_CONFLICT,    // UID mapped elsewhere and force not set
+    PATH_CONFLICT,   // Path belongs to another UID
+    NOT_COMMITTED,   // Valid, but the batch was not written
+    WRITE_FAILED     // Valid, but the file write failed (rolled back)
+};
+
+// One UID -> path pair of a batch. status/previous are filled in.
+struct BatchItem {
+    String uid;
+    String path;
+    bool force;               // Allow moving an already mapped UID
+    BatchStatus status;
+    String previous;          // Old path (REASSIGNED) or current path (UID_CONFLICT)
+
+    BatchItem() : force(false), status(BatchStatus::INVALID) {}
+    BatchItem(const String& u, const String& p, bool f = false)
+        : uid(u), path(p), force(f), status(BatchStatus::INVALID) {}
+};
+
 class MappingStore {
 private:
     fs::FS* sd;
@@ -45,6 +75,8 @@ private:
     // In-memory indexes
     std::unordered_map<String, String> uid_to_path;  // UID -> PATH
     std::unordered_map<String, String> path_to_uid;  // PATH -> UID (most recent binding)
+    std::vector<String> sorted_paths;                // Keys of path_to_uid, sorted by pathLess
+    uint32_t revision;                               // Bumped by every change of the maps
     
     // Helper functions
     bool parseLine(const String& line, Mapping& out) const;
@@ -54,6 +86,9 @@ private:
     String normalizeUid(const String& uid) const;
     String extract(const String& line, const String& start, const String& end) const;
     bool createIfMissing();
+    void addSortedPath(const String& path);
+    void removeSortedPath(const String& path);
+    void rebuildSortedPaths();
     
 public:
     MappingStore();
@@ -68,6 +103,13 @@ public:
     bool rebind(const String& uid, const String& newPath); // overwrite: rewrite canonical file
     bool unassign(const String& uid);      // remove mapping: rewrite canonical file
     
+    // Validate all items against the current mappings and each other, then
+    // write the accepted ones with a single canonical rewrite. allOrNothing:
+    // any rejected item leaves the store untouched. Returns false only when
+    // the write failed (memory is rolled back).
+    bool commitBatch(std::vector<BatchItem>& items, bool allOrNothing = false);
+    static const char* getBatchStatusName(BatchStatus status);
+    
     // Bijection enforcement
     bool enforceBijection(const String& uid, const String& path);
     bool removePathMapping(const String& path);
@@ -77,6 +119,8 @@ public:
     bool getUidFor(const String& path, String& out) const;
     const std::unordered_map<String, String>& uidMap() const { return uid_to_path; }
     const std::unordered_map<String, String>& pathMap() const { return path_to_uid; }
+    const std::vector<String>& sortedPaths() const { return sorted_paths; }   // Assigned paths
+    uint32_t getRevision() const { return revision; }
     
     // Utility
     bool hasUid(const String& uid) const;
@@ -0,0 +1,128 @@
+#ifndef MP3_FRAME_INDEX_H
+#define MP3_FRAME_INDEX_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <vector>
+
+// ============================================================================
+// MP3 FRAME INDEX
+// ============================================================================
+// Sparse seek table for a single MP3 file. Every entry holds the byte offset of
+// the frame that starts at (or just before) entry * kEntryIntervalMs, so a seek
+// is a table lookup followed by a single File::seek() instead of decoding from
+// the start of the file.
+//
+// The table is built from headers only, never from decoded audio:
+//   1. ID3v2 tag is skipped using its synchsafe size field
+//   2. A Xing/Info or VBRI header in the first frame provides frame count + TOC
+//   3. CBR streams without a TOC are indexed arithmetically from the first frame
+//   4. VBR streams without a TOC fall back to walking the frame headers; the
+//      walk is incremental (see continueBuild()) so it never stalls playback
+//
+// Completed tables are cached on SD under kCacheDir (one small binary file per
+// track, keyed by a hash of its path) so a file is only ever indexed once.
+// ============================================================================
+
+class Mp3FrameIndex {
+public:
+    // Decoded MPEG audio frame header
+    struct FrameHeader {
+        uint32_t sampleRate;
+        uint16_t bitrateKbps;
+        uint16_t samplesPerFrame;
+        uint16_t frameSize;     // bytes, including the 4-byte header
+        uint8_t channels;
+        uint8_t version;        // 10 = MPEG1, 20 = MPEG2, 25 = MPEG2.5
+        uint8_t layer;          // 1, 2 or 3
+    };
+
+    // How the table was (or is being) built
+    enum class Source : uint8_t {
+        NONE,
+        XING_TOC,
+        VBRI_TOC,
+        CBR,
+        FRAME_SCAN
+    };
+
+    static constexpr uint32_t kEntryIntervalMs = 1000;   // one entry per second
+    static constexpr uint32_t kScanFramesPerStep = 64;   // frames walked per continueBuild()
+    static constexpr const char* kCacheDir = "/.mp3index";
+
+    Mp3FrameIndex();
+
+    // Build the table for the given file. Returns false if the file is not a
+    // recognisable MP3 stream. A cached table is used when one matches the file;
+    // otherwise for VBR files without a TOC the table is only partially built on
+    // return; call continueBuild() until isComplete().
+    bool build(fs::FS& fs, const char* path);
+    bool continueBuild(uint32_t maxFrames = kScanFramesPerStep);
+    void clear();
+
+    // State
+    bool isValid() const { return source != Source::NONE; }
+    bool isComplete() const { return complete; }
+    bool isFor(const char* path) const;
+    Source getSource() const { return source; }
+    const char* getSourceName() const;
+    const String& getPath() const { return filePath; }
+
+    // Queries (valid once isValid())
+    uint32_t getDurationMs() const { return durationMs; }
+    uint32_t getIndexedMs() const;                 // time covered by the table so far
+    uint32_t getDataStart() const { return dataStart; }
+    uint32_t getDataEnd() const { return dataEnd; }
+    size_t getEntryCount() const { return offsets.size(); }
+    uint32_t getBuildTimeMs() const { return buildTimeMs; }
+    bool isFromCache() const { return fromCache; }
+    const FrameHeader& getFirstFrame() const { return firstFrame; }
+
+    // Time <-> byte offset mapping
+    uint32_t offsetForMs(uint32_t ms) const;
+    uint32_t msForOffset(uint32_t offset) const;
+
+    // Header parsing helpers (exposed for reuse by other MP3 tooling)
+    static bool parseFrameHeader(const uint8_t* h, FrameHeader& out);
+    static uint32_t id3v2Size(const uint8_t* h);
+
+private:
+    // Table + metadata
+    std::vector<uint32_t> offsets;
+    String filePath;
+    Source source;
+    bool complete;
+    bool fromCache;
+    FrameHeader firstFrame;
+    uint32_t fileSize;
+    uint32_t dataStart;
+    uint32_t dataEnd;
+    uint32_t durationMs;
+    uint32_t buildTimeMs;
+
+    // Incremental frame scan state
+    fs::FS* fileSystem;
+    fs::File scanFile;
+    uint32_t scanOffset;
+    uint64_t scanSamples;      // samples decoded up to scanOffset
+
+    // Build strategies
+    bool readTocFromXing(const uint8_t* frame, size_t len);
+    bool readTocFromVbri(const uint8_t* frame, size_t len);
+    bool looksLikeCbr(fs::File& f);
+    void buildCbrTable();
+    void finishScan();
+
+    // SD cache
+    String cachePathFor(const char* path) const;
+    bool loadCache(fs::FS& fs, const char* path, uint32_t expectedSize);
+    bool saveCache();
+
+    // Helpers
+    bool readAt(fs::File& f, uint32_t offset, uint8_t* buf, size_t len);
+    bool findFirstFrame(fs::File& f, uint32_t from, uint32_t& frameOffset, FrameHeader& header);
+    static uint32_t readBigEndian32(const uint8_t* p);
+    static uint16_t readBigEndian16(const uint8_t* p);
+};
+
+#endif // MP3_FRAME_INDEX_H
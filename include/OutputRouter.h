@@ -0,0 +1,108 @@
+#ifndef OUTPUT_ROUTER_H
+#define OUTPUT_ROUTER_H
+
+#include <Arduino.h>
+#include <atomic>
+
+class DAC_Manager;
+class Audio_Manager;
+
+// ============================================================================
+// OUTPUT ROUTER
+// ============================================================================
+// Switches between headphones and speaker without stopping playback. The jack
+// detect line raises an interrupt; once it has been quiet for DEBOUNCE_MS the
+// new route is applied by a small state machine stepped from update():
+//
+//   IDLE -> RAMP_DOWN -> (mute amp, switch route, un-mute) -> SETTLE -> RAMP_UP -> IDLE
+//
+// The ramps scale the digital output gain frame by frame as audio is written
+// (Audio_Manager::rampOutputGain), so audio keeps flowing through the
+// transition and update() never blocks. The route is only switched once the
+// silent frames have been played out of the I2S queue.
+// ============================================================================
+
+class OutputRouter {
+public:
+    enum class Route : uint8_t {
+        SPEAKER,
+        HEADPHONES
+    };
+
+    enum class State : uint8_t {
+        IDLE,
+        RAMP_DOWN,
+        SETTLE,
+        RAMP_UP
+    };
+
+    static constexpr uint16_t DEBOUNCE_MS = 50;     // Jack line quiet time before acting
+    static constexpr uint16_t RAMP_MS = 40;         // Each of ramp down / ramp up
+    static constexpr uint16_t AMP_SETTLE_MS = 15;   // PAM8302A turn-on after SD goes high
+    static constexpr uint16_t DRAIN_TIMEOUT_MS = 500;   // Longest wait for silence at the DAC
+    static constexpr uint8_t SPEAKER_VOLUME = 6;    // DAC speaker attenuation when enabled
+
+    // detectPin reads LOW with headphones in; ampShutdownPin HIGH = speaker amp on
+    OutputRouter(DAC_Manager& dac, Audio_Manager& audio, uint8_t detectPin, uint8_t ampShutdownPin);
+    ~OutputRouter();
+
+    // Attach the jack interrupt and apply the current route immediately
+    bool begin();
+
+    // Step debounce and transition (call every loop iteration, never blocks)
+    void update();
+
+    // Status
+    Route getRoute() const { return route; }
+    bool isHeadphones() const { return route == Route::HEADPHONES; }
+    bool isSwitching() const { return state != State::IDLE; }
+    State getState() const { return state; }
+    static const char* getRouteName(Route r);
+
+    // Statistics
+    uint32_t getSwitchCount() const { return switchCount; }
+    uint32_t getLastSwitchLatencyMs() const { return lastSwitchLatencyMs; }  // Jack edge -> full volume
+    uint32_t getMaxSwitchLatencyMs() const { return maxSwitchLatencyMs; }
+    uint32_t getEdgeCount() const { return edgeCount.load(std::memory_order_relaxed); }
+    void printStats() const;
+
+    // ISR function (must be static for interrupt)
+    static void IRAM_ATTR detectISR();
+
+    // Static instance for ISR access
+    static OutputRouter* instance;
+
+private:
+    DAC_Manager& dac;
+    Audio_Manager& audio;
+    uint8_t detectPin;
+    uint8_t ampShutdownPin;
+    bool initialized;
+
+    // ISR -> update() hand-off
+    std::atomic<bool> edgePending;
+    std::atomic<uint32_t> firstEdgeMs;   // First edge since the last debounce decision
+    std::atomic<uint32_t> lastEdgeMs;
+    std::atomic<uint32_t> edgeCount;
+
+    // Route state
+    Route route;
+    Route targetRoute;
+    State state;
+    uint32_t stateStartMs;
+    uint32_t requestMs;       // Edge that started the pending change
+
+    // Statistics
+    uint32_t switchCount;
+    uint32_t lastSwitchLatencyMs;
+    uint32_t maxSwitchLatencyMs;
+
+    // Helpers
+    Route readDetect() const;
+    void startTransition(uint32_t now);
+    void applyRoute(Route newRoute);
+    void finishTransition(uint32_t now);
+    void enterState(State newState, uint32_t now);
+};
+
+#endif // OUTPUT_ROUTER_H
@@ -0,0 +1,123 @@
+#ifndef POWER_GOVERNOR_H
+#define POWER_GOVERNOR_H
+
+#include <Arduino.h>
+
+// ============================================================================
+// POWER GOVERNOR
+// ============================================================================
+// Picks a power mode once per loop iteration:
+//
+//   ACTIVE      - decoding, switching routes or serving web setup: 240 MHz
+//   IDLE        - nothing playing: 80 MHz (APB stays at 80 MHz, so I2C, SPI
+//                 and I2S timing are unchanged)
+//   LIGHT_SLEEP - idle for IDLE_HOLDOFF_MS: idleDelay() light-sleeps until the
+//                 next RFID poll instead of spinning
+//
+// Light sleep wakes on the timer or a level change on any wake pin (encoder,
+// jack detect). The button ladder is analog and the RFID reader has no IRQ
+// line, so both are sampled on each timer wake instead. After the deep sleep
+// timeout without input the callback runs and the chip deep-sleeps until the
+// encoder moves; the next boot resumes the saved session.
+//
+// Time spent in each mode is weighted by nominal currents to estimate the
+// average draw and the remaining runtime.
+// ============================================================================
+
+class PowerGovernor {
+public:
+    enum class Mode : uint8_t {
+        ACTIVE,
+        IDLE,
+        LIGHT_SLEEP
+    };
+
+    typedef void (*DeepSleepCallback)();
+
+    static constexpr uint32_t ACTIVE_CPU_MHZ = 240;
+    static constexpr uint32_t IDLE_CPU_MHZ = 80;
+    static constexpr uint32_t IDLE_HOLDOFF_MS = 3000;   // Stay awake after input or playback
+    static constexpr uint32_t LOOP_DELAY_MS = 10;       // Loop pacing while awake
+    static constexpr uint32_t MIN_SLEEP_MS = 5;         // Shorter gaps are not worth the wake-up
+    static constexpr uint32_t MAX_SLEEP_MS = 100;       // Upper bound for one light sleep
+    static constexpr uint8_t MAX_WAKE_PINS = 4;
+
+    // Nominal board current per mode (3.7 V cell, speaker amp off)
+    static constexpr float ACTIVE_CURRENT_MA = 95.0f;
+    static constexpr float IDLE_CURRENT_MA = 38.0f;
+    static constexpr float LIGHT_SLEEP_CURRENT_MA = 12.0f;   // RFID reader and codec dominate
+    static constexpr float DEFAULT_CAPACITY_MAH = 2000.0f;
+
+    PowerGovernor();
+
+    // Log the wake-up cause and start accounting
+    bool begin();
+
+    // Configuration
+    bool addWakePin(uint8_t pin);                   // Light sleep GPIO wake (any level change)
+    void setDeepSleepWakePin(uint8_t pin);          // Must be an RTC GPIO (ext0)
+    void setDeepSleepTimeout(uint32_t timeoutMs);   // 0 = never deep-sleep
+    void setDeepSleepCallback(DeepSleepCallback callback) { deepSleepCallback = callback; }
+    void setBatteryCapacity(float capacityMah);
+
+    // Input was seen (button, encoder, tag) - restart the idle timers
+    void notifyActivity();
+
+    // Pick the mode for this iteration (call once per loop)
+    void update(bool busy);
+
+    // Replaces the loop's trailing delay: light-sleeps for up to sleepBudgetMs
+    // when idle, otherwise delays LOOP_DELAY_MS
+    void idleDelay(uint32_t sleepBudgetMs);
+
+    // Status
+    Mode getMode() const { return mode; }
+    static const char* getModeName(Mode m);
+    uint32_t getIdleMs() const { return millis() - lastActivityMs; }
+
+    // Average current for the given time split (pure, usable off-target)
+    static float estimateCurrentMa(uint32_t activeTimeMs, uint32_t idleTimeMs, uint32_t sleepTimeMs);
+
+    // Statistics
+    float getAverageCurrentMa() const;
+    float getEstimatedRuntimeHours() const;
+    float getBatteryCapacity() const { return batteryCapacityMah; }
+    uint32_t getLightSleepCount() const { return lightSleepCount; }
+    uint32_t getGpioWakeCount() const { return gpioWakeCount; }
+    void printStats() const;
+    const char* getLastError() const;
+
+private:
+    Mode mode;
+    uint32_t currentCpuMhz;
+    uint32_t lastActivityMs;
+    uint32_t lastAccountMs;
+    uint32_t deepSleepTimeoutMs;
+    DeepSleepCallback deepSleepCallback;
+    float batteryCapacityMah;
+
+    uint8_t wakePins[MAX_WAKE_PINS];
+    uint8_t wakePinCount;
+    int8_t deepSleepWakePin;
+
+    // Time per mode
+    uint32_t activeMs;
+    uint32_t idleMs;
+    uint32_t sleepMs;
+
+    // Statistics
+    uint32_t lightSleepCount;
+    uint32_t gpioWakeCount;
+
+    // Helpers
+    void setCpuMhz(uint32_t mhz);
+    void accountTime(uint32_t now);
+    uint32_t lightSleep(uint32_t durationMs);
+    void enterDeepSleep();
+
+    // Error handling
+    void setLastError(const char* error) const;
+    mutable char lastError[128];
+};
+
+#endif // POWER_GOVERNOR_H
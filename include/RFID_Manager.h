@@ -4,6 +4,7 @@
 #include <Arduino.h>
 #include <SPI.h>
 #include <MFRC522.h>
+#include "TagRecord.h"
 
 // RFID MFRC522 Reset Pin
 #define MFRC522_RST_PIN  16  // RST
@@ -15,6 +16,10 @@ class Audio_Manager;
 typedef void (*AudioControlCallback)(const char* uid, bool tagPresent, bool isNewTag, bool isSameTag);
 
 class RFID_Manager {
+public:
+    // "aa:bb:..:jj" for the longest (10 byte) UID plus the terminator
+    static constexpr size_t UID_STRING_SIZE = 10 * 3;
+
 private:
     MFRC522 mfrc522;
     bool initialized;
@@ -29,7 +34,7 @@ private:
     bool tagPresent;
     byte lastDetectedUID[10]; // Store the UID of the currently present tag
     byte lastDetectedUIDSize;
-    String lastDetectedUIDString; // String representation for easy comparison
+    char lastDetectedUIDString[UID_STRING_SIZE]; // Formatted only when the tag changes
     
     // Debounce variables (based on MicroPython code)
     const int DEBOUNCE_THRESHOLD = 5; // Number of iterations to wait (from MicroPython)
@@ -37,13 +42,35 @@ private:
     unsigned long lastTagCheck;
     const int TAG_CHECK_INTERVAL_MS = 100; // Check every 100ms (from MicroPython)
     
+    // Where the tag record lives
+    static constexpr uint8_t RECORD_FIRST_PAGE = 4;      // NTAG / Ultralight user pages 4-15
+    static constexpr uint8_t RECORD_FIRST_BLOCK = 4;     // MIFARE Classic sector 1, blocks 4-6
+    static constexpr uint8_t RECORD_TRAILER_BLOCK = 7;   // Sector 1 trailer (key A = factory default)
+    
     // Audio control variables
     AudioControlCallback audioCallback;
     bool audioControlEnabled;
     
+    // Poll statistics: a steady tag costs polls but no UID formatting
+    uint32_t pollCount;
+    uint32_t uidFormatCount;
+    
+    // Folder record in the tag's user memory (read with the UID of a new tag)
+    bool tagRecordsEnabled;
+    bool tagRecordValid;
+    char tagRecordPath[TagRecord::MAX_PATH_LENGTH + 1];
+    uint32_t tagRecordReadUs;
+    
     // Helper functions
     bool compareUid(const byte* uid, const byte* candidate, byte len);
-    String uidToString(const byte* uid, byte len);
+    void rememberUid(const byte* uid, byte len);
+    static void formatUid(const byte* uid, byte len, char* out, size_t outSize);
+    void readTagRecord();
+    bool reselectTag();
+    bool beginRecordAccess(MFRC522::PICC_Type type);
+    bool readRecordBlock(MFRC522::PICC_Type type, uint8_t index, uint8_t* out);
+    bool writeRecordBlock(MFRC522::PICC_Type type, uint8_t index, const uint8_t* data);
+    static bool isClassic(MFRC522::PICC_Type type);
     
 public:
     RFID_Manager(uint8_t sclk, uint8_t miso, uint8_t mosi, uint8_t ss);
@@ -60,13 +87,32 @@ public:
     bool isTagPresent() const { return tagPresent; }
     byte* getLastDetectedUID() { return lastDetectedUID; }
     byte getLastDetectedUIDSize() const { return lastDetectedUIDSize; }
-    String getLastDetectedUIDString() const { return lastDetectedUIDString; }
+    const char* getLastDetectedUIDCStr() const { return lastDetectedUIDString; }   // No allocation
+    String getLastDetectedUIDString() const { return String(lastDetectedUIDString); }
+    uint32_t getPollCount() const { return pollCount; }
+    uint32_t getUidFormatCount() const { return uidFormatCount; }
+    
+    // Seed the last-seen tag (e.g. from a restored session) so that card is
+    // reported as re-inserted (isSameTag) instead of as a new tag
+    bool expectTag(const char* uidString);
+    
+    // Folder records on the tag (optional, setting "tagRecords"). The record of
+    // the current tag is read before the audio callback runs.
+    void setTagRecordsEnabled(bool enable) { tagRecordsEnabled = enable; }
+    bool isTagRecordsEnabled() const { return tagRecordsEnabled; }
+    bool hasTagRecord() const { return tagRecordValid; }
+    const char* getTagRecordPath() const { return tagRecordPath; }
+    uint32_t getTagRecordReadUs() const { return tagRecordReadUs; }
+    bool writeTagRecord(const char* path);   // Tag on the reader now; main loop only
     
     // Audio control
     void setAudioControlCallback(AudioControlCallback callback);
     void enableAudioControl(bool enable) { audioControlEnabled = enable; }
     bool isAudioControlEnabled() const { return audioControlEnabled; }
     
+    // Power control (the reader is re-initialized by begin() after wake)
+    void powerDown();
+    
     // Debug and status
     void printStatus();
     void printTagUID();
@@ -2,74 +2,128 @@
 #define ROTARY_MANAGER_H
 
 #include <Arduino.h>
+#include <atomic>
 // Forward declaration to avoid enum conflict
 class AiEsp32RotaryEncoder;
 
+// One point of the acceleration curve: while the encoder turns at least
+// minDetentsPerSecond, every detent moves the value by multiplier steps
+struct RotaryAccelerationStep {
+    uint16_t minDetentsPerSecond;
+    uint8_t multiplier;
+};
+
 class Rotary_Manager {
+public:
+    static constexpr uint8_t STEPS_PER_DETENT = 4;          // Quadrature transitions per click
+    static constexpr uint16_t DEFAULT_COALESCE_MS = 12;     // ~ one 512-frame audio block at 44.1 kHz
+    static constexpr size_t MAX_CURVE_STEPS = 8;
+
 private:
     // Pin definitions
     uint8_t clkPin;
     uint8_t dtPin;
     uint8_t buttonPin;
     uint8_t vccPin;
-    
-    // Encoder instance
+
+    // Encoder instance (pin setup + button only, quadrature is decoded in our ISR)
     AiEsp32RotaryEncoder* encoder;
-    
+
     // Volume control
     float currentVolume;
     float minVolume;
     float maxVolume;
     int16_t encoderValue;
     int16_t lastEncoderValue;
-    
-    // Settings
-    bool accelerationEnabled;
-    uint16_t accelerationValue;
+
+    // Boundaries
+    int16_t minEncoderValue;
+    int16_t maxEncoderValue;
+    bool circleValues;
     bool boundariesSet;
-    
+
+    // ISR -> loop hand-off (quadrature transitions, signed)
+    std::atomic<int32_t> pendingSteps;
+    std::atomic<uint32_t> isrEventCount;
+    volatile uint8_t lastPinState;
+    int32_t stepRemainder;   // Transitions not yet making a full detent
+
+    // Coalescing
+    uint16_t coalesceIntervalMs;
+    uint32_t lastApplyTime;
+    uint32_t lastDetentTime;
+
+    // Acceleration
+    bool accelerationEnabled;
+    RotaryAccelerationStep accelerationCurve[MAX_CURVE_STEPS];
+    size_t accelerationCurveSize;
+
+    // Diagnostics (updated once per second)
+    uint32_t rateWindowStart;
+    uint32_t rateWindowEvents;
+    uint32_t eventsPerSecond;
+    uint32_t callbackCount;
+    uint32_t callbacksPerSecond;
+    uint32_t rateWindowCallbacks;
+
     // Callback function for volume changes
     void (*volumeChangeCallback)(float volume);
 
+    // Helpers
+    uint8_t multiplierFor(uint32_t detentsPerSecond) const;
+    void applyEncoderValue(int32_t value);
+    void updateRates(uint32_t now);
+
 public:
     // Constructor
     Rotary_Manager(uint8_t clk_pin, uint8_t dt_pin, uint8_t button_pin, uint8_t vcc_pin = -1);
-    
+
     // Destructor
     ~Rotary_Manager();
-    
+
     // Initialization
     bool begin();
     void setup();
-    
+
     // Volume control
     void setVolume(float volume);
     float getVolume() const;
     void setVolumeRange(float min_vol, float max_vol);
-    
+
     // Encoder configuration
-    void setAcceleration(uint16_t acceleration);
+    void setAccelerationCurve(const RotaryAccelerationStep* curve, size_t count);
     void enableAcceleration();
     void disableAcceleration();
     void setConservativeMode(bool enabled); // Disable acceleration for precise control
-    uint16_t getAcceleration() const { return accelerationValue; }
     bool isAccelerationEnabled() const { return accelerationEnabled; }
     void setBoundaries(int16_t min_val, int16_t max_val, bool circle = false);
-    
+
+    // At most one volume callback is issued per interval; detents turned in
+    // between are summed. Match this to the audio block period.
+    void setCoalesceInterval(uint16_t intervalMs);
+    uint16_t getCoalesceInterval() const { return coalesceIntervalMs; }
+
     // Update function (call in main loop)
     void update();
-    
+
     // Volume change callback
     void setVolumeChangeCallback(void (*callback)(float volume));
-    
+
     // Utility functions
     int16_t getEncoderValue() const;
     bool isButtonClicked() const;
     void reset();
-    
+
+    // Diagnostics
+    uint32_t getEventsPerSecond() const { return eventsPerSecond; }      // Raw ISR transitions
+    uint32_t getCallbacksPerSecond() const { return callbacksPerSecond; }
+    uint32_t getTotalEvents() const { return isrEventCount.load(std::memory_order_relaxed); }
+    uint32_t getCallbackCount() const { return callbackCount; }
+    void printStats() const;
+
     // ISR function (must be static for interrupt)
     static void IRAM_ATTR readEncoderISR();
-    
+
     // Static instance for ISR access
     static Rotary_Manager* instance;
 };
@@ -0,0 +1,59 @@
+#ifndef SEEKABLE_AUDIO_SOURCE_SDMMC_H
+#define SEEKABLE_AUDIO_SOURCE_SDMMC_H
+
+#include <Arduino.h>
+#include <AudioTools.h>
+#include "AudioTools/Disk/AudioSourceSDMMC.h"
+#include "SD_MMC.h"
+
+// AudioSourceSDMMC that remembers the File it handed to the AudioPlayer so the
+// read position of the current track can be queried and moved (in-track seek).
+// Every stream the base class opens comes back through one of the three
+// overrides below, so the tracked pointer always refers to the live file.
+class SeekableAudioSourceSDMMC : public AudioSourceSDMMC {
+public:
+    SeekableAudioSourceSDMMC(const char* startFilePath, const char* ext)
+        : AudioSourceSDMMC(startFilePath, ext), current(nullptr) {}
+
+    Stream* nextStream(int offset) override {
+        return track(AudioSourceSDMMC::nextStream(offset));
+    }
+
+    Stream* selectStream(int index) override {
+        return track(AudioSourceSDMMC::selectStream(index));
+    }
+
+    Stream* selectStream(const char* path) override {
+        return track(AudioSourceSDMMC::selectStream(path));
+    }
+
+    // Point the source at another folder without rebuilding it. The path is
+    // kept by pointer (as the base class does), so it must outlive the source.
+    // The player re-indexes the folder on its next begin().
+    void retarget(const char* startFilePath) {
+        setPath(startFilePath);
+        current = nullptr;
+    }
+
+    // Currently open track (nullptr or closed file when nothing is selected)
+    fs::File* currentFile() {
+        return (current && *current) ? current : nullptr;
+    }
+
+    // Full path of the current track, empty string if none
+    const char* currentPath() {
+        fs::File* f = currentFile();
+        return f ? f->path() : "";
+    }
+
+private:
+    Stream* track(Stream* stream) {
+        // AudioSourceSDMMC always returns its own File member
+        current = static_cast<fs::File*>(stream);
+        return stream;
+    }
+
+    fs::File* current;
+};
+
+#endif // SEEKABLE_AUDIO_SOURCE_SDMMC_H
@@ -0,0 +1,75 @@
+#ifndef SESSION_STORE_H
+#define SESSION_STORE_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+
+// ============================================================================
+// SESSION STORE
+// ============================================================================
+// Persists the "last session" (tag, folder, track, position, volume) in
+// NVS so playback can resume before the rest of the system has finished
+// booting. The record is a single fixed-size blob, and writes that would not
+// change it are skipped, so saving on every pause/stop is cheap.
+// ============================================================================
+
+struct SessionRecord {
+    char uid[32];            // RFID UID as reported by RFID_Manager ("aa:bb:cc:dd")
+    char folder[128];        // Audio folder the tag maps to
+    int32_t trackIndex;      // Index of the track within the folder
+    uint32_t byteOffset;     // Read position within the track
+    float volume;            // Volume at the time of saving (0.0-1.0)
+    uint32_t positionMs;     // byteOffset as a time, 0 if the track was not indexed
+    uint32_t durationMs;     // Length of the track, 0 if not indexed
+};
+
+class SessionStore {
+public:
+    static constexpr const char* kNamespace = "session";
+    static constexpr const char* kRecordKey = "last";
+    static constexpr uint8_t kRecordVersion = 2;
+
+    SessionStore();
+
+    // Open the NVS namespace and load the stored record (if any)
+    bool begin();
+    bool isInitialized() const { return initialized; }
+
+    // Stored record
+    bool hasSession() const { return valid; }
+    const SessionRecord& getSession() const { return record; }
+
+    // Save a new record (no flash write if nothing changed)
+    bool save(const SessionRecord& session);
+
+    // Forget the stored session
+    bool clear();
+
+    // Statistics
+    uint32_t getWriteCount() const { return writeCount; }
+    uint32_t getSkippedWriteCount() const { return skippedWriteCount; }
+
+    // Debug
+    void printSession() const;
+    const char* getLastError() const;
+
+private:
+    // On-flash layout: version byte in front of the record
+    struct StoredRecord {
+        uint8_t version;
+        SessionRecord session;
+    };
+
+    Preferences prefs;
+    SessionRecord record;
+    bool initialized;
+    bool valid;
+    uint32_t writeCount;
+    uint32_t skippedWriteCount;
+
+    // Error handling
+    void setLastError(const char* error) const;
+    mutable char lastError[128];
+};
+
+#endif // SESSION_STORE_H
@@ -0,0 +1,134 @@
+#ifndef SETTINGS_SCHEMA_H
+#define SETTINGS_SCHEMA_H
+
+#include <Arduino.h>
+#include <stddef.h>
+
+class JsonStreamWriter;
+
+// ============================================================================
+// SETTINGS SCHEMA
+// ============================================================================
+// One constexpr descriptor per persisted field of Settings (JSON name, offset,
+// type, bounds, default, dirty bit). Defaults, clamping, validation, change
+// detection and the JSON reader/writer all walk this table, so a new setting
+// is a struct member plus one table row.
+//
+// The reader is a small in-place parser for a flat JSON object: no heap, no
+// document, unknown keys are skipped. The writer streams through
+// JsonStreamWriter. settingsJsonCapacity() is the compile-time upper bound of
+// the written JSON, used to size buffers and request limits.
+// ============================================================================
+
+// Settings structure to hold all configuration values
+struct Settings {
+    // Audio settings
+    float defaultVolume;
+    float maxVolume;
+
+    // WiFi settings
+    char wifiSSID[32];
+    char wifiPassword[64];
+
+    // Power management
+    int sleepTimeout;           // minutes
+    int batteryCheckInterval;   // minutes
+    
+    // RFID
+    int tagRecords;             // 1 = read/write folder records on tags
+
+    // Constructor with the defaults from SettingsSchema::fields
+    Settings();
+};
+
+// Dirty bits, one per persisted field
+enum SettingsField : uint8_t {
+    SETTING_DEFAULT_VOLUME   = 1 << 0,
+    SETTING_MAX_VOLUME       = 1 << 1,
+    SETTING_WIFI_SSID        = 1 << 2,
+    SETTING_WIFI_PASSWORD    = 1 << 3,
+    SETTING_SLEEP_TIMEOUT    = 1 << 4,
+    SETTING_BATTERY_INTERVAL = 1 << 5,
+    SETTING_TAG_RECORDS      = 1 << 6
+};
+
+enum class SettingType : uint8_t {
+    FLOAT,
+    INT,
+    STRING      // char array, size includes the terminator
+};
+
+struct SettingDescriptor {
+    const char* name;       // JSON key
+    uint16_t offset;        // offsetof(Settings, member)
+    uint16_t size;          // sizeof(member)
+    SettingType type;
+    uint8_t dirtyBit;       // SettingsField
+    float minValue;         // Numeric bounds (unused for strings)
+    float maxValue;
+    float defaultValue;     // Strings default to ""
+};
+
+struct SettingsSchema {
+    static constexpr SettingDescriptor fields[] = {
+        { "defaultVolume", offsetof(Settings, defaultVolume), sizeof(float), SettingType::FLOAT,
+          SETTING_DEFAULT_VOLUME, 0.0f, 1.0f, 0.2f },
+        { "maxVolume", offsetof(Settings, maxVolume), sizeof(float), SettingType::FLOAT,
+          SETTING_MAX_VOLUME, 0.0f, 1.0f, 1.0f },
+        { "wifiSSID", offsetof(Settings, wifiSSID), sizeof(Settings::wifiSSID), SettingType::STRING,
+          SETTING_WIFI_SSID, 0.0f, 0.0f, 0.0f },
+        { "wifiPassword", offsetof(Settings, wifiPassword), sizeof(Settings::wifiPassword), SettingType::STRING,
+          SETTING_WIFI_PASSWORD, 0.0f, 0.0f, 0.0f },
+        { "sleepTimeout", offsetof(Settings, sleepTimeout), sizeof(int), SettingType::INT,
+          SETTING_SLEEP_TIMEOUT, 0.0f, 1440.0f, 15.0f },           // 0 = never, up to 24 hours
+        { "batteryCheckInterval", offsetof(Settings, batteryCheckInterval), sizeof(int), SettingType::INT,
+          SETTING_BATTERY_INTERVAL, 1.0f, 60.0f, 1.0f },          // 1 min to 1 hour
+        { "tagRecords", offsetof(Settings, tagRecords), sizeof(int), SettingType::INT,
+          SETTING_TAG_RECORDS, 0.0f, 1.0f, 0.0f },                 // Off by default
+    };
+    static constexpr size_t FIELD_COUNT = sizeof(fields) / sizeof(fields[0]);
+    static constexpr uint8_t FLOAT_DECIMALS = 2;
+    static constexpr size_t MAX_KEY_LENGTH = 32;
+
+    // Table driven operations
+    static void applyDefaults(Settings& settings);
+    static void clamp(Settings& settings);                 // Bounds, then defaultVolume <= maxVolume
+    static bool validate(const Settings& settings, const char** failedField = nullptr);
+    static uint8_t diff(const Settings& a, const Settings& b);   // Dirty bits of the fields that differ
+    static const SettingDescriptor* find(const char* name);
+
+    // Add every field to the open object of json
+    static void write(JsonStreamWriter& json, const Settings& settings);
+
+    // Apply the fields of the JSON object in text (NUL-terminated) to
+    // settings. Returns false on malformed JSON. A field with the wrong type
+    // is left unchanged and reported through rejected; fieldsSet receives the
+    // dirty bits of the fields that were applied. No bounds are enforced here.
+    static bool parse(const char* text, Settings& settings, uint8_t* fieldsSet = nullptr,
+                      const char** rejected = nullptr);
+};
+
+// ----------------------------------------------------------------------------
+// Compile-time size of the JSON written by SettingsSchema::write() in pretty
+// mode, with every string at full length and every character \uXXXX escaped.
+// ----------------------------------------------------------------------------
+
+constexpr size_t settingsKeyLength(const char* key) {
+    return *key ? 1 + settingsKeyLength(key + 1) : 0;
+}
+
+constexpr size_t settingsValueCapacity(const SettingDescriptor& field) {
+    return field.type == SettingType::STRING ? 2 + 6 * (field.size - 1)   // Quotes + escapes
+         : field.type == SettingType::FLOAT ? 24
+         : 11;                                                            // -2147483648
+}
+
+constexpr size_t settingsJsonCapacity(size_t index = 0) {
+    // Per line: indent, quoted key, ": ", value, ",\n"; plus "{\n" and "}\n"
+    return index < SettingsSchema::FIELD_COUNT
+        ? 2 + settingsKeyLength(SettingsSchema::fields[index].name) + 2 + 2 +
+          settingsValueCapacity(SettingsSchema::fields[index]) + 2 + settingsJsonCapacity(index + 1)
+        : 4;
+}
+
+#endif // SETTINGS_SCHEMA_H
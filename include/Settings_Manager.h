@@ -2,35 +2,18 @@
 #define SETTINGS_MANAGER_H
 
 #include <Arduino.h>
-#include <ArduinoJson.h>
-
-// Settings structure to hold all configuration values
-struct Settings {
-    // Audio settings
-    float defaultVolume;
-    float maxVolume;
-    
-    // WiFi settings
-    char wifiSSID[32];
-    char wifiPassword[64];
-    
-    // Power management
-    int sleepTimeout;           // minutes
-    int batteryCheckInterval;   // minutes
-    
-    // Constructor with default values
-    Settings() : 
-        defaultVolume(0.2f),
-        maxVolume(1.0f),
-        sleepTimeout(15),
-        batteryCheckInterval(1) {
-        // Initialize string arrays
-        strcpy(wifiSSID, "");
-        strcpy(wifiPassword, "");
-    }
-};
+#include <Preferences.h>
+#include "SettingsSchema.h"
 
 class Settings_Manager {
+public:
+    static constexpr uint32_t FLUSH_DELAY_MS = 2000;   // Quiet time before a deferred write
+    
+    // NVS mirror of the settings (the SD JSON stays the source of truth)
+    static constexpr const char* kMirrorNamespace = "settings";
+    static constexpr const char* kMirrorKey = "mirror";
+    static constexpr uint8_t kMirrorVersion = 2;   // Bump when Settings changes layout
+
 private:
     // Settings file path
     const char* settingsFilePath;
@@ -45,26 +28,58 @@ private:
     bool settingsLoaded;
     bool fileExists;
     
-    // Default settings values
-    static constexpr float DEFAULT_VOLUME = 0.2f;
-    static constexpr float DEFAULT_MAX_VOLUME = 1.0f;
-    static constexpr int DEFAULT_SLEEP_TIMEOUT = 15;
-    static constexpr int DEFAULT_BATTERY_INTERVAL = 1;
+    // Deferred writes: setters only mark fields, update() writes once the
+    // changes have settled. contentHash is the FNV-1a of the file as last
+    // read or written, so unchanged content is never rewritten.
+    uint8_t dirtyFields;
+    uint32_t lastChangeMs;
+    uint32_t contentHash;
+    
+    // NVS mirror: the settings plus the size, mtime and hash of the JSON they
+    // came from. Read in setup() before the SD card is mounted; begin() only
+    // parses the JSON again when the file no longer matches.
+    struct MirrorRecord {
+        uint8_t version;
+        uint32_t jsonHash;
+        uint32_t jsonSize;
+        uint32_t jsonMtime;
+        Settings settings;
+    };
+    Preferences prefs;
+    bool mirrorOpen;
+    bool mirrorLoaded;
+    MirrorRecord mirror;
+    uint32_t mirrorLoadUs;    // loadMirror() duration
+    uint32_t fileLoadUs;      // begin() duration (SD check and, if needed, JSON parse)
+    
+    // Largest settings file read (defaults and bounds live in SettingsSchema)
     static constexpr size_t MAX_JSON_SIZE = 1024;
+    static_assert(settingsJsonCapacity() <= MAX_JSON_SIZE, "MAX_JSON_SIZE must fit the largest settings file");
 
 public:
     // Constructor
     Settings_Manager(const char* file_path = "/settings.json");
     
-    // Initialize settings manager
+    // Read the NVS mirror - call before begin(), needs no SD card
+    bool loadMirror();
+    bool isMirrorLoaded() const { return mirrorLoaded; }
+    
+    // Initialize settings manager (reconciles the mirror with the SD file)
     bool begin(void* fs = nullptr);
     
     // Load settings from file
     bool loadSettings();
     
-    // Save settings to file
+    // Save settings to file now (skipped when the content is unchanged)
     bool saveSettings();
     
+    // Deferred saving - call update() from the main loop. flushNow writes
+    // pending changes without waiting (e.g. battery nearly empty).
+    void update(bool flushNow = false);
+    bool flush();
+    bool isDirty() const { return dirtyFields != 0; }
+    uint8_t getDirtyFields() const { return dirtyFields; }
+    
     // Create default settings file
     bool createDefaultSettings();
     
@@ -76,6 +91,7 @@ public:
     const char* getWifiPassword() const { return currentSettings.wifiPassword; }
     int getSleepTimeout() const { return currentSettings.sleepTimeout; }
     int getBatteryCheckInterval() const { return currentSettings.batteryCheckInterval; }
+    bool getTagRecords() const { return currentSettings.tagRecords != 0; }
     
     // Set settings
     void setDefaultVolume(float volume);
@@ -84,6 +100,7 @@ public:
     void setWifiPassword(const char* password);
     void setSleepTimeout(int minutes);
     void setBatteryCheckInterval(int minutes);
+    void setTagRecords(bool enable);
     
     // Update all settings at once
     void updateSettings(const Settings& newSettings);
@@ -92,6 +109,8 @@ public:
     bool validateSettings() const;
     bool isSettingsLoaded() const { return settingsLoaded; }
     bool doesFileExist() const { return fileExists; }
+    uint32_t getMirrorLoadTimeUs() const { return mirrorLoadUs; }
+    uint32_t getFileLoadTimeUs() const { return fileLoadUs; }
     
     // Utility functions
     void printSettings() const;
@@ -107,8 +126,13 @@ public:
 private:
     // Internal helper functions
     bool parseJsonDocument(const char* jsonString);
-    bool serializeToJson(char* buffer, size_t bufferSize) const;
-    bool validateJsonStructure(JsonDocument& doc) const;
+    size_t writeJson(Print& out) const;
+    void markDirty(uint8_t fields);
+    void applySettings(Settings next);   // Clamp through SettingsSchema, mark what changed
+    bool openMirror();
+    bool writeMirror();
+    bool readFileStamp(uint32_t& size, uint32_t& mtime) const;
+    bool fileMatchesMirror();
     void setLastError(const char* error) const; // Make const-correct
     
     // Error tracking
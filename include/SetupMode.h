@@ -5,6 +5,7 @@
 #include <vector>
 #include "MappingStore.h"
 #include "SdScanner.h"
+#include "FolderCatalog.h"
 #include "RFID_Manager.h"
 #include "Button_Manager.h"
 
@@ -17,6 +18,8 @@ enum class SetupState {
     READ_UID,
     CONFIRM_OVERWRITE,
     WAIT_FOR_CARD_REMOVAL,
+    AUTO_ASSIGN,          // Auto-assign: pair folders with cards as they are tapped
+    AUTO_COMMIT,          // Auto-assign: write the session in one batch
     RFID_SETUP_SUMMARY
 };
 
@@ -42,12 +45,20 @@ private:
     Button_Manager* buttonManager;
     
     // Setup data
+    FolderCatalog catalog;               // Scan kept across setup sessions
     std::vector<String> unassignedPaths;
     size_t currentPathIndex;
     String currentFolder;
     String currentUid;
     String contentRoot;  // Configurable content root
     
+    // Auto-assign session: pairs held in memory until the session ends
+    bool autoAssign;
+    std::vector<BatchItem> autoItems;
+    std::vector<size_t> autoFolderIndexes;           // unassignedPaths index of each pair
+    char autoLastUid[RFID_Manager::UID_STRING_SIZE];   // Card last accepted (still on the reader)
+    int autoIgnoredCount;                             // Taps of already mapped/paired cards
+    
     // Assignment tracking
     int assignedCount;
     int skippedCount;
@@ -73,16 +84,19 @@ private:
     void stepReadUid();
     void stepConfirmOverwrite();
     void stepWaitForCardRemoval();
+    void stepAutoAssign();
+    void stepAutoCommit();
     void stepSummary();
     
     // Helper methods
     void handleUid(const String& uid);
+    void handleAutoUid(const char* uid);
     void handleButtonAction(SetupButtonAction action);
+    void handleAutoButtonAction(SetupButtonAction action);
     SetupButtonAction getButtonAction();
     bool waitForRfid(String& uid, unsigned long timeout);
     void showPrompt(const String& message);
     void showStatus(const String& message);
-    void computeUnassignedPaths();
     
 public:
     SetupMode();
@@ -93,9 +107,11 @@ public:
     
     // Main control
     void enter();
+    void enterAutoAssign();   // Tap cards in a row: Play=save, Back=undo, Next=skip, long-press=discard
     void exit();
     void loop();  // call while in setup mode
     bool isSetupActive() const { return isActive; }
+    bool isAutoAssign() const { return autoAssign; }
     
     // State queries
     SetupState getCurrentState() const { return currentState; }
@@ -0,0 +1,40 @@
+#ifndef TAG_RECORD_H
+#define TAG_RECORD_H
+
+#include <Arduino.h>
+
+// ============================================================================
+// TAG RECORD
+// ============================================================================
+// Compact folder record kept in a tag's user memory, so a card plays its
+// folder without a MappingStore lookup and keeps working on another player.
+//
+// Layout (48 bytes = 3 MIFARE Classic blocks of sector 1, or NTAG pages 4-15):
+//   'R' 'G' version length | path (length bytes) | FNV-1a of everything before
+// Unused bytes after the checksum are zero. Paths longer than MAX_PATH_LENGTH
+// are not stored; such cards keep using the mapping file.
+// ============================================================================
+
+class TagRecord {
+public:
+    static constexpr uint8_t kMagic0 = 'R';
+    static constexpr uint8_t kMagic1 = 'G';
+    static constexpr uint8_t kVersion = 1;
+
+    static constexpr size_t BLOCK_SIZE = 16;                // One MIFARE read
+    static constexpr size_t RECORD_SIZE = 3 * BLOCK_SIZE;
+    static constexpr size_t HEADER_SIZE = 4;
+    static constexpr size_t CHECK_SIZE = 4;
+    static constexpr size_t MAX_PATH_LENGTH = RECORD_SIZE - HEADER_SIZE - CHECK_SIZE;
+
+    // Build the record for path into out (RECORD_SIZE bytes)
+    static bool encode(const char* path, uint8_t* out);
+
+    // Bytes needed to decode, judged from the first block (0 = no record)
+    static size_t usedSize(const uint8_t* firstBlock);
+
+    // Check the record and copy its path into path (pathSize incl. terminator)
+    static bool decode(const uint8_t* data, size_t length, char* path, size_t pathSize);
+};
+
+#endif // TAG_RECORD_H
@@ -2,63 +2,127 @@
 #define WEB_SETUP_SERVER_H
 
 #include <Arduino.h>
-#include <WebServer.h>
+#include <ESPAsyncWebServer.h>
 #include <WiFi.h>
 #include <vector>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "MappingStore.h"
 #include "SdScanner.h"
+#include "FolderCatalog.h"
 #include "RFID_Manager.h"
+#include "SettingsSchema.h"
 
 class Settings_Manager;
 class Battery_Manager;
+class PowerGovernor;
+struct WebAsset;
+
+// ============================================================================
+// WEB SETUP SERVER
+// ============================================================================
+// Setup portal on an open soft AP. Requests are served by ESPAsyncWebServer
+// from the AsyncTCP task, so several browsers can be connected and the main
+// loop (playback, buttons, RFID) keeps running while setup is open.
+//
+// Threading: handlers run in the AsyncTCP task, start()/stop()/loop() in the
+// main loop. Everything the two share (folder list, selection, tag snapshot,
+// mapping store writes) is guarded by stateLock. RFID is only polled by the
+// main loop, which publishes the current tag to the handlers in loop().
+// Settings posted to /api/settings are applied by loop(); the main loop's
+// Settings_Manager::update() writes them to the SD card.
+// ============================================================================
 
 class WebSetupServer {
 public:
+    static constexpr size_t MAX_BODY_SIZE = 1024;       // Largest accepted POST body
+    static constexpr size_t MAX_BATCH_BODY_SIZE = 12288; // /api/assign/batch (~100 cards)
+    static constexpr size_t MAX_BATCH_ITEMS = 128;
+    static constexpr uint32_t STOP_DELAY_MS = 150;      // Let the /done response go out first
+    static constexpr uint32_t LOCK_TIMEOUT_MS = 1000;
+    static constexpr uint8_t MAX_LOCK_RETRIES = 5;      // /folders chunks asked again while the lock is busy
+
+    static_assert(settingsJsonCapacity() <= MAX_BODY_SIZE, "MAX_BODY_SIZE must fit a full /api/settings body");
+
     WebSetupServer();
 
-    bool begin(MappingStore* store, SdScanner* scanner, RFID_Manager* rfid, const String& contentRoot = "/", Settings_Manager* settings = nullptr, Battery_Manager* battery = nullptr);
+    bool begin(MappingStore* store, SdScanner* scanner, RFID_Manager* rfid, const String& contentRoot = "/", Settings_Manager* settings = nullptr, Battery_Manager* battery = nullptr, PowerGovernor* power = nullptr);
     bool start();
     void stop();
-    void loop();
+    void loop();    // Call every main loop iteration (after RFID polling)
 
     bool isActive() const { return active; }
 
 private:
-    WebServer server;
-    bool active;
+    class FolderListSource;   // Chunk source for /folders
+
+    AsyncWebServer server;
+    AsyncEventSource events;  // /events - pushes the tag while waiting for a card
+    SemaphoreHandle_t stateLock;
+    bool routesRegistered;
+    volatile bool active;
+
+    // Shared with the handlers (stateLock)
     bool waitingForTag;
+    bool tagEventSent;
     String selectedFolder;
     String lastUid;
-    String contentRoot;
+    bool tagPresent;          // RFID snapshot published by loop()
+    char tagUid[32];
+    FolderCatalog catalog;    // Scanned once per start(), merged with the store on change
 
+    // Folder record for the card on the reader, queued by the assign
+    // handlers and written to the tag by loop()
+    volatile bool recordPending;
+    char pendingRecordUid[RFID_Manager::UID_STRING_SIZE];
+    String pendingRecordPath;
+
+    // Settings accepted by /api/settings, applied by loop()
+    volatile bool settingsPending;
+    Settings pendingSettings;
+
+    // Set by /done, acted on by loop()
+    volatile bool stopRequested;
+    uint32_t stopRequestedMs;
+
+    String contentRoot;
     MappingStore* mappingStore;
     SdScanner* sdScanner;
     RFID_Manager* rfidManager;
     Settings_Manager* settingsManager;
     Battery_Manager* batteryManager;
+    PowerGovernor* powerGovernor;
 
-    std::vector<String> unassignedFolders;
+    // Bytes not sent thanks to gzip and 304 responses
+    uint32_t assetBytesSaved;
 
     // Internal helpers
+    bool lock();
+    void unlock();
     void registerRoutes();
-    void sendJson(int statusCode, const String& body);
-    void handleRoot();
-    void handleSettingsPage();
-    void handleFolders();
-    void handleSelect();
-    void handleTag();
-    void handleAssign();
-    void handleReassign();
-    void handleDone();
-    void handleBattery();
-    void handleSettingsJson();
-    void handleSettingsSave();
-
-    void refreshFolders();
+    void publishTag();
+    void queueTagRecord(const String& uid, const String& folder);
+    void writePendingRecord();
+    void applyPendingSettings();
+    void sendJson(AsyncWebServerRequest* request, int statusCode, const char* body);
+    void sendStatus(AsyncWebServerRequest* request, int statusCode, const char* status, const char* key, const String& value);
+    void handleAsset(AsyncWebServerRequest* request, const WebAsset& asset);
+    void handleFolders(AsyncWebServerRequest* request);
+    void handleSelect(AsyncWebServerRequest* request);
+    void handleTag(AsyncWebServerRequest* request);
+    void handleAssign(AsyncWebServerRequest* request);
+    void handleReassign(AsyncWebServerRequest* request);
+    void handleAssignBatch(AsyncWebServerRequest* request);
+    void handleDone(AsyncWebServerRequest* request);
+    void handleBattery(AsyncWebServerRequest* request);
+    void handleSettingsJson(AsyncWebServerRequest* request);
+    void handleSettingsSave(AsyncWebServerRequest* request);
+    static void collectBody(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total, size_t limit);
+
+    void refreshFolders(bool rescan);
     bool normalizeUid(String& uid) const;
     bool appendMapping(const String& uid, const String& folder);
     bool reassignMapping(const String& uid, const String& folder, String& previous);
 };
 
 #endif // WEB_SETUP_SERVER_H
-
@@ -0,0 +1,123 @@
+"""
+Embed the setup portal assets (web/*.html, *.js, *.css) as gzipped PROGMEM
+byte arrays in include/WebAssets.h.
+
+Runs as a PlatformIO pre-build script (extra_scripts = pre:...) and can also
+be run by hand:  python scripts/embed_web_assets.py
+
+Each asset gets a strong ETag (SHA-256 of the uncompressed file) so the server
+can answer 304 Not Modified. The header is only rewritten when its content
+changes, so unchanged assets do not trigger a rebuild.
+"""
+
+import gzip
+import hashlib
+import os
+import re
+
+CONTENT_TYPES = {
+    ".html": "text/html",
+    ".js": "application/javascript",
+    ".css": "text/css",
+}
+
+# Files served at a different URL than /<name>
+ROUTES = {
+    "index.html": "/",
+    "settings.html": "/settings",
+}
+
+
+def project_dir():
+    try:
+        Import("env")  # noqa: F821 - provided by PlatformIO/SCons
+        return env.subst("$PROJECT_DIR")  # noqa: F821
+    except NameError:
+        return os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+def symbol_for(name):
+    return "kWebAsset_" + re.sub(r"[^0-9A-Za-z]", "_", name)
+
+
+def format_bytes(data):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append("    " + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+    return "\n".join(lines)
+
+
+def build_header(web_dir):
+    names = sorted(n for n in os.listdir(web_dir)
+                   if os.path.splitext(n)[1] in CONTENT_TYPES)
+
+    out = [
+        "// Generated by scripts/embed_web_assets.py from web/ - do not edit.",
+        "#ifndef WEB_ASSETS_H",
+        "#define WEB_ASSETS_H",
+        "",
+        "#include <Arduino.h>",
+        "",
+        "struct WebAsset {",
+        "    const char* path;          // URL",
+        "    const char* contentType;",
+        "    const char* etag;          // Quoted strong ETag",
+        "    const uint8_t* data;       // gzip",
+        "    size_t length;",
+        "    size_t rawLength;          // Uncompressed size",
+        "};",
+        "",
+    ]
+
+    table = []
+    report = []
+    for name in names:
+        with open(os.path.join(web_dir, name), "rb") as f:
+            raw = f.read()
+        # mtime=0 keeps the output identical for identical input
+        packed = gzip.compress(raw, compresslevel=9, mtime=0)
+        etag = hashlib.sha256(raw).hexdigest()[:16]
+        symbol = symbol_for(name)
+
+        out.append("static const uint8_t %s[] PROGMEM = {" % symbol)
+        out.append(format_bytes(packed))
+        out.append("};")
+        out.append("")
+
+        path = ROUTES.get(name, "/" + name)
+        content_type = CONTENT_TYPES[os.path.splitext(name)[1]]
+        table.append('    { "%s", "%s", "\\"%s\\"", %s, sizeof(%s), %d },'
+                     % (path, content_type, etag, symbol, symbol, len(raw)))
+        report.append((name, len(raw), len(packed)))
+
+    out.append("static const WebAsset kWebAssets[] = {")
+    out.extend(table)
+    out.append("};")
+    out.append("static const size_t kWebAssetCount = sizeof(kWebAssets) / sizeof(kWebAssets[0]);")
+    out.append("")
+    out.append("#endif // WEB_ASSETS_H")
+    out.append("")
+    return "\n".join(out), report
+
+
+def main():
+    root = project_dir()
+    web_dir = os.path.join(root, "web")
+    header_path = os.path.join(root, "include", "WebAssets.h")
+
+    header, report = build_header(web_dir)
+
+    old = None
+    if os.path.exists(header_path):
+        with open(header_path, "r") as f:
+            old = f.read()
+    if old != header:
+        with open(header_path, "w") as f:
+            f.write(header)
+
+    for name, raw, packed in report:
+        print("[web-assets] %-16s %6d -> %5d bytes gzip (saves %d per load)"
+              % (name, raw, packed, raw - packed))
+
+
+main()
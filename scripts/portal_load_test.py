@@ -0,0 +1,104 @@
+"""
+Load test for the setup portal.
+
+Connect the computer to the device's "setup" access point (setup mode on the
+player), then run:
+
+    python scripts/portal_load_test.py --clients 4 --requests 25
+
+Each client thread requests the portal page, the folder list and the battery
+history in turn, like a browser reloading the page. Reports latency
+percentiles, throughput and errors per path. Run it while a card is playing to
+check that playback does not stutter while the portal is busy.
+
+Without a device, sim/scenarios/portal_concurrent.scn keeps several of these
+requests in flight at once in the simulator.
+"""
+
+import argparse
+import statistics
+import threading
+import time
+import urllib.error
+import urllib.request
+
+PATHS = ["/", "/folders", "/api/battery"]
+
+
+def percentile(values, fraction):
+    if not values:
+        return 0.0
+    ordered = sorted(values)
+    index = min(len(ordered) - 1, int(round(fraction * (len(ordered) - 1))))
+    return ordered[index]
+
+
+def run_client(base_url, count, timeout, results, lock):
+    for _ in range(count):
+        for path in PATHS:
+            start = time.perf_counter()
+            error = None
+            size = 0
+            try:
+                request = urllib.request.Request(base_url + path,
+                                                 headers={"Accept-Encoding": "gzip"})
+                with urllib.request.urlopen(request, timeout=timeout) as response:
+                    size = len(response.read())
+            except (urllib.error.URLError, OSError) as exc:
+                error = str(exc)
+            elapsed_ms = (time.perf_counter() - start) * 1000.0
+
+            with lock:
+                entry = results.setdefault(path, {"ms": [], "bytes": 0, "errors": []})
+                if error:
+                    entry["errors"].append(error)
+                else:
+                    entry["ms"].append(elapsed_ms)
+                    entry["bytes"] += size
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--host", default="192.168.4.1", help="device address (default: soft AP)")
+    parser.add_argument("--clients", type=int, default=4, help="concurrent clients")
+    parser.add_argument("--requests", type=int, default=25, help="page loads per client")
+    parser.add_argument("--timeout", type=float, default=10.0, help="per request timeout (s)")
+    args = parser.parse_args()
+
+    base_url = "http://" + args.host
+    results = {}
+    lock = threading.Lock()
+    threads = [threading.Thread(target=run_client,
+                                args=(base_url, args.requests, args.timeout, results, lock))
+               for _ in range(args.clients)]
+
+    start = time.perf_counter()
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    wall_s = time.perf_counter() - start
+
+    total_ok = 0
+    total_errors = 0
+    print("%-14s %6s %6s %8s %8s %8s %8s" % ("path", "ok", "errors", "p50 ms", "p95 ms", "max ms", "KB"))
+    for path in PATHS:
+        entry = results.get(path, {"ms": [], "bytes": 0, "errors": []})
+        ms = entry["ms"]
+        total_ok += len(ms)
+        total_errors += len(entry["errors"])
+        print("%-14s %6d %6d %8.0f %8.0f %8.0f %8.1f" % (
+            path, len(ms), len(entry["errors"]),
+            statistics.median(ms) if ms else 0.0, percentile(ms, 0.95),
+            max(ms) if ms else 0.0, entry["bytes"] / 1024.0))
+        for error in sorted(set(entry["errors"]))[:3]:
+            print("    error: %s" % error)
+
+    print("\n%d clients, %d requests in %.1f s (%.1f req/s), %d errors"
+          % (args.clients, total_ok + total_errors, wall_s,
+             (total_ok + total_errors) / wall_s if wall_s > 0 else 0.0, total_errors))
+    return 1 if total_errors else 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -0,0 +1,693 @@
+#include "Scenario.h"
+#include "SimHardware.h"
+#include "TagRecord.h"
+#include <AudioTools.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+namespace stdfs = std::filesystem;
+
+namespace sim {
+
+namespace {
+
+// Board wiring (src/main.cpp)
+const uint8_t kHeadphonePin = 33;     // LOW = plugged in
+const uint8_t kButtonAdcPin = 39;
+const uint8_t kEncoderClkPin = 27;
+const uint8_t kEncoderDtPin = 34;
+const float kIdleVolts = 3.3f;
+
+// Resistor ladder voltages (Button_Manager thresholds in src/main.cpp)
+const std::map<std::string, float> kButtonVolts = {
+    { "encoder", 1.74f },
+    { "previous", 1.35f },
+    { "play", 0.80f },
+    { "next", 0.39f }
+};
+
+const uint64_t kDefaultHoldUs = 150000;
+const uint64_t kEncoderEdgeUs = 2000;      // Between quadrature edges
+const uint64_t kEncoderDetentUs = 40000;   // Between detents
+const uint64_t kTailUs = 5000000;          // Default run time after the last event
+
+// Where RFID_Manager keeps the folder record
+const int kRecordFirstPage = 4;
+const int kRecordFirstBlock = 4;
+
+// MPEG-1 Layer III, 128 kbit/s, 44.1 kHz, stereo: 417 or 418 bytes per
+// 1152-sample frame. Headers are valid so Mp3FrameIndex can walk them, the
+// payload is silence (the player fake does not decode it).
+const uint8_t kFrameHeader[4] = { 0xFF, 0xFB, 0x90, 0x00 };
+const double kFrameSeconds = 1152.0 / 44100.0;
+
+std::vector<std::string> split(const std::string& line) {
+    std::vector<std::string> words;
+    std::istringstream in(line);
+    std::string word;
+    while (in >> word) {
+        words.push_back(word);
+    }
+    return words;
+}
+
+bool parseTime(const std::string& text, uint64_t& us) {
+    char* end = nullptr;
+    const double value = strtod(text.c_str(), &end);
+    if (end == text.c_str() || value < 0) {
+        return false;
+    }
+    const std::string unit(end);
+    if (unit == "ms") {
+        us = (uint64_t)(value * 1000.0 + 0.5);
+    } else if (unit == "s") {
+        us = (uint64_t)(value * 1000000.0 + 0.5);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool parseUid(const std::string& text, SimCard& card) {
+    card.uidSize = 0;
+    for (size_t i = 0; i < text.size() && card.uidSize < sizeof(card.uid);) {
+        if (text[i] == ':') {
+            i++;
+            continue;
+        }
+        if (i + 1 >= text.size() || !isxdigit((unsigned char)text[i]) || !isxdigit((unsigned char)text[i + 1])) {
+            return false;
+        }
+        card.uid[card.uidSize++] = (uint8_t)strtoul(text.substr(i, 2).c_str(), nullptr, 16);
+        i += 2;
+    }
+    return card.uidSize == 4 || card.uidSize == 7 || card.uidSize == 10;
+}
+
+// Same form as RFID_Manager::formatUid
+std::string formatUid(const SimCard& card) {
+    std::string text;
+    char byte[4];
+    for (uint8_t i = 0; i < card.uidSize; i++) {
+        snprintf(byte, sizeof(byte), i ? ":%02x" : "%02x", card.uid[i]);
+        text += byte;
+    }
+    return text;
+}
+
+// Counters an expect line can name
+uint64_t counterValue(const std::string& name) {
+    const SimCounters& c = counters();
+    if (name == "sdOpens") return c.sdOpens;
+    if (name == "sdReads") return c.sdReadCalls;
+    if (name == "sdWrites") return c.sdWriteCalls;
+    if (name == "sdRemoves") return c.sdRemoves;
+    if (name == "sdRenames") return c.sdRenames;
+    if (name == "nvsWrites") return c.nvsWrites;
+    if (name == "i2cTransactions") return c.i2cTransactions;
+    if (name == "dacWrites") return c.dacWrites;
+    if (name == "dacBursts") return c.dacBursts;
+    if (name == "dacUnchangedWrites") return c.dacUnchangedWrites;
+    if (name == "dacPageSelects") return c.dacPageSelects;
+    if (name == "dacReads") return c.dacReads;
+    if (name == "rfidPolls") return c.rfidPolls;
+    if (name == "ledShows") return c.ledShows;
+    if (name == "speakerPops") return c.speakerPops;
+    if (name == "lightSleeps") return c.lightSleeps;
+    if (name == "httpRequests") return c.httpRequests;
+    if (name == "httpErrors") return c.httpErrors;
+    if (name == "tracksStarted") return audioStats().tracksStarted;
+    return heapAllocations();
+}
+
+const char* const kCounterNames[] = {
+    "sdOpens", "sdReads", "sdWrites", "sdRemoves", "sdRenames", "nvsWrites", "i2cTransactions",
+    "dacWrites", "dacBursts", "dacUnchangedWrites", "dacPageSelects", "dacReads", "rfidPolls", "ledShows", "speakerPops", "lightSleeps", "httpRequests", "httpErrors", "tracksStarted", "allocations"
+};
+
+bool validCounter(const std::string& name) {
+    for (const char* known : kCounterNames) {
+        if (name == known) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool compare(uint64_t value, const std::string& op, uint64_t expected) {
+    if (op == "==") return value == expected;
+    if (op == "!=") return value != expected;
+    if (op == "<") return value < expected;
+    if (op == "<=") return value <= expected;
+    if (op == ">") return value > expected;
+    return value >= expected;
+}
+
+bool validCheck(const std::vector<std::string>& args) {
+    if (args[0] == "mark") {
+        return args.size() == 1;
+    }
+    if (args.size() >= 3 && args[1] == "stopped") {
+        return true;
+    }
+    if (args.size() >= 5 && args[1] == "file" && args[2][0] == '/' && args[3] == "contains") {
+        return true;
+    }
+    if (args.size() >= 4 && args[1] == "response" && args[2] == "contains") {
+        return true;
+    }
+    static const char* const kOps[] = { "==", "!=", "<", "<=", ">", ">=" };
+    if (args.size() == 5 && args[1] == "http" && args[2] == "streaming") {
+        return std::find(std::begin(kOps), std::end(kOps), args[3]) != std::end(kOps) &&
+               isdigit((unsigned char)args[4][0]);
+    }
+    if (args.size() == 5 && args[1] == "response" && args[2] == "folders") {
+        return std::find(std::begin(kOps), std::end(kOps), args[3]) != std::end(kOps) &&
+               isdigit((unsigned char)args[4][0]);
+    }
+    return args.size() == 4 && validCounter(args[1]) &&
+           std::find(std::begin(kOps), std::end(kOps), args[2]) != std::end(kOps) &&
+           isdigit((unsigned char)args[3][0]);
+}
+
+// Decode one JSON string starting at the opening quote; pos ends after the
+// closing one. Kept apart from the firmware's parser so the check is independent.
+bool decodeJsonString(const std::string& text, size_t& pos, std::string& out) {
+    out.clear();
+    if (pos >= text.size() || text[pos] != '"') {
+        return false;
+    }
+    for (pos++; pos < text.size(); pos++) {
+        const char c = text[pos];
+        if (c == '"') {
+            pos++;
+            return true;
+        }
+        if ((unsigned char)c < 0x20) {
+            return false;
+        }
+        if (c != '\\') {
+            out += c;
+            continue;
+        }
+        if (++pos >= text.size()) {
+            return false;
+        }
+        switch (text[pos]) {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                if (pos + 4 >= text.size()) {
+                    return false;
+                }
+                const unsigned long code = strtoul(text.substr(pos + 1, 4).c_str(), nullptr, 16);
+                if (code > 0x7F) {
+                    return false;   // The writer only escapes control characters
+                }
+                out += (char)code;
+                pos += 4;
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return false;
+}
+
+// {"folders":[...]} as written by WebSetupServer; false if it does not parse
+bool decodeFolderList(const std::string& text, std::vector<std::string>& folders) {
+    static const std::string kStart = "{\"folders\":[";
+    if (text.compare(0, kStart.size(), kStart) != 0) {
+        return false;
+    }
+    size_t pos = kStart.size();
+    std::string folder;
+    while (pos < text.size() && text[pos] != ']') {
+        if (!folders.empty() && text[pos++] != ',') {
+            return false;
+        }
+        if (!decodeJsonString(text, pos, folder)) {
+            return false;
+        }
+        folders.push_back(folder);
+    }
+    return text.compare(pos, std::string::npos, "]}") == 0;
+}
+
+std::vector<CheckResult>& results() {
+    static std::vector<CheckResult> list;
+    return list;
+}
+
+// Counter values at the last mark (zero before the first one)
+std::map<std::string, uint64_t>& markedCounters() {
+    static std::map<std::string, uint64_t> marked;
+    return marked;
+}
+
+void runCheck(const ScenarioCheck& check, size_t resultIndex, const std::string& sdRoot) {
+    Untracked untracked;
+    const std::vector<std::string>& args = check.args;
+    if (args[0] == "mark") {
+        for (const char* name : kCounterNames) {
+            markedCounters()[name] = counterValue(name);
+        }
+        return;
+    }
+
+    CheckResult& result = results()[resultIndex];
+    result.reached = true;
+    if (args[1] == "file") {
+        const size_t start = check.text.find(args[4], check.text.find(" contains ") + 10);
+        const std::string text = check.text.substr(start);
+        std::ifstream in(sdRoot + args[2]);
+        std::stringstream content;
+        content << in.rdbuf();
+        result.passed = in && content.str().find(text) != std::string::npos;
+        result.actual = in ? std::to_string(content.str().size()) + " bytes" : "missing";
+        return;
+    }
+    if (args[1] == "response" && args[2] == "folders") {
+        // Parse /folders back; an entry only counts if it names a folder on the card
+        std::vector<std::string> folders;
+        if (!decodeFolderList(lastHttpBody(), folders)) {
+            result.passed = false;
+            result.actual = "does not parse";
+            return;
+        }
+        uint64_t found = 0;
+        for (const std::string& folder : folders) {
+            found += stdfs::is_directory(sdRoot + folder) ? 1 : 0;
+        }
+        result.passed = compare(found, args[3], strtoull(args[4].c_str(), nullptr, 10));
+        result.actual = std::to_string(found) + " of " + std::to_string(folders.size()) + ", " +
+                        std::to_string(lastHttpBody().size()) + " bytes";
+        return;
+    }
+    if (args[1] == "http") {
+        result.passed = compare(httpStreaming(), args[3], strtoull(args[4].c_str(), nullptr, 10));
+        result.actual = std::to_string(httpStreaming());
+        return;
+    }
+    if (args[1] == "response") {
+        const size_t start = check.text.find(args[3], check.text.find(" contains ") + 10);
+        result.passed = lastHttpBody().find(check.text.substr(start)) != std::string::npos;
+        result.actual = std::to_string(lastHttpBody().size()) + " bytes";
+        return;
+    }
+
+    const uint64_t value = counterValue(args[1]) - markedCounters()[args[1]];
+    result.passed = compare(value, args[2], strtoull(args[3].c_str(), nullptr, 10));
+    result.actual = std::to_string(value);
+}
+
+bool validEvent(const std::vector<std::string>& args) {
+    const std::string& kind = args[0];
+    if (kind == "tag") {
+        SimCard card;
+        return args.size() >= 2 && (args[1] == "off" || parseUid(args[1], card));
+    }
+    if (kind == "button") {
+        return args.size() >= 2 && kButtonVolts.count(args[1]) > 0;
+    }
+    if (kind == "encoder") {
+        return args.size() == 2 && (args[1][0] == '+' || args[1][0] == '-') && atoi(args[1].c_str() + 1) > 0;
+    }
+    if (kind == "headphones") {
+        return args.size() == 2 && (args[1] == "in" || args[1] == "out");
+    }
+    if (kind == "battery") {
+        return args.size() == 2;
+    }
+    if (kind == "http") {
+        const size_t first = args.size() > 1 && args[1] == "stream" ? 2 : 1;
+        return args.size() >= first + 2 && (args[first] == "GET" || args[first] == "POST") &&
+               args[first + 1][0] == '/';
+    }
+    if (kind == "locks") {
+        return args.size() == 3 && args[1] == "busy" && atoi(args[2].c_str()) > 0;
+    }
+    return kind == "end" && args.size() == 1;
+}
+
+// Cards keep what the firmware wrote to them while off the reader
+std::map<std::string, SimCard>& cardShelf() {
+    static std::map<std::string, SimCard> shelf;
+    return shelf;
+}
+
+SimCard& cardFor(const std::vector<std::string>& args) {
+    SimCard parsed = {};
+    parseUid(args[1], parsed);
+    const std::string key = formatUid(parsed);
+    std::map<std::string, SimCard>::iterator it = cardShelf().find(key);
+    if (it != cardShelf().end()) {
+        return it->second;
+    }
+
+    SimCard& card = cardShelf()[key];
+    card = parsed;
+    bool classic = false;
+    std::string record;
+    for (size_t i = 2; i < args.size(); i++) {
+        if (args[i] == "classic") {
+            classic = true;
+        } else if (args[i].compare(0, 7, "record=") == 0) {
+            record = args[i].substr(7);
+        }
+    }
+    card.sak = classic ? 0x08 : 0x00;
+    memcpy(card.memory, card.uid, card.uidSize);   // Manufacturer block/pages
+    if (!record.empty()) {
+        const int offset = classic ? kRecordFirstBlock * 16 : kRecordFirstPage * 4;
+        TagRecord::encode(record.c_str(), card.memory + offset);
+    }
+    return card;
+}
+
+// Take the card off the reader, keeping what the firmware wrote to it
+void takeCard() {
+    Untracked untracked;
+    const SimCard* card = cardInField();
+    if (card) {
+        cardShelf()[formatUid(*card)] = *card;
+    }
+    removeCard();
+}
+
+void pressButton(const std::vector<std::string>& args, uint64_t atUs) {
+    uint64_t holdUs = kDefaultHoldUs;
+    if (args.size() >= 3 && args[2].compare(0, 5, "hold=") == 0) {
+        holdUs = (uint64_t)atoi(args[2].c_str() + 5) * 1000;
+    }
+    const float volts = kButtonVolts.at(args[1]);
+    schedule(atUs, [volts]() { setAdcVoltage(kButtonAdcPin, volts); });
+    schedule(atUs + holdUs, []() { setAdcVoltage(kButtonAdcPin, kIdleVolts); });
+}
+
+// One detent is four edges; clockwise (+) pulls CLK low first
+void turnEncoder(int detents, uint64_t atUs) {
+    static const int kClockwise[4][2] = { { 0, 1 }, { 0, 0 }, { 1, 0 }, { 1, 1 } };
+    static const int kCounterClockwise[4][2] = { { 1, 0 }, { 0, 0 }, { 0, 1 }, { 1, 1 } };
+    const int (*edges)[2] = detents > 0 ? kClockwise : kCounterClockwise;
+    const int count = detents > 0 ? detents : -detents;
+    for (int d = 0; d < count; d++) {
+        for (int e = 0; e < 4; e++) {
+            const int clk = edges[e][0];
+            const int dt = edges[e][1];
+            const uint64_t at = atUs + d * kEncoderDetentUs + e * kEncoderEdgeUs;
+            schedule(at, [clk, dt]() {
+                drivePin(kEncoderClkPin, clk);
+                drivePin(kEncoderDtPin, dt);
+            }, true);
+        }
+    }
+}
+
+void scheduleEvent(const ScenarioEvent& event) {
+    const std::vector<std::string>& args = event.args;
+    const std::string& kind = args[0];
+    if (kind == "tag" && args[1] == "off") {
+        schedule(event.atUs, []() { takeCard(); });
+    } else if (kind == "tag") {
+        SimCard* card = &cardFor(args);
+        schedule(event.atUs, [card]() {
+            takeCard();
+            placeCard(*card);
+        });
+    } else if (kind == "button") {
+        pressButton(args, event.atUs);
+    } else if (kind == "encoder") {
+        turnEncoder(atoi(args[1].c_str()), event.atUs);
+    } else if (kind == "headphones") {
+        const int level = args[1] == "in" ? 0 : 1;
+        schedule(event.atUs, [level]() { drivePin(kHeadphonePin, level); }, true);
+    } else if (kind == "battery") {
+        const float percent = (float)atof(args[1].c_str());
+        schedule(event.atUs, [percent]() { setBatteryPercent(percent); });
+    } else if (kind == "http") {
+        const bool stream = args[1] == "stream";
+        const size_t first = stream ? 2 : 1;
+        std::string body;
+        for (size_t i = first + 2; i < args.size(); i++) {
+            body += (i > first + 2 ? " " : "") + args[i];
+        }
+        const std::string method = args[first];
+        const std::string url = args[first + 1];
+        if (stream) {
+            schedule(event.atUs, [method, url, body]() { httpStream(method, url, body); });
+        } else {
+            schedule(event.atUs, [method, url, body]() { httpRequest(method, url, body); });
+        }
+    } else if (kind == "locks") {
+        const uint32_t count = (uint32_t)atoi(args[2].c_str());
+        schedule(event.atUs, [count]() { setLockTimeouts(count); });
+    }
+}
+
+bool writeMp3(const std::string& hostPath, double seconds, bool vbr) {
+    std::ofstream out(hostPath, std::ios::binary);
+    if (!out) {
+        return false;
+    }
+    const long frames = (long)(seconds / kFrameSeconds + 0.5);
+    std::vector<char> frame(522, 0);
+    memcpy(frame.data(), kFrameHeader, sizeof(kFrameHeader));
+    if (vbr) {
+        // 96 and 160 kbit/s in turn (313 and 522 bytes): 128 kbit/s on
+        // average, but no two neighbours alike, so only a frame walk indexes it
+        for (long i = 0; i < frames; i++) {
+            frame[2] = (char)(i % 2 ? 0xA0 : 0x70);
+            out.write(frame.data(), i % 2 ? 522 : 313);
+        }
+        return (bool)out;
+    }
+    long padAccumulator = 0;
+    for (long i = 0; i < frames; i++) {
+        // Padding keeps the average at 417.96 bytes per frame
+        padAccumulator += 96;
+        const bool padded = padAccumulator >= 100;
+        if (padded) {
+            padAccumulator -= 100;
+        }
+        frame[2] = (char)(padded ? 0x92 : 0x90);
+        out.write(frame.data(), padded ? 418 : 417);
+    }
+    return (bool)out;
+}
+
+} // namespace
+
+bool loadScenario(const std::string& path, Scenario& scenario, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    scenario = Scenario();
+    scenario.name = stdfs::path(path).filename().string();
+
+    std::string line;
+    int lineNumber = 0;
+    bool explicitEnd = false;
+    int repeatGroups = 0;
+    uint64_t lastUs = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        const size_t hash = line.find('#');
+        if (hash != std::string::npos) {
+            line.erase(hash);
+        }
+        std::vector<std::string> words = split(line);
+        if (words.empty()) {
+            continue;
+        }
+        const std::string where = path + ":" + std::to_string(lineNumber) + ": ";
+
+        uint64_t atUs = 0;
+        if (parseTime(words[0], atUs)) {
+            std::vector<std::string> args(words.begin() + 1, words.end());
+            int count = 1;
+            uint64_t intervalUs = 0;
+            int group = -1;
+            if (!args.empty() && args[0] == "repeat") {
+                count = args.size() > 3 ? atoi(args[1].c_str()) : 0;
+                if (count < 1 || !parseTime(args[2], intervalUs)) {
+                    error = where + "bad repeat";
+                    return false;
+                }
+                args.erase(args.begin(), args.begin() + 3);
+                group = repeatGroups++;
+            }
+            if (!args.empty() && (args[0] == "mark" || args[0] == "expect")) {
+                if (count != 1 || !validCheck(args)) {
+                    error = where + "bad check";
+                    return false;
+                }
+                std::string text = args[0];
+                for (size_t i = 1; i < args.size(); i++) {
+                    text += " " + args[i];
+                }
+                scenario.checks.push_back(ScenarioCheck{ atUs, text, args });
+                lastUs = std::max(lastUs, atUs);
+                continue;
+            }
+            if (args.empty() || !validEvent(args)) {
+                error = where + "bad event";
+                return false;
+            }
+            if (args[0] == "end") {
+                scenario.endUs = atUs;
+                explicitEnd = true;
+                continue;
+            }
+            std::string text = args[0];
+            for (size_t i = 1; i < args.size(); i++) {
+                text += " " + args[i];
+            }
+            for (int i = 0; i < count; i++) {
+                scenario.events.push_back(ScenarioEvent{ atUs + i * intervalUs, text, args, group });
+            }
+            lastUs = std::max(lastUs, atUs + (count - 1) * intervalUs);
+            continue;
+        }
+
+        const std::string& directive = words[0];
+        if (directive == "folder" && (words.size() == 4 || (words.size() == 5 && words[4] == "vbr")) &&
+            words[1][0] == '/') {
+            scenario.folders.push_back(
+                FolderSpec{ words[1], atoi(words[2].c_str()), atof(words[3].c_str()), words.size() == 5 });
+        } else if (directive == "folders" && words.size() == 5 && words[1][0] == '/' && atoi(words[2].c_str()) > 0) {
+            const int count = atoi(words[2].c_str());
+            const int width = (int)std::to_string(count).size();
+            for (int i = 1; i <= count; i++) {
+                char number[16];
+                snprintf(number, sizeof(number), "%0*d", width, i);
+                scenario.folders.push_back(FolderSpec{ words[1] + number, atoi(words[3].c_str()), atof(words[4].c_str()), false });
+            }
+        } else if (directive == "map" && words.size() == 3) {
+            SimCard card;
+            if (!parseUid(words[1], card)) {
+                error = where + "bad uid";
+                return false;
+            }
+            scenario.mappings.push_back(std::make_pair(formatUid(card), words[2]));
+        } else if (directive == "file" && words.size() >= 3 && words[1][0] == '/') {
+            const size_t start = line.find(words[2], line.find(words[1]) + words[1].size());
+            scenario.files.push_back(std::make_pair(words[1], line.substr(start)));
+        } else if (directive == "headphones" && words.size() == 2 && (words[1] == "in" || words[1] == "out")) {
+            scenario.headphonesIn = words[1] == "in";
+        } else if (directive == "battery" && words.size() == 2) {
+            scenario.batteryPercent = (float)atof(words[1].c_str());
+        } else if (directive == "tasks" && words.size() == 3 && words[1] == "fail") {
+            scenario.failedTasks = (uint32_t)atoi(words[2].c_str());
+        } else {
+            error = where + "unknown directive '" + directive + "'";
+            return false;
+        }
+    }
+    std::stable_sort(scenario.events.begin(), scenario.events.end(),
+                     [](const ScenarioEvent& a, const ScenarioEvent& b) { return a.atUs < b.atUs; });
+    std::stable_sort(scenario.checks.begin(), scenario.checks.end(),
+                     [](const ScenarioCheck& a, const ScenarioCheck& b) { return a.atUs < b.atUs; });
+    if (!explicitEnd) {
+        scenario.endUs = lastUs + kTailUs;
+    }
+    return true;
+}
+
+bool prepareCard(const std::string& sdRoot, const Scenario& scenario, std::string& error) {
+    std::error_code ec;
+    stdfs::create_directories(sdRoot, ec);
+    if (ec) {
+        error = "cannot create " + sdRoot;
+        return false;
+    }
+
+    for (const FolderSpec& folder : scenario.folders) {
+        const std::string dir = sdRoot + folder.path;
+        stdfs::create_directories(dir, ec);
+        for (int i = 1; i <= folder.tracks; i++) {
+            char name[32];
+            snprintf(name, sizeof(name), "/%02d.mp3", i);
+            if (!stdfs::exists(dir + name) && !writeMp3(dir + name, folder.seconds, folder.vbr)) {
+                error = "cannot write " + dir + name;
+                return false;
+            }
+        }
+    }
+
+    if (!scenario.mappings.empty()) {
+        std::ofstream out(sdRoot + "/lookup.ndjson");
+        for (const std::pair<std::string, std::string>& mapping : scenario.mappings) {
+            out << "{\"uid\":\"" << mapping.first << "\",\"path\":\"" << mapping.second << "\"}\n";
+        }
+    }
+
+    for (const std::pair<std::string, std::string>& file : scenario.files) {
+        stdfs::create_directories(stdfs::path(sdRoot + file.first).parent_path(), ec);
+        std::ofstream out(sdRoot + file.first);
+        out << file.second << "\n";
+    }
+    return true;
+}
+
+void applyScenario(const Scenario& scenario, const std::string& sdRoot) {
+    drivePin(kHeadphonePin, scenario.headphonesIn ? 0 : 1);
+    setAdcVoltage(kButtonAdcPin, kIdleVolts);
+    setBatteryPercent(scenario.batteryPercent);
+    setTaskCreateFailures(scenario.failedTasks);
+    for (const ScenarioEvent& event : scenario.events) {
+        scheduleEvent(event);
+    }
+    for (const ScenarioCheck& check : scenario.checks) {
+        size_t resultIndex = 0;
+        if (check.args[0] == "expect") {
+            resultIndex = results().size();
+            results().push_back(CheckResult{ check.atUs, check.text, false, false, "" });
+        }
+        if (check.args[0] == "expect" && check.args[1] == "stopped") {
+            continue;   // Decided by finishChecks()
+        }
+        const ScenarioCheck* queued = &check;
+        schedule(check.atUs, [queued, resultIndex, sdRoot]() { runCheck(*queued, resultIndex, sdRoot); });
+    }
+    setStopUs(scenario.endUs);
+}
+
+void finishChecks(const Scenario& scenario, const std::string& stopReason) {
+    size_t resultIndex = 0;
+    for (const ScenarioCheck& check : scenario.checks) {
+        if (check.args[0] != "expect") {
+            continue;
+        }
+        CheckResult& result = results()[resultIndex++];
+        if (check.args[1] != "stopped") {
+            continue;
+        }
+        const std::string expected = check.text.substr(check.text.find(check.args[2]));
+        result.reached = true;
+        result.passed = stopReason == expected && nowUs() <= check.atUs;
+        char at[32];
+        snprintf(at, sizeof(at), " at %.1f ms", nowUs() / 1000.0);
+        result.actual = stopReason + at;
+    }
+}
+
+const std::vector<CheckResult>& checkResults() {
+    return results();
+}
+
+} // namespace sim
@@ -0,0 +1,114 @@
+#ifndef SIM_SCENARIO_H
+#define SIM_SCENARIO_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// SCENARIO
+// ============================================================================
+// A text file describing the SD card, the starting state and a timeline of
+// user actions. One directive per line, '#' starts a comment.
+//
+// Setup (before boot):
+//   folder <path> <tracks> <seconds> [vbr]   Generate <tracks> MP3 files of <seconds>
+//                                      (vbr: 96/160 kbit/s frames, no TOC)
+//   folders <prefix> <count> <tracks> <seconds>   <prefix>1 .. <prefix><count>
+//   map <uid> <path>                   Mapping line in /lookup.ndjson
+//   file <path> <text...>              Any other file (e.g. /settings.json)
+//   headphones in|out                  Jack state at power-on (default out)
+//   battery <percent>                  Fuel gauge reading (default 80)
+//   tasks fail <count>                 First <count> task creations fail (no memory)
+//
+// Timeline, "<time> <event>" with time in ms or s (e.g. 1500ms, 2.5s):
+//   tag <uid> [classic|ntag] [record=<path>]   Place a card (uid aa:bb:cc:dd)
+//   tag off                                    Take it away
+//   button next|previous|play|encoder [hold=<ms>]
+//   encoder +<detents>|-<detents>              Turn the knob
+//   headphones in|out
+//   battery <percent>
+//   http GET|POST <url> [<body...>]            Portal request (form or JSON body)
+//   http stream GET|POST <url> [<body...>]     Same, response read one segment per 5 ms
+//   locks busy <count>                         Next <count> timed lock takes time out
+//   repeat <count> <interval> <event...>       Same event <count> times
+//   end                                        Stop the run (default: last event + 5 s)
+//
+// Checks, on the same timeline (a failed check makes sim exit with 1):
+//   mark                                       Start counting from here
+//   expect <counter> ==|!=|<|<=|>|>= <n>       Change since the last mark
+//   expect file <path> contains <text...>      File on the SD card
+//   expect response contains <text...>         Body of the last completed http response
+//   expect response folders <op> <n>           /folders entries that parse back
+//                                              to a folder on the SD card
+//   expect http streaming <op> <n>             Streamed responses still in flight
+//   expect stopped <reason...>                 The run ended by then, e.g. "deep sleep"
+// Counters: sdOpens sdReads sdWrites sdRemoves sdRenames nvsWrites
+//   i2cTransactions dacWrites dacBursts dacUnchangedWrites dacPageSelects
+//   dacReads rfidPolls ledShows speakerPops lightSleeps httpRequests
+//   httpErrors tracksStarted allocations
+// (dac*: codec transactions seen on the fake I2C bus; speakerPops: the
+// speaker amp or the codec's class-D switched while sound was playing)
+// ============================================================================
+
+namespace sim {
+
+struct FolderSpec {
+    std::string path;
+    int tracks;
+    double seconds;
+    bool vbr;
+};
+
+struct ScenarioEvent {
+    uint64_t atUs;
+    std::string text;          // As written, for the report
+    std::vector<std::string> args;
+    int repeatGroup;           // Events of one repeat line share it, -1 otherwise
+};
+
+struct ScenarioCheck {
+    uint64_t atUs;
+    std::string text;
+    std::vector<std::string> args;   // mark | expect ...
+};
+
+struct CheckResult {
+    uint64_t atUs;
+    std::string text;
+    bool reached;
+    bool passed;
+    std::string actual;
+};
+
+struct Scenario {
+    std::string name;
+    std::vector<FolderSpec> folders;
+    std::vector<std::pair<std::string, std::string>> mappings;   // uid, path
+    std::vector<std::pair<std::string, std::string>> files;      // path, content
+    bool headphonesIn = false;
+    float batteryPercent = 80.0f;
+    uint32_t failedTasks = 0;
+    std::vector<ScenarioEvent> events;
+    std::vector<ScenarioCheck> checks;
+    uint64_t endUs = 0;
+};
+
+bool loadScenario(const std::string& path, Scenario& scenario, std::string& error);
+
+// Write the folders, mapping file and extra files below sdRoot
+bool prepareCard(const std::string& sdRoot, const Scenario& scenario, std::string& error);
+
+// Apply the power-on state and queue the timeline and checks on the
+// simulated hardware (sdRoot is read by file checks)
+void applyScenario(const Scenario& scenario, const std::string& sdRoot);
+
+// Decide the checks on how the run ended, once it has
+void finishChecks(const Scenario& scenario, const std::string& stopReason);
+
+// One entry per expect line, in timeline order
+const std::vector<CheckResult>& checkResults();
+
+} // namespace sim
+
+#endif // SIM_SCENARIO_H
@@ -0,0 +1,374 @@
+#include "SimHardware.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+namespace sim {
+
+// ============================================================================
+// CLOCK AND SCHEDULED ACTIONS
+// ============================================================================
+
+namespace {
+
+struct Action {
+    uint64_t atUs;
+    uint64_t sequence;     // FIFO among actions due at the same time
+    bool changesPins;
+    std::function<void()> fn;
+};
+
+struct ActionLater {
+    bool operator()(const Action& a, const Action& b) const {
+        return a.atUs != b.atUs ? a.atUs > b.atUs : a.sequence > b.sequence;
+    }
+};
+
+uint64_t g_nowUs = 0;
+uint64_t g_stopUs = UINT64_MAX;
+uint64_t g_sequence = 0;
+std::vector<Action> g_actions;   // Min-heap on (atUs, sequence)
+
+// ============================================================================
+// PINS
+// ============================================================================
+
+struct Pin {
+    uint8_t mode = 0;
+    int level = 1;             // Inputs idle high (pull-ups everywhere on this board)
+    IsrFunction isr = nullptr;
+    int isrMode = 0;
+    bool isrEnabled = true;
+    bool wakeEnabled = false;
+    float adcVolts = 3.3f;
+};
+
+// Interrupt modes as in esp32-hal-gpio.h
+const int kRising = 1;
+const int kFalling = 2;
+const int kChange = 3;
+
+const uint8_t kSpeakerSdPin = 0;   // PAM8302A shutdown, HIGH = on
+
+std::map<uint8_t, Pin> g_pins;
+uint8_t g_adcBits = 12;
+bool g_pinWoke = false;     // A wake pin changed during sleepUntil()
+
+bool g_cardPresent = false;
+SimCard g_card;
+float g_batteryPercent = 80.0f;
+bool g_bclkRunning = false;
+uint32_t g_lockTimeouts = 0;
+uint32_t g_taskCreateFailures = 0;
+
+FILE* g_uart = nullptr;
+std::string g_uartLine;
+
+std::vector<Observation> g_observations;
+SimCounters g_counters = {};
+
+} // namespace
+
+uint64_t nowUs() {
+    return g_nowUs;
+}
+
+void schedule(uint64_t atUs, std::function<void()> fn, bool changesPins) {
+    Untracked untracked;
+    g_actions.push_back(Action{ atUs, g_sequence++, changesPins, std::move(fn) });
+    std::push_heap(g_actions.begin(), g_actions.end(), ActionLater());
+}
+
+uint64_t nextActionUs() {
+    return g_actions.empty() ? UINT64_MAX : g_actions.front().atUs;
+}
+
+void setStopUs(uint64_t atUs) {
+    g_stopUs = atUs;
+}
+
+uint64_t stopUs() {
+    return g_stopUs;
+}
+
+// Run one due action (the clock is already at its time)
+static bool runNextAction() {
+    Action action;
+    {
+        Untracked untracked;
+        std::pop_heap(g_actions.begin(), g_actions.end(), ActionLater());
+        action = std::move(g_actions.back());
+        g_actions.pop_back();
+    }
+    g_pinWoke = false;
+    action.fn();
+    return action.changesPins && g_pinWoke;
+}
+
+// Advance to targetUs; optionally return early at a wake-pin change
+static bool advanceInternal(uint64_t targetUs, bool stopOnWake) {
+    while (!g_actions.empty() && g_actions.front().atUs <= targetUs) {
+        uint64_t at = std::max(g_actions.front().atUs, g_nowUs);
+        if (at > g_stopUs) {
+            break;
+        }
+        g_nowUs = at;
+        if (runNextAction() && stopOnWake) {
+            return true;
+        }
+    }
+    if (targetUs > g_stopUs) {
+        g_nowUs = g_stopUs;
+        throw SimStop{ "scenario end" };
+    }
+    g_nowUs = std::max(g_nowUs, targetUs);
+    return false;
+}
+
+static int g_otherCore = 0;
+
+void advanceUs(uint64_t us) {
+    if (g_otherCore > 0) {
+        return;
+    }
+    advanceInternal(g_nowUs + us, false);
+}
+
+void advanceTo(uint64_t targetUs) {
+    advanceInternal(targetUs, false);
+}
+
+bool sleepUntil(uint64_t targetUs) {
+    return advanceInternal(targetUs, true);
+}
+
+// ============================================================================
+// GPIO, ADC
+// ============================================================================
+
+void setPinMode(uint8_t pin, uint8_t mode) {
+    Untracked untracked;
+    g_pins[pin].mode = mode;
+}
+
+void writePin(uint8_t pin, int level) {
+    Untracked untracked;
+    Pin& p = g_pins[pin];
+    level = level ? 1 : 0;
+    if (p.level != level) {
+        p.level = level;
+        observe("pin", "GPIO" + std::to_string(pin) + "=" + std::to_string(level));
+        if (pin == kSpeakerSdPin && outputAudible()) {
+            g_counters.speakerPops++;
+        }
+    }
+}
+
+int readPin(uint8_t pin) {
+    Untracked untracked;
+    return g_pins[pin].level;
+}
+
+void drivePin(uint8_t pin, int level) {
+    IsrFunction isr = nullptr;
+    {
+        Untracked untracked;
+        Pin& p = g_pins[pin];
+        level = level ? 1 : 0;
+        if (p.level == level) {
+            return;
+        }
+        p.level = level;
+        if (p.wakeEnabled) {
+            g_pinWoke = true;
+        }
+        const bool edgeMatches = p.isrMode == kChange || (p.isrMode == kRising && level) ||
+                                 (p.isrMode == kFalling && !level);
+        if (p.isr && p.isrEnabled && edgeMatches) {
+            isr = p.isr;
+        }
+    }
+    if (isr) {
+        isr();
+    }
+}
+
+void attachIsr(uint8_t pin, IsrFunction isr, int mode) {
+    Untracked untracked;
+    Pin& p = g_pins[pin];
+    p.isr = isr;
+    p.isrMode = mode;
+    p.isrEnabled = true;
+}
+
+void detachIsr(uint8_t pin) {
+    Untracked untracked;
+    g_pins[pin].isr = nullptr;
+}
+
+void setIsrEnabled(uint8_t pin, bool enabled) {
+    Untracked untracked;
+    g_pins[pin].isrEnabled = enabled;
+}
+
+void setWakeEnabled(uint8_t pin, bool enabled) {
+    Untracked untracked;
+    g_pins[pin].wakeEnabled = enabled;
+}
+
+void setAdcVoltage(uint8_t pin, float volts) {
+    Untracked untracked;
+    g_pins[pin].adcVolts = volts;
+}
+
+uint16_t readAdc(uint8_t pin) {
+    Untracked untracked;
+    const float volts = std::min(std::max(g_pins[pin].adcVolts, 0.0f), 3.3f);
+    const uint32_t full = (1UL << g_adcBits) - 1;
+    return (uint16_t)(volts / 3.3f * full + 0.5f);
+}
+
+void setAdcBits(uint8_t bits) {
+    g_adcBits = bits > 0 && bits <= 16 ? bits : 12;
+}
+
+// ============================================================================
+// RFID CARD, BATTERY
+// ============================================================================
+
+void placeCard(const SimCard& card) {
+    g_card = card;
+    g_cardPresent = true;
+}
+
+void removeCard() {
+    g_cardPresent = false;
+}
+
+SimCard* cardInField() {
+    return g_cardPresent ? &g_card : nullptr;
+}
+
+void setBatteryPercent(float percent) {
+    g_batteryPercent = percent;
+}
+
+float batteryPercent() {
+    return g_batteryPercent;
+}
+
+void setBclkRunning(bool running) {
+    g_bclkRunning = running;
+}
+
+bool bclkRunning() {
+    return g_bclkRunning;
+}
+
+void setLockTimeouts(uint32_t count) {
+    g_lockTimeouts = count;
+}
+
+bool takeLockTimeout() {
+    if (g_lockTimeouts == 0) {
+        return false;
+    }
+    g_lockTimeouts--;
+    return true;
+}
+
+void setTaskCreateFailures(uint32_t count) {
+    g_taskCreateFailures = count;
+}
+
+bool takeTaskCreateFailure() {
+    if (g_taskCreateFailures == 0) {
+        return false;
+    }
+    g_taskCreateFailures--;
+    return true;
+}
+
+// ============================================================================
+// UART
+// ============================================================================
+
+void setUartOutput(FILE* out) {
+    g_uart = out;
+}
+
+// 115200 baud, 10 bits per byte; the 128-byte TX FIFO absorbs bursts and
+// the writer waits once it is full (no TX ring buffer configured)
+static const double kUartUsPerByte = 10.0 * 1e6 / 115200;
+static const size_t kUartFifoBytes = 128;
+static double g_uartIdleUs = 0;    // When the FIFO will have drained
+
+OtherCore::OtherCore() {
+    g_otherCore++;
+}
+
+OtherCore::~OtherCore() {
+    g_otherCore--;
+}
+
+void uartWrite(const uint8_t* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        const double now = (double)g_nowUs;
+        g_uartIdleUs = std::max(g_uartIdleUs, now) + kUartUsPerByte;
+        const double fullUs = kUartFifoBytes * kUartUsPerByte;
+        if (g_otherCore == 0 && g_uartIdleUs - now > fullUs) {
+            advanceUs((uint64_t)(g_uartIdleUs - now - fullUs) + 1);
+        }
+
+        const char c = (char)data[i];
+        if (c == '\r') {
+            continue;
+        }
+        Untracked untracked;
+        if (c != '\n') {
+            g_uartLine += c;
+            continue;
+        }
+        if (g_uart) {
+            fprintf(g_uart, "[%6llu.%03llu] %s\n", (unsigned long long)(g_nowUs / 1000000),
+                    (unsigned long long)(g_nowUs / 1000 % 1000), g_uartLine.c_str());
+        }
+        g_uartLine.clear();
+    }
+}
+
+void uartFlush(bool endLine) {
+    if (endLine && !g_uartLine.empty()) {
+        const uint8_t newline = '\n';
+        uartWrite(&newline, 1);
+    }
+    if (g_uartIdleUs > (double)g_nowUs) {
+        advanceTo((uint64_t)g_uartIdleUs + 1);   // Serial.flush() waits for the last byte
+    }
+    if (g_uart) {
+        fflush(g_uart);
+    }
+}
+
+// ============================================================================
+// OBSERVATIONS AND COUNTERS
+// ============================================================================
+
+void observe(const char* kind, const std::string& detail) {
+    observeAt(g_nowUs, kind, detail);
+}
+
+void observeAt(uint64_t atUs, const char* kind, const std::string& detail) {
+    Untracked untracked;
+    g_observations.push_back(Observation{ atUs, kind, detail });
+}
+
+const std::vector<Observation>& observations() {
+    return g_observations;
+}
+
+SimCounters& counters() {
+    return g_counters;
+}
+
+} // namespace sim
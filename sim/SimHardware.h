@@ -0,0 +1,245 @@
+#ifndef SIM_HARDWARE_H
+#define SIM_HARDWARE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// SIMULATED HARDWARE
+// ============================================================================
+// State shared by the fake libraries in sim/fakes: a virtual microsecond
+// clock, GPIO levels and interrupts, the button ADC, the card in the RFID
+// field, the battery, plus counters and an observation log for the report.
+//
+// Time only moves when the firmware waits (delay(), blocking I2S writes,
+// light sleep) or when the runner charges the cost of a loop iteration.
+// Scenario actions are queued with a due time and run at exactly that time
+// while the clock passes it, so a pin edge fires its ISR in the middle of a
+// delay() just like on the device.
+// ============================================================================
+
+namespace sim {
+
+// Thrown to end the run (scenario end, deep sleep); not a std::exception so
+// the firmware's catch (const std::exception&) blocks let it through
+struct SimStop {
+    std::string reason;
+};
+
+// One output the firmware produced that a user would notice
+struct Observation {
+    uint64_t atUs;
+    std::string kind;     // "audio", "volume", "output", "pin", "speaker", "led", "sleep", "wifi", "http"
+    std::string detail;
+};
+
+// Card in the RFID field
+struct SimCard {
+    uint8_t uid[10];
+    uint8_t uidSize;
+    uint8_t sak;               // 0x08 = MIFARE Classic 1K, 0x00 = Ultralight/NTAG
+    uint8_t memory[64 * 16];   // Classic: 64 blocks of 16 bytes, NTAG: 4-byte pages
+};
+
+// Counters of everything the report breaks down
+struct SimCounters {
+    // SD card
+    uint32_t sdOpens;
+    uint32_t sdOpenFailures;
+    uint32_t sdReadCalls;
+    uint64_t sdBytesRead;
+    uint32_t sdWriteCalls;
+    uint64_t sdBytesWritten;
+    uint32_t sdSeeks;
+    uint32_t sdExists;
+    uint32_t sdRemoves;
+    uint32_t sdRenames;
+    uint32_t sdMkdirs;
+    uint32_t sdDirEntries;
+
+    // Other buses
+    uint32_t nvsWrites;
+    uint32_t i2cTransactions;
+    uint32_t dacWrites;           // Codec register writes (page selects not included)
+    uint32_t dacBursts;           // ... of more than one register
+    uint32_t dacUnchangedWrites;  // Registers written with the value they held
+    uint32_t dacPageSelects;
+    uint32_t dacReads;
+    uint32_t rfidPolls;
+    uint32_t ledShows;
+    uint32_t speakerPops;         // Speaker amp switched while the DAC played sound
+
+    // Setup portal
+    uint32_t httpRequests;
+    uint32_t httpErrors;       // No server, status >= 400 or a stalled response
+
+    // Power
+    uint32_t lightSleeps;
+    uint64_t lightSleepUs;
+    uint32_t cpuMhzChanges;
+};
+
+// ============================================================================
+// CLOCK AND SCHEDULED ACTIONS
+// ============================================================================
+
+uint64_t nowUs();
+
+// Queue fn to run when the clock reaches atUs (FIFO among equal times);
+// changesPins marks actions that may end a light sleep
+void schedule(uint64_t atUs, std::function<void()> fn, bool changesPins = false);
+uint64_t nextActionUs();   // UINT64_MAX if nothing is queued
+
+// Move the clock forward, running due actions on the way. Throws SimStop
+// once the stop time is passed. Inside an OtherCore scope the clock does not
+// move: that work runs next to the main loop, not in its time.
+void advanceUs(uint64_t us);
+void advanceTo(uint64_t targetUs);
+
+// Sleep until targetUs or the first pin-changing action on a wake pin;
+// returns true if a pin woke it
+bool sleepUntil(uint64_t targetUs);
+
+void setStopUs(uint64_t atUs);
+uint64_t stopUs();
+
+// ============================================================================
+// GPIO, ADC
+// ============================================================================
+
+typedef void (*IsrFunction)();
+
+void setPinMode(uint8_t pin, uint8_t mode);
+void writePin(uint8_t pin, int level);      // Firmware output
+int readPin(uint8_t pin);
+void drivePin(uint8_t pin, int level);      // External level (scenario); fires ISRs
+void attachIsr(uint8_t pin, IsrFunction isr, int mode);
+void detachIsr(uint8_t pin);
+void setIsrEnabled(uint8_t pin, bool enabled);   // gpio_intr_enable/disable
+void setWakeEnabled(uint8_t pin, bool enabled);  // gpio_wakeup_enable/disable
+
+void setAdcVoltage(uint8_t pin, float volts);
+uint16_t readAdc(uint8_t pin);
+void setAdcBits(uint8_t bits);
+
+// ============================================================================
+// RFID CARD, BATTERY
+// ============================================================================
+
+void placeCard(const SimCard& card);
+void removeCard();
+SimCard* cardInField();   // nullptr if the field is empty
+
+void setBatteryPercent(float percent);
+float batteryPercent();
+
+// I2S bit clock; the codec PLL runs from it
+void setBclkRunning(bool running);
+bool bclkRunning();
+
+// The next <count> mutex takes with a timeout fail after waiting it out
+// (another task holding the lock)
+void setLockTimeouts(uint32_t count);
+bool takeLockTimeout();   // Called by xSemaphoreTake; true = time out
+
+// The next <count> xTaskCreate calls fail as if the heap had no room
+void setTaskCreateFailures(uint32_t count);
+bool takeTaskCreateFailure();   // Called by xTaskCreate; true = fail
+
+// ============================================================================
+// CPU CLOCK (sim/fakes/Arduino.cpp)
+// ============================================================================
+
+// Time since power-on with the CPU at 240 MHz
+uint64_t cpuFullSpeedUs();
+
+// ============================================================================
+// AUDIO OUTPUT (sim/fakes/AudioTools.cpp)
+// ============================================================================
+
+// The DAC is playing non-zero samples right now (not what was last written
+// to I2S, which is still queued)
+bool outputAudible();
+
+// ============================================================================
+// SETUP PORTAL (sim/fakes/ESPAsyncWebServer.cpp)
+// ============================================================================
+
+// One request from a phone on the portal: runs the route's handler as the
+// AsyncTCP task would and reads the whole response. Returns the status code,
+// 0 if the server is not running. The body is a form (a=1&b=2) or JSON.
+int httpRequest(const std::string& method, const std::string& url, const std::string& body);
+
+// Same, but the client reads one TCP segment every 5 ms of virtual time, so
+// the main loop and other requests run while the response is in flight
+int httpStream(const std::string& method, const std::string& url, const std::string& body);
+size_t httpStreaming();   // Responses still in flight
+
+// Body of the response completed last
+const std::string& lastHttpBody();
+
+// ============================================================================
+// UART
+// ============================================================================
+
+// Serial output; each line is prefixed with the virtual time
+void setUartOutput(FILE* out);
+void uartWrite(const uint8_t* data, size_t size);
+void uartFlush(bool endLine = false);   // endLine: terminate a partial line
+
+// Output written inside this scope comes from a task on the other core: it
+// occupies the UART but does not hold up the caller
+struct OtherCore {
+    OtherCore();
+    ~OtherCore();
+};
+
+// ============================================================================
+// OBSERVATIONS AND COUNTERS
+// ============================================================================
+
+void observe(const char* kind, const std::string& detail);
+void observeAt(uint64_t atUs, const char* kind, const std::string& detail);   // E.g. audio still queued
+const std::vector<Observation>& observations();
+
+SimCounters& counters();
+
+// Heap accounting (sim/SimHeap.cpp). Bookkeeping of the simulator itself
+// runs inside an Untracked scope so only firmware allocations are counted.
+size_t heapLiveBytes();
+size_t heapPeakBytes();
+uint64_t heapAllocations();
+void resetHeapPeak();
+
+// Free space of the arena model in SimHeap.cpp (block headers included)
+struct HeapLayout {
+    size_t freeBytes;
+    size_t largestFreeBlock;   // What ESP.getMaxAllocHeap() reports
+    size_t freeBlocks;
+    uint64_t unplaced;         // Allocations that found no free block
+};
+HeapLayout heapLayout();
+
+struct Untracked {
+    Untracked();
+    ~Untracked();
+};
+
+// Counts again inside an Untracked scope (a fake's stand-in for a device allocation)
+struct Tracked {
+    Tracked();
+    ~Tracked();
+
+    int saved;
+};
+
+// Total heap the fake ESP reports (free = total - live)
+static const size_t kHeapTotalBytes = 320 * 1024;
+
+} // namespace sim
+
+#endif // SIM_HARDWARE_H
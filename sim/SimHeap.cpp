@@ -0,0 +1,179 @@
+#include "SimHardware.h"
+#include <cstdlib>
+#include <iterator>
+#include <map>
+#include <new>
+
+// ============================================================================
+// HEAP ACCOUNTING
+// ============================================================================
+// Global operator new/delete with a size header, so live bytes and the
+// high-water mark of the firmware's allocations can be reported like
+// ESP.getFreeHeap()/getMinFreeHeap() would on the device.
+//
+// Tracked allocations are also placed in a model of the device heap: a
+// kHeapTotalBytes arena, first fit in address order, 8-byte granules plus
+// a block header, neighbours merged on free. It is not the IDF allocator,
+// but it fragments the same way under the same alloc/free pattern, so the
+// largest free block (ESP.getMaxAllocHeap()) can be compared between builds.
+
+namespace {
+
+struct alignas(std::max_align_t) Header {
+    size_t size;
+    size_t offset;    // Position in the arena model, kNotPlaced if none
+    bool tracked;
+};
+
+const size_t kGranule = 8;
+const size_t kBlockOverhead = 8;
+const size_t kNotPlaced = (size_t)-1;
+
+size_t g_live = 0;
+size_t g_peak = 0;
+uint64_t g_count = 0;
+uint64_t g_unplaced = 0;
+int g_untracked = 0;
+
+// Free blocks of the arena, offset -> size (allocated Untracked)
+std::map<size_t, size_t>& freeBlocks() {
+    static std::map<size_t, size_t>* blocks = nullptr;
+    if (!blocks) {
+        g_untracked++;
+        blocks = new std::map<size_t, size_t>();
+        (*blocks)[0] = sim::kHeapTotalBytes;
+        g_untracked--;
+    }
+    return *blocks;
+}
+
+size_t blockSize(size_t size) {
+    return (size + kBlockOverhead + kGranule - 1) / kGranule * kGranule;
+}
+
+size_t place(size_t size) {
+    std::map<size_t, size_t>& blocks = freeBlocks();
+    const size_t need = blockSize(size);
+    for (std::map<size_t, size_t>::iterator it = blocks.begin(); it != blocks.end(); ++it) {
+        if (it->second < need) {
+            continue;
+        }
+        const size_t offset = it->first;
+        const size_t rest = it->second - need;
+        g_untracked++;
+        blocks.erase(it);
+        if (rest) {
+            blocks[offset + need] = rest;
+        }
+        g_untracked--;
+        return offset;
+    }
+    g_unplaced++;   // Would have failed on the device
+    return kNotPlaced;
+}
+
+void unplace(size_t offset, size_t size) {
+    std::map<size_t, size_t>& blocks = freeBlocks();
+    size_t start = offset;
+    size_t length = blockSize(size);
+    g_untracked++;
+    std::map<size_t, size_t>::iterator next = blocks.lower_bound(offset);
+    if (next != blocks.end() && start + length == next->first) {
+        length += next->second;
+        next = blocks.erase(next);
+    }
+    if (next != blocks.begin()) {
+        std::map<size_t, size_t>::iterator prev = std::prev(next);
+        if (prev->first + prev->second == start) {
+            start = prev->first;
+            length += prev->second;
+            blocks.erase(prev);
+        }
+    }
+    blocks[start] = length;
+    g_untracked--;
+}
+
+void* allocate(size_t size) {
+    Header* header = static_cast<Header*>(std::malloc(sizeof(Header) + (size ? size : 1)));
+    if (!header) {
+        throw std::bad_alloc();
+    }
+    header->size = size;
+    header->tracked = g_untracked == 0;
+    header->offset = kNotPlaced;
+    if (header->tracked) {
+        header->offset = place(size);
+        g_live += size;
+        g_count++;
+        if (g_live > g_peak) {
+            g_peak = g_live;
+        }
+    }
+    return header + 1;
+}
+
+void release(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+    Header* header = static_cast<Header*>(ptr) - 1;
+    if (header->tracked) {
+        g_live -= header->size;
+        if (header->offset != kNotPlaced) {
+            unplace(header->offset, header->size);
+        }
+    }
+    std::free(header);
+}
+
+} // namespace
+
+void* operator new(size_t size) { return allocate(size); }
+void* operator new[](size_t size) { return allocate(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+void operator delete(void* ptr) noexcept { release(ptr); }
+void operator delete[](void* ptr) noexcept { release(ptr); }
+void operator delete(void* ptr, size_t) noexcept { release(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { release(ptr); }
+
+namespace sim {
+
+size_t heapLiveBytes() { return g_live; }
+size_t heapPeakBytes() { return g_peak; }
+uint64_t heapAllocations() { return g_count; }
+void resetHeapPeak() { g_peak = g_live; }
+
+HeapLayout heapLayout() {
+    HeapLayout layout = {};
+    for (const std::pair<const size_t, size_t>& block : freeBlocks()) {
+        layout.freeBytes += block.second;
+        layout.freeBlocks++;
+        if (block.second > layout.largestFreeBlock) {
+            layout.largestFreeBlock = block.second;
+        }
+    }
+    layout.unplaced = g_unplaced;
+    return layout;
+}
+
+Untracked::Untracked() { g_untracked++; }
+Untracked::~Untracked() { g_untracked--; }
+
+Tracked::Tracked() : saved(g_untracked) { g_untracked = 0; }
+Tracked::~Tracked() { g_untracked = saved; }
+
+} // namespace sim
@@ -0,0 +1,28 @@
+#include "Adafruit_TLV320DAC3100.h"
+
+bool Adafruit_TLV320DAC3100::begin(uint8_t i2cAddress, TwoWire* bus) {
+    address = i2cAddress;
+    wire = bus;
+    if (!reset()) {
+        return false;
+    }
+    delay(1);   // The library waits for the software reset
+    return true;
+}
+
+bool Adafruit_TLV320DAC3100::write(uint8_t page, uint8_t reg, uint8_t value) {
+    const uint8_t select[2] = { 0x00, page };
+    wire->beginTransmission(address);
+    wire->write(select, 2);
+    if (wire->endTransmission() != 0) {
+        return false;
+    }
+    const uint8_t data[2] = { reg, value };
+    wire->beginTransmission(address);
+    wire->write(data, 2);
+    return wire->endTransmission() == 0;
+}
+
+bool Adafruit_TLV320DAC3100::speakerEnabled() {
+    return (sim::tlvRegister(1, 0x20) & 0x80) != 0;
+}
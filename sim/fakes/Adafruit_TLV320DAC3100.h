@@ -0,0 +1,61 @@
+#ifndef SIM_ADAFRUIT_TLV320DAC3100_H
+#define SIM_ADAFRUIT_TLV320DAC3100_H
+
+// ============================================================================
+// ADAFRUIT TLV320DAC3100
+// ============================================================================
+// Library calls become register writes on the simulated bus (one page
+// select and one write each, like the real library), so they show up in
+// the I2C count and move the codec's page behind DAC_Manager's cache.
+// ============================================================================
+
+#include <Wire.h>
+#include "Adafruit_TLV320DAC3100_typedefs.h"
+
+class Adafruit_TLV320DAC3100 {
+public:
+    bool begin(uint8_t address = 0x18, TwoWire* wire = &Wire);
+    bool reset() { return write(0, 0x01, 0x01); }
+
+    bool setCodecInterface(int format, int length) { return write(0, 0x1B, (uint8_t)((format << 6) | (length << 4))); }
+    bool setCodecClockInput(int source) { return write(0, 0x04, (uint8_t)source); }
+    bool setPLLClockInput(int source) { return write(0, 0x04, (uint8_t)(source << 2)); }
+    bool setPLLValues(int p, int r, int j, int d) { (void)d; return write(0, 0x05, (uint8_t)((p << 4) | r)) && write(0, 0x06, (uint8_t)j); }
+    bool setNDAC(bool enable, int value) { return write(0, 0x0B, (uint8_t)((enable ? 0x80 : 0) | value)); }
+    bool setMDAC(bool enable, int value) { return write(0, 0x0C, (uint8_t)((enable ? 0x80 : 0) | value)); }
+    bool powerPLL(bool on) { return write(0, 0x05, on ? 0x80 : 0x00); }
+    bool setDACDataPath(bool left, bool right, int leftPath, int rightPath, int step) {
+        return write(0, 0x3F, (uint8_t)((left ? 0x80 : 0) | (right ? 0x40 : 0) | (leftPath << 4) | (rightPath << 2) | step));
+    }
+    bool configureAnalogInputs(int left, int right, bool a, bool b, bool c, bool d) {
+        (void)a; (void)b; (void)c; (void)d;
+        return write(1, 0x23, (uint8_t)((left << 6) | (right << 2)));
+    }
+    bool setDACVolumeControl(bool leftMute, bool rightMute, int control) {
+        return write(0, 0x40, (uint8_t)((leftMute ? 0x08 : 0) | (rightMute ? 0x04 : 0) | control));
+    }
+    bool setChannelVolume(bool right, float db) { return write(0, right ? 0x42 : 0x41, (uint8_t)(int8_t)(db * 2)); }
+    bool configureHeadphoneDriver(bool left, bool right, int common, bool shortProtect) {
+        return write(1, 0x1F, (uint8_t)((left ? 0x80 : 0) | (right ? 0x40 : 0) | (common << 3) | (shortProtect ? 0x02 : 0)));
+    }
+    bool configureHPL_PGA(int gain, bool unmute) { return write(1, 0x28, (uint8_t)((gain << 3) | (unmute ? 0x04 : 0))); }
+    bool configureHPR_PGA(int gain, bool unmute) { return write(1, 0x29, (uint8_t)((gain << 3) | (unmute ? 0x04 : 0))); }
+    bool setHPLVolume(bool route, uint8_t volume) { return write(1, 0x24, (uint8_t)((route ? 0x80 : 0) | volume)); }
+    bool setHPRVolume(bool route, uint8_t volume) { return write(1, 0x25, (uint8_t)((route ? 0x80 : 0) | volume)); }
+    bool configureSPK_PGA(int gain, bool unmute) { return write(1, 0x2A, (uint8_t)((gain << 3) | (unmute ? 0x04 : 0))); }
+    bool setSPKVolume(bool route, uint8_t volume) { return write(1, 0x26, (uint8_t)((route ? 0x80 : 0) | volume)); }
+    bool configMicBias(bool power, bool alwaysOn, int voltage) {
+        return write(1, 0x2E, (uint8_t)((power ? 0x08 : 0) | (alwaysOn ? 0x04 : 0) | voltage));
+    }
+    bool enableSpeaker(bool on) { return write(1, 0x20, on ? 0x86 : 0x06); }
+    bool speakerEnabled();
+    tlv320_headset_status_t getHeadsetStatus() { return TLV320_HEADSET_NONE; }
+
+private:
+    uint8_t address = 0x18;
+    TwoWire* wire = &Wire;
+
+    bool write(uint8_t page, uint8_t reg, uint8_t value);
+};
+
+#endif // SIM_ADAFRUIT_TLV320DAC3100_H
@@ -0,0 +1,17 @@
+#ifndef SIM_ADAFRUIT_TLV320DAC3100_TYPEDEFS_H
+#define SIM_ADAFRUIT_TLV320DAC3100_TYPEDEFS_H
+
+typedef enum { TLV320DAC3100_FORMAT_I2S = 0, TLV320DAC3100_FORMAT_DSP, TLV320DAC3100_FORMAT_RJF, TLV320DAC3100_FORMAT_LJF } tlv320dac3100_format_t;
+typedef enum { TLV320DAC3100_DATA_LEN_16 = 0, TLV320DAC3100_DATA_LEN_20, TLV320DAC3100_DATA_LEN_24, TLV320DAC3100_DATA_LEN_32 } tlv320dac3100_data_len_t;
+typedef enum { TLV320DAC3100_CODEC_CLKIN_MCLK = 0, TLV320DAC3100_CODEC_CLKIN_BCLK, TLV320DAC3100_CODEC_CLKIN_GPIO1, TLV320DAC3100_CODEC_CLKIN_PLL } tlv320dac3100_codec_clkin_t;
+typedef enum { TLV320DAC3100_PLL_CLKIN_MCLK = 0, TLV320DAC3100_PLL_CLKIN_BCLK, TLV320DAC3100_PLL_CLKIN_GPIO1, TLV320DAC3100_PLL_CLKIN_DIN } tlv320dac3100_pll_clkin_t;
+typedef enum { TLV320_DAC_PATH_OFF = 0, TLV320_DAC_PATH_NORMAL, TLV320_DAC_PATH_SWAPPED, TLV320_DAC_PATH_MIXED } tlv320_dac_path_t;
+typedef enum { TLV320_VOLUME_STEP_1SAMPLE = 0, TLV320_VOLUME_STEP_2SAMPLE, TLV320_VOLUME_STEP_DISABLED } tlv320_volume_step_t;
+typedef enum { TLV320_DAC_ROUTE_NONE = 0, TLV320_DAC_ROUTE_MIXER, TLV320_DAC_ROUTE_HP } tlv320_dac_route_t;
+typedef enum { TLV320_VOL_INDEPENDENT = 0, TLV320_VOL_LEFT_TO_RIGHT, TLV320_VOL_RIGHT_TO_LEFT } tlv320_vol_control_t;
+typedef enum { TLV320_HP_COMMON_1_35V = 0, TLV320_HP_COMMON_1_50V, TLV320_HP_COMMON_1_65V, TLV320_HP_COMMON_1_80V } tlv320_hp_common_t;
+typedef enum { TLV320_SPK_GAIN_6DB = 0, TLV320_SPK_GAIN_12DB, TLV320_SPK_GAIN_18DB, TLV320_SPK_GAIN_24DB } tlv320_spk_gain_t;
+typedef enum { TLV320_MICBIAS_OFF = 0, TLV320_MICBIAS_2V, TLV320_MICBIAS_2_5V, TLV320_MICBIAS_AVDD } tlv320_micbias_volt_t;
+typedef enum { TLV320_HEADSET_NONE = 0, TLV320_HEADSET_WITHOUT_MIC = 1, TLV320_HEADSET_WITH_MIC = 3 } tlv320_headset_status_t;
+
+#endif // SIM_ADAFRUIT_TLV320DAC3100_TYPEDEFS_H
@@ -0,0 +1,39 @@
+#ifndef SIM_AIESP32ROTARYENCODER_H
+#define SIM_AIESP32ROTARYENCODER_H
+
+// Rotary encoder library: Rotary_Manager only uses it to set the pin modes
+// and attach its ISR to both encoder pins
+
+#include <Arduino.h>
+
+class AiEsp32RotaryEncoder {
+public:
+    AiEsp32RotaryEncoder(uint8_t aPin, uint8_t bPin, int buttonPin = -1, int vccPin = -1, uint8_t stepsPerNotch = 1)
+        : aPin(aPin), bPin(bPin), buttonPin(buttonPin) {
+        (void)vccPin;
+        (void)stepsPerNotch;
+    }
+
+    void begin() {
+        pinMode(aPin, INPUT);
+        pinMode(bPin, INPUT);
+        if (buttonPin >= 0) {
+            pinMode((uint8_t)buttonPin, INPUT_PULLUP);
+        }
+    }
+
+    void setup(void (*isr)()) {
+        attachInterrupt(aPin, isr, CHANGE);
+        attachInterrupt(bPin, isr, CHANGE);
+    }
+
+    void readEncoder_ISR() {}
+    bool isEncoderButtonClicked() { return false; }
+
+private:
+    uint8_t aPin;
+    uint8_t bPin;
+    int buttonPin;
+};
+
+#endif // SIM_AIESP32ROTARYENCODER_H
@@ -0,0 +1,234 @@
+#include <Arduino.h>
+#include "../SimHardware.h"
+
+// ============================================================================
+// TIME
+// ============================================================================
+
+unsigned long millis() {
+    return (uint32_t)(sim::nowUs() / 1000);
+}
+
+unsigned long micros() {
+    return (uint32_t)sim::nowUs();
+}
+
+void delay(uint32_t ms) {
+    sim::advanceUs((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(uint32_t us) {
+    sim::advanceUs(us);
+}
+
+void yield() {
+}
+
+// ============================================================================
+// GPIO, ADC, INTERRUPTS
+// ============================================================================
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    sim::setPinMode(pin, mode);
+}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+    sim::writePin(pin, level);
+}
+
+int digitalRead(uint8_t pin) {
+    return sim::readPin(pin);
+}
+
+uint16_t analogRead(uint8_t pin) {
+    return sim::readAdc(pin);
+}
+
+void analogReadResolution(uint8_t bits) {
+    sim::setAdcBits(bits);
+}
+
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode) {
+    sim::attachIsr(pin, isr, mode);
+}
+
+void detachInterrupt(uint8_t pin) {
+    sim::detachIsr(pin);
+}
+
+// ============================================================================
+// CPU CLOCK
+// ============================================================================
+
+static uint32_t g_cpuMhz = 240;
+static uint64_t g_cpuMhzSinceUs = 0;
+static uint64_t g_fullSpeedUs = 0;   // Completed stretches at 240 MHz
+
+bool setCpuFrequencyMhz(uint32_t mhz) {
+    if (mhz != 240 && mhz != 160 && mhz != 80 && mhz != 40 && mhz != 20 && mhz != 10) {
+        return false;
+    }
+    if (mhz != g_cpuMhz) {
+        if (g_cpuMhz == 240) {
+            g_fullSpeedUs += sim::nowUs() - g_cpuMhzSinceUs;
+        }
+        g_cpuMhz = mhz;
+        g_cpuMhzSinceUs = sim::nowUs();
+        sim::counters().cpuMhzChanges++;
+    }
+    return true;
+}
+
+uint64_t sim::cpuFullSpeedUs() {
+    return g_fullSpeedUs + (g_cpuMhz == 240 ? sim::nowUs() - g_cpuMhzSinceUs : 0);
+}
+
+uint32_t getCpuFrequencyMhz() {
+    return g_cpuMhz;
+}
+
+// ============================================================================
+// SERIAL
+// ============================================================================
+
+HardwareSerial Serial;
+
+size_t HardwareSerial::write(uint8_t c) {
+    sim::uartWrite(&c, 1);
+    return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    sim::uartWrite(buffer, size);
+    return size;
+}
+
+void HardwareSerial::flush() {
+    sim::uartFlush();
+}
+
+// ============================================================================
+// PRINT, STREAM
+// ============================================================================
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+        if (!write(*buffer++)) {
+            break;
+        }
+        n++;
+    }
+    return n;
+}
+
+size_t Print::printf(const char* format, ...) {
+    char local[64];
+    va_list args;
+    va_start(args, format);
+    va_list copy;
+    va_copy(copy, args);
+    int length = vsnprintf(local, sizeof(local), format, copy);
+    va_end(copy);
+    if (length < 0) {
+        va_end(args);
+        return 0;
+    }
+
+    // Same as the core: a stack buffer, a heap one for long output
+    char* buffer = local;
+    if ((size_t)length >= sizeof(local)) {
+        buffer = new char[length + 1];
+        vsnprintf(buffer, length + 1, format, args);
+    }
+    va_end(args);
+    size_t written = write((const uint8_t*)buffer, length);
+    if (buffer != local) {
+        delete[] buffer;
+    }
+    return written;
+}
+
+size_t Print::print(long value, int base) {
+    return print(String(value, (unsigned char)base));
+}
+
+size_t Print::print(unsigned long value, int base) {
+    return print(String(value, (unsigned char)base));
+}
+
+size_t Print::print(double value, int digits) {
+    return print(String(value, (unsigned char)digits));
+}
+
+size_t Stream::readBytes(char* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        int c = read();
+        if (c < 0) {
+            break;
+        }
+        *buffer++ = (char)c;
+        count++;
+    }
+    return count;
+}
+
+size_t Stream::readBytesUntil(char terminator, char* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        int c = read();
+        if (c < 0 || c == terminator) {
+            break;
+        }
+        *buffer++ = (char)c;
+        count++;
+    }
+    return count;
+}
+
+String Stream::readString() {
+    String result;
+    int c;
+    while ((c = read()) >= 0) {
+        result += (char)c;
+    }
+    return result;
+}
+
+String Stream::readStringUntil(char terminator) {
+    String result;
+    int c;
+    while ((c = read()) >= 0 && c != terminator) {
+        result += (char)c;
+    }
+    return result;
+}
+
+// ============================================================================
+// ESP
+// ============================================================================
+
+EspClass ESP;
+
+uint32_t EspClass::getHeapSize() {
+    return sim::kHeapTotalBytes;
+}
+
+uint32_t EspClass::getFreeHeap() {
+    const size_t live = sim::heapLiveBytes();
+    return live < sim::kHeapTotalBytes ? (uint32_t)(sim::kHeapTotalBytes - live) : 0;
+}
+
+uint32_t EspClass::getMinFreeHeap() {
+    const size_t peak = sim::heapPeakBytes();
+    return peak < sim::kHeapTotalBytes ? (uint32_t)(sim::kHeapTotalBytes - peak) : 0;
+}
+
+uint32_t EspClass::getMaxAllocHeap() {
+    return (uint32_t)sim::heapLayout().largestFreeBlock;
+}
+
+void EspClass::restart() {
+    throw sim::SimStop{ "ESP.restart()" };
+}
@@ -0,0 +1,105 @@
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+// ============================================================================
+// ARDUINO-ESP32 CORE (HOST)
+// ============================================================================
+// The subset of the ESP32 Arduino core the firmware uses, backed by the
+// simulated hardware in sim/SimHardware.h: time is virtual, GPIO and ADC
+// levels come from the scenario, Serial goes to the simulator's log.
+
+#include <cctype>
+#include <cmath>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define PULLUP 0x04
+#define INPUT_PULLUP 0x05
+#define PULLDOWN 0x08
+#define INPUT_PULLDOWN 0x09
+
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+using std::abs;
+using std::min;
+using std::max;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// Time (virtual clock)
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+// GPIO, ADC, interrupts
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalRead(uint8_t pin);
+uint16_t analogRead(uint8_t pin);
+void analogReadResolution(uint8_t bits);
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode);
+void detachInterrupt(uint8_t pin);
+inline uint8_t digitalPinToInterrupt(uint8_t pin) { return pin; }
+
+// CPU clock
+bool setCpuFrequencyMhz(uint32_t mhz);
+uint32_t getCpuFrequencyMhz();
+
+// Serial: lines are prefixed with the virtual time and written to the log
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    void end() {}
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    int availableForWrite() override { return 128; }
+    void flush() override;
+    operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+// Heap figures come from the simulator's operator new accounting
+class EspClass {
+public:
+    uint32_t getHeapSize();
+    uint32_t getFreeHeap();
+    uint32_t getMinFreeHeap();
+    uint32_t getMaxAllocHeap();
+    uint32_t getCpuFreqMHz() { return getCpuFrequencyMhz(); }
+    void restart();
+};
+
+extern EspClass ESP;
+
+#endif // SIM_ARDUINO_H
@@ -0,0 +1,542 @@
+#include "AudioTools.h"
+#include "AudioTools/Disk/AudioSourceSDMMC.h"
+#include "../SimHardware.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const int kSampleRate = 44100;
+const int kBytesPerFrame = 4;                 // 16-bit stereo
+const uint64_t kMp3BytesPerSecond = 16000;    // 128 kbit/s
+const uint32_t kDecoderMhz = 22;              // Helix at 128 kbit/s stereo, in CPU MHz
+const size_t kDecoderStateBytes = 24 * 1024;
+const uint64_t kMaxWavSilenceUs = 2000000;
+const uint32_t kSilentFrames = 64;            // Zero frames in a row that count as silence
+
+// Playback state shared by the player and the I2S queue
+bool g_playing = false;
+uint64_t g_playingSinceUs = 0;     // Last start/resume/track change
+bool g_awaitFirstFrame = false;
+std::string g_trackLabel;
+
+sim::AudioStats g_stats = {};
+
+FILE* g_wav = nullptr;
+uint64_t g_wavFrames = 0;
+
+double framesToUs(double frames) {
+    return frames * 1e6 / kSampleRate;
+}
+
+void wavWriteSilence(uint64_t us) {
+    if (!g_wav) {
+        return;
+    }
+    static const uint8_t zeros[1024] = {};
+    uint64_t bytes = std::min(us, kMaxWavSilenceUs) * kSampleRate / 1000000 * kBytesPerFrame;
+    g_wavFrames += bytes / kBytesPerFrame;
+    while (bytes > 0) {
+        const size_t chunk = (size_t)std::min<uint64_t>(bytes, sizeof(zeros));
+        fwrite(zeros, 1, chunk, g_wav);
+        bytes -= chunk;
+    }
+}
+
+void wavWrite(const uint8_t* data, size_t len) {
+    if (!g_wav) {
+        return;
+    }
+    fwrite(data, 1, len, g_wav);
+    g_wavFrames += len / kBytesPerFrame;
+}
+
+void writeLe(FILE* f, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        fputc((value >> (8 * i)) & 0xFF, f);
+    }
+}
+
+void writeWavHeader(FILE* f, uint32_t dataBytes) {
+    fwrite("RIFF", 1, 4, f);
+    writeLe(f, 36 + dataBytes, 4);
+    fwrite("WAVEfmt ", 1, 8, f);
+    writeLe(f, 16, 4);
+    writeLe(f, 1, 2);                                  // PCM
+    writeLe(f, 2, 2);
+    writeLe(f, kSampleRate, 4);
+    writeLe(f, kSampleRate * kBytesPerFrame, 4);
+    writeLe(f, kBytesPerFrame, 2);
+    writeLe(f, 16, 2);
+    fwrite("data", 1, 4, f);
+    writeLe(f, dataBytes, 4);
+}
+
+// Semitone from the path, so each track is recognisable in the recording
+double toneForPath(const char* path) {
+    uint32_t hash = 2166136261u;
+    for (const char* p = path; p && *p; p++) {
+        hash = (hash ^ (uint8_t)*p) * 16777619u;
+    }
+    return 220.0 * std::pow(2.0, (hash % 24) / 12.0);
+}
+
+// I2S DMA queue
+double g_queueEndUs = 0;          // When the last queued frame has been played
+uint64_t g_capacityFrames = 0;
+
+double queuedFrames(double nowUs) {
+    return g_queueEndUs > nowUs ? (g_queueEndUs - nowUs) * kSampleRate / 1e6 : 0.0;
+}
+
+// Sound/silence as the DAC plays it: changes are stamped with the time the
+// frame leaves the queue, which may still be ahead of the clock
+bool g_queuedAudible = false;                         // State at the end of the queue
+uint32_t g_zeroRun = 0;
+double g_zeroRunStartUs = 0;
+std::vector<std::pair<double, bool>> g_audibleChanges;   // (play time, audible), oldest first
+
+void trackAudible(const uint8_t* data, size_t frames, double startUs) {
+    for (size_t i = 0; i < frames; i++) {
+        int16_t left;
+        int16_t right;
+        memcpy(&left, data + i * kBytesPerFrame, sizeof(left));
+        memcpy(&right, data + i * kBytesPerFrame + sizeof(left), sizeof(right));
+        const double atUs = startUs + framesToUs((double)i);
+        if (left != 0 || right != 0) {
+            g_zeroRun = 0;
+            if (!g_queuedAudible) {
+                g_queuedAudible = true;
+                g_audibleChanges.push_back(std::make_pair(atUs, true));
+                sim::observeAt((uint64_t)atUs, "output", "sound");
+            }
+        } else if (g_zeroRun++ == 0) {
+            g_zeroRunStartUs = atUs;
+        } else if (g_queuedAudible && g_zeroRun >= kSilentFrames) {
+            g_queuedAudible = false;
+            g_audibleChanges.push_back(std::make_pair(g_zeroRunStartUs, false));
+            sim::observeAt((uint64_t)g_zeroRunStartUs, "output", "silent");
+        }
+    }
+}
+
+} // namespace
+
+namespace sim {
+
+const AudioStats& audioStats() {
+    return g_stats;
+}
+
+bool outputAudible() {
+    const double now = (double)nowUs();
+    if (now >= g_queueEndUs) {
+        return false;   // Queue empty: the DAC outputs zeros
+    }
+    bool audible = false;
+    size_t played = 0;
+    while (played < g_audibleChanges.size() && g_audibleChanges[played].first <= now) {
+        audible = g_audibleChanges[played].second;
+        played++;
+    }
+    if (played > 1) {
+        // Only the latest change that has been played still matters
+        Untracked untracked;
+        g_audibleChanges.erase(g_audibleChanges.begin(), g_audibleChanges.begin() + (played - 1));
+    } else if (played == 0) {
+        audible = false;
+    }
+    return audible;
+}
+
+bool openWav(const std::string& path) {
+    g_wav = fopen(path.c_str(), "wb");
+    if (!g_wav) {
+        return false;
+    }
+    writeWavHeader(g_wav, 0);
+    g_wavFrames = 0;
+    return true;
+}
+
+void closeWav() {
+    if (!g_wav) {
+        return;
+    }
+    fseek(g_wav, 0, SEEK_SET);
+    writeWavHeader(g_wav, (uint32_t)(g_wavFrames * kBytesPerFrame));
+    fclose(g_wav);
+    g_wav = nullptr;
+}
+
+} // namespace sim
+
+namespace audio_tools {
+
+// ============================================================================
+// I2S
+// ============================================================================
+
+bool I2SStream::begin(I2SConfig config) {
+    cfg = config;
+    g_capacityFrames = (uint64_t)std::max(cfg.buffer_size, 8) * (uint64_t)std::max(cfg.buffer_count, 2);
+    g_queueEndUs = (double)sim::nowUs();
+    started = true;
+    sim::setBclkRunning(true);
+    sim::advanceUs(1000);   // Driver install and DMA allocation
+    return true;
+}
+
+void I2SStream::end() {
+    started = false;
+    sim::setBclkRunning(false);
+}
+
+int I2SStream::availableForWrite() {
+    if (!started) {
+        return 0;
+    }
+    const double freeFrames = (double)g_capacityFrames - queuedFrames((double)sim::nowUs());
+    return freeFrames > 0 ? (int)freeFrames * kBytesPerFrame : 0;
+}
+
+size_t I2SStream::write(const uint8_t* data, size_t len) {
+    if (!started) {
+        return 0;
+    }
+    size_t done = 0;
+    while (done + kBytesPerFrame <= len) {
+        const uint64_t frames = std::min<uint64_t>((len - done) / kBytesPerFrame, g_capacityFrames / 2);
+        double now = (double)sim::nowUs();
+
+        // Queue ran dry: the DAC played silence since then
+        if (now > g_queueEndUs) {
+            const uint64_t gapUs = (uint64_t)(now - g_queueEndUs);
+            if (g_playing && !g_awaitFirstFrame && g_queueEndUs >= (double)g_playingSinceUs && gapUs > 0) {
+                g_stats.underruns++;
+                g_stats.underrunUs += gapUs;
+            }
+            wavWriteSilence(gapUs);
+            if (g_queuedAudible) {
+                sim::Untracked untracked;
+                g_queuedAudible = false;
+                g_audibleChanges.push_back(std::make_pair(g_queueEndUs, false));
+                sim::observeAt((uint64_t)g_queueEndUs, "output", "silent");
+            }
+            g_zeroRun = 0;
+            g_queueEndUs = now;
+        }
+
+        // Full: wait for the DMA to make room
+        const double excess = queuedFrames(now) + (double)frames - (double)g_capacityFrames;
+        if (excess > 0) {
+            const uint64_t waitUs = (uint64_t)std::ceil(framesToUs(excess));
+            sim::advanceUs(waitUs);
+            g_stats.blockedUs += waitUs;
+            now = (double)sim::nowUs();
+        }
+
+        if (g_awaitFirstFrame) {
+            g_awaitFirstFrame = false;
+            const uint64_t audibleUs = (uint64_t)std::max(now, g_queueEndUs);
+            sim::Untracked untracked;
+            sim::observeAt(audibleUs, "audio", "first frame " + g_trackLabel);
+        }
+
+        {
+            sim::Untracked untracked;
+            trackAudible(data + done, (size_t)frames, g_queueEndUs);
+        }
+        g_queueEndUs += framesToUs((double)frames);
+        g_stats.framesPlayed += frames;
+        wavWrite(data + done, (size_t)frames * kBytesPerFrame);
+        done += (size_t)frames * kBytesPerFrame;
+    }
+    return len;
+}
+
+// ============================================================================
+// VOLUME
+// ============================================================================
+
+bool VolumeStream::begin(VolumeStreamConfig config) {
+    cfg = config;
+    currentVolume = config.volume;
+    return output != nullptr;
+}
+
+bool VolumeStream::setVolume(float vol) {
+    vol = std::min(std::max(vol, 0.0f), 1.0f);
+    if (!volumeSet || std::fabs(vol - currentVolume) >= 0.005f) {
+        char detail[16];
+        snprintf(detail, sizeof(detail), "%.2f", vol);
+        sim::observe("volume", detail);
+    }
+    currentVolume = vol;
+    volumeSet = true;
+    return true;
+}
+
+size_t VolumeStream::write(const uint8_t* data, size_t len) {
+    if (!output) {
+        return 0;
+    }
+    int16_t scaled[512];
+    const size_t samples = len / sizeof(int16_t);
+    size_t done = 0;
+    while (done < samples) {
+        const size_t chunk = std::min(samples - done, sizeof(scaled) / sizeof(scaled[0]));
+        for (size_t i = 0; i < chunk; i++) {
+            int16_t sample;
+            memcpy(&sample, data + (done + i) * sizeof(int16_t), sizeof(sample));
+            scaled[i] = (int16_t)(sample * currentVolume);
+        }
+        output->write((const uint8_t*)scaled, chunk * sizeof(int16_t));
+        done += chunk;
+    }
+    return len;
+}
+
+// ============================================================================
+// DECODER
+// ============================================================================
+
+bool MP3DecoderHelix::begin() {
+    if (!state) {
+        state = new uint8_t[kDecoderStateBytes];
+    }
+    return true;
+}
+
+void MP3DecoderHelix::end() {
+    delete[] state;
+    state = nullptr;
+}
+
+// ============================================================================
+// PLAYER
+// ============================================================================
+
+AudioPlayer::AudioPlayer(AudioSource& source, Print& output, AudioDecoder& decoder)
+    : source(&source), output(&output), decoder(&decoder) {
+    setBufferSize(bufferSize);
+}
+
+void AudioPlayer::setBufferSize(int size) {
+    if (size <= 0 || (buffer && size == bufferSize)) {
+        return;
+    }
+    delete[] buffer;
+    bufferSize = size;
+    buffer = new uint8_t[bufferSize];
+}
+
+void AudioPlayer::setAudioSource(AudioSource& newSource) {
+    source = &newSource;
+    input = nullptr;
+}
+
+bool AudioPlayer::startStream(Stream* stream, const char* why) {
+    input = stream;
+    eofSinceUs = 0;
+    byteRemainder = 0;
+    if (!stream) {
+        active = false;
+        g_playing = false;
+        return false;
+    }
+    decoder->begin();
+    const fs::File* file = static_cast<const fs::File*>(stream);
+    toneHz = toneForPath(file->path());
+    tonePhase = 0.0;
+    active = true;
+    g_playing = true;
+    g_playingSinceUs = sim::nowUs();
+    g_awaitFirstFrame = true;
+    g_stats.tracksStarted++;
+    sim::Untracked untracked;
+    g_trackLabel = file->path();
+    sim::observe("audio", std::string(why) + " " + file->path());
+    return true;
+}
+
+bool AudioPlayer::begin(int index, bool isActive) {
+    source->begin();
+    if (!startStream(source->selectStream(index), "start")) {
+        return false;
+    }
+    if (!isActive) {
+        stop();
+    }
+    return true;
+}
+
+bool AudioPlayer::playPath(const char* path) {
+    return startStream(source->selectStream(path), "start");
+}
+
+bool AudioPlayer::next(int offset) {
+    return startStream(source->nextStream(offset), "next");
+}
+
+bool AudioPlayer::previous(int offset) {
+    return startStream(source->previousStream(offset), "previous");
+}
+
+bool AudioPlayer::setIndex(int index) {
+    return startStream(source->selectStream(index), "start");
+}
+
+void AudioPlayer::stop() {
+    if (active) {
+        sim::observe("audio", "stop");
+    }
+    active = false;
+    g_playing = false;
+}
+
+void AudioPlayer::play() {
+    if (!active && input) {
+        sim::observe("audio", "play");
+        g_playingSinceUs = sim::nowUs();
+        g_awaitFirstFrame = true;
+    }
+    active = input != nullptr;
+    g_playing = active;
+}
+
+void AudioPlayer::writeTone(size_t frames) {
+    int16_t pcm[256 * 2];
+    const double step = 2.0 * M_PI * toneHz / kSampleRate;
+    while (frames > 0) {
+        const size_t chunk = std::min(frames, sizeof(pcm) / sizeof(pcm[0]) / 2);
+        for (size_t i = 0; i < chunk; i++) {
+            const int16_t sample = (int16_t)(std::sin(tonePhase) * 8000.0);
+            pcm[2 * i] = sample;
+            pcm[2 * i + 1] = sample;
+            tonePhase += step;
+        }
+        tonePhase = std::fmod(tonePhase, 2.0 * M_PI);
+        output->write((const uint8_t*)pcm, chunk * kBytesPerFrame);
+        frames -= chunk;
+    }
+}
+
+size_t AudioPlayer::copy() {
+    if (!active || !input || !buffer) {
+        return 0;
+    }
+    const size_t bytes = input->readBytes(buffer, bufferSize);
+    if (bytes == 0) {
+        // End of file: the library moves on after the auto-next timeout
+        const uint64_t now = sim::nowUs();
+        if (eofSinceUs == 0) {
+            eofSinceUs = now;
+        } else if (autoNext && now - eofSinceUs >= (uint64_t)source->timeoutAutoNext() * 1000) {
+            if (!startStream(source->nextStream(1), "next")) {
+                sim::observe("audio", "end of folder");
+            }
+        }
+        return 0;
+    }
+    eofSinceUs = 0;
+
+    const uint64_t scaled = (uint64_t)bytes * kSampleRate + byteRemainder;
+    const size_t frames = (size_t)(scaled / kMp3BytesPerSecond);
+    byteRemainder = scaled % kMp3BytesPerSecond;
+
+    const uint64_t decodeUs = (uint64_t)framesToUs((double)frames) * kDecoderMhz / getCpuFrequencyMhz();
+    g_stats.decodeUs += decodeUs;
+    sim::advanceUs(decodeUs);
+    writeTone(frames);
+    return bytes;
+}
+
+// ============================================================================
+// SD SOURCE
+// ============================================================================
+
+// The library only keeps the caller's pointers; the copies are not charged
+AudioSourceSDMMC::AudioSourceSDMMC(const char* startFilePath, const char* ext, bool setupIndex) {
+    (void)setupIndex;
+    sim::Untracked untracked;
+    startPath = startFilePath ? startFilePath : "/";
+    extension = ext ? ext : ".mp3";
+}
+
+AudioSourceSDMMC::~AudioSourceSDMMC() {
+    sim::Untracked untracked;
+    names.clear();
+}
+
+void AudioSourceSDMMC::setPath(const char* path) {
+    sim::Untracked untracked;
+    startPath = path ? path : "/";
+    indexed = false;
+}
+
+// The library keeps its index in a file on the card, so the list is not
+// charged to the firmware heap; the folder walk is charged to the card
+void AudioSourceSDMMC::buildIndex() {
+    sim::Untracked untracked;
+    names.clear();
+    indexed = true;
+    File dir = SD_MMC.open(startPath.c_str());
+    if (!dir || !dir.isDirectory()) {
+        return;
+    }
+    String prefix = startPath.endsWith("/") ? startPath : startPath + "/";
+    String ext = extension;
+    ext.toLowerCase();
+    for (File entry = dir.openNextFile(); entry; entry = dir.openNextFile()) {
+        String name = entry.name();
+        String lower = name;
+        lower.toLowerCase();
+        if (!entry.isDirectory() && lower.endsWith(ext) && !name.startsWith(".")) {
+            names.push_back(prefix + name);
+        }
+    }
+    std::sort(names.begin(), names.end(), [](const String& a, const String& b) { return a.compareTo(b) < 0; });
+}
+
+void AudioSourceSDMMC::begin() {
+    if (!indexed) {
+        buildIndex();
+    }
+    idxPos = 0;
+}
+
+Stream* AudioSourceSDMMC::selectStream(int index) {
+    if (!indexed) {
+        buildIndex();
+    }
+    idxPos = index < 0 ? 0 : index;
+    if (idxPos >= (int)names.size()) {
+        return nullptr;
+    }
+    file.close();
+    file = SD_MMC.open(names[idxPos].c_str());
+    return file ? &file : nullptr;
+}
+
+Stream* AudioSourceSDMMC::selectStream(const char* path) {
+    file.close();
+    file = SD_MMC.open(path);
+    return file ? &file : nullptr;
+}
+
+Stream* AudioSourceSDMMC::nextStream(int offset) {
+    return selectStream(idxPos + offset);
+}
+
+long AudioSourceSDMMC::size() {
+    if (!indexed) {
+        buildIndex();
+    }
+    return (long)names.size();
+}
+
+} // namespace audio_tools
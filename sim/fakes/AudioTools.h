@@ -0,0 +1,207 @@
+#ifndef SIM_AUDIOTOOLS_H
+#define SIM_AUDIOTOOLS_H
+
+// ============================================================================
+// AUDIOTOOLS
+// ============================================================================
+// The parts of arduino-audio-tools the firmware uses, with the timing that
+// matters on the device:
+//
+// - AudioPlayer::copy() reads buffer_size bytes from the source stream and
+//   "decodes" them: the MP3 data is taken as 128 kbit/s and replaced by a
+//   tone whose pitch identifies the track. Decoding is charged to the clock
+//   in proportion to the audio produced and inversely to the CPU frequency.
+// - I2SStream is a DMA queue of buffer_size * buffer_count frames drained
+//   at 44.1 kHz on the virtual clock. A write into a full queue blocks (the
+//   clock moves); a queue that runs dry while playing is an underrun.
+// - Everything that reaches I2S can be recorded to a WAV file, with the
+//   silence of underruns and pauses (pauses capped at 2 s) in place.
+// ============================================================================
+
+#include <Arduino.h>
+#include <FS.h>
+#include <string>
+
+namespace audio_tools {
+
+enum RxTxMode { TX_MODE = 1, RX_MODE = 2, RXTX_MODE = 3 };
+
+struct AudioInfo {
+    int sample_rate = 44100;
+    int channels = 2;
+    int bits_per_sample = 16;
+
+    void copyFrom(const AudioInfo& info) {
+        sample_rate = info.sample_rate;
+        channels = info.channels;
+        bits_per_sample = info.bits_per_sample;
+    }
+};
+
+struct I2SConfig : AudioInfo {
+    RxTxMode rx_tx_mode = TX_MODE;
+    int pin_bck = 14;
+    int pin_ws = 15;
+    int pin_data = 22;
+    int buffer_size = 512;     // Frames per DMA buffer
+    int buffer_count = 6;
+};
+
+struct VolumeStreamConfig : AudioInfo {
+    float volume = 1.0f;
+};
+
+class AudioStream : public Stream {
+public:
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* data, size_t len) override = 0;
+    using Print::write;
+    int available() override { return 0; }
+    int read() override { return -1; }
+};
+
+// I2S output with a real-time DMA queue (see above)
+class I2SStream : public AudioStream {
+public:
+    I2SConfig defaultConfig(RxTxMode mode = TX_MODE) {
+        I2SConfig config;
+        config.rx_tx_mode = mode;
+        return config;
+    }
+    bool begin(I2SConfig config);
+    void end();
+    size_t write(const uint8_t* data, size_t len) override;
+    using AudioStream::write;
+    void flush() override {}
+    int availableForWrite() override;
+
+private:
+    I2SConfig cfg;
+    bool started = false;
+};
+
+// Scales 16-bit samples by the volume (linear) and passes them on
+class VolumeStream : public AudioStream {
+public:
+    VolumeStream() {}
+    explicit VolumeStream(Print& out) : output(&out) {}
+
+    VolumeStreamConfig defaultConfig() { return VolumeStreamConfig(); }
+    bool begin(VolumeStreamConfig config);
+    void end() {}
+    void setOutput(Print& out) { output = &out; }
+    bool setVolume(float vol);
+    float volume() const { return currentVolume; }
+    size_t write(const uint8_t* data, size_t len) override;
+    using AudioStream::write;
+
+private:
+    Print* output = nullptr;
+    VolumeStreamConfig cfg;
+    float currentVolume = 1.0f;
+    bool volumeSet = false;
+};
+
+class AudioDecoder {
+public:
+    virtual ~AudioDecoder() {}
+    virtual bool begin() { return true; }
+    virtual void end() {}
+};
+
+// Holds the Helix working buffers on the heap while running
+class MP3DecoderHelix : public AudioDecoder {
+public:
+    ~MP3DecoderHelix() override { end(); }
+    bool begin() override;
+    void end() override;
+
+private:
+    uint8_t* state = nullptr;
+};
+
+class AudioSource {
+public:
+    virtual ~AudioSource() {}
+    virtual void begin() {}
+    virtual Stream* nextStream(int offset) = 0;
+    virtual Stream* previousStream(int offset) { return nextStream(-offset); }
+    virtual Stream* selectStream(int index) { (void)index; return nullptr; }
+    virtual Stream* selectStream(const char* path) = 0;
+    virtual int index() { return 0; }
+    virtual void setPath(const char* path) { (void)path; }
+    virtual int timeoutAutoNext() { return 500; }
+};
+
+class AudioPlayer {
+public:
+    AudioPlayer(AudioSource& source, Print& output, AudioDecoder& decoder);
+    ~AudioPlayer() { delete[] buffer; }
+
+    void setBufferSize(int size);
+    bool begin(int index = 0, bool isActive = true);
+    void end() { stop(); }
+    bool playPath(const char* path);
+    bool next(int offset = 1);
+    bool previous(int offset = 1);
+    bool setIndex(int index);
+    void stop();
+    void play();
+    void setActive(bool isActive) { isActive ? play() : stop(); }
+    bool isActive() const { return active; }
+    void setAutoNext(bool next) { autoNext = next; }
+    void setAudioSource(AudioSource& source);
+    size_t copy();
+
+private:
+    AudioSource* source;
+    Print* output;
+    AudioDecoder* decoder;
+    Stream* input = nullptr;
+    uint8_t* buffer = nullptr;
+    int bufferSize = 512;
+    bool active = false;
+    bool autoNext = true;
+    uint64_t eofSinceUs = 0;       // First empty read of the current stream
+    double toneHz = 440.0;         // Pitch of the current track's tone
+    double tonePhase = 0.0;
+    uint64_t byteRemainder = 0;    // Bytes not yet turned into whole frames
+
+    bool startStream(Stream* stream, const char* why);
+    void writeTone(size_t frames);
+};
+
+class AudioLogger {
+public:
+    enum LogLevel { Debug, Info, Warning, Error };
+    static AudioLogger& instance() {
+        static AudioLogger logger;
+        return logger;
+    }
+    void begin(Print& out, LogLevel level) { (void)out; (void)level; }
+};
+
+} // namespace audio_tools
+
+using namespace audio_tools;
+
+namespace sim {
+
+struct AudioStats {
+    uint64_t framesPlayed;        // Frames written to I2S
+    uint32_t underruns;           // Times the queue ran dry while playing
+    uint64_t underrunUs;
+    uint64_t blockedUs;           // Time spent in writes waiting for the queue
+    uint64_t decodeUs;
+    uint32_t tracksStarted;
+};
+
+const AudioStats& audioStats();
+
+// Record everything written to I2S; closeWav() patches the header
+bool openWav(const std::string& path);
+void closeWav();
+
+} // namespace sim
+
+#endif // SIM_AUDIOTOOLS_H
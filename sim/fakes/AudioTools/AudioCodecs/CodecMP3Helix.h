@@ -0,0 +1,7 @@
+#ifndef SIM_CODEC_MP3_HELIX_H
+#define SIM_CODEC_MP3_HELIX_H
+
+// MP3DecoderHelix is declared with the player in AudioTools.h
+#include <AudioTools.h>
+
+#endif // SIM_CODEC_MP3_HELIX_H
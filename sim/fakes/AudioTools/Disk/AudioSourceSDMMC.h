@@ -0,0 +1,48 @@
+#ifndef SIM_AUDIO_SOURCE_SDMMC_H
+#define SIM_AUDIO_SOURCE_SDMMC_H
+
+// ============================================================================
+// AUDIOSOURCESDMMC
+// ============================================================================
+// Files with the extension in the start folder, in name order, opened
+// through SD_MMC so every access is counted. The index is built on begin()
+// by walking the folder, as the library does. Every stream handed out is
+// the file member.
+// ============================================================================
+
+#include <AudioTools.h>
+#include <SD_MMC.h>
+#include <vector>
+
+namespace audio_tools {
+
+class AudioSourceSDMMC : public AudioSource {
+public:
+    AudioSourceSDMMC(const char* startFilePath = "/", const char* ext = ".mp3", bool setupIndex = true);
+    ~AudioSourceSDMMC() override;
+
+    void begin() override;
+    void end() { file.close(); }
+    Stream* nextStream(int offset = 1) override;
+    Stream* selectStream(int index) override;
+    Stream* selectStream(const char* path) override;
+    int index() override { return idxPos; }
+    void setPath(const char* path) override;
+    long size();
+
+protected:
+    File file;
+
+private:
+    String startPath;
+    String extension;
+    std::vector<String> names;   // Full paths, sorted
+    bool indexed = false;
+    int idxPos = 0;
+
+    void buildIndex();
+};
+
+} // namespace audio_tools
+
+#endif // SIM_AUDIO_SOURCE_SDMMC_H
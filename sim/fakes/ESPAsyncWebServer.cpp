@@ -0,0 +1,290 @@
+#include "ESPAsyncWebServer.h"
+#include "../SimHardware.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+AsyncWebServer* g_running = nullptr;
+std::string g_lastBody;
+
+const size_t kSegmentBytes = 1436;   // TCP payload per body piece and per chunk
+const int kMaxTries = 100;           // RESPONSE_TRY_AGAIN in a row before the client gives up
+
+// application/x-www-form-urlencoded value
+String urlDecode(const std::string& text) {
+    std::string out;
+    for (size_t i = 0; i < text.size(); i++) {
+        if (text[i] == '+') {
+            out += ' ';
+        } else if (text[i] == '%' && i + 2 < text.size() && isxdigit((unsigned char)text[i + 1]) &&
+                   isxdigit((unsigned char)text[i + 2])) {
+            out += (char)strtoul(text.substr(i + 1, 2).c_str(), nullptr, 16);
+            i += 2;
+        } else {
+            out += text[i];
+        }
+    }
+    return String(out.c_str(), out.size());
+}
+
+void parseArgs(const std::string& query, std::map<std::string, String>& args) {
+    size_t start = 0;
+    while (start < query.size()) {
+        size_t end = query.find('&', start);
+        if (end == std::string::npos) {
+            end = query.size();
+        }
+        const std::string pair = query.substr(start, end - start);
+        const size_t equals = pair.find('=');
+        if (!pair.empty()) {
+            args[urlDecode(pair.substr(0, equals)).c_str()] =
+                equals == std::string::npos ? String("") : urlDecode(pair.substr(equals + 1));
+        }
+        start = end + 1;
+    }
+}
+
+// One request from the moment its handler ran until the client has read
+// the whole response
+struct Exchange {
+    AsyncWebServerRequest* request;
+    std::string detail;      // "GET /folders"
+    std::string received;
+    int code;
+    int tries;               // RESPONSE_TRY_AGAIN in a row
+    bool stalled;
+};
+
+std::vector<Exchange*> g_streaming;   // Read one segment at a time
+const uint64_t kSegmentIntervalUs = 5000;
+
+// Read the next piece of the response; true once it is complete (or stalled)
+bool readSegment(Exchange& exchange) {
+    AsyncWebServerResponse* response = exchange.request->response;
+    if (!response || !response->filler) {
+        return true;
+    }
+    uint8_t buffer[kSegmentBytes];
+    size_t count;
+    {
+        sim::Tracked tracked;
+        sim::OtherCore asyncTcp;
+        count = response->filler(buffer, sizeof(buffer), exchange.received.size());
+    }
+    if (count == RESPONSE_TRY_AGAIN) {
+        exchange.stalled = ++exchange.tries >= kMaxTries;
+        return exchange.stalled;
+    }
+    if (count == 0) {
+        return true;
+    }
+    exchange.tries = 0;
+    exchange.received.append((const char*)buffer, count);
+    return false;
+}
+
+// Release the request as AsyncTCP does once the client has the response
+void finish(Exchange* exchange) {
+    {
+        sim::Tracked tracked;
+        sim::OtherCore asyncTcp;
+        delete exchange->request->response;
+        exchange->request->response = nullptr;
+        free(exchange->request->_tempObject);
+        exchange->request->_tempObject = nullptr;
+    }
+    if (exchange->stalled || exchange->code >= 400) {
+        sim::counters().httpErrors++;
+    }
+    g_lastBody = exchange->received;
+    std::string detail = exchange->detail + " " + std::to_string(exchange->code) + " " +
+                         std::to_string(exchange->received.size()) + " bytes";
+    sim::observe("http", exchange->stalled ? detail + " stalled" : detail);
+    delete exchange->request;
+    delete exchange;
+}
+
+void scheduleSegment(Exchange* exchange) {
+    sim::schedule(sim::nowUs() + kSegmentIntervalUs, [exchange]() {
+        sim::Untracked untracked;
+        if (!readSegment(*exchange)) {
+            scheduleSegment(exchange);
+            return;
+        }
+        g_streaming.erase(std::find(g_streaming.begin(), g_streaming.end(), exchange));
+        finish(exchange);
+    });
+}
+
+// Run the route's handler; nullptr if the server is not running
+Exchange* start(const std::string& method, const std::string& url, const std::string& body) {
+    sim::SimCounters& c = sim::counters();
+    c.httpRequests++;
+    const std::string detail = method + " " + url;
+    if (!g_running) {
+        c.httpErrors++;
+        g_lastBody.clear();
+        sim::observe("http", detail + " refused");
+        return nullptr;
+    }
+
+    // Parsing belongs to AsyncTCP; only the handler's own work is counted
+    sim::Untracked untracked;
+    const WebRequestMethod verb = method == "POST" ? HTTP_POST : HTTP_GET;
+    const size_t query = url.find('?');
+    Exchange* exchange = new Exchange{ nullptr, detail, std::string(), 404, 0, false };
+    exchange->request = new AsyncWebServerRequest(verb, url.substr(0, query), body.size());
+    if (query != std::string::npos) {
+        parseArgs(url.substr(query + 1), exchange->request->args);
+    }
+    if (verb == HTTP_POST && !body.empty() && body[0] != '{') {
+        parseArgs(body, exchange->request->args);
+    }
+
+    bool handled;
+    {
+        sim::Tracked tracked;
+        sim::OtherCore asyncTcp;
+        handled = g_running->handle(*exchange->request, body);
+    }
+    if (handled && exchange->request->response) {
+        exchange->code = exchange->request->response->code;
+        exchange->received = exchange->request->response->content;
+    }
+    return exchange;
+}
+
+} // namespace
+
+// ============================================================================
+// REQUEST
+// ============================================================================
+
+void AsyncWebServerRequest::send(AsyncWebServerResponse* sent) {
+    delete response;
+    response = sent;
+}
+
+void AsyncWebServerRequest::send(int code, const char* contentType, const char* content) {
+    (void)contentType;
+    AsyncWebServerResponse* sent = new AsyncWebServerResponse(code);
+    if (content) {
+        sent->content = content;
+    }
+    send(sent);
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginChunkedResponse(const char* contentType, AwsResponseFiller filler) {
+    (void)contentType;
+    AsyncWebServerResponse* chunked = new AsyncWebServerResponse(200);
+    chunked->filler = filler;
+    return chunked;
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(int code, const char* contentType, const char* content) {
+    (void)contentType;
+    AsyncWebServerResponse* created = new AsyncWebServerResponse(code);
+    if (content) {
+        created->content = content;
+    }
+    return created;
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(int code, const char* contentType, const uint8_t* content,
+                                                             size_t length) {
+    (void)contentType;
+    AsyncWebServerResponse* created = new AsyncWebServerResponse(code);
+    created->content.assign((const char*)content, length);
+    return created;
+}
+
+const String& AsyncWebServerRequest::arg(const char* name) const {
+    std::map<std::string, String>::const_iterator it = args.find(name);
+    return it == args.end() ? empty : it->second;
+}
+
+// ============================================================================
+// SERVER
+// ============================================================================
+
+AsyncWebServer::~AsyncWebServer() {
+    end();
+}
+
+void AsyncWebServer::begin() {
+    g_running = this;
+}
+
+void AsyncWebServer::end() {
+    if (g_running == this) {
+        g_running = nullptr;
+    }
+}
+
+AsyncCallbackWebHandler& AsyncWebServer::on(const char* uri, WebRequestMethodComposite method,
+                                            ArRequestHandlerFunction onRequest, ArUploadHandlerFunction onUpload,
+                                            ArBodyHandlerFunction onBody) {
+    (void)onUpload;
+    sim::Untracked untracked;
+    routes.push_back(Route{ uri, method, onRequest, onBody });
+    return handler;
+}
+
+bool AsyncWebServer::handle(AsyncWebServerRequest& request, const std::string& body) {
+    for (const Route& route : routes) {
+        if (route.uri != request.url || !(route.method & request.method)) {
+            continue;
+        }
+        if (route.onBody) {
+            for (size_t index = 0; index < body.size(); index += kSegmentBytes) {
+                const size_t length = std::min(kSegmentBytes, body.size() - index);
+                route.onBody(&request, (uint8_t*)body.data() + index, length, index, body.size());
+            }
+        }
+        route.onRequest(&request);
+        return true;
+    }
+    return false;
+}
+
+// ============================================================================
+// CLIENT
+// ============================================================================
+
+namespace sim {
+
+int httpRequest(const std::string& method, const std::string& url, const std::string& body) {
+    Exchange* exchange = start(method, url, body);
+    if (!exchange) {
+        return 0;
+    }
+    Untracked untracked;
+    while (!readSegment(*exchange)) {
+    }
+    const int code = exchange->code;
+    finish(exchange);
+    return code;
+}
+
+int httpStream(const std::string& method, const std::string& url, const std::string& body) {
+    Exchange* exchange = start(method, url, body);
+    if (!exchange) {
+        return 0;
+    }
+    Untracked untracked;
+    g_streaming.push_back(exchange);
+    scheduleSegment(exchange);
+    return exchange->code;
+}
+
+size_t httpStreaming() {
+    return g_streaming.size();
+}
+
+const std::string& lastHttpBody() {
+    return g_lastBody;
+}
+
+} // namespace sim
@@ -0,0 +1,146 @@
+#ifndef SIM_ESPASYNCWEBSERVER_H
+#define SIM_ESPASYNCWEBSERVER_H
+
+// ============================================================================
+// ESPASYNCWEBSERVER
+// ============================================================================
+// Routes registered with on() are dispatched by sim::httpRequest() and
+// sim::httpStream() (the scenario's "http" events) while the server is
+// running. The handler runs as on the AsyncTCP task: inside an OtherCore
+// scope, with the body fed to the body callback in TCP-sized pieces and
+// chunked responses read one chunk at a time, either at once or one chunk
+// per 5 ms so several requests are in flight together. Headers and
+// server-sent events are not modelled.
+// ============================================================================
+
+#include <Arduino.h>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+// Returned by a chunk filler that has nothing yet; the chunk is asked again
+#define RESPONSE_TRY_AGAIN 0xFFFFFFFF
+
+typedef enum {
+    HTTP_GET = 0b00000001,
+    HTTP_POST = 0b00000010,
+    HTTP_ANY = 0b01111111
+} WebRequestMethod;
+typedef uint8_t WebRequestMethodComposite;
+
+typedef std::function<size_t(uint8_t*, size_t, size_t)> AwsResponseFiller;
+
+class AsyncWebServerResponse {
+public:
+    explicit AsyncWebServerResponse(int code = 200) : code(code) {}
+    virtual ~AsyncWebServerResponse() {}
+    void addHeader(const char* name, const char* value, bool replace = true) { (void)name; (void)value; (void)replace; }
+    void addHeader(const String& name, const String& value) { (void)name; (void)value; }
+    void setCode(int code) { this->code = code; }
+    void setContentLength(size_t length) { (void)length; }
+
+    // Simulator side
+    int code;
+    std::string content;
+    AwsResponseFiller filler;   // Chunked responses
+};
+
+class AsyncResponseStream : public AsyncWebServerResponse, public Print {
+public:
+    size_t write(uint8_t c) override { content += (char)c; return 1; }
+    size_t write(const uint8_t* buffer, size_t size) override { content.append((const char*)buffer, size); return size; }
+    using Print::write;
+};
+
+class AsyncWebServerRequest {
+public:
+    void* _tempObject = nullptr;
+
+    AsyncWebServerRequest(WebRequestMethod method, const std::string& url, size_t contentLength)
+        : response(nullptr), method(method), url(url), length(contentLength) {}
+
+    void send(AsyncWebServerResponse* response);
+    void send(int code, const char* contentType = nullptr, const char* content = nullptr);
+    void send(int code, const char* contentType, const String& content) { send(code, contentType, content.c_str()); }
+    AsyncResponseStream* beginResponseStream(const char* contentType, size_t bufferSize = 1460) {
+        (void)contentType; (void)bufferSize;
+        return new AsyncResponseStream();
+    }
+    AsyncWebServerResponse* beginChunkedResponse(const char* contentType, AwsResponseFiller filler);
+    AsyncWebServerResponse* beginResponse(int code, const char* contentType = nullptr, const char* content = nullptr);
+    AsyncWebServerResponse* beginResponse(int code, const char* contentType, const uint8_t* content, size_t length);
+    bool hasHeader(const char* name) const { (void)name; return false; }
+    const String& header(const char* name) const { (void)name; return empty; }
+    bool hasArg(const char* name) const { return args.count(name) > 0; }
+    const String& arg(const char* name) const;
+    size_t contentLength() const { return length; }
+
+    // Simulator side
+    AsyncWebServerResponse* response;   // Sent by the handler
+    std::map<std::string, String> args;
+    WebRequestMethod method;
+    std::string url;
+
+private:
+    size_t length;
+    String empty;
+};
+
+typedef std::function<void(AsyncWebServerRequest*)> ArRequestHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest*, const String&, size_t, uint8_t*, size_t, bool)> ArUploadHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> ArBodyHandlerFunction;
+
+class AsyncWebHandler {
+public:
+    virtual ~AsyncWebHandler() {}
+};
+
+class AsyncCallbackWebHandler : public AsyncWebHandler {};
+
+class AsyncEventSourceClient {
+public:
+    bool send(const char* message, const char* event = nullptr, uint32_t id = 0, uint32_t reconnect = 0) {
+        (void)message; (void)event; (void)id; (void)reconnect;
+        return true;
+    }
+};
+
+class AsyncEventSource : public AsyncWebHandler {
+public:
+    explicit AsyncEventSource(const char* url) { (void)url; }
+    void onConnect(std::function<void(AsyncEventSourceClient*)> callback) { (void)callback; }
+    void send(const char* message, const char* event = nullptr, uint32_t id = 0, uint32_t reconnect = 0) {
+        (void)message; (void)event; (void)id; (void)reconnect;
+    }
+    size_t count() const { return 0; }
+    void close() {}
+};
+
+class AsyncWebServer {
+public:
+    explicit AsyncWebServer(uint16_t port) { (void)port; }
+    ~AsyncWebServer();
+    void begin();
+    void end();
+    AsyncCallbackWebHandler& on(const char* uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest,
+                                ArUploadHandlerFunction onUpload = nullptr, ArBodyHandlerFunction onBody = nullptr);
+    AsyncWebHandler& addHandler(AsyncWebHandler* h) { return *h; }
+    void onNotFound(ArRequestHandlerFunction fn) { (void)fn; }
+
+    // Simulator side: run the matching route, false if there is none
+    bool handle(AsyncWebServerRequest& request, const std::string& body);
+
+private:
+    struct Route {
+        std::string uri;
+        WebRequestMethodComposite method;
+        ArRequestHandlerFunction onRequest;
+        ArBodyHandlerFunction onBody;
+    };
+
+    std::vector<Route> routes;
+    AsyncCallbackWebHandler handler;
+};
+
+#endif // SIM_ESPASYNCWEBSERVER_H
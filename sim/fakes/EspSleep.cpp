@@ -0,0 +1,113 @@
+#include "esp_sleep.h"
+#include "../SimHardware.h"
+
+namespace {
+
+uint64_t g_timerWakeUs = 0;        // 0 = timer wake not armed
+bool g_gpioWakeArmed = false;
+esp_sleep_wakeup_cause_t g_wakeCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+
+const uint64_t kLightSleepEntryUs = 300;   // Entry plus wake-up latency
+
+} // namespace
+
+// ============================================================================
+// GPIO DRIVER
+// ============================================================================
+
+esp_err_t gpio_pullup_en(gpio_num_t gpio_num) {
+    (void)gpio_num;
+    return ESP_OK;
+}
+
+esp_err_t gpio_pullup_dis(gpio_num_t gpio_num) {
+    (void)gpio_num;
+    return ESP_OK;
+}
+
+esp_err_t gpio_intr_enable(gpio_num_t gpio_num) {
+    sim::setIsrEnabled((uint8_t)gpio_num, true);
+    return ESP_OK;
+}
+
+esp_err_t gpio_intr_disable(gpio_num_t gpio_num) {
+    sim::setIsrEnabled((uint8_t)gpio_num, false);
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_intr_type(gpio_num_t gpio_num, gpio_int_type_t intr_type) {
+    (void)gpio_num;
+    (void)intr_type;
+    return ESP_OK;
+}
+
+// Any change of an armed pin wakes; the firmware always arms the level
+// opposite to the current one
+esp_err_t gpio_wakeup_enable(gpio_num_t gpio_num, gpio_int_type_t intr_type) {
+    if (intr_type != GPIO_INTR_LOW_LEVEL && intr_type != GPIO_INTR_HIGH_LEVEL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    sim::setWakeEnabled((uint8_t)gpio_num, true);
+    return ESP_OK;
+}
+
+esp_err_t gpio_wakeup_disable(gpio_num_t gpio_num) {
+    sim::setWakeEnabled((uint8_t)gpio_num, false);
+    return ESP_OK;
+}
+
+// ============================================================================
+// SLEEP
+// ============================================================================
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us) {
+    g_timerWakeUs = time_in_us;
+    return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_gpio_wakeup() {
+    g_gpioWakeArmed = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_ext0_wakeup(gpio_num_t gpio_num, int level) {
+    (void)gpio_num;
+    (void)level;
+    return ESP_OK;
+}
+
+esp_err_t esp_sleep_disable_wakeup_source(esp_sleep_source_t source) {
+    if (source == ESP_SLEEP_WAKEUP_ALL || source == ESP_SLEEP_WAKEUP_TIMER) {
+        g_timerWakeUs = 0;
+    }
+    if (source == ESP_SLEEP_WAKEUP_ALL || source == ESP_SLEEP_WAKEUP_GPIO) {
+        g_gpioWakeArmed = false;
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_light_sleep_start() {
+    if (g_timerWakeUs == 0 && !g_gpioWakeArmed) {
+        return ESP_FAIL;   // Would never wake
+    }
+    const uint64_t start = sim::nowUs();
+    const uint64_t until = g_timerWakeUs ? start + g_timerWakeUs : UINT64_MAX;
+    const bool pinWoke = sim::sleepUntil(until) && g_gpioWakeArmed;
+    sim::advanceUs(kLightSleepEntryUs);
+
+    sim::SimCounters& c = sim::counters();
+    c.lightSleeps++;
+    c.lightSleepUs += sim::nowUs() - start;
+    g_wakeCause = pinWoke ? ESP_SLEEP_WAKEUP_GPIO : ESP_SLEEP_WAKEUP_TIMER;
+    return ESP_OK;
+}
+
+void esp_deep_sleep_start() {
+    sim::uartFlush(true);
+    sim::observe("sleep", "deep");
+    throw sim::SimStop{ "deep sleep" };
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause() {
+    return g_wakeCause;
+}
@@ -0,0 +1,397 @@
+#include "FS.h"
+#include "SD_MMC.h"
+#include "../SimHardware.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <system_error>
+#include <vector>
+
+namespace stdfs = std::filesystem;
+
+// ============================================================================
+// SD TIMING
+// ============================================================================
+// Rough cost of each operation on a 1-bit SDMMC card at 20 MHz (~2.5 MB/s,
+// FAT lookups and directory updates in the milliseconds). Good enough to
+// show which code paths touch the card, not a model of a specific card.
+
+namespace {
+
+const uint64_t kOpenUs = 1000;
+const uint64_t kOpenMissUs = 500;
+const uint64_t kDirEntryUs = 300;
+const uint64_t kCallUs = 100;          // Per read()/write() call
+const double kReadUsPerByte = 0.4;
+const double kWriteUsPerByte = 0.5;
+const uint64_t kSeekUs = 50;
+const uint64_t kCloseWrittenUs = 3000; // Directory entry and FAT update
+const uint64_t kExistsUs = 500;
+const uint64_t kMetadataUs = 3000;     // mkdir, remove, rename
+
+void charge(uint64_t us) {
+    sim::advanceUs(us);
+}
+
+} // namespace
+
+namespace fs {
+
+// ============================================================================
+// FILE IMPLEMENTATION
+// ============================================================================
+
+class FileImpl {
+public:
+    std::string path;       // Path on the card
+    std::string host;       // Path on the host
+    FILE* fp = nullptr;
+    bool directory = false;
+    bool written = false;
+    std::vector<std::string> entries;   // Directory: child names, sorted
+    size_t nextEntry = 0;
+    FS* owner = nullptr;
+
+    // Destructors must not move the clock (it may throw SimStop)
+    ~FileImpl() { close(false); }
+
+    void close(bool charged) {
+        if (fp) {
+            fclose(fp);
+            fp = nullptr;
+            if (written && charged) {
+                charge(kCloseWrittenUs);
+            }
+        }
+        directory = false;
+    }
+
+    bool isOpen() const { return fp || directory; }
+
+    const char* name() const {
+        const size_t slash = path.rfind('/');
+        return slash == std::string::npos ? path.c_str() : path.c_str() + slash + 1;
+    }
+};
+
+size_t File::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t File::write(const uint8_t* buffer, size_t size) {
+    if (!impl || !impl->fp) {
+        return 0;
+    }
+    sim::SimCounters& c = sim::counters();
+    c.sdWriteCalls++;
+    c.sdBytesWritten += size;
+    impl->written = true;
+    charge(kCallUs + (uint64_t)(size * kWriteUsPerByte));
+    return fwrite(buffer, 1, size, impl->fp);
+}
+
+int File::available() {
+    if (!impl || !impl->fp) {
+        return 0;
+    }
+    const long remaining = (long)size() - (long)position();
+    return remaining > 0 ? (int)remaining : 0;
+}
+
+int File::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::peek() {
+    if (!impl || !impl->fp) {
+        return -1;
+    }
+    const int c = fgetc(impl->fp);
+    if (c != EOF) {
+        ungetc(c, impl->fp);
+    }
+    return c == EOF ? -1 : c;
+}
+
+void File::flush() {
+    if (impl && impl->fp) {
+        fflush(impl->fp);
+    }
+}
+
+size_t File::read(uint8_t* buffer, size_t size) {
+    if (!impl || !impl->fp) {
+        return 0;
+    }
+    const size_t n = fread(buffer, 1, size, impl->fp);
+    sim::SimCounters& c = sim::counters();
+    c.sdReadCalls++;
+    c.sdBytesRead += n;
+    charge(kCallUs + (uint64_t)(n * kReadUsPerByte));
+    return n;
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+    if (!impl || !impl->fp) {
+        return false;
+    }
+    sim::counters().sdSeeks++;
+    charge(kSeekUs);
+    const int whence = mode == SeekCur ? SEEK_CUR : (mode == SeekEnd ? SEEK_END : SEEK_SET);
+    return fseek(impl->fp, (long)pos, whence) == 0;
+}
+
+size_t File::position() const {
+    if (!impl || !impl->fp) {
+        return 0;
+    }
+    const long pos = ftell(impl->fp);
+    return pos < 0 ? 0 : (size_t)pos;
+}
+
+size_t File::size() const {
+    if (!impl || !impl->fp) {
+        return 0;
+    }
+    fflush(impl->fp);
+    sim::Untracked untracked;
+    std::error_code ec;
+    const uintmax_t bytes = stdfs::file_size(impl->host, ec);
+    return ec ? 0 : (size_t)bytes;
+}
+
+void File::close() {
+    if (impl) {
+        impl->close(true);
+        impl.reset();
+    }
+}
+
+File::operator bool() const {
+    return impl && impl->isOpen();
+}
+
+time_t File::getLastWrite() {
+    if (!impl) {
+        return 0;
+    }
+    sim::Untracked untracked;
+    std::error_code ec;
+    const auto modified = stdfs::last_write_time(impl->host, ec);
+    if (ec) {
+        return 0;
+    }
+    const auto system = std::chrono::time_point_cast<std::chrono::system_clock::duration>(
+        modified - stdfs::file_time_type::clock::now() + std::chrono::system_clock::now());
+    return std::chrono::system_clock::to_time_t(system);
+}
+
+const char* File::path() const {
+    return impl ? impl->path.c_str() : "";
+}
+
+const char* File::name() const {
+    return impl ? impl->name() : "";
+}
+
+bool File::isDirectory() {
+    return impl && impl->directory;
+}
+
+File File::openNextFile(const char* mode) {
+    if (!impl || !impl->directory || !impl->owner) {
+        return File();
+    }
+    sim::counters().sdDirEntries++;
+    charge(kDirEntryUs);
+    if (impl->nextEntry >= impl->entries.size()) {
+        return File();
+    }
+    std::string child;
+    {
+        sim::Untracked untracked;
+        child = impl->path == "/" ? "/" : impl->path + "/";
+        child += impl->entries[impl->nextEntry++];
+    }
+    return impl->owner->open(child.c_str(), mode);
+}
+
+void File::rewindDirectory() {
+    if (impl) {
+        impl->nextEntry = 0;
+    }
+}
+
+// ============================================================================
+// FILE SYSTEM
+// ============================================================================
+
+std::string FS::hostPath(const char* path) const {
+    std::string p = path ? path : "";
+    if (p.empty() || p[0] != '/') {
+        p = "/" + p;
+    }
+    while (p.size() > 1 && p.back() == '/') {
+        p.pop_back();
+    }
+    return hostRoot + p;
+}
+
+File FS::open(const char* path, const char* mode, const bool create) {
+    if (!mounted || !path || path[0] != '/') {
+        return File();
+    }
+    sim::Untracked untracked;   // Host path handling is not the device's heap
+    const std::string host = hostPath(path);
+    std::error_code ec;
+    const bool isDir = stdfs::is_directory(host, ec);
+    const bool reading = !mode || mode[0] == 'r';
+
+    if (reading && !isDir && !stdfs::exists(host, ec)) {
+        sim::counters().sdOpenFailures++;
+        charge(kOpenMissUs);
+        return File();
+    }
+    if (!reading) {
+        const stdfs::path parent = stdfs::path(host).parent_path();
+        if (isDir || (!stdfs::is_directory(parent, ec) && !create)) {
+            sim::counters().sdOpenFailures++;
+            charge(kOpenMissUs);
+            return File();
+        }
+        if (create) {
+            stdfs::create_directories(parent, ec);
+        }
+    }
+
+    // The handle stands in for the VFS's FILE, so it is charged to the heap
+    FileImplPtr impl;
+    {
+        sim::Tracked tracked;
+        impl = std::make_shared<FileImpl>();
+    }
+    impl->path = path;
+    if (impl->path.size() > 1 && impl->path.back() == '/') {
+        impl->path.pop_back();
+    }
+    impl->host = host;
+    impl->owner = this;
+
+    if (isDir) {
+        impl->directory = true;
+        for (const stdfs::directory_entry& entry : stdfs::directory_iterator(host, ec)) {
+            impl->entries.push_back(entry.path().filename().string());
+        }
+        std::sort(impl->entries.begin(), impl->entries.end());
+    } else {
+        const char* hostMode = reading ? "rb" : (mode[0] == 'a' ? "ab+" : "wb+");
+        if (reading && mode && strchr(mode, '+')) {
+            hostMode = "rb+";
+        }
+        impl->fp = fopen(host.c_str(), hostMode);
+        if (!impl->fp) {
+            sim::counters().sdOpenFailures++;
+            charge(kOpenMissUs);
+            return File();
+        }
+    }
+    sim::counters().sdOpens++;
+    charge(kOpenUs);
+    return File(impl);
+}
+
+bool FS::exists(const char* path) {
+    if (!mounted || !path) {
+        return false;
+    }
+    sim::counters().sdExists++;
+    charge(kExistsUs);
+    sim::Untracked untracked;
+    std::error_code ec;
+    return stdfs::exists(hostPath(path), ec);
+}
+
+bool FS::remove(const char* path) {
+    if (!mounted || !path) {
+        return false;
+    }
+    sim::counters().sdRemoves++;
+    charge(kMetadataUs);
+    sim::Untracked untracked;
+    std::error_code ec;
+    const std::string host = hostPath(path);
+    return stdfs::is_regular_file(host, ec) && stdfs::remove(host, ec);
+}
+
+bool FS::rename(const char* from, const char* to) {
+    if (!mounted || !from || !to) {
+        return false;
+    }
+    sim::counters().sdRenames++;
+    charge(kMetadataUs);
+    sim::Untracked untracked;
+    std::error_code ec;
+    const std::string target = hostPath(to);
+    if (stdfs::exists(target, ec)) {
+        return false;   // FAT VFS does not replace an existing file
+    }
+    stdfs::rename(hostPath(from), target, ec);
+    return !ec;
+}
+
+bool FS::mkdir(const char* path) {
+    if (!mounted || !path) {
+        return false;
+    }
+    sim::counters().sdMkdirs++;
+    charge(kMetadataUs);
+    sim::Untracked untracked;
+    std::error_code ec;
+    return stdfs::create_directory(hostPath(path), ec) && !ec;
+}
+
+bool FS::rmdir(const char* path) {
+    if (!mounted || !path) {
+        return false;
+    }
+    sim::counters().sdRemoves++;
+    charge(kMetadataUs);
+    sim::Untracked untracked;
+    std::error_code ec;
+    const std::string host = hostPath(path);
+    return stdfs::is_directory(host, ec) && stdfs::remove(host, ec);
+}
+
+// ============================================================================
+// SD_MMC
+// ============================================================================
+
+bool SDMMCFS::begin(const char* mountpoint, bool mode1bit, bool formatOnFail, int sdmmcFrequency,
+                    uint8_t maxOpenFiles) {
+    (void)mountpoint;
+    (void)mode1bit;
+    (void)formatOnFail;
+    (void)sdmmcFrequency;
+    (void)maxOpenFiles;
+    std::error_code ec;
+    charge(50000);   // Card init and FAT mount
+    mounted = !hostRoot.empty() && stdfs::is_directory(hostRoot, ec);
+    return mounted;
+}
+
+uint64_t SDMMCFS::usedBytes() {
+    sim::Untracked untracked;
+    uint64_t used = 0;
+    std::error_code ec;
+    for (const stdfs::directory_entry& entry : stdfs::recursive_directory_iterator(hostRoot, ec)) {
+        if (entry.is_regular_file(ec)) {
+            used += entry.file_size(ec);
+        }
+    }
+    return used;
+}
+
+} // namespace fs
+
+fs::SDMMCFS SD_MMC;
@@ -0,0 +1,110 @@
+#ifndef SIM_FS_H
+#define SIM_FS_H
+
+// ============================================================================
+// FS (HOST)
+// ============================================================================
+// fs::FS and fs::File over a host directory that stands in for the SD card.
+// Behaves like the ESP32 FAT VFS where the firmware could tell the
+// difference: name() is the base name, rename() onto an existing file
+// fails, writing needs the parent directory. Directory entries come back in
+// name order (FAT returns creation order) so runs are reproducible.
+//
+// Every operation is counted for the report and charged to the virtual
+// clock with a rough 1-bit SDMMC cost (see FS.cpp).
+// ============================================================================
+
+#include <Arduino.h>
+#include <memory>
+#include <string>
+#include <ctime>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+enum SeekMode {
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+};
+
+class FileImpl;
+typedef std::shared_ptr<FileImpl> FileImplPtr;
+
+class File : public Stream {
+public:
+    File(FileImplPtr impl = FileImplPtr()) : impl(impl) {}
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    int available() override;
+    int read() override;
+    int peek() override;
+    void flush() override;
+    size_t read(uint8_t* buffer, size_t size);
+    size_t readBytes(char* buffer, size_t length) override { return read((uint8_t*)buffer, length); }
+
+    bool seek(uint32_t pos, SeekMode mode);
+    bool seek(uint32_t pos) { return seek(pos, SeekSet); }
+    size_t position() const;
+    size_t size() const;
+    void close();
+    operator bool() const;
+    time_t getLastWrite();
+    const char* path() const;
+    const char* name() const;
+
+    bool isDirectory();
+    File openNextFile(const char* mode = FILE_READ);
+    void rewindDirectory();
+
+private:
+    FileImplPtr impl;
+};
+
+class FS {
+public:
+    explicit FS(const char* label = "sd") : label(label) {}
+    virtual ~FS() {}
+
+    // Host directory that holds the card's files
+    void setHostRoot(const std::string& dir) { hostRoot = dir; }
+    const std::string& getHostRoot() const { return hostRoot; }
+
+    File open(const char* path, const char* mode = FILE_READ, const bool create = false);
+    File open(const String& path, const char* mode = FILE_READ, const bool create = false) {
+        return open(path.c_str(), mode, create);
+    }
+    bool exists(const char* path);
+    bool exists(const String& path) { return exists(path.c_str()); }
+    bool remove(const char* path);
+    bool remove(const String& path) { return remove(path.c_str()); }
+    bool rename(const char* from, const char* to);
+    bool rename(const String& from, const String& to) { return rename(from.c_str(), to.c_str()); }
+    bool mkdir(const char* path);
+    bool mkdir(const String& path) { return mkdir(path.c_str()); }
+    bool rmdir(const char* path);
+    bool rmdir(const String& path) { return rmdir(path.c_str()); }
+
+protected:
+    const char* label;
+    std::string hostRoot;
+    bool mounted = false;
+
+    std::string hostPath(const char* path) const;
+};
+
+} // namespace fs
+
+using fs::File;
+using fs::FS;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
+
+#endif // SIM_FS_H
@@ -0,0 +1,33 @@
+#include "FastLED.h"
+#include "../SimHardware.h"
+
+CFastLED FastLED;
+
+// ~30 us per WS2812B pixel on the wire
+void CFastLED::show() {
+    sim::counters().ledShows++;
+    sim::advanceUs(30 * (uint64_t)(ledCount > 0 ? ledCount : 1) + 50);
+    if (!leds || ledCount <= 0) {
+        return;
+    }
+    CRGB shown = leds[0];
+    if (brightness != 255) {
+        shown.nscale8(brightness);
+    }
+    const uint32_t packed = ((uint32_t)shown.r << 16) | ((uint32_t)shown.g << 8) | shown.b;
+    if (packed != lastShown) {
+        lastShown = packed;
+        char detail[16];
+        snprintf(detail, sizeof(detail), "%u,%u,%u", shown.r, shown.g, shown.b);
+        sim::observe("led", detail);
+    }
+}
+
+void CFastLED::clear(bool writeData) {
+    for (int i = 0; i < ledCount; i++) {
+        leds[i] = CRGB::Black;
+    }
+    if (writeData) {
+        show();
+    }
+}
@@ -0,0 +1,84 @@
+#ifndef SIM_FASTLED_H
+#define SIM_FASTLED_H
+
+// ============================================================================
+// FASTLED
+// ============================================================================
+// CRGB with the scaling the renderer relies on; show() pushes the first LED,
+// with global brightness applied, to the report as an "led" observation.
+// ============================================================================
+
+#include <Arduino.h>
+
+struct CRGB {
+    uint8_t r = 0;
+    uint8_t g = 0;
+    uint8_t b = 0;
+
+    enum HTMLColorCode : uint32_t {
+        Black = 0x000000,
+        Blue = 0x0000FF,
+        Cyan = 0x00FFFF,
+        Green = 0x008000,
+        Magenta = 0xFF00FF,
+        Orange = 0xFFA500,
+        Purple = 0x800080,
+        Red = 0xFF0000,
+        White = 0xFFFFFF,
+        Yellow = 0xFFFF00
+    };
+
+    CRGB() {}
+    CRGB(uint32_t colorcode) : r((colorcode >> 16) & 0xFF), g((colorcode >> 8) & 0xFF), b(colorcode & 0xFF) {}
+    CRGB(HTMLColorCode colorcode) : CRGB((uint32_t)colorcode) {}
+    CRGB(uint8_t red, uint8_t green, uint8_t blue) : r(red), g(green), b(blue) {}
+
+    bool operator==(const CRGB& other) const { return r == other.r && g == other.g && b == other.b; }
+    bool operator!=(const CRGB& other) const { return !(*this == other); }
+
+    // scale8 with FASTLED_SCALE8_FIXED: 255 keeps the value unchanged
+    CRGB& nscale8(uint8_t scale) {
+        r = scaleChannel(r, scale);
+        g = scaleChannel(g, scale);
+        b = scaleChannel(b, scale);
+        return *this;
+    }
+    CRGB& fadeToBlackBy(uint8_t amount) { return nscale8(255 - amount); }
+
+    static uint8_t scaleChannel(uint8_t value, uint8_t scale) {
+        return (uint8_t)(((int)value * (1 + (int)scale)) >> 8);
+    }
+};
+
+enum EOrder { RGB = 0012, GRB = 0102 };
+
+template <uint8_t DATA_PIN, EOrder RGB_ORDER = GRB>
+class WS2812B {};
+
+class CFastLED {
+public:
+    template <template <uint8_t, EOrder> class CHIPSET, uint8_t DATA_PIN, EOrder RGB_ORDER>
+    CFastLED& addLeds(CRGB* data, int count) {
+        leds = data;
+        ledCount = count;
+        return *this;
+    }
+    void setBrightness(uint8_t scale) { brightness = scale; }
+    uint8_t getBrightness() const { return brightness; }
+    void show();
+    void show(uint8_t scale) {
+        brightness = scale;
+        show();
+    }
+    void clear(bool writeData = false);
+
+private:
+    CRGB* leds = nullptr;
+    int ledCount = 0;
+    uint8_t brightness = 255;
+    uint32_t lastShown = 0xFFFFFFFF;
+};
+
+extern CFastLED FastLED;
+
+#endif // SIM_FASTLED_H
@@ -0,0 +1,152 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include "../SimHardware.h"
+
+// ============================================================================
+// TASKS
+// ============================================================================
+
+namespace {
+
+// Thrown by vTaskDelay() inside an inline task
+struct TaskBlocked {};
+
+int g_taskDepth = 0;
+uint8_t g_taskHandle;   // Handles only need to be distinct from nullptr
+
+BaseType_t runInline(TaskFunction_t function, void* parameter, TaskHandle_t* createdTask) {
+    g_taskDepth++;
+    try {
+        function(parameter);
+    } catch (const TaskBlocked&) {
+        g_taskDepth--;
+        return pdFAIL;
+    } catch (...) {
+        g_taskDepth--;
+        throw;
+    }
+    g_taskDepth--;
+    if (createdTask) {
+        *createdTask = &g_taskHandle;
+    }
+    return pdPASS;
+}
+
+} // namespace
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char* name, uint32_t stackDepth, void* parameter,
+                       UBaseType_t priority, TaskHandle_t* createdTask) {
+    (void)name;
+    (void)stackDepth;
+    (void)priority;
+    if (sim::takeTaskCreateFailure()) {
+        return pdFAIL;
+    }
+    return runInline(function, parameter, createdTask);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t stackDepth,
+                                   void* parameter, UBaseType_t priority, TaskHandle_t* createdTask,
+                                   BaseType_t coreId) {
+    (void)coreId;
+    return xTaskCreate(function, name, stackDepth, parameter, priority, createdTask);
+}
+
+// Deleting the calling task outside an inline task ends setup()/loop()
+void vTaskDelete(TaskHandle_t task) {
+    if (!task && g_taskDepth == 0) {
+        throw sim::SimStop{ "main task deleted" };
+    }
+}
+
+void vTaskDelay(TickType_t ticks) {
+    if (g_taskDepth > 0) {
+        throw TaskBlocked();
+    }
+    sim::advanceUs((uint64_t)ticks * 1000);
+}
+
+TickType_t xTaskGetTickCount() {
+    return (TickType_t)(sim::nowUs() / 1000);
+}
+
+BaseType_t xPortGetCoreID() {
+    return 1;
+}
+
+// ============================================================================
+// SEMAPHORES
+// ============================================================================
+
+static uint8_t g_semaphore;
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    return &g_semaphore;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary() {
+    return &g_semaphore;
+}
+
+// Free unless a scenario made another task hold it (sim::setLockTimeouts)
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks) {
+    if (!semaphore) {
+        return pdFALSE;
+    }
+    if (ticks != 0 && sim::takeLockTimeout()) {
+        sim::advanceUs((uint64_t)ticks * 1000);
+        return pdFALSE;
+    }
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+    return semaphore ? pdTRUE : pdFALSE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) {
+    (void)semaphore;
+}
+
+// ============================================================================
+// EVENT GROUPS
+// ============================================================================
+
+EventGroupHandle_t xEventGroupCreate() {
+    return new EventBits_t(0);
+}
+
+void vEventGroupDelete(EventGroupHandle_t group) {
+    delete static_cast<EventBits_t*>(group);
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits) {
+    EventBits_t* value = static_cast<EventBits_t*>(group);
+    *value |= bits;
+    return *value;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits) {
+    EventBits_t* value = static_cast<EventBits_t*>(group);
+    const EventBits_t before = *value;
+    *value &= ~bits;
+    return before;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group) {
+    return *static_cast<EventBits_t*>(group);
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clearOnExit,
+                                BaseType_t waitForAll, TickType_t ticks) {
+    (void)waitForAll;
+    (void)ticks;
+    EventBits_t* value = static_cast<EventBits_t*>(group);
+    const EventBits_t result = *value;
+    if (clearOnExit) {
+        *value &= ~bits;
+    }
+    return result;
+}
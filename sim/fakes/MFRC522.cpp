@@ -0,0 +1,273 @@
+#include "MFRC522.h"
+#include "../SimHardware.h"
+#include <cstring>
+
+namespace {
+
+// MFRC522 at 10 MHz SPI, 106 kbit/s on air
+const uint64_t kInitUs = 50000;          // Soft reset and oscillator start
+const uint64_t kRegisterUs = 10;
+const uint64_t kTimeoutUs = 25000;       // TReload set by PCD_Init()
+const uint64_t kRequestUs = 600;         // REQA/WUPA answered
+const uint64_t kSelectUs = 2500;         // Anticollision and select, all cascade levels
+const uint64_t kHaltUs = 1200;
+const uint64_t kAuthUs = 3000;
+const uint64_t kReadUs = 1500;
+const uint64_t kWriteUs = 6000;          // Two-step Classic write or one UL page
+const uint64_t kSelfTestUs = 40000;
+
+const byte kVersion = 0x92;              // MFRC522 v2.0
+const int kNtagPages = 135;              // NTAG215
+
+bool isClassicSak(byte sak) {
+    const byte s = sak & 0x7F;
+    return s == 0x08 || s == 0x09 || s == 0x18;
+}
+
+} // namespace
+
+MFRC522::MFRC522(byte chipSelectPin, byte resetPowerDownPin) {
+    (void)chipSelectPin;
+    (void)resetPowerDownPin;
+    memset(&uid, 0, sizeof(uid));
+    memset(trackedUid, 0, sizeof(trackedUid));
+}
+
+void MFRC522::PCD_Init() {
+    sim::advanceUs(kInitUs);
+    antennaOn = true;
+    poweredDown = false;
+    cardState = CARD_IDLE;
+}
+
+byte MFRC522::PCD_ReadRegister(PCD_Register reg) {
+    sim::advanceUs(kRegisterUs);
+    return reg == VersionReg ? kVersion : 0x00;
+}
+
+void MFRC522::PCD_WriteRegister(PCD_Register reg, byte value) {
+    (void)reg;
+    (void)value;
+    sim::advanceUs(kRegisterUs);
+}
+
+bool MFRC522::PCD_PerformSelfTest() {
+    sim::advanceUs(kSelfTestUs);
+    PCD_Init();
+    return true;
+}
+
+// Card in the field, powered by the antenna; a new card starts IDLE
+bool MFRC522::cardReachable() {
+    sim::SimCard* card = sim::cardInField();
+    if (!card || !antennaOn || poweredDown) {
+        cardState = CARD_IDLE;
+        trackedUidSize = 0;
+        authenticatedSector = -1;
+        return false;
+    }
+    if (card->uidSize != trackedUidSize || memcmp(card->uid, trackedUid, trackedUidSize) != 0) {
+        memcpy(trackedUid, card->uid, card->uidSize);
+        trackedUidSize = card->uidSize;
+        cardState = CARD_IDLE;
+        authenticatedSector = -1;
+    }
+    return true;
+}
+
+MFRC522::StatusCode MFRC522::request(bool wakeup, byte* bufferATQA, byte* bufferSize) {
+    if (!bufferATQA || !bufferSize || *bufferSize < 2) {
+        return STATUS_NO_ROOM;
+    }
+    authenticatedSector = -1;
+    if (!cardReachable()) {
+        sim::advanceUs(kTimeoutUs);
+        return STATUS_TIMEOUT;
+    }
+    const bool answers = cardState == CARD_IDLE || (wakeup && cardState == CARD_HALT);
+    if (!answers) {
+        // Any unexpected frame sends a selected card back to IDLE
+        if (cardState != CARD_HALT) {
+            cardState = CARD_IDLE;
+        }
+        sim::advanceUs(kTimeoutUs);
+        return STATUS_TIMEOUT;
+    }
+    cardState = CARD_READY;
+    const sim::SimCard* card = sim::cardInField();
+    bufferATQA[0] = isClassicSak(card->sak) ? 0x04 : 0x44;
+    bufferATQA[1] = 0x00;
+    *bufferSize = 2;
+    sim::advanceUs(kRequestUs);
+    return STATUS_OK;
+}
+
+MFRC522::StatusCode MFRC522::PICC_RequestA(byte* bufferATQA, byte* bufferSize) {
+    return request(false, bufferATQA, bufferSize);
+}
+
+MFRC522::StatusCode MFRC522::PICC_WakeupA(byte* bufferATQA, byte* bufferSize) {
+    return request(true, bufferATQA, bufferSize);
+}
+
+bool MFRC522::PICC_IsNewCardPresent() {
+    sim::counters().rfidPolls++;
+    byte atqa[2];
+    byte size = sizeof(atqa);
+    const StatusCode result = PICC_RequestA(atqa, &size);
+    return result == STATUS_OK || result == STATUS_COLLISION;
+}
+
+MFRC522::StatusCode MFRC522::PICC_Select(Uid* target, byte validBits) {
+    (void)validBits;
+    if (!target) {
+        return STATUS_INVALID;
+    }
+    if (!cardReachable() || cardState != CARD_READY) {
+        if (cardState != CARD_HALT) {
+            cardState = CARD_IDLE;
+        }
+        sim::advanceUs(kTimeoutUs);
+        return STATUS_TIMEOUT;
+    }
+    const sim::SimCard* card = sim::cardInField();
+    target->size = card->uidSize;
+    memcpy(target->uidByte, card->uid, card->uidSize);
+    target->sak = card->sak;
+    cardState = CARD_ACTIVE;
+    sim::advanceUs(kSelectUs);
+    return STATUS_OK;
+}
+
+bool MFRC522::PICC_ReadCardSerial() {
+    return PICC_Select(&uid) == STATUS_OK;
+}
+
+MFRC522::StatusCode MFRC522::PICC_HaltA() {
+    sim::advanceUs(kHaltUs);
+    if (cardReachable() && cardState == CARD_ACTIVE) {
+        cardState = CARD_HALT;
+    }
+    return STATUS_OK;   // A halted card does not answer; the library treats silence as success
+}
+
+MFRC522::StatusCode MFRC522::PCD_Authenticate(byte command, byte blockAddr, MIFARE_Key* key, Uid* target) {
+    (void)target;
+    if (command != PICC_CMD_MF_AUTH_KEY_A && command != PICC_CMD_MF_AUTH_KEY_B) {
+        return STATUS_INVALID;
+    }
+    if (!key || !cardReachable() || cardState != CARD_ACTIVE || !isClassicSak(sim::cardInField()->sak)) {
+        sim::advanceUs(kTimeoutUs);
+        return STATUS_TIMEOUT;
+    }
+    sim::advanceUs(kAuthUs);
+
+    // Transport key FFFFFFFFFFFF; a failed authentication halts the card
+    for (size_t i = 0; i < sizeof(key->keyByte); i++) {
+        if (key->keyByte[i] != 0xFF) {
+            cardState = CARD_IDLE;
+            return STATUS_ERROR;
+        }
+    }
+    authenticatedSector = blockAddr / 4;
+    return STATUS_OK;
+}
+
+MFRC522::StatusCode MFRC522::MIFARE_Read(byte blockAddr, byte* buffer, byte* bufferSize) {
+    if (!buffer || !bufferSize || *bufferSize < 18) {
+        return STATUS_NO_ROOM;
+    }
+    if (!cardReachable() || cardState != CARD_ACTIVE) {
+        sim::advanceUs(kTimeoutUs);
+        return STATUS_TIMEOUT;
+    }
+    const sim::SimCard* card = sim::cardInField();
+    memset(buffer, 0, 18);
+    if (isClassicSak(card->sak)) {
+        if (blockAddr >= 64 || authenticatedSector != blockAddr / 4) {
+            cardState = CARD_IDLE;
+            sim::advanceUs(kReadUs);
+            return STATUS_MIFARE_NACK;
+        }
+        memcpy(buffer, card->memory + blockAddr * 16, 16);
+    } else {
+        // Ultralight/NTAG READ returns four pages, wrapping at the end
+        for (int i = 0; i < 16; i++) {
+            buffer[i] = card->memory[((blockAddr * 4) + i) % (kNtagPages * 4)];
+        }
+    }
+    *bufferSize = 18;   // Data plus CRC_A
+    sim::advanceUs(kReadUs);
+    return STATUS_OK;
+}
+
+MFRC522::StatusCode MFRC522::MIFARE_Write(byte blockAddr, byte* buffer, byte bufferSize) {
+    if (!buffer || bufferSize < 16) {
+        return STATUS_INVALID;
+    }
+    if (!cardReachable() || cardState != CARD_ACTIVE) {
+        sim::advanceUs(kTimeoutUs);
+        return STATUS_TIMEOUT;
+    }
+    sim::SimCard* card = sim::cardInField();
+    sim::advanceUs(kWriteUs);
+    if (!isClassicSak(card->sak) || blockAddr == 0 || blockAddr >= 64 || authenticatedSector != blockAddr / 4) {
+        cardState = CARD_IDLE;
+        return STATUS_MIFARE_NACK;
+    }
+    memcpy(card->memory + blockAddr * 16, buffer, 16);
+    return STATUS_OK;
+}
+
+MFRC522::StatusCode MFRC522::MIFARE_Ultralight_Write(byte page, byte* buffer, byte bufferSize) {
+    if (!buffer || bufferSize < 4) {
+        return STATUS_INVALID;
+    }
+    if (!cardReachable() || cardState != CARD_ACTIVE) {
+        sim::advanceUs(kTimeoutUs);
+        return STATUS_TIMEOUT;
+    }
+    sim::SimCard* card = sim::cardInField();
+    sim::advanceUs(kWriteUs);
+    if (isClassicSak(card->sak) || page < 4 || page >= kNtagPages) {
+        cardState = CARD_IDLE;
+        return STATUS_MIFARE_NACK;   // UID, lock and OTP pages are read-only
+    }
+    memcpy(card->memory + page * 4, buffer, 4);
+    return STATUS_OK;
+}
+
+MFRC522::PICC_Type MFRC522::PICC_GetType(byte sak) {
+    switch (sak & 0x7F) {
+        case 0x04: return PICC_TYPE_NOT_COMPLETE;
+        case 0x09: return PICC_TYPE_MIFARE_MINI;
+        case 0x08: return PICC_TYPE_MIFARE_1K;
+        case 0x18: return PICC_TYPE_MIFARE_4K;
+        case 0x00: return PICC_TYPE_MIFARE_UL;
+        case 0x10:
+        case 0x11: return PICC_TYPE_MIFARE_PLUS;
+        case 0x01: return PICC_TYPE_TNP3XXX;
+        case 0x20: return PICC_TYPE_ISO_14443_4;
+        case 0x40: return PICC_TYPE_ISO_18092;
+        default: return PICC_TYPE_UNKNOWN;
+    }
+}
+
+const char* MFRC522::PICC_GetTypeName(PICC_Type type) {
+    switch (type) {
+        case PICC_TYPE_MIFARE_MINI: return "MIFARE Mini, 320 bytes";
+        case PICC_TYPE_MIFARE_1K: return "MIFARE 1KB";
+        case PICC_TYPE_MIFARE_4K: return "MIFARE 4KB";
+        case PICC_TYPE_MIFARE_UL: return "MIFARE Ultralight or Ultralight C";
+        default: return "Unknown type";
+    }
+}
+
+const char* MFRC522::GetStatusCodeName(StatusCode code) {
+    switch (code) {
+        case STATUS_OK: return "Success.";
+        case STATUS_TIMEOUT: return "Timeout in communication.";
+        case STATUS_MIFARE_NACK: return "A MIFARE PICC responded with NAK.";
+        default: return "Error in communication.";
+    }
+}
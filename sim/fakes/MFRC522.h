@@ -0,0 +1,118 @@
+#ifndef SIM_MFRC522_H
+#define SIM_MFRC522_H
+
+// ============================================================================
+// MFRC522
+// ============================================================================
+// Reader plus the ISO 14443-3 state of the card in the field: an IDLE card
+// answers REQA, a selected (ACTIVE) card ignores REQA and drops back to IDLE,
+// a HALTed card only answers WUPA. That is why PICC_IsNewCardPresent()
+// alternates between true and false while a card rests on the reader.
+//
+// Commands are charged what they cost on the device: a command nobody
+// answers waits for the 25 ms timer configured by PCD_Init().
+// ============================================================================
+
+#include <Arduino.h>
+
+class MFRC522 {
+public:
+    enum PCD_Register : byte {
+        CommandReg = 0x01 << 1,
+        ComIrqReg = 0x04 << 1,
+        Status2Reg = 0x08 << 1,
+        VersionReg = 0x37 << 1
+    };
+
+    enum PICC_Command : byte {
+        PICC_CMD_REQA = 0x26,
+        PICC_CMD_WUPA = 0x52,
+        PICC_CMD_MF_AUTH_KEY_A = 0x60,
+        PICC_CMD_MF_AUTH_KEY_B = 0x61,
+        PICC_CMD_MF_READ = 0x30,
+        PICC_CMD_MF_WRITE = 0xA0,
+        PICC_CMD_UL_WRITE = 0xA2
+    };
+
+    enum PICC_Type : byte {
+        PICC_TYPE_UNKNOWN,
+        PICC_TYPE_ISO_14443_4,
+        PICC_TYPE_ISO_18092,
+        PICC_TYPE_MIFARE_MINI,
+        PICC_TYPE_MIFARE_1K,
+        PICC_TYPE_MIFARE_4K,
+        PICC_TYPE_MIFARE_UL,
+        PICC_TYPE_MIFARE_PLUS,
+        PICC_TYPE_MIFARE_DESFIRE,
+        PICC_TYPE_TNP3XXX,
+        PICC_TYPE_NOT_COMPLETE = 0xff
+    };
+
+    enum StatusCode : byte {
+        STATUS_OK,
+        STATUS_ERROR,
+        STATUS_COLLISION,
+        STATUS_TIMEOUT,
+        STATUS_NO_ROOM,
+        STATUS_INTERNAL_ERROR,
+        STATUS_INVALID,
+        STATUS_CRC_WRONG,
+        STATUS_MIFARE_NACK = 0xff
+    };
+
+    typedef struct {
+        byte size;
+        byte uidByte[10];
+        byte sak;
+    } Uid;
+
+    typedef struct {
+        byte keyByte[6];
+    } MIFARE_Key;
+
+    Uid uid;
+
+    MFRC522() : MFRC522(0, 0) {}
+    MFRC522(byte chipSelectPin, byte resetPowerDownPin);
+
+    void PCD_Init();
+    byte PCD_ReadRegister(PCD_Register reg);
+    void PCD_WriteRegister(PCD_Register reg, byte value);
+    bool PCD_PerformSelfTest();
+    void PCD_AntennaOn() { antennaOn = true; }
+    void PCD_AntennaOff() { antennaOn = false; }
+    void PCD_SoftPowerDown() { antennaOn = false; poweredDown = true; }
+    void PCD_SoftPowerUp() { poweredDown = false; antennaOn = true; }
+    void PCD_StopCrypto1() { authenticatedSector = -1; }
+
+    bool PICC_IsNewCardPresent();
+    bool PICC_ReadCardSerial();
+    StatusCode PICC_RequestA(byte* bufferATQA, byte* bufferSize);
+    StatusCode PICC_WakeupA(byte* bufferATQA, byte* bufferSize);
+    StatusCode PICC_Select(Uid* uid, byte validBits = 0);
+    StatusCode PICC_HaltA();
+
+    StatusCode PCD_Authenticate(byte command, byte blockAddr, MIFARE_Key* key, Uid* uid);
+    StatusCode MIFARE_Read(byte blockAddr, byte* buffer, byte* bufferSize);
+    StatusCode MIFARE_Write(byte blockAddr, byte* buffer, byte bufferSize);
+    StatusCode MIFARE_Ultralight_Write(byte page, byte* buffer, byte bufferSize);
+
+    static PICC_Type PICC_GetType(byte sak);
+    static const char* PICC_GetTypeName(PICC_Type type);
+    static const char* GetStatusCodeName(StatusCode code);
+
+private:
+    enum CardState { CARD_IDLE, CARD_READY, CARD_ACTIVE, CARD_HALT };
+
+    bool antennaOn = false;
+    bool poweredDown = false;
+    CardState cardState = CARD_IDLE;
+    byte trackedUid[10];          // Card the state belongs to
+    byte trackedUidSize = 0;
+    int authenticatedSector = -1;
+
+    bool cardReachable();
+    StatusCode request(bool wakeup, byte* bufferATQA, byte* bufferSize);
+};
+
+#endif // SIM_MFRC522_H
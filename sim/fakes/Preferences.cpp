@@ -0,0 +1,186 @@
+#include "Preferences.h"
+#include "../SimHardware.h"
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <vector>
+
+namespace {
+
+// "namespace/key" -> value bytes. NVS entries are written to flash; the
+// simulator's bookkeeping is not firmware heap.
+typedef std::map<std::string, std::vector<uint8_t>> NvsMap;
+
+NvsMap& store() {
+    static NvsMap* nvs = nullptr;
+    if (!nvs) {
+        sim::Untracked untracked;
+        nvs = new NvsMap();
+    }
+    return *nvs;
+}
+
+const uint64_t kNvsWriteUs = 2000;   // Flash page write
+
+} // namespace
+
+bool Preferences::begin(const char* name, bool readOnlyMode, const char* partitionLabel) {
+    (void)partitionLabel;
+    if (!name || strlen(name) > 15) {
+        return false;
+    }
+    sim::Untracked untracked;
+    space = name;
+    readOnly = readOnlyMode;
+    opened = true;
+    return true;
+}
+
+std::string Preferences::fullKey(const char* key) const {
+    return space + "/" + (key ? key : "");
+}
+
+bool Preferences::clear() {
+    if (!opened || readOnly) {
+        return false;
+    }
+    sim::Untracked untracked;
+    const std::string prefix = space + "/";
+    NvsMap& nvs = store();
+    for (NvsMap::iterator it = nvs.begin(); it != nvs.end();) {
+        it = it->first.compare(0, prefix.size(), prefix) == 0 ? nvs.erase(it) : std::next(it);
+    }
+    sim::counters().nvsWrites++;
+    sim::advanceUs(kNvsWriteUs);
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    if (!opened || readOnly || !key) {
+        return false;
+    }
+    sim::Untracked untracked;
+    if (store().erase(fullKey(key)) == 0) {
+        return false;
+    }
+    sim::counters().nvsWrites++;
+    sim::advanceUs(kNvsWriteUs);
+    return true;
+}
+
+bool Preferences::isKey(const char* key) {
+    sim::Untracked untracked;
+    return opened && key && store().count(fullKey(key)) > 0;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t length) {
+    if (!opened || readOnly || !key || strlen(key) > 15 || (!value && length)) {
+        return 0;
+    }
+    {
+        sim::Untracked untracked;
+        std::vector<uint8_t>& entry = store()[fullKey(key)];
+        const uint8_t* bytes = (const uint8_t*)value;
+        if (entry.size() == length && (length == 0 || memcmp(entry.data(), bytes, length) == 0)) {
+            return length;   // Unchanged: NVS skips the write
+        }
+        entry.assign(bytes, bytes + length);
+    }
+    sim::counters().nvsWrites++;
+    sim::advanceUs(kNvsWriteUs);
+    return length;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    if (!opened || !key) {
+        return 0;
+    }
+    sim::Untracked untracked;
+    NvsMap::const_iterator it = store().find(fullKey(key));
+    return it == store().end() ? 0 : it->second.size();
+}
+
+size_t Preferences::getBytes(const char* key, void* buffer, size_t maxLength) {
+    const size_t length = getBytesLength(key);
+    if (length == 0 || !buffer || length > maxLength) {
+        return 0;
+    }
+    sim::Untracked untracked;
+    memcpy(buffer, store()[fullKey(key)].data(), length);
+    return length;
+}
+
+size_t Preferences::putString(const char* key, const char* value) {
+    if (!value) {
+        return 0;
+    }
+    const size_t length = strlen(value);
+    return putBytes(key, value, length + 1) ? length : 0;
+}
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+    if (getBytesLength(key) == 0) {
+        return defaultValue;
+    }
+    const char* stored;
+    {
+        sim::Untracked untracked;
+        stored = (const char*)store()[fullKey(key)].data();
+    }
+    return String(stored);   // Stored with its terminator
+}
+
+size_t Preferences::getString(const char* key, char* value, size_t maxLength) {
+    const size_t length = getBytesLength(key);
+    if (length == 0 || !value || length > maxLength) {
+        return 0;
+    }
+    getBytes(key, value, length);
+    value[length - 1] = '\0';
+    return length;
+}
+
+namespace sim {
+
+// File format: one "key<TAB>hex bytes" line per entry
+bool loadNvs(const std::string& path) {
+    Untracked untracked;
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    NvsMap& nvs = store();
+    nvs.clear();
+    std::string key, hex;
+    while (in >> key >> hex) {
+        std::vector<uint8_t> bytes;
+        for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+            bytes.push_back((uint8_t)std::stoul(hex.substr(i, 2), nullptr, 16));
+        }
+        nvs[key] = bytes;
+    }
+    return true;
+}
+
+bool saveNvs(const std::string& path) {
+    Untracked untracked;
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+    for (const NvsMap::value_type& entry : store()) {
+        out << entry.first << '\t';
+        char byte[3];
+        for (uint8_t b : entry.second) {
+            snprintf(byte, sizeof(byte), "%02x", b);
+            out << byte;
+        }
+        if (entry.second.empty()) {
+            out << "-";
+        }
+        out << '\n';
+    }
+    return true;
+}
+
+} // namespace sim
@@ -0,0 +1,76 @@
+#ifndef SIM_PREFERENCES_H
+#define SIM_PREFERENCES_H
+
+// ============================================================================
+// PREFERENCES (NVS)
+// ============================================================================
+// Key/value store per namespace, kept in memory for the run (optionally
+// loaded from and saved to a host file so a second run sees the first run's
+// state). Every put that changes a value counts as one NVS write, the same
+// way the NVS library skips writes of an identical value.
+// ============================================================================
+
+#include <Arduino.h>
+#include <string>
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false, const char* partitionLabel = nullptr);
+    void end() { opened = false; }
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+    size_t freeEntries() { return 500; }
+
+    size_t putBytes(const char* key, const void* value, size_t length);
+    size_t getBytes(const char* key, void* buffer, size_t maxLength);
+    size_t getBytesLength(const char* key);
+
+    size_t putBool(const char* key, bool value) { return putValue(key, value); }
+    bool getBool(const char* key, bool defaultValue = false) { return getValue(key, defaultValue); }
+    size_t putUChar(const char* key, uint8_t value) { return putValue(key, value); }
+    uint8_t getUChar(const char* key, uint8_t defaultValue = 0) { return getValue(key, defaultValue); }
+    size_t putUShort(const char* key, uint16_t value) { return putValue(key, value); }
+    uint16_t getUShort(const char* key, uint16_t defaultValue = 0) { return getValue(key, defaultValue); }
+    size_t putInt(const char* key, int32_t value) { return putValue(key, value); }
+    int32_t getInt(const char* key, int32_t defaultValue = 0) { return getValue(key, defaultValue); }
+    size_t putUInt(const char* key, uint32_t value) { return putValue(key, value); }
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0) { return getValue(key, defaultValue); }
+    size_t putULong(const char* key, uint32_t value) { return putValue(key, value); }
+    uint32_t getULong(const char* key, uint32_t defaultValue = 0) { return getValue(key, defaultValue); }
+    size_t putFloat(const char* key, float value) { return putValue(key, value); }
+    float getFloat(const char* key, float defaultValue = 0.0f) { return getValue(key, defaultValue); }
+
+    size_t putString(const char* key, const char* value);
+    size_t putString(const char* key, const String& value) { return putString(key, value.c_str()); }
+    String getString(const char* key, const String& defaultValue = String());
+    size_t getString(const char* key, char* value, size_t maxLength);
+
+private:
+    std::string space;
+    bool opened = false;
+    bool readOnly = false;
+
+    std::string fullKey(const char* key) const;
+
+    template <typename T>
+    size_t putValue(const char* key, T value) {
+        return putBytes(key, &value, sizeof(value)) == sizeof(value) ? sizeof(value) : 0;
+    }
+
+    template <typename T>
+    T getValue(const char* key, T defaultValue) {
+        T value;
+        return getBytesLength(key) == sizeof(T) && getBytes(key, &value, sizeof(T)) == sizeof(T) ? value : defaultValue;
+    }
+};
+
+namespace sim {
+
+// Host file that keeps NVS across runs ("" = start empty, keep nothing)
+bool loadNvs(const std::string& path);
+bool saveNvs(const std::string& path);
+
+} // namespace sim
+
+#endif // SIM_PREFERENCES_H
@@ -0,0 +1,33 @@
+#ifndef SIM_SD_MMC_H
+#define SIM_SD_MMC_H
+
+#include "FS.h"
+
+#define CARD_NONE 0
+#define CARD_MMC 1
+#define CARD_SD 2
+#define CARD_SDHC 3
+#define CARD_UNKNOWN 4
+
+namespace fs {
+
+// SD card in the SDMMC slot; begin() fails if no host root is set
+class SDMMCFS : public FS {
+public:
+    SDMMCFS() : FS("sdmmc") {}
+
+    bool setPins(int clk, int cmd, int d0) { (void)clk; (void)cmd; (void)d0; return true; }
+    bool begin(const char* mountpoint = "/sdcard", bool mode1bit = false, bool formatOnFail = false,
+               int sdmmcFrequency = 20000, uint8_t maxOpenFiles = 5);
+    void end() { mounted = false; }
+    uint8_t cardType() { return mounted ? CARD_SDHC : CARD_NONE; }
+    uint64_t cardSize() { return mounted ? 8ULL * 1024 * 1024 * 1024 : 0; }
+    uint64_t totalBytes() { return cardSize(); }
+    uint64_t usedBytes();
+};
+
+} // namespace fs
+
+extern fs::SDMMCFS SD_MMC;
+
+#endif // SIM_SD_MMC_H
@@ -0,0 +1,49 @@
+#include "SparkFun_MAX1704x_Fuel_Gauge_Arduino_Library.h"
+#include "../SimHardware.h"
+
+namespace {
+
+const uint8_t kFuelGaugeAddress = 0x36;
+
+} // namespace
+
+bool SFE_MAX1704X::begin(TwoWire& wirePort) {
+    wire = &wirePort;
+    return isConnected();
+}
+
+bool SFE_MAX1704X::isConnected() {
+    if (!wire) {
+        return false;
+    }
+    wire->beginTransmission(kFuelGaugeAddress);
+    return wire->endTransmission() == 0;
+}
+
+// Register pointer write plus a two-byte read
+bool SFE_MAX1704X::transaction() {
+    if (!wire) {
+        return false;
+    }
+    wire->beginTransmission(kFuelGaugeAddress);
+    wire->write((uint8_t)0x02);
+    if (wire->endTransmission(false) != 0) {
+        return false;
+    }
+    return wire->requestFrom(kFuelGaugeAddress, (size_t)2, true) == 2;
+}
+
+// Rough single-cell LiPo curve: 3.3 V empty, 4.2 V full
+float SFE_MAX1704X::getVoltage() {
+    if (!transaction()) {
+        return 0.0f;
+    }
+    return 3.3f + 0.9f * sim::batteryPercent() / 100.0f;
+}
+
+float SFE_MAX1704X::getSOC() {
+    if (!transaction()) {
+        return 0.0f;
+    }
+    return sim::batteryPercent();
+}
@@ -0,0 +1,41 @@
+#ifndef SIM_SPARKFUN_MAX1704X_H
+#define SIM_SPARKFUN_MAX1704X_H
+
+// ============================================================================
+// SPARKFUN MAX1704X
+// ============================================================================
+// MAX17048 fuel gauge: readings come from the simulated battery, each call
+// is one register transaction on the bus.
+// ============================================================================
+
+#include <Wire.h>
+
+#define MAX1704X_MAX17043 0
+#define MAX1704X_MAX17044 1
+#define MAX1704X_MAX17048 2
+#define MAX1704X_MAX17049 3
+
+class SFE_MAX1704X {
+public:
+    explicit SFE_MAX1704X(int device = MAX1704X_MAX17048) { (void)device; }
+
+    bool begin(TwoWire& wirePort = Wire);
+    bool isConnected();
+    uint8_t reset() { return transaction() ? 0 : 1; }
+    uint8_t quickStart() { return transaction() ? 0 : 1; }
+    uint16_t getVersion() { return transaction() ? 0x0012 : 0; }
+    float getVoltage();
+    float getSOC();
+    float getChangeRate() { transaction(); return 0.0f; }
+    uint8_t setThreshold(uint8_t percent = 4) { (void)percent; return transaction() ? 0 : 1; }
+    uint8_t enableSleep() { return transaction() ? 0 : 1; }
+    uint8_t sleep() { return transaction() ? 0 : 1; }
+    uint8_t wake() { return transaction() ? 0 : 1; }
+
+private:
+    TwoWire* wire = nullptr;
+
+    bool transaction();
+};
+
+#endif // SIM_SPARKFUN_MAX1704X_H
@@ -0,0 +1,31 @@
+#ifndef SIM_STREAM_H
+#define SIM_STREAM_H
+
+#include "Print.h"
+
+// ============================================================================
+// STREAM (HOST)
+// ============================================================================
+// Nothing on the simulated device ever blocks waiting for input, so the
+// timeout only exists for API compatibility.
+
+class Stream : public Print {
+public:
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+    virtual int peek() { return -1; }
+
+    void setTimeout(unsigned long timeoutMs) { timeout = timeoutMs; }
+    unsigned long getTimeout() const { return timeout; }
+
+    virtual size_t readBytes(char* buffer, size_t length);
+    size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+    size_t readBytesUntil(char terminator, char* buffer, size_t length);
+    String readString();
+    String readStringUntil(char terminator);
+
+protected:
+    unsigned long timeout = 1000;
+};
+
+#endif // SIM_STREAM_H
@@ -0,0 +1,415 @@
+#include "WString.h"
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+
+// ============================================================================
+// CONSTRUCTION, STORAGE
+// ============================================================================
+
+String::String(const char* cstr) : buffer(nullptr), capacity(0), len(0) {
+    if (cstr) {
+        copy(cstr, strlen(cstr));
+    }
+}
+
+String::String(const char* cstr, size_t length) : buffer(nullptr), capacity(0), len(0) {
+    if (cstr) {
+        copy(cstr, (unsigned int)length);
+    }
+}
+
+String::String(const String& other) : buffer(nullptr), capacity(0), len(0) {
+    copy(other.buffer, other.len);
+}
+
+String::String(String&& other) noexcept : buffer(nullptr), capacity(0), len(0) {
+    move(other);
+}
+
+String::String(char c) : buffer(nullptr), capacity(0), len(0) {
+    copy(&c, 1);
+}
+
+static void formatInteger(String& out, unsigned long long magnitude, bool negative, unsigned char base) {
+    char buf[72];
+    char* p = buf + sizeof(buf) - 1;
+    *p = '\0';
+    if (base < 2 || base > 36) {
+        base = 10;
+    }
+    do {
+        const unsigned digit = (unsigned)(magnitude % base);
+        *--p = (char)(digit < 10 ? '0' + digit : 'a' + digit - 10);
+        magnitude /= base;
+    } while (magnitude);
+    if (negative) {
+        *--p = '-';
+    }
+    out = p;
+}
+
+String::String(unsigned char value, unsigned char base) : buffer(nullptr), capacity(0), len(0) {
+    formatInteger(*this, value, false, base);
+}
+
+String::String(int value, unsigned char base) : buffer(nullptr), capacity(0), len(0) {
+    const bool negative = base == 10 && value < 0;
+    formatInteger(*this, negative ? 0ULL - (long long)value : (unsigned)value, negative, base);
+}
+
+String::String(unsigned int value, unsigned char base) : buffer(nullptr), capacity(0), len(0) {
+    formatInteger(*this, value, false, base);
+}
+
+String::String(long value, unsigned char base) : buffer(nullptr), capacity(0), len(0) {
+    const bool negative = base == 10 && value < 0;
+    formatInteger(*this, negative ? 0ULL - (long long)value : (unsigned long)value, negative, base);
+}
+
+String::String(unsigned long value, unsigned char base) : buffer(nullptr), capacity(0), len(0) {
+    formatInteger(*this, value, false, base);
+}
+
+String::String(long long value, unsigned char base) : buffer(nullptr), capacity(0), len(0) {
+    const bool negative = base == 10 && value < 0;
+    formatInteger(*this, negative ? 0ULL - (unsigned long long)value : (unsigned long long)value, negative, base);
+}
+
+String::String(unsigned long long value, unsigned char base) : buffer(nullptr), capacity(0), len(0) {
+    formatInteger(*this, value, false, base);
+}
+
+String::String(float value, unsigned char decimals) : String((double)value, decimals) {
+}
+
+String::String(double value, unsigned char decimals) : buffer(nullptr), capacity(0), len(0) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, value);
+    copy(buf, strlen(buf));
+}
+
+String::~String() {
+    delete[] buffer;
+}
+
+void String::invalidate() {
+    delete[] buffer;
+    buffer = nullptr;
+    capacity = 0;
+    len = 0;
+}
+
+bool String::reserve(unsigned int size) {
+    if (buffer && capacity >= size) {
+        return true;
+    }
+    if (changeBuffer(size)) {
+        if (len == 0) {
+            buffer[0] = '\0';
+        }
+        return true;
+    }
+    return false;
+}
+
+bool String::changeBuffer(unsigned int maxStrLen) {
+    char* next = new char[maxStrLen + 1];
+    if (buffer) {
+        memcpy(next, buffer, len + 1);
+        delete[] buffer;
+    }
+    buffer = next;
+    capacity = maxStrLen;
+    return true;
+}
+
+String& String::copy(const char* cstr, unsigned int length) {
+    if (!cstr) {
+        invalidate();
+        return *this;
+    }
+    if (length == 0) {
+        len = 0;
+        if (buffer) {
+            buffer[0] = '\0';
+        }
+        return *this;
+    }
+    if (!reserve(length)) {
+        invalidate();
+        return *this;
+    }
+    len = length;
+    memmove(buffer, cstr, length);
+    buffer[len] = '\0';
+    return *this;
+}
+
+void String::move(String& other) {
+    delete[] buffer;
+    buffer = other.buffer;
+    capacity = other.capacity;
+    len = other.len;
+    other.buffer = nullptr;
+    other.capacity = 0;
+    other.len = 0;
+}
+
+String& String::operator=(const String& other) {
+    if (this != &other) {
+        copy(other.c_str(), other.len);
+    }
+    return *this;
+}
+
+String& String::operator=(String&& other) noexcept {
+    if (this != &other) {
+        move(other);
+    }
+    return *this;
+}
+
+String& String::operator=(const char* cstr) {
+    return cstr ? copy(cstr, strlen(cstr)) : copy("", 0);
+}
+
+// ============================================================================
+// CONCATENATION
+// ============================================================================
+
+bool String::concat(const char* cstr) {
+    return cstr ? concat(cstr, strlen(cstr)) : false;
+}
+
+bool String::concat(const char* cstr, unsigned int length) {
+    if (!cstr) {
+        return false;
+    }
+    if (length == 0) {
+        return true;
+    }
+    // Appending part of ourselves: the buffer may move
+    if (buffer && cstr >= buffer && cstr < buffer + len) {
+        String copyOfSelf(cstr, length);
+        return concat(copyOfSelf.c_str(), length);
+    }
+    const unsigned int newLen = len + length;
+    if (!reserve(newLen)) {
+        return false;
+    }
+    memcpy(buffer + len, cstr, length);
+    len = newLen;
+    buffer[len] = '\0';
+    return true;
+}
+
+String operator+(const String& lhs, const String& rhs) { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String& lhs, const char* rhs) { String s(lhs); s.concat(rhs); return s; }
+String operator+(const char* lhs, const String& rhs) { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String& lhs, char rhs) { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String& lhs, unsigned char rhs) { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String& lhs, int rhs) { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String& lhs, unsigned int rhs) { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String& lhs, long rhs) { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String& lhs, unsigned long rhs) { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String& lhs, long long rhs) { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String& lhs, unsigned long long rhs) { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String& lhs, float rhs) { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String& lhs, double rhs) { String s(lhs); s.concat(rhs); return s; }
+
+// ============================================================================
+// COMPARISON, SEARCH
+// ============================================================================
+
+int String::compareTo(const String& other) const {
+    return strcmp(c_str(), other.c_str());
+}
+
+bool String::equalsIgnoreCase(const String& other) const {
+    if (len != other.len) {
+        return false;
+    }
+    for (unsigned int i = 0; i < len; i++) {
+        if (tolower((unsigned char)buffer[i]) != tolower((unsigned char)other.buffer[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool String::startsWith(const String& prefix, unsigned int offset) const {
+    if (offset > len || prefix.len > len - offset) {
+        return false;
+    }
+    return strncmp(c_str() + offset, prefix.c_str(), prefix.len) == 0;
+}
+
+bool String::endsWith(const String& suffix) const {
+    if (suffix.len > len) {
+        return false;
+    }
+    return strcmp(c_str() + len - suffix.len, suffix.c_str()) == 0;
+}
+
+char& String::operator[](unsigned int index) {
+    static char dummy;
+    if (index >= len) {
+        dummy = 0;
+        return dummy;
+    }
+    return buffer[index];
+}
+
+void String::getBytes(unsigned char* buf, unsigned int bufsize, unsigned int index) const {
+    if (!bufsize || !buf) {
+        return;
+    }
+    if (index >= len) {
+        buf[0] = 0;
+        return;
+    }
+    unsigned int n = bufsize - 1;
+    if (n > len - index) {
+        n = len - index;
+    }
+    memcpy(buf, buffer + index, n);
+    buf[n] = 0;
+}
+
+int String::indexOf(char c, unsigned int from) const {
+    if (from >= len) {
+        return -1;
+    }
+    const char* found = strchr(buffer + from, c);
+    return found ? (int)(found - buffer) : -1;
+}
+
+int String::indexOf(const String& str, unsigned int from) const {
+    if (from >= len) {
+        return -1;
+    }
+    const char* found = strstr(buffer + from, str.c_str());
+    return found ? (int)(found - buffer) : -1;
+}
+
+int String::lastIndexOf(char c) const {
+    if (!len) {
+        return -1;
+    }
+    const char* found = strrchr(buffer, c);
+    return found ? (int)(found - buffer) : -1;
+}
+
+int String::lastIndexOf(const String& str) const {
+    if (str.len == 0 || str.len > len) {
+        return -1;
+    }
+    for (int i = (int)(len - str.len); i >= 0; i--) {
+        if (strncmp(buffer + i, str.c_str(), str.len) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const {
+    if (beginIndex > endIndex) {
+        unsigned int t = beginIndex;
+        beginIndex = endIndex;
+        endIndex = t;
+    }
+    if (beginIndex >= len) {
+        return String();
+    }
+    if (endIndex > len) {
+        endIndex = len;
+    }
+    return String(buffer + beginIndex, endIndex - beginIndex);
+}
+
+// ============================================================================
+// MODIFICATION, CONVERSION
+// ============================================================================
+
+void String::replace(char find, char replacement) {
+    for (unsigned int i = 0; i < len; i++) {
+        if (buffer[i] == find) {
+            buffer[i] = replacement;
+        }
+    }
+}
+
+void String::replace(const String& find, const String& replacement) {
+    if (len == 0 || find.len == 0) {
+        return;
+    }
+    String result;
+    unsigned int pos = 0;
+    int found;
+    while ((found = indexOf(find, pos)) >= 0) {
+        result.concat(buffer + pos, found - pos);
+        result.concat(replacement);
+        pos = found + find.len;
+    }
+    if (pos == 0) {
+        return;
+    }
+    result.concat(buffer + pos, len - pos);
+    *this = std::move(result);
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+    if (index >= len) {
+        return;
+    }
+    if (count > len - index) {
+        count = len - index;
+    }
+    memmove(buffer + index, buffer + index + count, len - index - count + 1);
+    len -= count;
+}
+
+void String::toLowerCase() {
+    for (unsigned int i = 0; i < len; i++) {
+        buffer[i] = (char)tolower((unsigned char)buffer[i]);
+    }
+}
+
+void String::toUpperCase() {
+    for (unsigned int i = 0; i < len; i++) {
+        buffer[i] = (char)toupper((unsigned char)buffer[i]);
+    }
+}
+
+void String::trim() {
+    if (len == 0) {
+        return;
+    }
+    unsigned int start = 0;
+    while (start < len && isspace((unsigned char)buffer[start])) {
+        start++;
+    }
+    unsigned int end = len;
+    while (end > start && isspace((unsigned char)buffer[end - 1])) {
+        end--;
+    }
+    len = end - start;
+    if (start > 0) {
+        memmove(buffer, buffer + start, len);
+    }
+    buffer[len] = '\0';
+}
+
+long String::toInt() const {
+    return len ? atol(buffer) : 0;
+}
+
+float String::toFloat() const {
+    return (float)toDouble();
+}
+
+double String::toDouble() const {
+    return len ? atof(buffer) : 0.0;
+}
@@ -0,0 +1,146 @@
+#ifndef SIM_WSTRING_H
+#define SIM_WSTRING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// ============================================================================
+// ARDUINO STRING (HOST)
+// ============================================================================
+// Same storage model as the Arduino core: one heap buffer of capacity + 1
+// bytes for every non-empty string and no small-string buffer, so the heap
+// figures of the simulator follow the device.
+
+class __FlashStringHelper;
+
+class String {
+public:
+    String(const char* cstr = "");
+    String(const char* cstr, size_t length);
+    String(const String& other);
+    String(String&& other) noexcept;
+    String(const __FlashStringHelper* str) : String(reinterpret_cast<const char*>(str)) {}
+    explicit String(char c);
+    explicit String(unsigned char value, unsigned char base = 10);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(long long value, unsigned char base = 10);
+    explicit String(unsigned long long value, unsigned char base = 10);
+    explicit String(float value, unsigned char decimals = 2);
+    explicit String(double value, unsigned char decimals = 2);
+    ~String();
+
+    String& operator=(const String& other);
+    String& operator=(String&& other) noexcept;
+    String& operator=(const char* cstr);
+
+    bool reserve(unsigned int size);
+    unsigned int length() const { return len; }
+    bool isEmpty() const { return len == 0; }
+    const char* c_str() const { return buffer ? buffer : ""; }
+    explicit operator bool() const { return true; }
+
+    // Concatenation
+    bool concat(const String& str) { return concat(str.c_str(), str.len); }
+    bool concat(const char* cstr);
+    bool concat(const char* cstr, unsigned int length);
+    bool concat(char c) { return concat(&c, 1); }
+    bool concat(unsigned char value) { return concat(String(value)); }
+    bool concat(int value) { return concat(String(value)); }
+    bool concat(unsigned int value) { return concat(String(value)); }
+    bool concat(long value) { return concat(String(value)); }
+    bool concat(unsigned long value) { return concat(String(value)); }
+    bool concat(long long value) { return concat(String(value)); }
+    bool concat(unsigned long long value) { return concat(String(value)); }
+    bool concat(float value) { return concat(String(value)); }
+    bool concat(double value) { return concat(String(value)); }
+
+    template <typename T>
+    String& operator+=(const T& value) {
+        concat(value);
+        return *this;
+    }
+
+    // Comparison
+    int compareTo(const String& other) const;
+    bool equals(const String& other) const { return len == other.len && compareTo(other) == 0; }
+    bool equals(const char* cstr) const { return strcmp(c_str(), cstr ? cstr : "") == 0; }
+    bool equalsIgnoreCase(const String& other) const;
+    bool operator==(const String& other) const { return equals(other); }
+    bool operator==(const char* cstr) const { return equals(cstr); }
+    bool operator!=(const String& other) const { return !equals(other); }
+    bool operator!=(const char* cstr) const { return !equals(cstr); }
+    bool operator<(const String& other) const { return compareTo(other) < 0; }
+    bool operator>(const String& other) const { return compareTo(other) > 0; }
+    bool operator<=(const String& other) const { return compareTo(other) <= 0; }
+    bool operator>=(const String& other) const { return compareTo(other) >= 0; }
+    bool startsWith(const String& prefix) const { return startsWith(prefix, 0); }
+    bool startsWith(const String& prefix, unsigned int offset) const;
+    bool endsWith(const String& suffix) const;
+
+    // Characters
+    char charAt(unsigned int index) const { return index < len ? buffer[index] : 0; }
+    void setCharAt(unsigned int index, char c) { if (index < len) buffer[index] = c; }
+    char operator[](unsigned int index) const { return charAt(index); }
+    char& operator[](unsigned int index);
+    void getBytes(unsigned char* buf, unsigned int bufsize, unsigned int index = 0) const;
+    void toCharArray(char* buf, unsigned int bufsize, unsigned int index = 0) const {
+        getBytes(reinterpret_cast<unsigned char*>(buf), bufsize, index);
+    }
+    const char* begin() const { return c_str(); }
+    const char* end() const { return c_str() + len; }
+
+    // Search
+    int indexOf(char c, unsigned int from = 0) const;
+    int indexOf(const String& str, unsigned int from = 0) const;
+    int lastIndexOf(char c) const;
+    int lastIndexOf(const String& str) const;
+    String substring(unsigned int beginIndex) const { return substring(beginIndex, len); }
+    String substring(unsigned int beginIndex, unsigned int endIndex) const;
+
+    // Modification
+    void replace(char find, char replacement);
+    void replace(const String& find, const String& replacement);
+    void remove(unsigned int index) { remove(index, (unsigned int)-1); }
+    void remove(unsigned int index, unsigned int count);
+    void toLowerCase();
+    void toUpperCase();
+    void trim();
+
+    // Conversion
+    long toInt() const;
+    float toFloat() const;
+    double toDouble() const;
+
+private:
+    char* buffer;
+    unsigned int capacity;
+    unsigned int len;
+
+    void invalidate();
+    bool changeBuffer(unsigned int maxStrLen);
+    String& copy(const char* cstr, unsigned int length);
+    void move(String& other);
+};
+
+String operator+(const String& lhs, const String& rhs);
+String operator+(const String& lhs, const char* rhs);
+String operator+(const char* lhs, const String& rhs);
+String operator+(const String& lhs, char rhs);
+String operator+(const String& lhs, unsigned char rhs);
+String operator+(const String& lhs, int rhs);
+String operator+(const String& lhs, unsigned int rhs);
+String operator+(const String& lhs, long rhs);
+String operator+(const String& lhs, unsigned long rhs);
+String operator+(const String& lhs, long long rhs);
+String operator+(const String& lhs, unsigned long long rhs);
+String operator+(const String& lhs, float rhs);
+String operator+(const String& lhs, double rhs);
+
+inline bool operator==(const char* lhs, const String& rhs) { return rhs.equals(lhs); }
+inline bool operator!=(const char* lhs, const String& rhs) { return !rhs.equals(lhs); }
+
+#endif // SIM_WSTRING_H
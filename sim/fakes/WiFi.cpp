@@ -0,0 +1,31 @@
+#include "WiFi.h"
+#include "SPI.h"
+#include "../SimHardware.h"
+
+WiFiClass WiFi;
+SPIClass SPI;
+
+bool WiFiClass::mode(int m) {
+    if (m != wifiMode) {
+        wifiMode = m;
+        sim::observe("wifi", m == WIFI_OFF ? "off" : "ap");
+    }
+    return true;
+}
+
+bool WiFiClass::softAP(const char* ssid, const char* passphrase, int channel, int hidden, int maxConnections) {
+    (void)passphrase;
+    (void)channel;
+    (void)hidden;
+    (void)maxConnections;
+    sim::advanceUs(100000);   // Radio calibration and AP start
+    sim::observe("wifi", std::string("ap ") + (ssid ? ssid : ""));
+    return true;
+}
+
+bool WiFiClass::softAPdisconnect(bool wifiOff) {
+    if (wifiOff) {
+        mode(WIFI_OFF);
+    }
+    return true;
+}
@@ -0,0 +1,51 @@
+#ifndef SIM_WIFI_H
+#define SIM_WIFI_H
+
+// ============================================================================
+// WIFI
+// ============================================================================
+// The access point only "starts"; portal requests come from the scenario
+// through sim::httpRequest() (ESPAsyncWebServer.cpp).
+// ============================================================================
+
+#include <Arduino.h>
+
+#define WIFI_OFF 0
+#define WIFI_STA 1
+#define WIFI_AP 2
+#define WIFI_AP_STA 3
+
+struct IPAddress {
+    uint8_t bytes[4] = { 0, 0, 0, 0 };
+
+    IPAddress() {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : bytes{ a, b, c, d } {}
+    String toString() const {
+        char text[16];
+        snprintf(text, sizeof(text), "%u.%u.%u.%u", bytes[0], bytes[1], bytes[2], bytes[3]);
+        return String(text);
+    }
+};
+
+class WiFiClass {
+public:
+    bool mode(int m);
+    int getMode() { return wifiMode; }
+    bool softAP(const char* ssid, const char* passphrase = nullptr, int channel = 1, int hidden = 0, int maxConnections = 4);
+    bool softAPConfig(IPAddress local, IPAddress gateway, IPAddress subnet) {
+        (void)local; (void)gateway; (void)subnet;
+        return true;
+    }
+    bool softAPdisconnect(bool wifiOff = false);
+    IPAddress softAPIP() { return IPAddress(192, 168, 4, 1); }
+    uint8_t softAPgetStationNum() { return 0; }
+    bool disconnect(bool wifiOff = false, bool eraseAp = false) { (void)eraseAp; return softAPdisconnect(wifiOff); }
+    bool setSleep(bool enabled) { (void)enabled; return true; }
+
+private:
+    int wifiMode = WIFI_OFF;
+};
+
+extern WiFiClass WiFi;
+
+#endif // SIM_WIFI_H
@@ -0,0 +1,148 @@
+#include "Wire.h"
+#include "../SimHardware.h"
+#include <cstring>
+
+TwoWire Wire;
+TwoWire Wire1;
+
+// ============================================================================
+// TLV320DAC3100 MODEL
+// ============================================================================
+// Only what the firmware reads back or a listener would notice: register 0
+// selects the page, the DAC flag register reports both channels powered, and
+// the class-D amp bit (page 1, reg 0x20, D7) switches the speaker.
+
+namespace {
+
+const uint8_t kTlvAddress = 0x18;
+const uint8_t kFuelGaugeAddress = 0x36;
+const uint8_t kTlvPages = 2;
+const uint8_t kSpeakerAmpReg = 0x20;
+const uint8_t kSpeakerAmpBit = 0x80;
+const uint8_t kDacFlagReg = 0x25;
+
+uint8_t g_tlvPage = 0;
+uint8_t g_tlvRegs[kTlvPages][128];
+uint8_t g_tlvRegPointer = 0;
+
+bool deviceAcks(uint8_t address) {
+    return address == kTlvAddress || address == kFuelGaugeAddress;
+}
+
+} // namespace
+
+namespace sim {
+
+uint8_t tlvRegister(uint8_t page, uint8_t reg) {
+    if (reg == 0) {
+        return g_tlvPage;
+    }
+    if (page == 0 && reg == kDacFlagReg) {
+        return bclkRunning() ? 0x88 : 0x00;   // Left and right DAC powered once the PLL has BCLK
+    }
+    return page < kTlvPages && reg < 128 ? g_tlvRegs[page][reg] : 0;
+}
+
+void tlvWriteRegister(uint8_t page, uint8_t reg, uint8_t value) {
+    if (reg == 0) {
+        g_tlvPage = value;
+        return;
+    }
+    if (page >= kTlvPages || reg >= 128) {
+        return;
+    }
+    const uint8_t previous = g_tlvRegs[page][reg];
+    g_tlvRegs[page][reg] = value;
+    if (page == 1 && reg == kSpeakerAmpReg && ((previous ^ value) & kSpeakerAmpBit)) {
+        observe("speaker", (value & kSpeakerAmpBit) ? "on" : "off");
+        if (outputAudible()) {
+            counters().speakerPops++;
+        }
+    }
+}
+
+} // namespace sim
+
+// ============================================================================
+// BUS
+// ============================================================================
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency) {
+    (void)sda;
+    (void)scl;
+    setClock(frequency);
+    return true;
+}
+
+// Start, address, data and ACK bits: 9 clocks per byte
+void TwoWire::chargeBytes(size_t bytes) {
+    sim::counters().i2cTransactions++;
+    sim::advanceUs((uint64_t)(bytes + 1) * 9 * 1000000 / clockHz);
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+    txAddress = address;
+    txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t c) {
+    if (txLength >= kBufferSize) {
+        return 0;
+    }
+    txBuffer[txLength++] = c;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (n < size && write(buffer[n])) {
+        n++;
+    }
+    return n;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+    (void)sendStop;
+    chargeBytes(txLength);
+    if (!deviceAcks(txAddress)) {
+        return 2;   // NACK on address
+    }
+    if (txAddress == kTlvAddress && txLength > 0) {
+        sim::SimCounters& c = sim::counters();
+        g_tlvRegPointer = txBuffer[0];
+        if (txLength > 1 && g_tlvRegPointer == 0) {
+            c.dacPageSelects++;
+        } else if (txLength > 1) {
+            c.dacWrites++;
+            c.dacBursts += txLength > 2 ? 1 : 0;
+        }
+        for (size_t i = 1; i < txLength; i++) {
+            if (g_tlvRegPointer != 0 && sim::tlvRegister(g_tlvPage, g_tlvRegPointer) == txBuffer[i]) {
+                c.dacUnchangedWrites++;
+            }
+            sim::tlvWriteRegister(g_tlvPage, g_tlvRegPointer++, txBuffer[i]);
+        }
+    }
+    return 0;
+}
+
+size_t TwoWire::requestFrom(uint8_t address, size_t length, bool sendStop) {
+    (void)sendStop;
+    rxIndex = 0;
+    rxLength = 0;
+    chargeBytes(length);
+    if (!deviceAcks(address)) {
+        return 0;
+    }
+    if (length > kBufferSize) {
+        length = kBufferSize;
+    }
+    if (address == kTlvAddress) {
+        sim::counters().dacReads++;
+    }
+    for (size_t i = 0; i < length; i++) {
+        rxBuffer[i] = address == kTlvAddress ? sim::tlvRegister(g_tlvPage, g_tlvRegPointer++) : 0;
+    }
+    rxLength = length;
+    return length;
+}
@@ -0,0 +1,61 @@
+#ifndef SIM_WIRE_H
+#define SIM_WIRE_H
+
+// ============================================================================
+// WIRE (I2C)
+// ============================================================================
+// I2C master with the devices on the board's bus behind it: the TLV320DAC3100
+// at 0x18 (paged register file, auto-increment writes) and the MAX17048 at
+// 0x36 (ACK only; the fuel gauge fake answers its reads directly). Other
+// addresses NACK. Each transaction is counted and charged at the bus clock.
+// ============================================================================
+
+#include <Arduino.h>
+
+class TwoWire : public Stream {
+public:
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+    void end() {}
+    void setClock(uint32_t frequency) { clockHz = frequency ? frequency : 100000; }
+    void setTimeOut(uint16_t timeoutMs) { (void)timeoutMs; }
+
+    void beginTransmission(uint8_t address);
+    void beginTransmission(int address) { beginTransmission((uint8_t)address); }
+    uint8_t endTransmission(bool sendStop = true);
+    size_t requestFrom(uint8_t address, size_t length, bool sendStop = true);
+    size_t requestFrom(uint8_t address, uint8_t length) { return requestFrom(address, (size_t)length, true); }
+    size_t requestFrom(int address, int length) { return requestFrom((uint8_t)address, (size_t)length, true); }
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    int available() override { return (int)(rxLength - rxIndex); }
+    int read() override { return rxIndex < rxLength ? rxBuffer[rxIndex++] : -1; }
+    int peek() override { return rxIndex < rxLength ? rxBuffer[rxIndex] : -1; }
+
+private:
+    static const size_t kBufferSize = 128;
+
+    uint32_t clockHz = 100000;
+    uint8_t txAddress = 0;
+    uint8_t txBuffer[kBufferSize];
+    size_t txLength = 0;
+    uint8_t rxBuffer[kBufferSize];
+    size_t rxLength = 0;
+    size_t rxIndex = 0;
+
+    void chargeBytes(size_t bytes);
+};
+
+extern TwoWire Wire;
+extern TwoWire Wire1;
+
+namespace sim {
+
+// TLV320DAC3100 register, for the codec library fake and the report
+uint8_t tlvRegister(uint8_t page, uint8_t reg);
+void tlvWriteRegister(uint8_t page, uint8_t reg, uint8_t value);
+
+} // namespace sim
+
+#endif // SIM_WIRE_H
@@ -0,0 +1,36 @@
+#ifndef SIM_ESP_SLEEP_H
+#define SIM_ESP_SLEEP_H
+
+// ============================================================================
+// ESP SLEEP
+// ============================================================================
+// Light sleep jumps the virtual clock to the timer, or to the first scenario
+// event that moves an armed wake pin. Deep sleep ends the run.
+// ============================================================================
+
+#include <stdint.h>
+#include "driver/gpio.h"
+
+typedef enum {
+    ESP_SLEEP_WAKEUP_UNDEFINED,
+    ESP_SLEEP_WAKEUP_ALL,
+    ESP_SLEEP_WAKEUP_EXT0,
+    ESP_SLEEP_WAKEUP_EXT1,
+    ESP_SLEEP_WAKEUP_TIMER,
+    ESP_SLEEP_WAKEUP_TOUCHPAD,
+    ESP_SLEEP_WAKEUP_ULP,
+    ESP_SLEEP_WAKEUP_GPIO,
+    ESP_SLEEP_WAKEUP_UART
+} esp_sleep_source_t;
+
+typedef esp_sleep_source_t esp_sleep_wakeup_cause_t;
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us);
+esp_err_t esp_sleep_enable_gpio_wakeup();
+esp_err_t esp_sleep_enable_ext0_wakeup(gpio_num_t gpio_num, int level);
+esp_err_t esp_sleep_disable_wakeup_source(esp_sleep_source_t source);
+esp_err_t esp_light_sleep_start();
+void esp_deep_sleep_start();
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause();
+
+#endif // SIM_ESP_SLEEP_H
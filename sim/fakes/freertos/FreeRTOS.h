@@ -0,0 +1,40 @@
+#ifndef SIM_FREERTOS_H
+#define SIM_FREERTOS_H
+
+// ============================================================================
+// FREERTOS (HOST)
+// ============================================================================
+// The simulator is single-threaded: critical sections are empty, a task
+// runs to completion inside the call that creates it (see freertos/task.h)
+// and ticks are milliseconds of the virtual clock.
+
+#include <cstdint>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void* TaskHandle_t;
+
+typedef struct {
+    uint32_t owner;
+    uint32_t count;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED { 0, 0 }
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux) ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux) ((void)(mux))
+
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE ((BaseType_t)1)
+#define pdFAIL pdFALSE
+#define pdPASS pdTRUE
+
+#define portTICK_PERIOD_MS ((TickType_t)1)
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define tskIDLE_PRIORITY ((UBaseType_t)0)
+#define tskNO_AFFINITY ((BaseType_t)0x7fffffff)
+
+#endif // SIM_FREERTOS_H
@@ -0,0 +1,19 @@
+#ifndef SIM_FREERTOS_EVENT_GROUPS_H
+#define SIM_FREERTOS_EVENT_GROUPS_H
+
+#include "FreeRTOS.h"
+
+// Tasks have finished by the time anyone waits, so waiting never blocks:
+// the wait returns the bits as they are
+typedef void* EventGroupHandle_t;
+typedef uint32_t EventBits_t;
+
+EventGroupHandle_t xEventGroupCreate();
+void vEventGroupDelete(EventGroupHandle_t group);
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits);
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits);
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group);
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clearOnExit,
+                                BaseType_t waitForAll, TickType_t ticks);
+
+#endif // SIM_FREERTOS_EVENT_GROUPS_H
@@ -0,0 +1,15 @@
+#ifndef SIM_FREERTOS_SEMPHR_H
+#define SIM_FREERTOS_SEMPHR_H
+
+#include "FreeRTOS.h"
+
+// With one thread a mutex is always free
+typedef void* SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex();
+SemaphoreHandle_t xSemaphoreCreateBinary();
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+void vSemaphoreDelete(SemaphoreHandle_t semaphore);
+
+#endif // SIM_FREERTOS_SEMPHR_H
@@ -0,0 +1,23 @@
+#ifndef SIM_FREERTOS_TASK_H
+#define SIM_FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+// A created task runs inline until it returns or deletes itself. A task
+// that blocks (vTaskDelay) is a service loop the single-threaded simulator
+// cannot host: it is unwound at that point and creation reports pdFAIL, so
+// the firmware takes its no-task fallback.
+
+typedef void (*TaskFunction_t)(void*);
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char* name, uint32_t stackDepth, void* parameter,
+                       UBaseType_t priority, TaskHandle_t* createdTask);
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t stackDepth,
+                                   void* parameter, UBaseType_t priority, TaskHandle_t* createdTask,
+                                   BaseType_t coreId);
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount();
+BaseType_t xPortGetCoreID();
+
+#endif // SIM_FREERTOS_TASK_H
@@ -0,0 +1,518 @@
+// ============================================================================
+// SIM - HOST RUNNER
+// ============================================================================
+// Links src/ against the fakes in sim/fakes, replays a scenario on the
+// virtual clock and prints a timing report. Exits with 1 if an expect line
+// of the scenario failed:
+//
+//   sim <scenario> [--sd DIR] [--keep-sd] [--wav FILE] [--log FILE|-]
+//                  [--nvs FILE] [--loop-cost-us N] [--timeline]
+//
+//   --sd DIR          Host directory used as the SD card (default: a fresh
+//                     directory under /tmp). Scenario folders are generated
+//                     into it; existing files are kept.
+//   --keep-sd         Keep the fresh /tmp directory (removed on exit otherwise)
+//   --wav FILE        Write everything sent to I2S as 16-bit stereo WAV
+//   --log FILE|-      Serial output (default: discarded)
+//   --nvs FILE        Load NVS before the run and save it afterwards
+//   --loop-cost-us N  CPU time charged per loop() at 240 MHz (default 100),
+//                     on top of what the fakes charge for I/O
+//   --timeline        List every observation after the report
+// ============================================================================
+
+#include <Arduino.h>
+#include <AudioTools.h>
+#include <Preferences.h>
+#include <SD_MMC.h>
+#include "Audio_Manager.h"
+#include "Logger.h"
+#include "PowerGovernor.h"
+#include "Scenario.h"
+#include "SimHardware.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+
+void setup();
+void loop();
+
+extern Audio_Manager audioManager;
+extern PowerGovernor powerGovernor;
+
+namespace {
+
+struct Options {
+    std::string scenario;
+    std::string sdDir;
+    bool tempSd = false;   // sdDir was created by us
+    bool keepSd = false;
+    std::string wavPath;
+    std::string logPath;
+    std::string nvsPath;
+    uint64_t loopCostUs = 100;
+    bool timeline = false;
+};
+
+void usage() {
+    fprintf(stderr,
+            "usage: sim <scenario> [--sd DIR] [--keep-sd] [--wav FILE] [--log FILE|-]\n"
+            "           [--nvs FILE] [--loop-cost-us N] [--timeline]\n");
+}
+
+bool parseArgs(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--sd" && hasValue) {
+            options.sdDir = argv[++i];
+        } else if (arg == "--keep-sd") {
+            options.keepSd = true;
+        } else if (arg == "--wav" && hasValue) {
+            options.wavPath = argv[++i];
+        } else if (arg == "--log" && hasValue) {
+            options.logPath = argv[++i];
+        } else if (arg == "--nvs" && hasValue) {
+            options.nvsPath = argv[++i];
+        } else if (arg == "--loop-cost-us" && hasValue) {
+            options.loopCostUs = strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--timeline") {
+            options.timeline = true;
+        } else if (arg[0] != '-' && options.scenario.empty()) {
+            options.scenario = arg;
+        } else {
+            return false;
+        }
+    }
+    return !options.scenario.empty();
+}
+
+// ============================================================================
+// REPORT
+// ============================================================================
+
+const uint64_t kLatencyWindowUs = 10000000;
+
+// Kinds that follow from the input itself rather than the firmware's reaction
+bool isReaction(const sim::Observation& o) {
+    return o.kind != "pin" && o.kind != "led" && o.kind != "wifi";
+}
+
+double ms(uint64_t us) {
+    return us / 1000.0;
+}
+
+uint64_t percentile(const std::vector<uint64_t>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    const size_t index = std::min(sorted.size() - 1, (size_t)(p * (sorted.size() - 1) + 0.5));
+    return sorted[index];
+}
+
+void printDistribution(const char* label, std::vector<uint64_t> values, const char* unit) {
+    std::sort(values.begin(), values.end());
+    printf("  %-22s p50 %8llu  p90 %8llu  p99 %8llu  max %8llu %s\n", label,
+           (unsigned long long)percentile(values, 0.50), (unsigned long long)percentile(values, 0.90),
+           (unsigned long long)percentile(values, 0.99), (unsigned long long)percentile(values, 1.0), unit);
+}
+
+// One in-track seek (scrub step) as Audio_Manager reported it
+struct SeekStep {
+    uint64_t atUs;
+    uint32_t positionMs;
+    uint32_t durationMs;
+    uint32_t latencyUs;
+    std::string index;   // How the track's frame index was made
+};
+
+SeekStep seekStep() {
+    const Mp3FrameIndex& index = audioManager.getFrameIndex();
+    std::string how = index.getSourceName();
+    if (index.isFromCache()) {
+        how += ", from cache";
+    } else if (!index.isComplete()) {
+        how += ", walked to " + std::to_string(index.getIndexedMs() / 1000) + " s";
+    }
+    return SeekStep{ sim::nowUs(), audioManager.getPositionMs(), audioManager.getDurationMs(),
+                     audioManager.getLastSeekLatencyUs(), how };
+}
+
+std::string trackTime(uint32_t ms) {
+    const unsigned long tenths = ms / 100;
+    char text[24];
+    snprintf(text, sizeof(text), "%lu:%02lu.%lu", tenths / 600, tenths % 600 / 10, tenths % 10);
+    return text;
+}
+
+void printSeeks(const std::vector<SeekStep>& seeks) {
+    std::vector<uint64_t> latencies;
+    for (const SeekStep& seek : seeks) {
+        latencies.push_back(seek.latencyUs);
+    }
+    std::sort(latencies.begin(), latencies.end());
+    printf("\nSeeks (%zu, latency p50 %llu us, max %llu us)\n", seeks.size(),
+           (unsigned long long)percentile(latencies, 0.50), (unsigned long long)percentile(latencies, 1.0));
+    for (const SeekStep& seek : seeks) {
+        printf("  %10.1f ms  to %s of %s  %6u us  %s\n", ms(seek.atUs), trackTime(seek.positionMs).c_str(),
+               trackTime(seek.durationMs).c_str(), seek.latencyUs, seek.index.c_str());
+    }
+}
+
+// Latency to the first reaction after each event, UINT64_MAX if none
+std::vector<uint64_t> eventLatencies(const sim::Scenario& scenario,
+                                     const std::vector<sim::Observation>& observations) {
+    std::vector<uint64_t> latencies;
+    size_t first = 0;
+    for (size_t i = 0; i < scenario.events.size(); i++) {
+        const sim::ScenarioEvent& event = scenario.events[i];
+        uint64_t windowEnd = event.atUs + kLatencyWindowUs;
+        if (i + 1 < scenario.events.size()) {
+            windowEnd = std::min(windowEnd, scenario.events[i + 1].atUs);
+        }
+        while (first < observations.size() && observations[first].atUs < event.atUs) {
+            first++;
+        }
+        uint64_t latency = UINT64_MAX;
+        for (size_t j = first; j < observations.size() && observations[j].atUs < windowEnd; j++) {
+            if (isReaction(observations[j])) {
+                latency = observations[j].atUs - event.atUs;
+                break;
+            }
+        }
+        latencies.push_back(latency);
+    }
+    return latencies;
+}
+
+const sim::Observation* reactionTo(const sim::ScenarioEvent& event, uint64_t latency,
+                                   const std::vector<sim::Observation>& observations) {
+    for (const sim::Observation& o : observations) {
+        if (o.atUs == event.atUs + latency && isReaction(o)) {
+            return &o;
+        }
+    }
+    return nullptr;
+}
+
+// One line per event; a repeat line is summarised on the line of its first event
+// The governor's own figures next to the same estimate over the time the
+// fakes saw at 240 MHz, at a lower clock and in light sleep since power-on
+void printPower(const sim::SimCounters& c) {
+    const uint64_t fullUs = sim::cpuFullSpeedUs();
+    const uint64_t reducedUs = sim::nowUs() - fullUs - c.lightSleepUs;   // Light sleep follows the idle clock
+    const float measuredMa = PowerGovernor::estimateCurrentMa((uint32_t)(fullUs / 1000), (uint32_t)(reducedUs / 1000),
+                                                              (uint32_t)(c.lightSleepUs / 1000));
+    const float capacityMah = powerGovernor.getBatteryCapacity();
+
+    printf("\nPower (%.0f mAh battery)\n", capacityMah);
+    printf("  CPU clock changes %u, light sleeps %u (%.1f ms)\n", c.cpuMhzChanges, c.lightSleeps,
+           ms(c.lightSleepUs));
+    printf("  governor  average %.1f mA, estimated runtime %.1f h\n", powerGovernor.getAverageCurrentMa(),
+           powerGovernor.getEstimatedRuntimeHours());
+    printf("  measured  average %.1f mA, estimated runtime %.1f h (240 MHz %.1f s, lower clock %.1f s, "
+           "light sleep %.1f s)\n",
+           measuredMa, capacityMah / measuredMa, fullUs / 1e6, reducedUs / 1e6, c.lightSleepUs / 1e6);
+}
+
+void printEvents(const sim::Scenario& scenario, const std::vector<sim::Observation>& observations) {
+    const std::vector<uint64_t> latencies = eventLatencies(scenario, observations);
+    printf("\nEvents (latency to the first reaction before the next event)\n");
+    std::vector<bool> groupPrinted;
+    for (size_t i = 0; i < scenario.events.size(); i++) {
+        const sim::ScenarioEvent& event = scenario.events[i];
+        if (event.repeatGroup >= 0) {
+            if ((size_t)event.repeatGroup >= groupPrinted.size()) {
+                groupPrinted.resize(event.repeatGroup + 1, false);
+            }
+            if (groupPrinted[event.repeatGroup]) {
+                continue;
+            }
+            groupPrinted[event.repeatGroup] = true;
+
+            std::vector<uint64_t> reacted;
+            size_t count = 0;
+            for (size_t j = i; j < scenario.events.size(); j++) {
+                if (scenario.events[j].repeatGroup != event.repeatGroup) {
+                    continue;
+                }
+                count++;
+                if (latencies[j] != UINT64_MAX) {
+                    reacted.push_back(latencies[j]);
+                }
+            }
+            std::sort(reacted.begin(), reacted.end());
+            const std::string label = event.text + " x" + std::to_string(count);
+            if (reacted.empty()) {
+                printf("  %9.1f ms  %-28s %11s  (no reaction)\n", ms(event.atUs), label.c_str(), "-");
+                continue;
+            }
+            printf("  %9.1f ms  %-28s p50 %.1f ms, p99 %.1f ms, max %.1f ms, %zu without reaction\n",
+                   ms(event.atUs), label.c_str(), ms(percentile(reacted, 0.50)), ms(percentile(reacted, 0.99)),
+                   ms(percentile(reacted, 1.0)), count - reacted.size());
+            continue;
+        }
+
+        const sim::Observation* reaction =
+            latencies[i] == UINT64_MAX ? nullptr : reactionTo(event, latencies[i], observations);
+        if (reaction) {
+            printf("  %9.1f ms  %-28s %8.1f ms  %s %s\n", ms(event.atUs), event.text.c_str(), ms(latencies[i]),
+                   reaction->kind.c_str(), reaction->detail.c_str());
+        } else {
+            printf("  %9.1f ms  %-28s %11s  (no reaction)\n", ms(event.atUs), event.text.c_str(), "-");
+        }
+    }
+}
+
+void printHeap(const char* label, const sim::HeapLayout& layout, size_t live, uint64_t allocations) {
+    const double fragmentation = layout.freeBytes ? 1.0 - (double)layout.largestFreeBlock / layout.freeBytes : 0.0;
+    printf("  %-5s %7llu allocs, live %zu bytes, free %zu in %zu blocks, largest %zu, fragmentation %.1f%%\n",
+           label, (unsigned long long)allocations, live, layout.freeBytes, layout.freeBlocks,
+           layout.largestFreeBlock, fragmentation * 100.0);
+}
+
+// Returns the number of failed checks
+size_t printChecks() {
+    const std::vector<sim::CheckResult>& results = sim::checkResults();
+    if (results.empty()) {
+        return 0;
+    }
+    size_t failed = 0;
+    printf("\nChecks\n");
+    for (const sim::CheckResult& result : results) {
+        const bool ok = result.reached && result.passed;
+        failed += ok ? 0 : 1;
+        printf("  %9.1f ms  %-44s %s", ms(result.atUs), result.text.c_str(), ok ? "ok" : "FAILED");
+        if (!result.reached) {
+            printf(" (not reached)\n");
+        } else {
+            printf(" (%s)\n", result.actual.c_str());
+        }
+    }
+    return failed;
+}
+
+void printTimeline(const std::vector<sim::Observation>& observations) {
+    printf("\nTimeline\n");
+    for (const sim::Observation& o : observations) {
+        printf("  %11.3f ms  %-8s %s\n", o.atUs / 1000.0, o.kind.c_str(), o.detail.c_str());
+    }
+}
+
+// Everything before setup() is the harness, not the firmware: allocations
+// are kept out of the heap report. Returns the exit code, -1 to run.
+int prepare(int argc, char** argv, Options& options, sim::Scenario& scenario, FILE*& log) {
+    sim::Untracked untracked;
+    if (!parseArgs(argc, argv, options)) {
+        usage();
+        return 2;
+    }
+
+    std::string error;
+    if (!sim::loadScenario(options.scenario, scenario, error)) {
+        fprintf(stderr, "sim: %s\n", error.c_str());
+        return 1;
+    }
+
+    if (options.sdDir.empty()) {
+        char dir[] = "/tmp/sim-sd-XXXXXX";
+        if (!mkdtemp(dir)) {
+            fprintf(stderr, "sim: cannot create a temporary SD directory\n");
+            return 1;
+        }
+        options.sdDir = dir;
+        options.tempSd = true;
+    }
+    if (!sim::prepareCard(options.sdDir, scenario, error)) {
+        fprintf(stderr, "sim: %s\n", error.c_str());
+        return 1;
+    }
+    SD_MMC.setHostRoot(options.sdDir);
+
+    if (options.logPath == "-") {
+        log = stdout;
+    } else if (!options.logPath.empty()) {
+        log = fopen(options.logPath.c_str(), "w");
+        if (!log) {
+            fprintf(stderr, "sim: cannot write %s\n", options.logPath.c_str());
+            return 1;
+        }
+    }
+    sim::setUartOutput(log);
+
+    if (!options.nvsPath.empty()) {
+        sim::loadNvs(options.nvsPath);
+    }
+    if (!options.wavPath.empty() && !sim::openWav(options.wavPath)) {
+        fprintf(stderr, "sim: cannot write %s\n", options.wavPath.c_str());
+        return 1;
+    }
+    sim::applyScenario(scenario, options.sdDir);
+    return -1;
+}
+
+void removeTempSd(const Options& options) {
+    if (options.tempSd && !options.keepSd) {
+        std::error_code ec;
+        std::filesystem::remove_all(options.sdDir, ec);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    sim::Scenario scenario;
+    FILE* log = nullptr;
+    const int exitCode = prepare(argc, argv, options, scenario, log);
+    if (exitCode >= 0) {
+        removeTempSd(options);
+        return exitCode;
+    }
+
+    // Run until the scenario ends, the firmware restarts or goes to deep sleep
+    std::vector<uint64_t> loopVirtualUs;
+    std::vector<uint64_t> loopHostNs;
+    uint64_t bootUs = 0;
+    bool booted = false;
+    sim::HeapLayout bootHeap = {};
+    size_t bootLive = 0;
+    uint64_t bootAllocations = 0;
+    const uint64_t firstEventUs = scenario.events.empty() ? UINT64_MAX : scenario.events.front().atUs;
+    bool eventsStarted = false;
+    sim::HeapLayout eventsHeap = {};
+    size_t eventsLive = 0;
+    uint64_t eventsAllocations = 0;
+    std::vector<SeekStep> seeks;
+    uint32_t seekCount = 0;
+    std::string stopReason = "scenario end";
+    try {
+        setup();
+        bootUs = sim::nowUs();
+        booted = true;
+        bootHeap = sim::heapLayout();
+        bootLive = sim::heapLiveBytes();
+        bootAllocations = sim::heapAllocations();
+        for (;;) {
+            const uint64_t startUs = sim::nowUs();
+            if (!eventsStarted && startUs >= firstEventUs) {
+                // Heap as the firmware's loop is about to see the first event
+                eventsStarted = true;
+                eventsHeap = sim::heapLayout();
+                eventsLive = sim::heapLiveBytes();
+                eventsAllocations = sim::heapAllocations();
+            }
+            const auto hostStart = std::chrono::steady_clock::now();
+            loop();
+            if (audioManager.getSeekCount() != seekCount) {
+                sim::Untracked untracked;
+                seekCount = audioManager.getSeekCount();
+                seeks.push_back(seekStep());
+            }
+            {
+                sim::OtherCore logTask;
+                flushDeferredLogs();
+            }
+            sim::advanceUs(options.loopCostUs * 240 / getCpuFrequencyMhz());
+            const auto hostEnd = std::chrono::steady_clock::now();
+            sim::Untracked untracked;
+            loopVirtualUs.push_back(sim::nowUs() - startUs);
+            loopHostNs.push_back(
+                (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(hostEnd - hostStart).count());
+        }
+    } catch (const sim::SimStop& stop) {
+        sim::Untracked untracked;
+        if (!stop.reason.empty()) {
+            stopReason = stop.reason;
+        }
+    }
+    const sim::HeapLayout endHeap = sim::heapLayout();
+    const size_t endLive = sim::heapLiveBytes();
+    const size_t heapPeak = sim::heapPeakBytes();
+    const uint64_t heapAllocations = sim::heapAllocations();
+    sim::Untracked report;
+
+    // Drain what is still on its way out; nothing else may stop the run now
+    sim::setStopUs(UINT64_MAX);
+    sim::uartFlush(true);
+    sim::closeWav();
+    if (!options.nvsPath.empty()) {
+        sim::saveNvs(options.nvsPath);
+    }
+    if (log && log != stdout) {
+        fclose(log);
+    }
+
+    // Observations were recorded as they happened; audio ones may carry the
+    // time the sound leaves the DAC, so order them before matching
+    std::vector<sim::Observation> observations = sim::observations();
+    std::stable_sort(observations.begin(), observations.end(),
+                     [](const sim::Observation& a, const sim::Observation& b) { return a.atUs < b.atUs; });
+
+    const sim::SimCounters& c = sim::counters();
+    const sim::AudioStats& audio = sim::audioStats();
+
+    printf("Scenario %s: stopped at %.1f ms (%s)\n", scenario.name.c_str(), ms(sim::nowUs()), stopReason.c_str());
+    printf("SD card  %s%s\n", options.sdDir.c_str(),
+           options.tempSd && !options.keepSd ? " (removed on exit, --keep-sd keeps it)" : "");
+    if (booted) {
+        printf("Boot     %.1f ms until setup() returned\n", ms(bootUs));
+    } else {
+        printf("Boot     did not finish\n");
+    }
+
+    printEvents(scenario, observations);
+
+    printf("\nLoop (%zu iterations)\n", loopVirtualUs.size());
+    printDistribution("virtual time", loopVirtualUs, "us");
+    printDistribution("host time", loopHostNs, "ns");
+
+    printf("\nAudio\n");
+    printf("  tracks started %u, frames %llu (%.1f s), decode %.1f ms\n", audio.tracksStarted,
+           (unsigned long long)audio.framesPlayed, audio.framesPlayed / 44100.0, ms(audio.decodeUs));
+    printf("  underruns %u (%.1f ms), blocked on I2S %.1f ms\n", audio.underruns, ms(audio.underrunUs),
+           ms(audio.blockedUs));
+
+    if (!seeks.empty()) {
+        printSeeks(seeks);
+    }
+
+    printf("\nSD card\n");
+    printf("  opens %u (+%u failed), dir entries %u, exists %u\n", c.sdOpens, c.sdOpenFailures, c.sdDirEntries,
+           c.sdExists);
+    printf("  reads %u (%llu bytes), writes %u (%llu bytes), seeks %u\n", c.sdReadCalls,
+           (unsigned long long)c.sdBytesRead, c.sdWriteCalls, (unsigned long long)c.sdBytesWritten, c.sdSeeks);
+    printf("  mkdir %u, remove %u, rename %u\n", c.sdMkdirs, c.sdRemoves, c.sdRenames);
+
+    printf("\nOther\n");
+    printf("  NVS writes %u, I2C transactions %u, RFID polls %u, LED shows %u\n", c.nvsWrites, c.i2cTransactions,
+           c.rfidPolls, c.ledShows);
+    if (c.httpRequests) {
+        printf("  HTTP requests %u (%u errors)\n", c.httpRequests, c.httpErrors);
+    }
+
+    printPower(c);
+
+    printf("\nHeap (high-water %zu bytes; allocations counted from power-on)\n", heapPeak);
+    if (booted) {
+        printHeap("boot", bootHeap, bootLive, bootAllocations);
+    }
+    if (eventsStarted) {
+        printHeap("event", eventsHeap, eventsLive, eventsAllocations);
+    }
+    printHeap("end", endHeap, endLive, heapAllocations);
+    if (endHeap.unplaced) {
+        printf("  %llu allocations did not fit the %zu byte arena\n", (unsigned long long)endHeap.unplaced,
+               sim::kHeapTotalBytes);
+    }
+
+    sim::finishChecks(scenario, stopReason);
+    const size_t failedChecks = printChecks();
+
+    if (options.timeline) {
+        printTimeline(observations);
+    }
+    removeTempSd(options);
+    return failedChecks ? 1 : 0;
+}
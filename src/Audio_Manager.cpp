@@ -10,10 +10,10 @@ constexpr uint8_t Audio_Manager::kDefaultBufferCount;
 
 // Constructor
 Audio_Manager::Audio_Manager(const char* folder, const char* ext, FileSelectionMode mode)
-    : source(nullptr), i2s(nullptr), volume(nullptr), decoder(nullptr), player(nullptr),
-      audioFolder(folder), fileExtension(ext), currentVolume(kDefaultVolume),
+    : source(nullptr), i2s(nullptr), volume(nullptr), ramp(nullptr), decoder(nullptr), player(nullptr),
+      audioFolder(folder), fileExtension(ext), currentVolume(kDefaultVolume), outputGain(1.0f),
       audioInitialized(false), playerActive(false), filesListed(false), filesAvailable(false),
-      fileSelectionMode(mode), currentFileIndex(0),
+      fileSelectionMode(mode), currentFileIndex(0), lastSeekLatencyUs(0), seekCount(0),
       i2sBckPin(26), i2sWsPin(25), i2sDataPin(32), i2sChannels(2), i2sBitsPerSample(16),
       i2sBufferSize(kDefaultBufferSize), i2sBufferCount(kDefaultBufferCount),
       totalAudioFiles(0) {
@@ -24,15 +24,10 @@ Audio_Manager::Audio_Manager(const char* folder, const char* ext, FileSelectionM
 
 // Destructor
 Audio_Manager::~Audio_Manager() {
-    // Clean up audio pipeline
+    // Pipeline objects live in the slots for the life of the program
     if (player) {
         player->stop();
-        delete player;
     }
-    if (volume) delete volume;
-    if (decoder) delete decoder;
-    if (source) delete source;
-    if (i2s) delete i2s;
 }
 
 // Initialize audio manager
@@ -68,7 +63,9 @@ bool Audio_Manager::begin() {
 bool Audio_Manager::initializeI2S() {
     LOG_AUDIO_DEBUG("Initializing I2S...");
 
-    i2s = new I2SStream();
+    if (!i2s) {
+        i2s = i2sSlot.construct();
+    }
 
     // Build the real config ONCE and keep it
     i2sCfg_ = i2s->defaultConfig(TX_MODE);
@@ -105,12 +102,26 @@ bool Audio_Manager::initializeAudioPipeline() {
         
         // Create AudioSourceSDMMC that will scan the entire folder for audio files
         // This will automatically find all files with the specified extension
-    source = new AudioSourceSDMMC(sourcePath, fileExtension.c_str());
+    // A second begin() re-targets the objects built by the first one
+    if (source) {
+        source->retarget(sourcePath);
+    } else {
+        source = sourceSlot.construct(sourcePath, fileExtension.c_str());
+    }
         
-        LOG_AUDIO_DEBUG("Audio source created for path: %s with extension: %s", sourcePath, fileExtension);
+        LOG_AUDIO_DEBUG("Audio source created for path: %s with extension: %s", sourcePath, fileExtension.c_str());
+        
+        // Route-change gain ramp, between the volume stream and I2S
+        if (!ramp) {
+            ramp = rampSlot.construct(*i2s);
+        }
+        ramp->begin(i2sCfg_.sample_rate, i2sCfg_.channels, (uint32_t)i2sCfg_.buffer_size * i2sCfg_.buffer_count);
+        ramp->setGain(outputGain);
         
         // Create volume stream
-        volume = new VolumeStream(*i2s);
+        if (!volume) {
+            volume = volumeSlot.construct(*ramp);
+        }
         auto vcfg = volume->defaultConfig();
         vcfg.copyFrom(i2sCfg_);
         if (!volume->begin(vcfg)) {
@@ -119,15 +130,19 @@ bool Audio_Manager::initializeAudioPipeline() {
         }
         
         // Create MP3 decoder
-        decoder = new MP3DecoderHelix();
+        if (!decoder) {
+            decoder = decoderSlot.construct();
+        }
         
         // Create audio player
-        player = new AudioPlayer(*source, *volume, *decoder);
+        if (!player) {
+            player = playerSlot.construct(*source, *volume, *decoder);
+        }
         player->setBufferSize(i2sCfg_.buffer_size);
         
         // Set initial volume
         LOG_AUDIO_DEBUG("Setting initial volume: %.2f", currentVolume);
-        volume->setVolume(currentVolume);
+        applyVolume();
         
         LOG_AUDIO_DEBUG("Audio pipeline initialized successfully!");
         return true;
@@ -224,7 +239,7 @@ bool Audio_Manager::playFile(const String& filename) {
             audioFolder.isEmpty() ? "root directory" : audioFolder.c_str());
         
         // Set volume
-        volume->setVolume(currentVolume);
+        applyVolume();
         
         // Configure player buffer
         player->setBufferSize(i2sCfg_.buffer_size);
@@ -249,7 +264,7 @@ bool Audio_Manager::playFile(const String& filename) {
             LOG_AUDIO_DEBUG("Full path for custom mode: %s", fullPath.c_str());
             
             // Set volume
-            volume->setVolume(currentVolume);
+            applyVolume();
             
             // Configure player buffer
             player->setBufferSize(i2sCfg_.buffer_size);
@@ -613,10 +628,37 @@ bool Audio_Manager::isStopped() const {
 // Set volume
 void Audio_Manager::setVolume(float volume) {
     currentVolume = constrain(volume, 0.0f, 1.0f);
-    if (this->volume) {
-        this->volume->setVolume(currentVolume);
+    applyVolume();
+}
+
+// Set output gain (0.0-1.0) applied on top of the user volume, used for
+// click-free ramps around route changes
+void Audio_Manager::setOutputGain(float gain) {
+    outputGain = constrain(gain, 0.0f, 1.0f);
+    if (ramp) {
+        ramp->setGain(outputGain);
+    }
+}
+
+// Move the output gain over rampMs of audio, stepped per frame as it is
+// written (not per loop iteration, which can be longer than the ramp)
+void Audio_Manager::rampOutputGain(float gain, uint16_t rampMs) {
+    outputGain = constrain(gain, 0.0f, 1.0f);
+    if (ramp) {
+        ramp->rampTo(outputGain, rampMs);
+    }
+}
+
+// The DAC is playing the zero-gain samples, nothing from before the ramp
+bool Audio_Manager::isOutputSilent() const {
+    return !ramp || ramp->isSilentAtOutput();
+}
+
+// Push the user volume to the volume stream
+void Audio_Manager::applyVolume() {
+    if (volume) {
+        volume->setVolume(currentVolume);
     }
-    LOG_AUDIO_DEBUG("Volume set to: %.2f", currentVolume);
 }
 
 // Get current volume
@@ -659,6 +701,11 @@ void Audio_Manager::update() {
         lastDebug = millis();
     }
     
+    // Continue a pending frame-header walk (VBR files without a TOC)
+    if (frameIndex.isValid() && !frameIndex.isComplete()) {
+        frameIndex.continueBuild();
+    }
+    
     // Handle audio playback
     if (playerActive && player->isActive()) {
         try {
@@ -668,6 +715,14 @@ void Audio_Manager::update() {
             LOG_AUDIO_ERROR("Exception during audio copy");
             stopPlayback();
         }
+        
+        // A new track has its first block out: index it for position and
+        // duration (cache load, TOC or the start of a frame walk)
+        const char* path = source->currentPath();
+        if (path[0] != '\0' && indexRequestedFor != path) {
+            indexRequestedFor = path;
+            ensureFrameIndex();
+        }
     } else if (playerActive && !player->isActive()) {
         // Playback has naturally ended - update state
         LOG_AUDIO_DEBUG("Playback naturally ended, updating state... (playerActive=%s, currentFile='%s')", 
@@ -798,7 +853,7 @@ bool Audio_Manager::buildCustomFileList() {
     
     LOG_AUDIO_DEBUG("Building custom file list...");
     LOG_AUDIO_DEBUG("Audio folder: %s", audioFolder.c_str());
-    LOG_AUDIO_DEBUG("File extension: %s", fileExtension);
+    LOG_AUDIO_DEBUG("File extension: %s", fileExtension.c_str());
     
     audioFileList.clear();
     currentFileIndex = 0;
@@ -830,7 +885,7 @@ bool Audio_Manager::buildCustomFileList() {
             LOG_AUDIO_DEBUG("Found file: %s (starts with '._': %s, ends with %s: %s)", 
                             filename.c_str(), 
                             filename.startsWith("._") ? "yes" : "no",
-                            fileExtension,
+                            fileExtension.c_str(),
                             filename.endsWith(fileExtension) ? "yes" : "no");
             
             // Only include .mp3 files that don't start with "._" (macOS metadata files)
@@ -927,12 +982,12 @@ bool Audio_Manager::changeAudioSource(const char* newFolder) {
         return true;
     }
     
-    // Stop current playback
+    // Stop current playback. stopPlayback() returns with the decoder stopped
+    // and the I2S buffers flushed, so there is nothing left to wait for.
     stopPlayback();
-    delay(100); // Give time for cleanup
     
-    // Update the audio folder
-    audioFolder = newFolder ? String(newFolder) : String("");
+    // Update the audio folder (copied into the existing buffer when it fits)
+    audioFolder = newFolder ? newFolder : "";
     
     // Clear existing file information
     firstAudioFile = "";
@@ -942,52 +997,189 @@ bool Audio_Manager::changeAudioSource(const char* newFolder) {
     filesListed = false;
     filesAvailable = false;
     totalAudioFiles = 0;
+    frameIndex.clear();
+    indexRequestedFor = "";
     
-    // Delete and recreate the audio source
-    if (source) {
-        delete source;
-        source = nullptr;
-        delay(10); // Small delay for cleanup
+    if (!player || !source) {
+        setLastError("Player or source not initialized");
+        return false;
     }
     
     // Handle root directory (empty string)
     const char* sourcePath = audioFolder.isEmpty() ? "/" : audioFolder.c_str();
     
-    try {
-        // Create new AudioSourceSDMMC
-        source = new AudioSourceSDMMC(sourcePath, fileExtension.c_str());
-        if (!source) {
-            setLastError("Failed to create new audio source");
-            return false;
-        }
-        LOG_AUDIO_DEBUG("New audio source created for path: %s", sourcePath);
-        
-        // Update the player's source
-        if (player && source) {
-            // Stop the player first
-            player->stop();
-            
-            // Use setAudioSource to change the source without recreating the player
-            player->setAudioSource(*source);
-            
-            LOG_AUDIO_INFO("Audio player source updated successfully");
-        } else {
-            setLastError("Player or source not initialized");
-            return false;
-        }
-        
-        // Relist audio files in the new folder
-        if (!listAudioFiles()) {
-            LOG_AUDIO_ERROR("Failed to list audio files in new folder: %s", getLastError());
-            setLastError("Failed to list files in new folder");
+    // Re-target the source in place; the player keeps its buffer and decoder
+    player->stop();
+    source->retarget(sourcePath);
+    player->setAudioSource(*source);
+    LOG_AUDIO_DEBUG("Audio source re-targeted to path: %s", sourcePath);
+    
+    // Relist audio files in the new folder
+    if (!listAudioFiles()) {
+        LOG_AUDIO_ERROR("Failed to list audio files in new folder: %s", getLastError());
+        setLastError("Failed to list files in new folder");
+        return false;
+    }
+    
+    LOG_AUDIO_INFO("Audio source changed successfully to: %s", audioFolder.c_str());
+    return true;
+}
+
+// Build (or reuse) the frame index for the file that is currently playing
+bool Audio_Manager::ensureFrameIndex() {
+    const char* path = source ? source->currentPath() : "";
+    if (path[0] == '\0') {
+        setLastError("No open audio file to seek in");
+        return false;
+    }
+    
+    if (frameIndex.isFor(path)) {
+        return true;
+    }
+    
+    if (!frameIndex.build(SD_MMC, path)) {
+        setLastError("Failed to index audio file");
+        return false;
+    }
+    
+    LOG_AUDIO_INFO("Frame index for %s: %s, %u entries, %lu ms long (%s in %lu ms)",
+                   path, frameIndex.getSourceName(), (unsigned)frameIndex.getEntryCount(),
+                   (unsigned long)frameIndex.getDurationMs(),
+                   frameIndex.isFromCache() ? "loaded from cache" : "built",
+                   (unsigned long)frameIndex.getBuildTimeMs());
+    return true;
+}
+
+// Current playback position of the open track (0 if it is not indexed)
+uint32_t Audio_Manager::getPositionMs() const {
+    if (!audioInitialized || !player || !source || !frameIndex.isFor(source->currentPath())) {
+        return 0;
+    }
+    fs::File* file = source->currentFile();
+    return file ? frameIndex.msForOffset(file->position()) : 0;
+}
+
+// Duration of the open track (estimate until a VBR frame walk completes,
+// 0 if it is not indexed)
+uint32_t Audio_Manager::getDurationMs() const {
+    if (!audioInitialized || !player || !source || !frameIndex.isFor(source->currentPath())) {
+        return 0;
+    }
+    return frameIndex.getDurationMs();
+}
+
+// Jump to an absolute position within the current track
+bool Audio_Manager::seekToMs(uint32_t positionMs) {
+    if (!audioInitialized || !player || !playerActive) {
+        setLastError("Nothing playing to seek in");
+        return false;
+    }
+    
+    if (!ensureFrameIndex()) {
+        return false;
+    }
+    
+    fs::File* file = source->currentFile();
+    if (!file) {
+        setLastError("Audio file closed during seek");
+        return false;
+    }
+    
+    unsigned long startUs = micros();
+    
+    // Stay inside the indexed range and keep the final second so the track
+    // still ends (and auto-advances) naturally
+    uint32_t limitMs = frameIndex.getIndexedMs();
+    if (frameIndex.isComplete() && limitMs > Mp3FrameIndex::kEntryIntervalMs) {
+        limitMs -= Mp3FrameIndex::kEntryIntervalMs;
+    }
+    uint32_t targetMs = min(positionMs, limitMs);
+    
+    uint32_t offset = frameIndex.offsetForMs(targetMs);
+    if (!file->seek(offset)) {
+        setLastError("File seek failed");
+        return false;
+    }
+    
+    lastSeekLatencyUs = micros() - startUs;
+    seekCount++;
+    LOG_AUDIO_DEBUG("Seek to %lu ms (offset %lu, %lu us)",
+                    (unsigned long)targetMs, (unsigned long)offset, (unsigned long)lastSeekLatencyUs);
+    return true;
+}
+
+// Seek forward (positive) or backward (negative) within the current track
+bool Audio_Manager::seekRelativeMs(int32_t deltaMs) {
+    if (!audioInitialized || !player || !playerActive) {
+        setLastError("Nothing playing to seek in");
+        return false;
+    }
+    
+    if (!ensureFrameIndex()) {
+        return false;
+    }
+    
+    int64_t targetMs = (int64_t)getPositionMs() + deltaMs;
+    if (targetMs < 0) {
+        targetMs = 0;
+    }
+    return seekToMs((uint32_t)min<int64_t>(targetMs, UINT32_MAX));
+}
+
+// Index of the current track within the folder (-1 if nothing is selected)
+int Audio_Manager::getCurrentTrackIndex() const {
+    if (!source || source->currentPath()[0] == '\0') {
+        return -1;
+    }
+    if (fileSelectionMode == FileSelectionMode::CUSTOM) {
+        return currentFileIndex;
+    }
+    return source->index();
+}
+
+// Read position within the current track (still valid while paused)
+uint32_t Audio_Manager::getCurrentByteOffset() const {
+    fs::File* file = source ? source->currentFile() : nullptr;
+    return file ? (uint32_t)file->position() : 0;
+}
+
+// Switch to a folder and start the given track at a byte offset. Audio is
+// produced by the next update(), so this returns without touching I2S.
+bool Audio_Manager::resumeTrack(const char* folder, int trackIndex, uint32_t byteOffset) {
+    if (!changeAudioSource(folder)) {
+        return false;
+    }
+    
+    if (trackIndex < 0 || trackIndex >= totalAudioFiles) {
+        LOG_AUDIO_WARN("Resume track %d out of range (%d files), starting from first", trackIndex, totalAudioFiles);
+        trackIndex = 0;
+        byteOffset = 0;
+    }
+    
+    if (fileSelectionMode == FileSelectionMode::BUILTIN) {
+        applyVolume();
+        player->setBufferSize(i2sCfg_.buffer_size);
+        if (!player->begin(trackIndex)) {
+            setLastError("Failed to begin playback at resume track");
             return false;
         }
-        
-        LOG_AUDIO_INFO("Audio source changed successfully to: %s", audioFolder.c_str());
-        return true;
-        
-    } catch (const std::exception& e) {
-        setLastError("Exception during audio source change");
+        playerActive = true;
+    } else if (!playFileByIndex(trackIndex)) {
         return false;
     }
+    
+    currentFile = source->currentPath();
+    
+    // The decoder re-synchronises on the next frame header, so a raw byte
+    // offset is enough - no frame index needed on the boot path
+    fs::File* file = source->currentFile();
+    if (file && byteOffset > 0 && byteOffset < file->size()) {
+        if (!file->seek(byteOffset)) {
+            LOG_AUDIO_WARN("Resume seek to %lu failed, starting track from the top", (unsigned long)byteOffset);
+        }
+    }
+    
+    LOG_AUDIO_INFO("Resumed %s (track %d) at byte %lu", currentFile.c_str(), trackIndex,
+                   (unsigned long)(file ? file->position() : 0));
+    return true;
 }
@@ -1,11 +1,18 @@
 #include "Battery_Manager.h"
 #include "Logger.h"
 
+// Define static constexpr members
+constexpr uint8_t Battery_Manager::HISTORY_SIZE;
+constexpr uint8_t Battery_Manager::MIN_ESTIMATE_INTERVALS;
+
 // Constructor
 Battery_Manager::Battery_Manager(uint8_t sda, uint8_t scl)
     : initialized(false), sdaPin(sda), sclPin(scl),
       batteryVoltage(0.0f), batteryPercentage(0.0f),
-      lastReadingTime(0) {
+      lastReadingTime(0), readingInterval(5000),
+      historyHead(0), historyCount(0), historyMux(portMUX_INITIALIZER_UNLOCKED),
+      lastUpdateTime(0), decodeMs(0),
+      estimateValid(false), idleRatePerHour(0.0f), playRatePerHour(0.0f) {
 }
 
 // Initialize battery manager
@@ -24,9 +31,10 @@ bool Battery_Manager::begin() {
 
     // Hard resync if gauge lost context (battery swapped / power-cycled)
     lipo.reset();        // one-time at boot if readings look wrong
-    delay(200);
+    if (!waitForGauge(RESET_TIMEOUT_MS)) {
+        LOG_BATTERY_WARN("Fuel gauge not responding %lu ms after reset", (unsigned long)RESET_TIMEOUT_MS);
+    }
     lipo.quickStart();   // required after battery connect or reset
-    delay(50);
 
     // Optional: low-SOC alert at 20%
     // lipo.setThreshold(20);
@@ -34,65 +42,188 @@ bool Battery_Manager::begin() {
     // Optional: print version (if your lib has it)
     // Serial.printf("MAX1704x ver: 0x%04X\n", lipo.getVersion());
 
-    update();            // prime first reading
+    lastUpdateTime = millis();
+    takeReading(lastUpdateTime);   // prime first reading
     initialized = true;
     return true;
 }
 
+// Poll the version register until the gauge answers again (replaces fixed delays)
+bool Battery_Manager::waitForGauge(uint32_t timeoutMs) {
+    unsigned long start = millis();
+    do {
+        uint16_t version = lipo.getVersion();
+        if (version != 0 && version != 0xFFFF) {
+            LOG_BATTERY_DEBUG("Fuel gauge ready after %lu ms", millis() - start);
+            return true;
+        }
+        delay(2);
+    } while (millis() - start < timeoutMs);
+    return false;
+}
+
 // Test connection to the fuel gauge
 bool Battery_Manager::testConnection() {
     // Try to read the version register
     uint16_t version = lipo.getVersion();
     if (version == 0xFFFF) {
-        Serial.println("Battery_Manager: Failed to read version register");
+        LOG_BATTERY_ERROR("Failed to read version register");
         return false;
     }
     
-    Serial.printf("Battery_Manager: MAX1704x version: 0x%04X\n", version);
+    LOG_BATTERY_INFO("MAX1704x version: 0x%04X", version);
     return true;
 }
 
 // Main update function - call this in main loop
-void Battery_Manager::update() {
+void Battery_Manager::update(bool decoding) {
     if (!initialized) return;
     
     unsigned long currentMillis = millis();
+    if (decoding) {
+        decodeMs += currentMillis - lastUpdateTime;
+    }
+    lastUpdateTime = currentMillis;
+    
+    // Read battery status every readingInterval ms
+    if (currentMillis - lastReadingTime >= readingInterval) {
+        takeReading(currentMillis);
+    }
+}
+
+// Read the gauge and append a sample
+void Battery_Manager::takeReading(unsigned long now) {
+    unsigned long elapsed = now - lastReadingTime;
+    lastReadingTime = now;
     
-    // Read battery status every 5 seconds
-    if (currentMillis - lastReadingTime >= READING_INTERVAL) {
-        lastReadingTime = currentMillis;
-        
-        // Read voltage using the library
-        batteryVoltage = lipo.getVoltage();
-        
-        // Read SOC using the library
-        batteryPercentage = lipo.getSOC();
-        Serial.println(batteryPercentage);
-        
-        // Print battery status
-        printBatteryStatus();
+    // Read voltage and SOC using the library
+    batteryVoltage = lipo.getVoltage();
+    batteryPercentage = lipo.getSOC();
+    
+    BatterySample sample;
+    sample.timeS = now / 1000;
+    sample.millivolts = (uint16_t)(batteryVoltage * 1000.0f + 0.5f);
+    sample.socCenti = (uint16_t)(constrain(batteryPercentage, 0.0f, 100.0f) * 100.0f + 0.5f);
+    sample.decodeLoad = elapsed > 0 ? (uint8_t)min(255UL, decodeMs * 255UL / elapsed) : 0;
+    decodeMs = 0;
+    
+    portENTER_CRITICAL(&historyMux);
+    history[(historyHead + historyCount) % HISTORY_SIZE] = sample;
+    if (historyCount < HISTORY_SIZE) {
+        historyCount++;
+    } else {
+        historyHead = (historyHead + 1) % HISTORY_SIZE;
     }
+    portEXIT_CRITICAL(&historyMux);
+    
+    updateEstimate();
+    printBatteryStatus();
+}
+
+// Get a sample, index 0 = oldest
+const BatterySample& Battery_Manager::getSample(uint8_t index) const {
+    return history[(historyHead + index) % HISTORY_SIZE];
+}
+
+// Copy the history oldest first
+uint8_t Battery_Manager::copySamples(BatterySample* out, uint8_t maxCount) const {
+    portENTER_CRITICAL(&historyMux);
+    uint8_t count = historyCount < maxCount ? historyCount : maxCount;
+    uint8_t first = historyCount - count;   // Keep the newest if out is short
+    for (uint8_t i = 0; i < count; i++) {
+        out[i] = history[(historyHead + first + i) % HISTORY_SIZE];
+    }
+    portEXIT_CRITICAL(&historyMux);
+    return count;
+}
+
+// Least-squares fit of the per-interval discharge rate against decode load.
+// Intervals where the charge rose (charger connected) are skipped.
+void Battery_Manager::updateEstimate() {
+    float n = 0.0f, sumL = 0.0f, sumR = 0.0f, sumLL = 0.0f, sumLR = 0.0f;
+    
+    for (uint8_t i = 1; i < historyCount; i++) {
+        const BatterySample& prev = getSample(i - 1);
+        const BatterySample& cur = getSample(i);
+        if (cur.timeS <= prev.timeS || cur.socCenti > prev.socCenti) {
+            continue;
+        }
+        float hours = (cur.timeS - prev.timeS) / 3600.0f;
+        float rate = (prev.socCenti - cur.socCenti) / 100.0f / hours;   // %/h
+        float load = cur.decodeLoad / 255.0f;
+        n += 1.0f;
+        sumL += load;
+        sumR += rate;
+        sumLL += load * load;
+        sumLR += load * rate;
+    }
+    
+    if (n < MIN_ESTIMATE_INTERVALS) {
+        estimateValid = false;
+        return;
+    }
+    
+    float spread = n * sumLL - sumL * sumL;
+    if (spread > 0.01f * n * n) {
+        // Both idle and playing intervals seen - separate the two rates
+        float slope = (n * sumLR - sumL * sumR) / spread;
+        idleRatePerHour = (sumR - slope * sumL) / n;
+        playRatePerHour = idleRatePerHour + slope;
+    } else {
+        // Load barely varied - use the mean rate for both
+        idleRatePerHour = sumR / n;
+        playRatePerHour = idleRatePerHour;
+    }
+    estimateValid = playRatePerHour > 0.0f;
+}
+
+// Discharge rate (%/h) at the given decode load (0..1)
+float Battery_Manager::getDischargeRatePerHour(float decodeLoad) const {
+    if (!estimateValid) {
+        return 0.0f;
+    }
+    decodeLoad = constrain(decodeLoad, 0.0f, 1.0f);
+    return idleRatePerHour + (playRatePerHour - idleRatePerHour) * decodeLoad;
+}
+
+// Minutes until empty at the given decode load, -1 if unknown
+float Battery_Manager::getRemainingMinutes(float decodeLoad) const {
+    float rate = getDischargeRatePerHour(decodeLoad);
+    if (rate <= 0.0f) {
+        return -1.0f;
+    }
+    return batteryPercentage / rate * 60.0f;
 }
 
 // Print battery status
 void Battery_Manager::printBatteryStatus() {
     if (!initialized) {
-        Serial.println("[BATTERY] Manager not initialized");
+        LOG_BATTERY_WARN("Manager not initialized");
         return;
     }
     
-    Serial.printf("[BATTERY] Voltage: %.3fV (%.1f%%)\n",
-                  batteryVoltage, batteryPercentage);
+    // Deferred: this runs from update() in the audio loop on every reading
+    LOG_DEFER(DEBUG, BATTERY, "Voltage: %.3fV (%.1f%%), %.0f min playback left",
+              batteryVoltage, batteryPercentage, getRemainingMinutes());
 }
 
 // Set I2C pins
 void Battery_Manager::setI2CPins(uint8_t sda, uint8_t scl) {
     if (initialized) {
-        Serial.println("Battery_Manager: Cannot change pins after initialization");
+        LOG_BATTERY_WARN("Cannot change pins after initialization");
         return;
     }
     
     sdaPin = sda;
     sclPin = scl;
-    Serial.printf("Battery_Manager: I2C pins set to SDA:%d, SCL:%d\n", sdaPin, sclPin);
+    LOG_BATTERY_INFO("I2C pins set to SDA:%d, SCL:%d", sdaPin, sclPin);
+}
+
+// Set how often the fuel gauge is read (settings: batteryCheckInterval)
+void Battery_Manager::setReadingInterval(unsigned long intervalMs) {
+    if (intervalMs < 1000) {
+        intervalMs = 1000;
+    }
+    readingInterval = intervalMs;
+    LOG_BATTERY_INFO("Reading interval set to %lu ms", intervalMs);
 }
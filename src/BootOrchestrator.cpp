@@ -0,0 +1,216 @@
+#include "BootOrchestrator.h"
+#include "Logger.h"
+#include "freertos/task.h"
+
+// Define static constexpr members
+constexpr uint8_t BootOrchestrator::MAX_STAGES;
+constexpr uint32_t BootOrchestrator::DEFAULT_STACK_SIZE;
+
+// Constructor
+BootOrchestrator::BootOrchestrator()
+    : stageCount(0), doneBits(nullptr), startedBits(0), firstStartMs(0),
+      parallelMs(0), timeToAudioMs(0), timeToReadyMs(0) {
+    lastError[0] = '\0';
+}
+
+// Destructor
+BootOrchestrator::~BootOrchestrator() {
+    if (doneBits) {
+        vEventGroupDelete(doneBits);
+        doneBits = nullptr;
+    }
+}
+
+// Register a stage
+bool BootOrchestrator::addStage(const char* name, StageFunction function, bool required, uint32_t stackSize) {
+    if (stageCount >= MAX_STAGES || !function) {
+        setLastError("Too many boot stages");
+        return false;
+    }
+
+    Stage& stage = stages[stageCount++];
+    stage.name = name;
+    stage.function = function;
+    stage.stackSize = stackSize;
+    stage.required = required;
+    stage.started = false;
+    stage.success = false;
+    stage.finished = false;
+    stage.durationMs = 0;
+    return true;
+}
+
+// Run one stage, record its duration and signal completion
+void BootOrchestrator::runStage(uint8_t index) {
+    Stage& stage = stages[index];
+
+    unsigned long start = millis();
+    stage.success = stage.function();
+    stage.durationMs = millis() - start;
+    stage.finished = true;
+
+    xEventGroupSetBits(doneBits, 1UL << index);
+}
+
+// Task wrapper: the stage, then the task ends itself
+void BootOrchestrator::stageTask(void* param) {
+    TaskContext* context = static_cast<TaskContext*>(param);
+    context->owner->runStage(context->index);
+    vTaskDelete(nullptr);
+}
+
+// Start every stage that is not running yet
+bool BootOrchestrator::start() {
+    if (!doneBits) {
+        doneBits = xEventGroupCreate();
+        if (!doneBits) {
+            setLastError("Failed to create boot event group");
+            return false;
+        }
+    }
+
+    if (startedBits == 0) {
+        firstStartMs = millis();
+    }
+
+    for (uint8_t i = 0; i < stageCount; i++) {
+        if (stages[i].started) {
+            continue;
+        }
+        stages[i].started = true;
+        contexts[i].owner = this;
+        contexts[i].index = i;
+        startedBits |= 1UL << i;
+
+        // Same priority as the loop task so stages interleave while we wait
+        if (xTaskCreate(stageTask, stages[i].name, stages[i].stackSize, &contexts[i], 1, nullptr) != pdPASS) {
+            // Not enough memory for a task - run the stage inline instead
+            // (not through stageTask, which would delete the calling task)
+            LOG_WARN("[BOOT] Could not start task for %s, running inline", stages[i].name);
+            runStage(i);
+        }
+    }
+    return true;
+}
+
+// Find a stage by name
+int BootOrchestrator::findStage(const char* name) const {
+    for (uint8_t i = 0; i < stageCount; i++) {
+        if (strcmp(stages[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Wait for one stage
+bool BootOrchestrator::waitFor(const char* name, uint32_t timeoutMs) {
+    int index = findStage(name);
+    if (index < 0 || !stages[index].started || !doneBits) {
+        setLastError("Boot stage not started");
+        return false;
+    }
+
+    EventBits_t bit = 1UL << index;
+    EventBits_t done = xEventGroupWaitBits(doneBits, bit, pdFALSE, pdTRUE, pdMS_TO_TICKS(timeoutMs));
+    if (!(done & bit)) {
+        LOG_ERROR("[BOOT] Stage %s timed out after %lu ms", name, (unsigned long)timeoutMs);
+        setLastError("Boot stage timed out");
+        return false;
+    }
+    if (!stages[index].success) {
+        setLastError(stages[index].required ? "Required boot stage failed" : "Optional boot stage failed");
+        return false;
+    }
+    return true;
+}
+
+// Wait for every started stage
+bool BootOrchestrator::waitAll(uint32_t timeoutMs) {
+    if (startedBits == 0) {
+        return true;
+    }
+
+    EventBits_t done = xEventGroupWaitBits(doneBits, startedBits, pdFALSE, pdTRUE, pdMS_TO_TICKS(timeoutMs));
+    parallelMs = millis() - firstStartMs;
+
+    bool ok = true;
+    for (uint8_t i = 0; i < stageCount; i++) {
+        const Stage& stage = stages[i];
+        if (!stage.started) {
+            continue;
+        }
+        if (!(done & (1UL << i))) {
+            LOG_ERROR("[BOOT] Stage %s timed out after %lu ms", stage.name, (unsigned long)timeoutMs);
+            if (stage.required) {
+                setLastError("Boot stage timed out");
+                ok = false;
+            }
+        } else if (!stage.success && stage.required) {
+            setLastError("Required boot stage failed");
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+// Check (without blocking) whether every started stage is done
+bool BootOrchestrator::isFinished() const {
+    if (startedBits == 0) {
+        return true;
+    }
+    return (xEventGroupGetBits(doneBits) & startedBits) == startedBits;
+}
+
+bool BootOrchestrator::isStageFinished(const char* name) const {
+    int index = findStage(name);
+    if (index < 0 || !stages[index].started || !doneBits) {
+        return false;
+    }
+    return (xEventGroupGetBits(doneBits) & (1UL << index)) != 0;
+}
+
+// Start every stage and wait for all of them
+bool BootOrchestrator::run(uint32_t timeoutMs) {
+    return start() && waitAll(timeoutMs);
+}
+
+// Record time-to-audio (first buffer of resumed playback written)
+void BootOrchestrator::markFirstAudio() {
+    if (timeToAudioMs == 0) {
+        timeToAudioMs = millis();
+        LOG_INFO("[BOOT] Cold boot to audio: %lu ms", (unsigned long)timeToAudioMs);
+    }
+}
+
+// Record time-to-ready (millis() starts at zero when the app starts)
+void BootOrchestrator::markReady() {
+    timeToReadyMs = millis();
+    printReport();
+}
+
+// Print per-stage timings
+void BootOrchestrator::printReport() const {
+    for (uint8_t i = 0; i < stageCount; i++) {
+        const Stage& stage = stages[i];
+        LOG_INFO("[BOOT]   %-8s %s in %lu ms", stage.name,
+                 !stage.finished ? "TIMEOUT" : (stage.success ? "OK" : "FAILED"),
+                 (unsigned long)stage.durationMs);
+    }
+    if (timeToAudioMs > 0) {
+        LOG_INFO("[BOOT] Time-to-audio %lu ms", (unsigned long)timeToAudioMs);
+    }
+    LOG_INFO("[BOOT] Parallel stages took %lu ms, time-to-ready %lu ms",
+             (unsigned long)parallelMs, (unsigned long)timeToReadyMs);
+}
+
+// Get last error message
+const char* BootOrchestrator::getLastError() const {
+    return lastError;
+}
+
+// Set last error message
+void BootOrchestrator::setLastError(const char* error) const {
+    strncpy(lastError, error, sizeof(lastError) - 1);
+    lastError[sizeof(lastError) - 1] = '\0';
+}
@@ -51,7 +51,7 @@ bool Button_Manager::begin() {
     // Note: ESP32 Arduino framework handles attenuation automatically
     // No need to set attenuation manually
     
-    Serial.println("Button Manager initialized successfully!");
+    LOG_BUTTON_INFO("Button Manager initialized successfully!");
     return true;
 }
 
@@ -108,9 +108,9 @@ void Button_Manager::update() {
                 lastReleaseTime = currentTime;
                 lastButton = currentButton;
                 
-                // Print button release
-                Serial.printf("Button released: %s (held for %lums)\n", 
-                              getButtonName(lastButton), pressDuration);
+                // Print button release (deferred - formatted off the audio loop)
+                LOG_DEFER(INFO, BUTTON, "Button released: %s (held for %lums)",
+                          getButtonName(lastButton), pressDuration);
             }
             
             // Reset state for next press
@@ -123,8 +123,8 @@ void Button_Manager::update() {
             lastPressTime = currentTime;
             pressEventRegistered = false;  // Allow press event to be registered
             
-            // Print button press
-            Serial.printf("Button pressed: %s (%.2fV)\n", getButtonName(currentButton), voltage);
+            // Print button press (deferred - formatted off the audio loop)
+            LOG_DEFER(INFO, BUTTON, "Button pressed: %s (%.2fV)", getButtonName(currentButton), voltage);
         }
     } else if (stableButton == currentButton && stableButton != BUTTON_NONE) {
         // Same button is still being held (stable)
@@ -2,6 +2,16 @@
 #include "Logger.h"
 #include <Wire.h>
 
+// Define static constexpr members
+constexpr uint8_t DAC_Manager::REG_PAGE_SELECT;
+constexpr uint8_t DAC_Manager::REG_SPK_AMP;
+constexpr uint8_t DAC_Manager::REG_HPL_VOLUME;
+constexpr uint8_t DAC_Manager::REG_HPR_VOLUME;
+constexpr uint8_t DAC_Manager::REG_SPK_VOLUME;
+constexpr uint8_t DAC_Manager::ROUTE_ENABLE;
+constexpr uint8_t DAC_Manager::CACHED_PAGES;
+constexpr uint8_t DAC_Manager::PAGE_UNKNOWN;
+
 // Constructor
 DAC_Manager::DAC_Manager(uint8_t reset_pin, uint8_t sda_pin, uint8_t scl_pin, uint8_t address) {
     resetPin = reset_pin;
@@ -16,6 +26,10 @@ DAC_Manager::DAC_Manager(uint8_t reset_pin, uint8_t sda_pin, uint8_t scl_pin, ui
     enableSpeakerOutput = true;
     defaultHeadphoneVolume = 6;
     defaultSpeakerVolume = 0;
+    
+    i2cTransactions = 0;
+    naiveTransactions = 0;
+    invalidateCache();
 }
 
 // Initialize the DAC
@@ -26,10 +40,10 @@ bool DAC_Manager::begin() {
     LOG_DAC_INFO("Initializing I2C...");
     Wire.begin(sdaPin, sclPin);
     LOG_DAC_INFO("I2C initialized");
-    delay(100);
     
-    // Reset DAC
+    // Reset DAC (returns once the codec ACKs again)
     reset();
+    invalidateCache();
     
     // Check I2C communication
     if (!checkI2CCommunication()) {
@@ -45,30 +59,202 @@ bool DAC_Manager::begin() {
     }
     
     Serial.println("codec.begin() successful");
+    invalidateCache();
     initialized = true;
     return true;
 }
 
 // Reset DAC
 void DAC_Manager::reset() {
-    Serial.println("Resetting DAC...");
-    Serial.printf("Setting pin %d as output...\n", resetPin);
+    LOG_DAC_DEBUG("Resetting DAC (pin %d)...", resetPin);
     pinMode(resetPin, OUTPUT);
-    Serial.println("Pin mode set");
-    delay(50);
     
-    Serial.println("Setting pin LOW...");
+    // Datasheet: RESET low for at least 10 ns, registers usable 1 ms after release
     digitalWrite(resetPin, LOW);
-    Serial.println("Pin set LOW");
-    delay(100);
-    
-    Serial.println("Setting pin HIGH...");
+    delayMicroseconds(10);
     digitalWrite(resetPin, HIGH);
-    Serial.println("Pin set HIGH");
-    delay(100);
     
-    Serial.println("DAC reset complete");
-    delay(100);
+    // Poll for the codec to ACK instead of sleeping a fixed time
+    unsigned long waitedMs = 0;
+    if (waitForAck(RESET_TIMEOUT_MS, &waitedMs)) {
+        LOG_DAC_DEBUG("DAC reset complete (ready after %lu ms)", waitedMs);
+    } else {
+        LOG_DAC_WARN("DAC did not ACK within %lu ms after reset", (unsigned long)RESET_TIMEOUT_MS);
+    }
+}
+
+// Poll the codec address until it ACKs or the timeout expires
+bool DAC_Manager::waitForAck(uint32_t timeoutMs, unsigned long* waitedMs) {
+    unsigned long start = millis();
+    do {
+        Wire.beginTransmission(i2cAddress);
+        if (Wire.endTransmission() == 0) {
+            if (waitedMs) {
+                *waitedMs = millis() - start;
+            }
+            return true;
+        }
+        delay(1);
+    } while (millis() - start < timeoutMs);
+    return false;
+}
+
+// ============================================================================
+// REGISTER ACCESS AND SHADOW CACHE
+// ============================================================================
+
+// Forget every cached value (after reset or library calls)
+void DAC_Manager::invalidateCache() {
+    memset(shadowValid, 0, sizeof(shadowValid));
+    currentPage = PAGE_UNKNOWN;
+}
+
+bool DAC_Manager::isCached(uint8_t page, uint8_t reg, uint8_t value) const {
+    if (page >= CACHED_PAGES || reg >= 128) {
+        return false;
+    }
+    return (shadowValid[page][reg >> 3] & (1 << (reg & 7))) && shadowValues[page][reg] == value;
+}
+
+void DAC_Manager::setCached(uint8_t page, uint8_t reg, uint8_t value) {
+    if (page >= CACHED_PAGES || reg >= 128) {
+        return;
+    }
+    shadowValues[page][reg] = value;
+    shadowValid[page][reg >> 3] |= (1 << (reg & 7));
+}
+
+void DAC_Manager::clearCached(uint8_t page, uint8_t reg) {
+    if (page >= CACHED_PAGES || reg >= 128) {
+        return;
+    }
+    shadowValid[page][reg >> 3] &= ~(1 << (reg & 7));
+}
+
+// Select a register page (only sent when it changes)
+bool DAC_Manager::selectPage(uint8_t page) {
+    if (currentPage == page) {
+        return true;
+    }
+    
+    Wire.beginTransmission(i2cAddress);
+    Wire.write(REG_PAGE_SELECT);
+    Wire.write(page);
+    i2cTransactions++;
+    if (Wire.endTransmission() != 0) {
+        currentPage = PAGE_UNKNOWN;
+        return false;
+    }
+    currentPage = page;
+    return true;
+}
+
+// Read one register from the given page (never served from the cache, so
+// status registers can be polled)
+bool DAC_Manager::readRegister(uint8_t page, uint8_t reg, uint8_t& value) {
+    naiveTransactions += 2;
+    if (!selectPage(page)) {
+        return false;
+    }
+    
+    Wire.beginTransmission(i2cAddress);
+    Wire.write(reg);
+    i2cTransactions++;
+    if (Wire.endTransmission(false) != 0) {
+        return false;
+    }
+    if (Wire.requestFrom(i2cAddress, (uint8_t)1) != 1) {
+        return false;
+    }
+    value = Wire.read();
+    return true;
+}
+
+// Write consecutive registers in one burst (the codec auto-increments the
+// register address). Leading and trailing values that already match the
+// cache are trimmed; if nothing changed, nothing is sent.
+bool DAC_Manager::writeRegisters(uint8_t page, uint8_t firstReg, const uint8_t* values, uint8_t count) {
+    naiveTransactions += 2 * count;
+    
+    uint8_t start = 0;
+    uint8_t end = count;
+    while (start < end && isCached(page, firstReg + start, values[start])) {
+        start++;
+    }
+    while (end > start && isCached(page, firstReg + end - 1, values[end - 1])) {
+        end--;
+    }
+    if (start == end) {
+        return true;
+    }
+    
+    if (!selectPage(page)) {
+        return false;
+    }
+    
+    Wire.beginTransmission(i2cAddress);
+    Wire.write(firstReg + start);
+    Wire.write(values + start, end - start);
+    i2cTransactions++;
+    if (Wire.endTransmission() != 0) {
+        for (uint8_t i = start; i < end; i++) {
+            clearCached(page, firstReg + i);
+        }
+        return false;
+    }
+    
+    for (uint8_t i = start; i < end; i++) {
+        setCached(page, firstReg + i, values[i]);
+    }
+    return true;
+}
+
+// Write a single register
+bool DAC_Manager::writeRegister(uint8_t page, uint8_t reg, uint8_t value) {
+    return writeRegisters(page, reg, &value, 1);
+}
+
+// Read-modify-write of the bits in mask; the read is only needed once
+bool DAC_Manager::updateRegister(uint8_t page, uint8_t reg, uint8_t mask, uint8_t bits) {
+    uint8_t current = 0;
+    if (page < CACHED_PAGES && (shadowValid[page][reg >> 3] & (1 << (reg & 7)))) {
+        current = shadowValues[page][reg];
+    } else if (!readRegister(page, reg, current)) {
+        return false;
+    }
+    return writeRegister(page, reg, (current & ~mask) | (bits & mask));
+}
+
+// Transactions avoided compared to page select + write per register
+uint32_t DAC_Manager::getSavedTransactionCount() const {
+    return naiveTransactions > i2cTransactions ? naiveTransactions - i2cTransactions : 0;
+}
+
+void DAC_Manager::resetStats() {
+    i2cTransactions = 0;
+    naiveTransactions = 0;
+}
+
+void DAC_Manager::printStats() const {
+    LOG_DAC_INFO("I2C transactions: %lu issued, %lu saved by cache/bursts",
+                 (unsigned long)i2cTransactions, (unsigned long)getSavedTransactionCount());
+}
+
+// Poll the DAC flag register (page 0, reg 0x25) until both channels report powered up
+bool DAC_Manager::waitForDacPowerUp(uint32_t timeoutMs) {
+    const uint8_t kDacFlagRegister = 0x25;
+    const uint8_t kLeftRightPowered = 0x88;  // bit 7 = left DAC, bit 3 = right DAC
+    
+    unsigned long start = millis();
+    do {
+        uint8_t flags = 0;
+        if (readRegister(0, kDacFlagRegister, flags) && (flags & kLeftRightPowered) == kLeftRightPowered) {
+            LOG_DAC_DEBUG("DAC powered up after %lu ms", millis() - start);
+            return true;
+        }
+        delay(1);
+    } while (millis() - start < timeoutMs);
+    return false;
 }
 
 // Check I2C communication
@@ -104,27 +290,25 @@ bool DAC_Manager::configureBasic() {
     // Set I2S interface
     codec.setCodecInterface(TLV320DAC3100_FORMAT_I2S, TLV320DAC3100_DATA_LEN_16);
     Serial.println("Interface set");
-    delay(50);
     
     // Set clock configuration
     codec.setCodecClockInput(TLV320DAC3100_CODEC_CLKIN_PLL);
     Serial.println("Clock input set");
-    delay(50);
     
     codec.setPLLClockInput(TLV320DAC3100_PLL_CLKIN_BCLK);
     Serial.println("PLL clock set");
-    delay(50);
     
     codec.setPLLValues(1, 2, 32, 0);
     Serial.println("PLL values set");
-    delay(50);
     
     // Set DAC clocks
     codec.setNDAC(true, 8);
     codec.setMDAC(true, 2);
     codec.powerPLL(true);
     Serial.println("DAC clocks configured");
-    delay(50);
+    
+    // The library changed pages and registers behind the cache
+    invalidateCache();
     
     Serial.println("DAC basic configuration complete!");
     return true;
@@ -147,41 +331,42 @@ bool DAC_Manager::configureFull() {
     // Configure data path
     codec.setDACDataPath(true, true, TLV320_DAC_PATH_NORMAL, TLV320_DAC_PATH_NORMAL, TLV320_VOLUME_STEP_1SAMPLE);
     Serial.println("Data path configured");
-    delay(50);
+    
+    // The channels power up once the PLL locks to BCLK, i.e. after I2S starts;
+    // main.cpp polls waitForDacPowerUp() then instead of waiting here
     
     // Configure analog inputs
     codec.configureAnalogInputs(TLV320_DAC_ROUTE_MIXER, TLV320_DAC_ROUTE_MIXER, false, false, false, false);
     Serial.println("Analog inputs configured");
-    delay(50);
     
     // Configure volume control
     codec.setDACVolumeControl(false, false, TLV320_VOL_INDEPENDENT);
     codec.setChannelVolume(false, defaultHeadphoneVolume);
     codec.setChannelVolume(true, defaultHeadphoneVolume);
     Serial.println("Volume control configured");
-    delay(50);
     
     // Configure headphone driver
     codec.configureHeadphoneDriver(true, true, TLV320_HP_COMMON_1_35V, false);
     codec.configureHPL_PGA(0, true);
     codec.configureHPR_PGA(0, true);
-    codec.setHPLVolume(true, defaultHeadphoneVolume);
-    codec.setHPRVolume(true, defaultHeadphoneVolume);
     Serial.println("Headphone driver configured");
-    delay(50);
     
     // Configure speaker
     if (enableSpeakerOutput) {
         codec.configureSPK_PGA(TLV320_SPK_GAIN_6DB, true);
-        codec.setSPKVolume(true, defaultSpeakerVolume);
         Serial.println("Speaker configured");
-        delay(50);
     }
     
     // Configure microphone bias - DISABLE during headphone detection
     codec.configMicBias(false, false, TLV320_MICBIAS_2V);
     Serial.println("Mic bias OFF for jack detect");
-    delay(10);
+    
+    // Volumes go through the cache so later route changes can skip them
+    invalidateCache();
+    setHeadphoneVolume(defaultHeadphoneVolume);
+    if (enableSpeakerOutput) {
+        setSpeakerVolume(defaultSpeakerVolume);
+    }
     
     // Remove headphone detection configuration - now handled in main.cpp
     // Headphone detection is now configured directly in main.cpp using getCodec()
@@ -229,28 +414,30 @@ bool DAC_Manager::configure(bool enable_headphone_detection, bool enable_speaker
     return configureFull();
 }
 
-// Enable/disable speaker output
+// Enable/disable speaker output (class-D amp power, page 1 reg 0x20 bit 7)
 void DAC_Manager::enableSpeaker(bool enable) {
     if (!initialized) {
         Serial.printf("DAC_Manager::enableSpeaker(%s) called but DAC not initialized\n", enable ? "true" : "false");
         return;
     }
     
-    Serial.printf("DAC_Manager::enableSpeaker(%s) - calling codec.enableSpeaker()\n", enable ? "true" : "false");
-    codec.enableSpeaker(enable);
-    
-    // Verify the change took effect
-    delay(5); // Small delay for register update
-    bool actualState = codec.speakerEnabled();
-    Serial.printf("DAC_Manager::enableSpeaker(%s) - codec reports speaker is %s\n", 
-                  enable ? "true" : "false", actualState ? "ENABLED" : "DISABLED");
+    if (!updateRegister(1, REG_SPK_AMP, 0x80, enable ? 0x80 : 0x00)) {
+        LOG_DAC_ERROR("Failed to %s speaker amplifier", enable ? "enable" : "disable");
+        return;
+    }
+    LOG_DAC_DEBUG("Speaker amplifier %s", enable ? "ENABLED" : "DISABLED");
 }
 
-// Set headphone volume
+// Set headphone volume (HPL and HPR in one burst)
 void DAC_Manager::setHeadphoneVolume(uint8_t volume) {
     if (!initialized) return;
-    codec.setHPLVolume(true, volume);
-    codec.setHPRVolume(true, volume);
+    const uint8_t values[2] = {
+        (uint8_t)(ROUTE_ENABLE | (volume & 0x7F)),
+        (uint8_t)(ROUTE_ENABLE | (volume & 0x7F))
+    };
+    if (!writeRegisters(1, REG_HPL_VOLUME, values, 2)) {
+        LOG_DAC_ERROR("Failed to set headphone volume %d", volume);
+    }
 }
 
 // Set speaker volume
@@ -260,7 +447,9 @@ void DAC_Manager::setSpeakerVolume(uint8_t volume) {
         return;
     }
     
-    Serial.printf("DAC_Manager::setSpeakerVolume(%d) - calling codec.setSPKVolume()\n", volume);
-    codec.setSPKVolume(true, volume);
-    Serial.printf("DAC_Manager::setSpeakerVolume(%d) - volume set\n", volume);
-} 
\ No newline at end of file
+    if (!writeRegister(1, REG_SPK_VOLUME, ROUTE_ENABLE | (volume & 0x7F))) {
+        LOG_DAC_ERROR("Failed to set speaker volume %d", volume);
+        return;
+    }
+    LOG_DAC_DEBUG("Speaker volume set to %d", volume);
+}
@@ -0,0 +1,136 @@
+#include "FolderCatalog.h"
+#include "Logger.h"
+#include <algorithm>
+
+// Constructor
+FolderCatalog::FolderCatalog()
+    : unassigned(0), scannedRoot(""), scanned(false), merged(false), mergedRevision(0),
+      mergeCount(0), incrementalCount(0) {
+}
+
+// Scan the root unless it is already cached
+bool FolderCatalog::scan(SdScanner& scanner, fs::FS& fs, const String& root, bool force) {
+    if (!force && isScanned(root)) {
+        return true;
+    }
+
+    std::vector<String> paths;
+    if (!scanner.listAudioDirs(fs, root, paths)) {
+        return false;
+    }
+    setFolders(root, paths);
+    return true;
+}
+
+// Replace the folder list; flags are recomputed by the next refresh()
+void FolderCatalog::setFolders(const String& root, std::vector<String>& paths) {
+    std::sort(paths.begin(), paths.end(), pathLess);
+    paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+
+    folders.swap(paths);
+    assigned.assign(folders.size(), false);
+    unassigned = folders.size();
+    scannedRoot = root;
+    scanned = true;
+    merged = false;
+}
+
+void FolderCatalog::refresh(const MappingStore& store) {
+    if (merged && mergedRevision == store.getRevision()) {
+        return;
+    }
+    merge(store);
+}
+
+// Both lists are sorted by pathLess: one pass over each
+void FolderCatalog::merge(const MappingStore& store) {
+    const uint32_t startUs = micros();
+    const std::vector<String>& taken = store.sortedPaths();
+
+    size_t j = 0;
+    unassigned = 0;
+    for (size_t i = 0; i < folders.size(); i++) {
+        while (j < taken.size() && pathLess(taken[j], folders[i])) {
+            j++;
+        }
+        const bool isAssigned = j < taken.size() && taken[j] == folders[i];
+        assigned[i] = isAssigned;
+        if (!isAssigned) {
+            unassigned++;
+        }
+    }
+
+    merged = true;
+    mergedRevision = store.getRevision();
+    mergeCount++;
+    LOG_MAPPING_DEBUG("Folder merge: %u folders, %u mapped, %u unassigned in %lu us",
+                      (unsigned)folders.size(), (unsigned)taken.size(), (unsigned)unassigned,
+                      (unsigned long)(micros() - startUs));
+}
+
+// Set one folder's flag from the store
+void FolderCatalog::updateFlag(const MappingStore& store, const String& path) {
+    auto it = std::lower_bound(folders.begin(), folders.end(), path, pathLess);
+    if (it == folders.end() || *it != path) {
+        return;   // Not a folder of this root
+    }
+
+    const size_t i = it - folders.begin();
+    const bool isAssigned = store.hasPath(path);
+    if (assigned[i] != isAssigned) {
+        assigned[i] = isAssigned;
+        if (isAssigned) {
+            unassigned--;
+        } else {
+            unassigned++;
+        }
+    }
+}
+
+void FolderCatalog::applyChange(const MappingStore& store, const String& path, const String& oldPath) {
+    // Only valid if that was the one mutation since the last merge;
+    // otherwise leave it to the next refresh()
+    if (!merged || store.getRevision() != mergedRevision + 1) {
+        merged = false;
+        return;
+    }
+
+    updateFlag(store, path);
+    if (oldPath.length() > 0 && oldPath != path) {
+        updateFlag(store, oldPath);
+    }
+    mergedRevision = store.getRevision();
+    incrementalCount++;
+}
+
+// Next unassigned folder at or after cursor
+bool FolderCatalog::nextUnassigned(size_t& cursor, String& out) const {
+    while (cursor < folders.size()) {
+        const size_t i = cursor++;
+        if (!assigned[i]) {
+            out = folders[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+void FolderCatalog::copyUnassigned(std::vector<String>& out) const {
+    out.clear();
+    out.reserve(unassigned);
+    for (size_t i = 0; i < folders.size(); i++) {
+        if (!assigned[i]) {
+            out.push_back(folders[i]);
+        }
+    }
+}
+
+// Drop the cached scan
+void FolderCatalog::clear() {
+    folders.clear();
+    assigned.clear();
+    unassigned = 0;
+    scannedRoot = "";
+    scanned = false;
+    merged = false;
+}
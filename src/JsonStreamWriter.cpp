@@ -0,0 +1,216 @@
+#include "JsonStreamWriter.h"
+#include <math.h>
+#include <stdarg.h>
+
+// Define static constexpr members
+constexpr size_t JsonStreamWriter::BUFFER_SIZE;
+constexpr uint8_t JsonStreamWriter::MAX_DEPTH;
+
+// Constructor
+JsonStreamWriter::JsonStreamWriter(Print& out)
+    : out(out), used(0), depth(0), hasItems(0), pretty(false), bytesWritten(0), chunkCount(0) {
+}
+
+// Destructor - never drop buffered output
+JsonStreamWriter::~JsonStreamWriter() {
+    flush();
+}
+
+// Open an object
+void JsonStreamWriter::beginObject(const char* key) {
+    beginValue(key);
+    write('{');
+    if (depth < MAX_DEPTH) {
+        depth++;
+        hasItems &= ~(1UL << depth);
+    }
+}
+
+// Close an object
+void JsonStreamWriter::endObject() {
+    closeContainer('}');
+}
+
+// Open an array
+void JsonStreamWriter::beginArray(const char* key) {
+    beginValue(key);
+    write('[');
+    if (depth < MAX_DEPTH) {
+        depth++;
+        hasItems &= ~(1UL << depth);
+    }
+}
+
+// Close an array
+void JsonStreamWriter::endArray() {
+    closeContainer(']');
+}
+
+// Close the current container (pretty: on its own line if it has items)
+void JsonStreamWriter::closeContainer(char bracket) {
+    if (pretty && depth > 0 && (hasItems & (1UL << depth))) {
+        newLine(depth - 1);
+    }
+    write(bracket);
+    if (depth > 0) {
+        depth--;
+    }
+    if (pretty && depth == 0) {
+        write('\n');
+    }
+}
+
+// Line break plus two spaces per level
+void JsonStreamWriter::newLine(uint8_t level) {
+    write('\n');
+    for (uint8_t i = 0; i < level; i++) {
+        write("  ", 2);
+    }
+}
+
+// String value (escaped)
+void JsonStreamWriter::add(const char* key, const char* value) {
+    if (!value) {
+        addNull(key);
+        return;
+    }
+    beginValue(key);
+    writeEscaped(value);
+}
+
+// Numeric values
+void JsonStreamWriter::add(const char* key, int value) {
+    writeNumber(key, "%d", value);
+}
+
+void JsonStreamWriter::add(const char* key, unsigned int value) {
+    writeNumber(key, "%u", value);
+}
+
+void JsonStreamWriter::add(const char* key, long value) {
+    writeNumber(key, "%ld", value);
+}
+
+void JsonStreamWriter::add(const char* key, unsigned long value) {
+    writeNumber(key, "%lu", value);
+}
+
+void JsonStreamWriter::add(const char* key, double value, uint8_t decimals) {
+    // NaN and infinity are not valid JSON numbers
+    if (isnan(value) || isinf(value)) {
+        addNull(key);
+        return;
+    }
+    writeNumber(key, "%.*f", (int)decimals, value);
+}
+
+// Boolean value
+void JsonStreamWriter::add(const char* key, bool value) {
+    beginValue(key);
+    write(value ? "true" : "false");
+}
+
+// Null value
+void JsonStreamWriter::addNull(const char* key) {
+    beginValue(key);
+    write("null");
+}
+
+// Comma and key for the next value at the current depth
+void JsonStreamWriter::beginValue(const char* key) {
+    const uint32_t bit = 1UL << depth;
+    if (hasItems & bit) {
+        write(',');
+    }
+    hasItems |= bit;
+
+    if (pretty && depth > 0) {
+        newLine(depth);
+    }
+    if (key && depth > 0) {
+        writeEscaped(key);
+        write(pretty ? ": " : ":");
+    }
+}
+
+// Append raw bytes, flushing whenever the buffer fills
+void JsonStreamWriter::write(const char* text, size_t length) {
+    while (length > 0) {
+        size_t space = BUFFER_SIZE - used;
+        size_t count = length < space ? length : space;
+        memcpy(buffer + used, text, count);
+        used += count;
+        text += count;
+        length -= count;
+        if (used == BUFFER_SIZE) {
+            flush();
+        }
+    }
+}
+
+// Append one byte
+void JsonStreamWriter::write(char c) {
+    buffer[used++] = c;
+    if (used == BUFFER_SIZE) {
+        flush();
+    }
+}
+
+// Append a quoted string with JSON escaping (UTF-8 passes through)
+void JsonStreamWriter::writeEscaped(const char* text) {
+    write('"');
+    const char* run = text;
+    for (const char* p = text; *p; p++) {
+        const unsigned char c = (unsigned char)*p;
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+
+        // Copy the plain run before the character that needs escaping
+        write(run, p - run);
+        run = p + 1;
+
+        switch (c) {
+            case '"':  write("\\\"", 2); break;
+            case '\\': write("\\\\", 2); break;
+            case '\n': write("\\n", 2); break;
+            case '\r': write("\\r", 2); break;
+            case '\t': write("\\t", 2); break;
+            default: {
+                char escape[7];
+                snprintf(escape, sizeof(escape), "\\u%04x", c);
+                write(escape, 6);
+                break;
+            }
+        }
+    }
+    write(run, strlen(run));
+    write('"');
+}
+
+// Format a number into a small stack buffer and append it
+void JsonStreamWriter::writeNumber(const char* key, const char* format, ...) {
+    char number[48];   // Fits any float printed with %.2f
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(number, sizeof(number), format, args);
+    va_end(args);
+
+    beginValue(key);
+    if (length < 0) {
+        write("null");
+        return;
+    }
+    write(number, (size_t)length < sizeof(number) ? (size_t)length : sizeof(number) - 1);
+}
+
+// Hand the buffered bytes to the sink
+void JsonStreamWriter::flush() {
+    if (used == 0) {
+        return;
+    }
+    out.write((const uint8_t*)buffer, used);
+    bytesWritten += used;
+    chunkCount++;
+    used = 0;
+}
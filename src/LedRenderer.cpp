@@ -0,0 +1,119 @@
+#include "LedRenderer.h"
+#include "Logger.h"
+
+// Define static constexpr members
+constexpr uint8_t LedRenderer::PULSE_STEPS;
+constexpr uint32_t LedRenderer::BATTERY_BLINK_MS;
+constexpr float LedRenderer::BATTERY_LOW_PERCENT;
+constexpr float LedRenderer::BATTERY_CRITICAL_PERCENT;
+
+// Constructor
+LedRenderer::LedRenderer(CRGB* leds, uint8_t count)
+    : leds(leds), count(count), base(LedPattern::off()), baseStartMs(0), batteryPercent(-1.0f),
+      flashColor(CRGB::Black), flashTimes(0), flashOnMs(0), flashOffMs(0), flashStartMs(0),
+      flashPending(false), framePushed(false), frameCount(0), showCount(0) {
+}
+
+// Base pattern (restarts its phase only when the pattern changes)
+void LedRenderer::setBase(const LedPattern& pattern) {
+    if (pattern.kind == base.kind && pattern.color == base.color && pattern.periodMs == base.periodMs) {
+        return;
+    }
+    base = pattern;
+    baseStartMs = millis();
+}
+
+// Battery percentage for the low battery indication
+void LedRenderer::setBatteryLevel(float percent) {
+    batteryPercent = percent;
+}
+
+// One-shot flash on top of everything else (replaces a running flash)
+void LedRenderer::flash(const CRGB& color, uint8_t times, uint16_t onMs, uint16_t offMs) {
+    flashColor = color;
+    flashTimes = times;
+    flashOnMs = onMs;
+    flashOffMs = offMs;
+    flashPending = true;
+}
+
+// Colour of the base pattern at nowMs
+CRGB LedRenderer::evaluateBase(uint32_t nowMs) const {
+    if (base.kind == LedPattern::SOLID || base.periodMs == 0) {
+        return base.color;
+    }
+
+    const uint32_t phase = (nowMs - baseStartMs) % base.periodMs;
+    if (base.kind == LedPattern::BLINK) {
+        return phase < base.periodMs / 2 ? base.color : CRGB(CRGB::Black);
+    }
+
+    // PULSE: up for half the period, down for the other half, quantized so a
+    // slow fade produces PULSE_STEPS frames per ramp rather than one per loop
+    const uint32_t half = base.periodMs / 2;
+    const uint32_t ramp = phase < half ? phase : base.periodMs - phase;
+    const uint8_t step = half > 0 ? (uint8_t)(ramp * PULSE_STEPS / half) : PULSE_STEPS;
+    CRGB color = base.color;
+    color.nscale8((uint8_t)(step >= PULSE_STEPS ? 255 : step * (256 / PULSE_STEPS)));
+    return color;
+}
+
+// Colour of all layers at nowMs
+CRGB LedRenderer::evaluate(uint32_t nowMs) {
+    if (flashTimes > 0) {
+        if (flashPending) {
+            flashStartMs = nowMs;
+            flashPending = false;
+        }
+        const uint32_t cycle = (uint32_t)flashOnMs + flashOffMs;
+        const uint32_t elapsed = nowMs - flashStartMs;
+        // The last cycle ends with its on phase (no trailing pause)
+        if (cycle > 0 && elapsed < cycle * flashTimes - flashOffMs) {
+            return elapsed % cycle < flashOnMs ? flashColor : CRGB(CRGB::Black);
+        }
+        flashTimes = 0;
+    }
+
+    if (batteryPercent >= 0.0f && batteryPercent <= BATTERY_LOW_PERCENT &&
+        (nowMs / BATTERY_BLINK_MS) % 2 == 1) {
+        return batteryPercent <= BATTERY_CRITICAL_PERCENT ? CRGB(CRGB::Red) : CRGB(CRGB::Yellow);
+    }
+
+    return evaluateBase(nowMs);
+}
+
+// Write color to every pixel; show() only if one of them changed
+void LedRenderer::push(const CRGB& color) {
+    bool changed = !framePushed;
+    for (uint8_t i = 0; i < count; i++) {
+        if (leds[i] != color) {
+            leds[i] = color;
+            changed = true;
+        }
+    }
+    if (changed) {
+        FastLED.show();
+        framePushed = true;
+        showCount++;
+    }
+}
+
+// Evaluate and push - call every loop iteration
+void LedRenderer::render(uint32_t nowMs) {
+    frameCount++;
+    push(evaluate(nowMs));
+}
+
+// Off now, patterns cleared
+void LedRenderer::blank() {
+    base = LedPattern::off();
+    flashTimes = 0;
+    flashPending = false;
+    batteryPercent = -1.0f;
+    push(CRGB::Black);
+}
+
+// Print frame statistics
+void LedRenderer::printStats() const {
+    LOG_DEBUG("LED: %lu frames, %lu show() calls", (unsigned long)frameCount, (unsigned long)showCount);
+}
@@ -1,4 +1,6 @@
 #include "Logger.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 
 // ============================================================================
 // LOGGING SYSTEM IMPLEMENTATION
@@ -7,15 +9,53 @@
 // Global log level (default to INFO for production)
 LogLevel currentLogLevel = LogLevel::INFO;
 
+// Per-component levels, all following the global level until overridden
+LogLevel componentLogLevels[(size_t)LogComponent::COUNT] = {
+    LogLevel::INFO, LogLevel::INFO, LogLevel::INFO, LogLevel::INFO,
+    LogLevel::INFO, LogLevel::INFO, LogLevel::INFO, LogLevel::INFO,
+    LogLevel::INFO, LogLevel::INFO, LogLevel::INFO, LogLevel::INFO,
+    LogLevel::INFO, LogLevel::INFO
+};
+
+static const char* const kComponentNames[(size_t)LogComponent::COUNT] = {
+    "GENERAL", "AUDIO", "RFID", "SETUP", "DAC", "SD",
+    "BATTERY", "BUTTON", "ROTARY", "SETTINGS", "MAPPING", "SCANNER",
+    "SESSION", "POWER"
+};
+
+// Deferred log ring (single lock, records are copied in and out)
+static LogRecord deferredRing[LOG_DEFERRED_RING_SIZE];
+static uint16_t deferredHead = 0;
+static uint16_t deferredTail = 0;
+static uint32_t deferredDropped = 0;
+static portMUX_TYPE deferredMux = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t deferredTask = nullptr;
+
+static const uint32_t DEFERRED_TASK_STACK = 3072;
+static const uint32_t DEFERRED_DRAIN_INTERVAL_MS = 20;
+static const BaseType_t DEFERRED_TASK_CORE = 0;   // Audio loop runs on core 1
+
+static void deferredLogTask(void*);
+
 // Initialize logging system
 void initLogger(LogLevel level) {
-    currentLogLevel = level;
-    LOG_INFO("Logging system initialized with level: %d", (int)level);
+    setLogLevel(level);
+
+    if (!deferredTask) {
+        // Lowest priority: only runs when everything else on the core is idle
+        xTaskCreatePinnedToCore(deferredLogTask, "log", DEFERRED_TASK_STACK, nullptr,
+                                tskIDLE_PRIORITY, &deferredTask, DEFERRED_TASK_CORE);
+    }
+
+    LOG_INFO("Logging system initialized with level: %d (compiled up to %d)", (int)level, LOG_COMPILE_LEVEL);
 }
 
 // Set log level at runtime
 void setLogLevel(LogLevel level) {
     currentLogLevel = level;
+    for (size_t i = 0; i < (size_t)LogComponent::COUNT; i++) {
+        componentLogLevels[i] = level;
+    }
     LOG_INFO("Log level changed to: %d", (int)level);
 }
 
@@ -23,3 +63,203 @@ void setLogLevel(LogLevel level) {
 LogLevel getLogLevel() {
     return currentLogLevel;
 }
+
+// Override the level of a single component
+void setComponentLogLevel(LogComponent component, LogLevel level) {
+    if (component >= LogComponent::COUNT) {
+        return;
+    }
+    componentLogLevels[(size_t)component] = level;
+    if (component == LogComponent::GENERAL) {
+        currentLogLevel = level;
+    }
+    LOG_INFO("Log level for %s changed to: %d", getComponentName(component), (int)level);
+}
+
+// Get the level of a single component
+LogLevel getComponentLogLevel(LogComponent component) {
+    if (component >= LogComponent::COUNT) {
+        return currentLogLevel;
+    }
+    return componentLogLevels[(size_t)component];
+}
+
+// Get a readable component name
+const char* getComponentName(LogComponent component) {
+    if (component >= LogComponent::COUNT) {
+        return "UNKNOWN";
+    }
+    return kComponentNames[(size_t)component];
+}
+
+// ============================================================================
+// DEFERRED LOGGING
+// ============================================================================
+
+// Queue a record (drops it if the ring is full - the hot path never waits)
+void logDeferredPush(const LogRecord& record) {
+    portENTER_CRITICAL(&deferredMux);
+    uint16_t next = (deferredHead + 1) % LOG_DEFERRED_RING_SIZE;
+    if (next == deferredTail) {
+        deferredDropped++;
+    } else {
+        deferredRing[deferredHead] = record;
+        deferredHead = next;
+    }
+    portEXIT_CRITICAL(&deferredMux);
+}
+
+// Records lost to a full ring
+uint32_t getDeferredLogDropped() {
+    return deferredDropped;
+}
+
+// Take the oldest record out of the ring
+static bool popDeferred(LogRecord& record) {
+    bool available = false;
+    portENTER_CRITICAL(&deferredMux);
+    if (deferredTail != deferredHead) {
+        record = deferredRing[deferredTail];
+        deferredTail = (deferredTail + 1) % LOG_DEFERRED_RING_SIZE;
+        available = true;
+    }
+    portEXIT_CRITICAL(&deferredMux);
+    return available;
+}
+
+// Integer length modifier of a conversion spec
+enum class LogLength : uint8_t {
+    NONE,
+    LONG,
+    LONG_LONG,
+    SIZE
+};
+
+// Format one conversion spec with one tagged argument
+static int formatArg(char* out, size_t size, const char* spec, char conversion, LogLength length,
+                     LogArgType type, const LogArg& arg) {
+    switch (conversion) {
+        case 'd':
+        case 'i':
+            if (type == LogArgType::FLOAT) return snprintf(out, size, "%d", (int)arg.f);
+            switch (length) {
+                case LogLength::LONG: return snprintf(out, size, spec, (long)arg.i);
+                case LogLength::LONG_LONG: return snprintf(out, size, spec, (long long)arg.i);
+                case LogLength::SIZE: return snprintf(out, size, spec, (size_t)arg.u);
+                default: return snprintf(out, size, spec, (int)arg.i);
+            }
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o':
+            switch (length) {
+                case LogLength::LONG: return snprintf(out, size, spec, (unsigned long)arg.u);
+                case LogLength::LONG_LONG: return snprintf(out, size, spec, (unsigned long long)arg.u);
+                case LogLength::SIZE: return snprintf(out, size, spec, (size_t)arg.u);
+                default: return snprintf(out, size, spec, (unsigned)arg.u);
+            }
+        case 'c':
+            return snprintf(out, size, spec, (int)arg.i);
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+            if (type == LogArgType::INT) return snprintf(out, size, spec, (double)arg.i);
+            if (type == LogArgType::UINT) return snprintf(out, size, spec, (double)arg.u);
+            return snprintf(out, size, spec, (double)arg.f);
+        case 's':
+            return snprintf(out, size, spec, (type == LogArgType::STR && arg.s) ? arg.s : "(?)");
+        case 'p':
+            return snprintf(out, size, spec, arg.p);
+        default:
+            return snprintf(out, size, "%s", spec);
+    }
+}
+
+// Expand a record into text one conversion spec at a time
+static void formatDeferred(const LogRecord& record, char* out, size_t size) {
+    static const char* const kLevelPrefix[] = {"[ERROR] ", "[WARN]  ", "[INFO]  ", "[DEBUG] "};
+
+    size_t pos = snprintf(out, size, "%s[%lu] ", kLevelPrefix[(int)record.level],
+                          (unsigned long)record.timestampMs);
+    uint8_t argIndex = 0;
+    const char* f = record.fmt;
+
+    while (*f && pos + 1 < size) {
+        if (*f != '%') {
+            out[pos++] = *f++;
+            continue;
+        }
+        if (f[1] == '%') {
+            out[pos++] = '%';
+            f += 2;
+            continue;
+        }
+
+        // Copy "%[flags][width][.precision][length]conversion"
+        char spec[16];
+        size_t specLen = 0;
+        LogLength length = LogLength::NONE;
+        spec[specLen++] = *f++;
+        while (*f && strchr("-+ #0123456789.hlz", *f) && specLen < sizeof(spec) - 2) {
+            if (*f == 'l') length = (length == LogLength::LONG) ? LogLength::LONG_LONG : LogLength::LONG;
+            if (*f == 'z') length = LogLength::SIZE;
+            spec[specLen++] = *f++;
+        }
+        char conversion = *f;
+        if (!conversion) {
+            break;
+        }
+        spec[specLen++] = *f++;
+        spec[specLen] = '\0';
+
+        if (argIndex >= record.argCount) {
+            // More specs than arguments - print the spec itself
+            pos += snprintf(out + pos, size - pos, "%s", spec);
+        } else {
+            pos += formatArg(out + pos, size - pos, spec, conversion, length,
+                             record.types[argIndex], record.args[argIndex]);
+            argIndex++;
+        }
+    }
+
+    if (pos >= size) {
+        pos = size - 1;
+    }
+    out[pos] = '\0';
+}
+
+// Print every queued record
+static void drainDeferred(char* line, size_t size) {
+    static uint32_t reportedDropped = 0;
+    LogRecord record;
+
+    while (popDeferred(record)) {
+        formatDeferred(record, line, size);
+        Serial.println(line);
+    }
+
+    uint32_t dropped = deferredDropped;
+    if (dropped != reportedDropped) {
+        LOG_WARN("Deferred log ring full, %lu records dropped so far", (unsigned long)dropped);
+        reportedDropped = dropped;
+    }
+}
+
+// Drain the ring synchronously (e.g. before a restart or deep sleep)
+void flushDeferredLogs() {
+    char line[192];
+    drainDeferred(line, sizeof(line));
+}
+
+// Low-priority task that formats and prints deferred records
+static void deferredLogTask(void*) {
+    char line[192];
+
+    for (;;) {
+        drainDeferred(line, sizeof(line));
+        vTaskDelay(pdMS_TO_TICKS(DEFERRED_DRAIN_INTERVAL_MS));
+    }
+}
@@ -1,9 +1,10 @@
 #include "MappingStore.h"
 #include "Logger.h"
+#include <algorithm>
 
 // Constructor
 MappingStore::MappingStore() 
-    : sd(nullptr), filePath("/lookup.ndjson"), initialized(false) {
+    : sd(nullptr), filePath("/lookup.ndjson"), initialized(false), revision(0) {
 }
 
 // Initialize the mapping store
@@ -31,6 +32,8 @@ bool MappingStore::begin(fs::FS& sd, const char* path) {
 bool MappingStore::loadAll() {
     uid_to_path.clear();
     path_to_uid.clear();
+    sorted_paths.clear();
+    revision++;
     
     if (!sd->exists(filePath)) {
         Serial.println("MappingStore: Mapping file does not exist");
@@ -64,6 +67,7 @@ bool MappingStore::loadAll() {
     }
     
     f.close();
+    rebuildSortedPaths();
     Serial.printf("MappingStore: Loaded %d valid mappings from %d lines\n", validCount, lineCount);
     return true;
 }
@@ -164,6 +168,8 @@ bool MappingStore::append(const Mapping& m) {
     // Add to memory maps
     uid_to_path[m.uid] = m.path;
     path_to_uid[m.path] = m.uid;
+    addSortedPath(m.path);
+    revision++;
     
     // Write to file atomically: append new line to existing file
     String tempPath = String(filePath) + ".tmp";
@@ -232,10 +238,13 @@ bool MappingStore::rebind(const String& uid, const String& newPath) {
     // Update memory maps
     uid_to_path[normalizedUid] = normalizedPath;
     path_to_uid[normalizedPath] = normalizedUid;
+    addSortedPath(normalizedPath);
+    revision++;
     
     // Remove old path mapping if UID was mapped to different path
     if (oldPath.length() > 0 && oldPath != normalizedPath) {
         path_to_uid.erase(oldPath);
+        removeSortedPath(oldPath);
         Serial.printf("MappingStore: Removed old path mapping %s\n", oldPath.c_str());
     }
     
@@ -265,6 +274,8 @@ bool MappingStore::unassign(const String& uid) {
     // Remove from memory maps
     uid_to_path.erase(it);
     path_to_uid.erase(path);
+    removeSortedPath(path);
+    revision++;
     
     // Rewrite canonical file
     if (!writeCanonical()) {
@@ -276,6 +287,107 @@ bool MappingStore::unassign(const String& uid) {
     return true;
 }
 
+// Apply a list of assignments with one file write
+bool MappingStore::commitBatch(std::vector<BatchItem>& items, bool allOrNothing) {
+    // Stage on copies so rejected or failed batches leave the maps untouched
+    std::unordered_map<String, String> stagedUidToPath = uid_to_path;
+    std::unordered_map<String, String> stagedPathToUid = path_to_uid;
+    size_t changes = 0;
+    size_t rejected = 0;
+    
+    for (BatchItem& item : items) {
+        item.uid = normalizeUid(item.uid);
+        item.path = item.path.length() > 0 ? normalizePath(item.path) : String("");
+        item.previous = "";
+        
+        if (item.uid.length() == 0 || item.path.length() == 0) {
+            item.status = BatchStatus::INVALID;
+            rejected++;
+            continue;
+        }
+        
+        // Earlier items of the batch count as existing mappings
+        auto pathIt = stagedPathToUid.find(item.path);
+        if (pathIt != stagedPathToUid.end() && pathIt->second != item.uid) {
+            item.status = BatchStatus::PATH_CONFLICT;
+            item.previous = pathIt->second;
+            rejected++;
+            continue;
+        }
+        
+        auto uidIt = stagedUidToPath.find(item.uid);
+        if (uidIt != stagedUidToPath.end()) {
+            if (uidIt->second == item.path) {
+                item.status = BatchStatus::UNCHANGED;
+                continue;
+            }
+            item.previous = uidIt->second;
+            if (!item.force) {
+                item.status = BatchStatus::UID_CONFLICT;
+                rejected++;
+                continue;
+            }
+            stagedPathToUid.erase(uidIt->second);
+            item.status = BatchStatus::REASSIGNED;
+        } else {
+            item.status = BatchStatus::ASSIGNED;
+        }
+        
+        stagedUidToPath[item.uid] = item.path;
+        stagedPathToUid[item.path] = item.uid;
+        changes++;
+    }
+    
+    if (changes == 0 || (allOrNothing && rejected > 0)) {
+        if (changes > 0) {
+            for (BatchItem& item : items) {
+                if (item.status == BatchStatus::ASSIGNED || item.status == BatchStatus::REASSIGNED) {
+                    item.status = BatchStatus::NOT_COMMITTED;
+                }
+            }
+        }
+        LOG_MAPPING_INFO("Batch of %u: nothing written (%u rejected)", (unsigned)items.size(), (unsigned)rejected);
+        return true;
+    }
+    
+    uid_to_path.swap(stagedUidToPath);
+    path_to_uid.swap(stagedPathToUid);
+    rebuildSortedPaths();
+    revision++;
+    
+    if (!writeCanonical()) {
+        uid_to_path.swap(stagedUidToPath);
+        path_to_uid.swap(stagedPathToUid);
+        rebuildSortedPaths();
+        revision++;
+        for (BatchItem& item : items) {
+            if (item.status == BatchStatus::ASSIGNED || item.status == BatchStatus::REASSIGNED) {
+                item.status = BatchStatus::WRITE_FAILED;
+            }
+        }
+        LOG_MAPPING_ERROR("Batch write failed - %u changes rolled back", (unsigned)changes);
+        return false;
+    }
+    
+    LOG_MAPPING_INFO("Batch of %u: %u written, %u rejected", (unsigned)items.size(), (unsigned)changes, (unsigned)rejected);
+    return true;
+}
+
+// Get batch status name
+const char* MappingStore::getBatchStatusName(BatchStatus status) {
+    switch (status) {
+        case BatchStatus::ASSIGNED: return "assigned";
+        case BatchStatus::REASSIGNED: return "reassigned";
+        case BatchStatus::UNCHANGED: return "already_assigned_same";
+        case BatchStatus::INVALID: return "invalid";
+        case BatchStatus::UID_CONFLICT: return "conflict";
+        case BatchStatus::PATH_CONFLICT: return "path_conflict";
+        case BatchStatus::NOT_COMMITTED: return "not_committed";
+        case BatchStatus::WRITE_FAILED: return "write_failed";
+    }
+    return "unknown";
+}
+
 // Write canonical file (removes duplicates)
 bool MappingStore::writeCanonical() {
     String tempPath = String(filePath) + ".tmp";
@@ -357,6 +469,33 @@ bool MappingStore::hasPath(const String& path) const {
 void MappingStore::clear() {
     uid_to_path.clear();
     path_to_uid.clear();
+    sorted_paths.clear();
+    revision++;
+}
+
+// Keep sorted_paths in step with path_to_uid: binary search plus one
+// insert/erase for single changes, a sort after bulk changes
+void MappingStore::addSortedPath(const String& path) {
+    auto it = std::lower_bound(sorted_paths.begin(), sorted_paths.end(), path, pathLess);
+    if (it == sorted_paths.end() || *it != path) {
+        sorted_paths.insert(it, path);
+    }
+}
+
+void MappingStore::removeSortedPath(const String& path) {
+    auto it = std::lower_bound(sorted_paths.begin(), sorted_paths.end(), path, pathLess);
+    if (it != sorted_paths.end() && *it == path) {
+        sorted_paths.erase(it);
+    }
+}
+
+void MappingStore::rebuildSortedPaths() {
+    sorted_paths.clear();
+    sorted_paths.reserve(path_to_uid.size());
+    for (const auto& pair : path_to_uid) {
+        sorted_paths.push_back(pair.first);
+    }
+    std::sort(sorted_paths.begin(), sorted_paths.end(), pathLess);
 }
 
 // Debug methods
@@ -415,6 +554,8 @@ bool MappingStore::removePathMapping(const String& path) {
         String uid = it->second;
         uid_to_path.erase(uid);
         path_to_uid.erase(it);
+        removeSortedPath(normalizedPath);
+        revision++;
         Serial.printf("MappingStore: Removed path mapping %s -> %s\n", normalizedPath.c_str(), uid.c_str());
         return true;
     }
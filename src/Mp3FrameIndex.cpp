@@ -0,0 +1,703 @@
+#include "Mp3FrameIndex.h"
+#include "Logger.h"
+
+// Define static constexpr members
+constexpr uint32_t Mp3FrameIndex::kEntryIntervalMs;
+constexpr uint32_t Mp3FrameIndex::kScanFramesPerStep;
+constexpr const char* Mp3FrameIndex::kCacheDir;
+
+namespace {
+
+// Bitrates in kbps, indexed by [row][bitrate_index]
+// Rows: 0 = MPEG1 L1, 1 = MPEG1 L2, 2 = MPEG1 L3, 3 = MPEG2/2.5 L1, 4 = MPEG2/2.5 L2+L3
+const uint16_t kBitrates[5][16] = {
+    {0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448, 0},
+    {0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 0},
+    {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0},
+    {0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256, 0},
+    {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0}
+};
+
+// Sample rates indexed by [version][samplerate_index]
+// Rows: 0 = MPEG1, 1 = MPEG2, 2 = MPEG2.5
+const uint32_t kSampleRates[3][3] = {
+    {44100, 48000, 32000},
+    {22050, 24000, 16000},
+    {11025, 12000, 8000}
+};
+
+const size_t kHeaderProbeSize = 256;        // enough for any Xing/VBRI header
+const uint32_t kMaxSyncSearchBytes = 65536; // give up looking for a frame after 64 KB
+const int kCbrProbeFrames = 8;              // frames compared to detect CBR
+const uint32_t kId3v1Size = 128;
+
+// Cache file layout (little endian, written as-is from the ESP32)
+const uint32_t kCacheMagic = 0x58444952;    // "RIDX"
+const uint16_t kCacheVersion = 1;
+
+struct CacheHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t pathLength;
+    uint32_t fileSize;
+    uint32_t dataStart;
+    uint32_t dataEnd;
+    uint32_t durationMs;
+    uint32_t entryCount;
+    uint8_t source;
+    uint8_t reserved[3];
+    Mp3FrameIndex::FrameHeader firstFrame;
+};
+
+} // namespace
+
+// Constructor
+Mp3FrameIndex::Mp3FrameIndex()
+    : source(Source::NONE), complete(false), fromCache(false), firstFrame(),
+      fileSize(0), dataStart(0), dataEnd(0), durationMs(0), buildTimeMs(0),
+      fileSystem(nullptr), scanOffset(0), scanSamples(0) {
+}
+
+// Drop the current table
+void Mp3FrameIndex::clear() {
+    if (scanFile) {
+        scanFile.close();
+    }
+    offsets.clear();
+    offsets.shrink_to_fit();
+    filePath = "";
+    source = Source::NONE;
+    complete = false;
+    fromCache = false;
+    firstFrame = FrameHeader();
+    fileSize = 0;
+    dataStart = 0;
+    dataEnd = 0;
+    durationMs = 0;
+    buildTimeMs = 0;
+    fileSystem = nullptr;
+    scanOffset = 0;
+    scanSamples = 0;
+}
+
+// Check whether the table belongs to the given file
+bool Mp3FrameIndex::isFor(const char* path) const {
+    return isValid() && path && filePath == path;
+}
+
+// Get a readable name for the table source
+const char* Mp3FrameIndex::getSourceName() const {
+    switch (source) {
+        case Source::XING_TOC: return "XING";
+        case Source::VBRI_TOC: return "VBRI";
+        case Source::CBR: return "CBR";
+        case Source::FRAME_SCAN: return "SCAN";
+        default: return "NONE";
+    }
+}
+
+// Build the seek table from the file headers
+bool Mp3FrameIndex::build(fs::FS& fs, const char* path) {
+    clear();
+    if (!path || !path[0]) {
+        return false;
+    }
+
+    unsigned long startMs = millis();
+
+    fs::File f = fs.open(path, FILE_READ);
+    if (!f || f.isDirectory()) {
+        LOG_AUDIO_WARN("Frame index: cannot open %s", path);
+        return false;
+    }
+
+    fileSystem = &fs;
+    fileSize = f.size();
+
+    if (loadCache(fs, path, fileSize)) {
+        f.close();
+        buildTimeMs = millis() - startMs;
+        return true;
+    }
+
+    uint8_t probe[kHeaderProbeSize];
+
+    // Skip ID3v2 tag (size lives in a synchsafe field, no need to parse frames)
+    uint32_t searchFrom = 0;
+    if (readAt(f, 0, probe, 10)) {
+        searchFrom = id3v2Size(probe);
+    }
+
+    // Ignore trailing ID3v1 tag
+    dataEnd = fileSize;
+    if (fileSize > kId3v1Size && readAt(f, fileSize - kId3v1Size, probe, 3) &&
+        probe[0] == 'T' && probe[1] == 'A' && probe[2] == 'G') {
+        dataEnd = fileSize - kId3v1Size;
+    }
+
+    uint32_t frameOffset = 0;
+    if (!findFirstFrame(f, searchFrom, frameOffset, firstFrame)) {
+        LOG_AUDIO_WARN("Frame index: no MPEG frame found in %s", path);
+        f.close();
+        return false;
+    }
+
+    filePath = path;
+    dataStart = frameOffset;
+
+    // Xing/Info and VBRI headers live in the first frame
+    size_t probeLen = min((size_t)firstFrame.frameSize, kHeaderProbeSize);
+    if (readAt(f, frameOffset, probe, probeLen)) {
+        if (readTocFromXing(probe, probeLen) || readTocFromVbri(probe, probeLen)) {
+            f.close();
+            complete = true;
+            buildTimeMs = millis() - startMs;
+            saveCache();
+            return true;
+        }
+    }
+
+    if (looksLikeCbr(f)) {
+        f.close();
+        buildCbrTable();
+        complete = true;
+        buildTimeMs = millis() - startMs;
+        saveCache();
+        return true;
+    }
+
+    // VBR without a TOC: walk the frame headers incrementally
+    source = Source::FRAME_SCAN;
+    scanFile = f;
+    scanOffset = dataStart;
+    scanSamples = 0;
+    durationMs = (uint32_t)((uint64_t)(dataEnd - dataStart) * 8 / max<uint16_t>(firstFrame.bitrateKbps, 1));
+    continueBuild();
+    buildTimeMs = millis() - startMs;
+    return true;
+}
+
+// Walk up to maxFrames frame headers of a VBR file without a TOC
+bool Mp3FrameIndex::continueBuild(uint32_t maxFrames) {
+    if (complete || source != Source::FRAME_SCAN) {
+        return complete;
+    }
+    if (!scanFile) {
+        finishScan();
+        return true;
+    }
+
+    unsigned long startMs = millis();
+    uint8_t header[4];
+
+    for (uint32_t i = 0; i < maxFrames; i++) {
+        if (scanOffset + sizeof(header) > dataEnd) {
+            finishScan();
+            break;
+        }
+
+        FrameHeader frame;
+        if (!readAt(scanFile, scanOffset, header, sizeof(header)) || !parseFrameHeader(header, frame)) {
+            // Lost sync (corrupt frame or embedded junk) - search for the next frame
+            uint32_t next = 0;
+            if (!findFirstFrame(scanFile, scanOffset + 1, next, frame)) {
+                finishScan();
+                break;
+            }
+            scanOffset = next;
+        }
+
+        // Record an entry every time the timeline crosses the next interval
+        uint32_t frameMs = (uint32_t)(scanSamples * 1000 / frame.sampleRate);
+        while ((uint64_t)offsets.size() * kEntryIntervalMs <= frameMs) {
+            offsets.push_back(scanOffset);
+        }
+
+        scanSamples += frame.samplesPerFrame;
+        scanOffset += frame.frameSize;
+    }
+
+    if (!complete && scanOffset > dataStart) {
+        // Extrapolate total duration from the average bitrate seen so far
+        uint32_t scannedMs = (uint32_t)(scanSamples * 1000 / firstFrame.sampleRate);
+        durationMs = (uint32_t)((uint64_t)scannedMs * (dataEnd - dataStart) / (scanOffset - dataStart));
+    }
+
+    buildTimeMs += millis() - startMs;
+    return complete;
+}
+
+// Close the scan file and publish the final duration
+void Mp3FrameIndex::finishScan() {
+    if (scanFile) {
+        scanFile.close();
+    }
+    if (firstFrame.sampleRate > 0) {
+        durationMs = (uint32_t)(scanSamples * 1000 / firstFrame.sampleRate);
+    }
+    complete = true;
+    LOG_AUDIO_DEBUG("Frame index: scan of %s complete (%u entries, %u ms)",
+                    filePath.c_str(), (unsigned)offsets.size(), (unsigned)durationMs);
+    saveCache();
+}
+
+// Cache file name for a track (FNV-1a hash of the full path)
+String Mp3FrameIndex::cachePathFor(const char* path) const {
+    uint32_t hash = 2166136261UL;
+    for (const char* p = path; *p; p++) {
+        hash ^= (uint8_t)*p;
+        hash *= 16777619UL;
+    }
+    char name[24];
+    snprintf(name, sizeof(name), "/%08lx.idx", (unsigned long)hash);
+    return String(kCacheDir) + name;
+}
+
+// Load a previously saved table; rejected if the track changed size or the
+// cache belongs to another path with the same hash
+bool Mp3FrameIndex::loadCache(fs::FS& fs, const char* path, uint32_t expectedSize) {
+    String cachePath = cachePathFor(path);
+    if (!fs.exists(cachePath)) {
+        return false;
+    }
+
+    fs::File f = fs.open(cachePath, FILE_READ);
+    if (!f) {
+        return false;
+    }
+
+    CacheHeader header;
+    size_t pathLength = strlen(path);
+    bool ok = f.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+              header.magic == kCacheMagic && header.version == kCacheVersion &&
+              header.fileSize == expectedSize && header.pathLength == pathLength &&
+              header.source != (uint8_t)Source::NONE && header.entryCount > 0;
+
+    if (ok) {
+        // Confirm the stored path (guards against hash collisions)
+        char storedPath[128];
+        ok = pathLength < sizeof(storedPath) &&
+             f.read((uint8_t*)storedPath, pathLength) == pathLength &&
+             memcmp(storedPath, path, pathLength) == 0;
+    }
+
+    if (ok) {
+        // The table must fit what is left of the file before it is allocated
+        const size_t prefix = sizeof(header) + pathLength;
+        const size_t fileBytes = f.size();
+        ok = fileBytes >= prefix && header.entryCount <= (fileBytes - prefix) / sizeof(uint32_t);
+    }
+
+    if (ok) {
+        offsets.resize(header.entryCount);
+        size_t bytes = header.entryCount * sizeof(uint32_t);
+        ok = f.read((uint8_t*)offsets.data(), bytes) == bytes;
+    }
+    f.close();
+
+    if (!ok) {
+        offsets.clear();
+        LOG_AUDIO_DEBUG("Frame index: discarding stale cache %s", cachePath.c_str());
+        fs.remove(cachePath);
+        return false;
+    }
+
+    filePath = path;
+    source = (Source)header.source;
+    complete = true;
+    fromCache = true;
+    firstFrame = header.firstFrame;
+    dataStart = header.dataStart;
+    dataEnd = header.dataEnd;
+    durationMs = header.durationMs;
+    return true;
+}
+
+// Write the completed table next to the other cached indexes
+bool Mp3FrameIndex::saveCache() {
+    if (!fileSystem || !complete || offsets.empty() || filePath.length() >= 128) {
+        return false;
+    }
+
+    if (!fileSystem->exists(kCacheDir) && !fileSystem->mkdir(kCacheDir)) {
+        LOG_AUDIO_WARN("Frame index: cannot create %s", kCacheDir);
+        return false;
+    }
+
+    CacheHeader header = {};
+    header.magic = kCacheMagic;
+    header.version = kCacheVersion;
+    header.pathLength = filePath.length();
+    header.fileSize = fileSize;
+    header.dataStart = dataStart;
+    header.dataEnd = dataEnd;
+    header.durationMs = durationMs;
+    header.entryCount = offsets.size();
+    header.source = (uint8_t)source;
+    header.firstFrame = firstFrame;
+
+    // Write to a temp file and rename so a power cut never leaves a torn cache
+    String cachePath = cachePathFor(filePath.c_str());
+    String tempPath = cachePath + ".tmp";
+    fs::File f = fileSystem->open(tempPath, FILE_WRITE);
+    if (!f) {
+        return false;
+    }
+    size_t bytes = offsets.size() * sizeof(uint32_t);
+    bool ok = f.write((const uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+              f.write((const uint8_t*)filePath.c_str(), header.pathLength) == header.pathLength &&
+              f.write((const uint8_t*)offsets.data(), bytes) == bytes;
+    f.close();
+
+    if (ok) {
+        if (fileSystem->exists(cachePath)) {
+            fileSystem->remove(cachePath);
+        }
+        ok = fileSystem->rename(tempPath, cachePath);
+    }
+    if (!ok) {
+        fileSystem->remove(tempPath);
+        LOG_AUDIO_WARN("Frame index: failed to write cache for %s", filePath.c_str());
+        return false;
+    }
+
+    LOG_AUDIO_DEBUG("Frame index: cached %s as %s", filePath.c_str(), cachePath.c_str());
+    return true;
+}
+
+// Time covered by the table so far
+uint32_t Mp3FrameIndex::getIndexedMs() const {
+    if (complete) {
+        return durationMs;
+    }
+    return offsets.empty() ? 0 : (uint32_t)(offsets.size() - 1) * kEntryIntervalMs;
+}
+
+// Byte offset of the frame playing at the given time
+uint32_t Mp3FrameIndex::offsetForMs(uint32_t ms) const {
+    if (offsets.empty()) {
+        return dataStart;
+    }
+    size_t entry = ms / kEntryIntervalMs;
+    if (entry >= offsets.size()) {
+        entry = offsets.size() - 1;
+    }
+    return offsets[entry];
+}
+
+// Playback time of the given byte offset (interpolated between entries)
+uint32_t Mp3FrameIndex::msForOffset(uint32_t offset) const {
+    if (offsets.empty() || offset <= offsets[0]) {
+        return 0;
+    }
+
+    // Largest entry <= offset
+    size_t lo = 0;
+    size_t hi = offsets.size() - 1;
+    while (lo < hi) {
+        size_t mid = (lo + hi + 1) / 2;
+        if (offsets[mid] <= offset) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+
+    uint32_t baseMs = (uint32_t)lo * kEntryIntervalMs;
+    uint32_t nextOffset = (lo + 1 < offsets.size()) ? offsets[lo + 1] : dataEnd;
+    uint32_t nextMs = (lo + 1 < offsets.size()) ? baseMs + kEntryIntervalMs : durationMs;
+    if (nextOffset <= offsets[lo] || nextMs <= baseMs) {
+        return baseMs;
+    }
+
+    uint32_t ms = baseMs + (uint32_t)((uint64_t)(offset - offsets[lo]) * (nextMs - baseMs) /
+                                      (nextOffset - offsets[lo]));
+    return min(ms, durationMs);
+}
+
+// Parse a 4-byte MPEG audio frame header
+bool Mp3FrameIndex::parseFrameHeader(const uint8_t* h, FrameHeader& out) {
+    // 11-bit frame sync
+    if (h[0] != 0xFF || (h[1] & 0xE0) != 0xE0) {
+        return false;
+    }
+
+    uint8_t versionBits = (h[1] >> 3) & 0x03;
+    uint8_t layerBits = (h[1] >> 1) & 0x03;
+    uint8_t bitrateIndex = (h[2] >> 4) & 0x0F;
+    uint8_t sampleRateIndex = (h[2] >> 2) & 0x03;
+    uint8_t padding = (h[2] >> 1) & 0x01;
+    uint8_t channelMode = (h[3] >> 6) & 0x03;
+
+    // Reserved values, free-format and "bad" bitrates are rejected
+    if (versionBits == 0x01 || layerBits == 0x00 || bitrateIndex == 0x00 ||
+        bitrateIndex == 0x0F || sampleRateIndex == 0x03) {
+        return false;
+    }
+
+    bool mpeg1 = (versionBits == 0x03);
+    out.version = mpeg1 ? 10 : (versionBits == 0x02 ? 20 : 25);
+    out.layer = 4 - layerBits;
+
+    int rateRow = mpeg1 ? 0 : (versionBits == 0x02 ? 1 : 2);
+    out.sampleRate = kSampleRates[rateRow][sampleRateIndex];
+
+    int bitrateRow = mpeg1 ? (out.layer - 1) : (out.layer == 1 ? 3 : 4);
+    out.bitrateKbps = kBitrates[bitrateRow][bitrateIndex];
+
+    if (out.layer == 1) {
+        out.samplesPerFrame = 384;
+        out.frameSize = (uint16_t)((12UL * out.bitrateKbps * 1000 / out.sampleRate + padding) * 4);
+    } else {
+        out.samplesPerFrame = (out.layer == 3 && !mpeg1) ? 576 : 1152;
+        out.frameSize = (uint16_t)((uint32_t)out.samplesPerFrame / 8 * out.bitrateKbps * 1000 /
+                                   out.sampleRate + padding);
+    }
+
+    out.channels = (channelMode == 0x03) ? 1 : 2;
+    return out.frameSize > 4;
+}
+
+// Total size of a leading ID3v2 tag (0 if none)
+uint32_t Mp3FrameIndex::id3v2Size(const uint8_t* h) {
+    if (h[0] != 'I' || h[1] != 'D' || h[2] != '3') {
+        return 0;
+    }
+    // Synchsafe integer: 4 x 7 bits
+    if ((h[6] | h[7] | h[8] | h[9]) & 0x80) {
+        return 0;
+    }
+    uint32_t size = ((uint32_t)h[6] << 21) | ((uint32_t)h[7] << 14) |
+                    ((uint32_t)h[8] << 7) | (uint32_t)h[9];
+    bool hasFooter = (h[5] & 0x10) != 0;
+    return 10 + size + (hasFooter ? 10 : 0);
+}
+
+// Read the Xing/Info header (LAME, most VBR encoders)
+bool Mp3FrameIndex::readTocFromXing(const uint8_t* frame, size_t len) {
+    // Xing header follows the side information
+    size_t sideInfo;
+    if (firstFrame.version == 10) {
+        sideInfo = (firstFrame.channels == 1) ? 17 : 32;
+    } else {
+        sideInfo = (firstFrame.channels == 1) ? 9 : 17;
+    }
+    size_t pos = 4 + sideInfo;
+    if (pos + 8 > len) {
+        return false;
+    }
+
+    bool isXing = memcmp(frame + pos, "Xing", 4) == 0;
+    bool isInfo = memcmp(frame + pos, "Info", 4) == 0;
+    if (!isXing && !isInfo) {
+        return false;
+    }
+
+    uint32_t flags = readBigEndian32(frame + pos + 4);
+    pos += 8;
+
+    uint32_t frames = 0;
+    uint32_t bytes = 0;
+    const uint8_t* toc = nullptr;
+
+    if (flags & 0x01) {
+        if (pos + 4 > len) return false;
+        frames = readBigEndian32(frame + pos);
+        pos += 4;
+    }
+    if (flags & 0x02) {
+        if (pos + 4 > len) return false;
+        bytes = readBigEndian32(frame + pos);
+        pos += 4;
+    }
+    if (flags & 0x04) {
+        if (pos + 100 > len) return false;
+        toc = frame + pos;
+    }
+
+    if (frames == 0) {
+        return false;
+    }
+
+    // The info frame itself carries no audio
+    uint32_t tagFrameOffset = dataStart;
+    dataStart += firstFrame.frameSize;
+    durationMs = (uint32_t)((uint64_t)frames * firstFrame.samplesPerFrame * 1000 / firstFrame.sampleRate);
+
+    if (!toc) {
+        // "Info" (CBR) or Xing without TOC: frame count is enough for arithmetic indexing
+        buildCbrTable();
+        return true;
+    }
+
+    uint32_t span = (bytes > 0) ? bytes : (dataEnd - tagFrameOffset);
+    size_t entries = durationMs / kEntryIntervalMs + 1;
+    offsets.reserve(entries);
+
+    for (size_t i = 0; i < entries; i++) {
+        // Linear interpolation inside the 100-point percentage TOC
+        float percent = (float)(i * kEntryIntervalMs) * 100.0f / (float)durationMs;
+        if (percent > 99.999f) percent = 99.999f;
+        int idx = (int)percent;
+        float a = toc[idx];
+        float b = (idx < 99) ? toc[idx + 1] : 256.0f;
+        float x = a + (b - a) * (percent - idx);
+        uint32_t offset = tagFrameOffset + (uint32_t)(x / 256.0f * span);
+        offsets.push_back(max(offset, dataStart));
+    }
+
+    source = Source::XING_TOC;
+    LOG_AUDIO_DEBUG("Frame index: Xing TOC, %u frames, %u ms", (unsigned)frames, (unsigned)durationMs);
+    return true;
+}
+
+// Read the Fraunhofer VBRI header
+bool Mp3FrameIndex::readTocFromVbri(const uint8_t* frame, size_t len) {
+    // VBRI always sits 32 bytes after the frame header
+    const size_t pos = 4 + 32;
+    if (pos + 26 > len || memcmp(frame + pos, "VBRI", 4) != 0) {
+        return false;
+    }
+
+    uint32_t frames = readBigEndian32(frame + pos + 14);
+    uint16_t tocEntries = readBigEndian16(frame + pos + 18);
+    uint16_t scale = readBigEndian16(frame + pos + 20);
+    uint16_t entrySize = readBigEndian16(frame + pos + 22);
+    uint16_t framesPerEntry = readBigEndian16(frame + pos + 24);
+
+    if (frames == 0 || tocEntries == 0 || framesPerEntry == 0 || entrySize == 0 || entrySize > 4 ||
+        pos + 26 + (size_t)tocEntries * entrySize > len) {
+        // TOC larger than the probe (rare) - fall back to other strategies
+        return false;
+    }
+
+    dataStart += firstFrame.frameSize;
+    durationMs = (uint32_t)((uint64_t)frames * firstFrame.samplesPerFrame * 1000 / firstFrame.sampleRate);
+
+    // Cumulative byte offsets at every framesPerEntry boundary
+    std::vector<uint32_t> points;
+    points.reserve(tocEntries + 1);
+    points.push_back(dataStart);
+    const uint8_t* toc = frame + pos + 26;
+    for (uint16_t i = 0; i < tocEntries; i++) {
+        uint32_t size = 0;
+        for (uint16_t b = 0; b < entrySize; b++) {
+            size = (size << 8) | toc[i * entrySize + b];
+        }
+        points.push_back(points.back() + size * scale);
+    }
+
+    size_t entries = durationMs / kEntryIntervalMs + 1;
+    offsets.reserve(entries);
+    for (size_t i = 0; i < entries; i++) {
+        uint64_t frameNo = (uint64_t)i * kEntryIntervalMs * firstFrame.sampleRate /
+                           (1000ULL * firstFrame.samplesPerFrame);
+        size_t k = frameNo / framesPerEntry;
+        if (k >= points.size() - 1) {
+            offsets.push_back(min(points.back(), dataEnd));
+            continue;
+        }
+        uint32_t within = (uint32_t)(frameNo - (uint64_t)k * framesPerEntry);
+        uint32_t offset = points[k] + (uint32_t)((uint64_t)(points[k + 1] - points[k]) * within / framesPerEntry);
+        offsets.push_back(offset);
+    }
+
+    source = Source::VBRI_TOC;
+    LOG_AUDIO_DEBUG("Frame index: VBRI TOC, %u frames, %u ms", (unsigned)frames, (unsigned)durationMs);
+    return true;
+}
+
+// Check whether the first frames share a bitrate
+bool Mp3FrameIndex::looksLikeCbr(fs::File& f) {
+    uint32_t offset = dataStart;
+    uint8_t header[4];
+    for (int i = 0; i < kCbrProbeFrames; i++) {
+        FrameHeader frame;
+        if (offset + sizeof(header) > dataEnd) {
+            break;
+        }
+        if (!readAt(f, offset, header, sizeof(header)) || !parseFrameHeader(header, frame)) {
+            return false;
+        }
+        if (frame.bitrateKbps != firstFrame.bitrateKbps || frame.sampleRate != firstFrame.sampleRate) {
+            return false;
+        }
+        offset += frame.frameSize;
+    }
+    return true;
+}
+
+// Arithmetic table for constant-bitrate streams (frame-aligned)
+void Mp3FrameIndex::buildCbrTable() {
+    const uint64_t bytesPerSecondX8 = (uint64_t)firstFrame.bitrateKbps * 1000;
+    if (durationMs == 0) {
+        durationMs = (uint32_t)((uint64_t)(dataEnd - dataStart) * 8 * 1000 / bytesPerSecondX8);
+    }
+
+    size_t entries = durationMs / kEntryIntervalMs + 1;
+    offsets.reserve(entries);
+    for (size_t i = 0; i < entries; i++) {
+        // Round down to a frame boundary so the decoder lands on a sync word
+        uint64_t frameNo = (uint64_t)i * kEntryIntervalMs * firstFrame.sampleRate /
+                           (1000ULL * firstFrame.samplesPerFrame);
+        uint64_t offset = dataStart + frameNo * firstFrame.samplesPerFrame * bytesPerSecondX8 /
+                                      (8ULL * firstFrame.sampleRate);
+        offsets.push_back((uint32_t)min<uint64_t>(offset, dataEnd));
+    }
+
+    if (source == Source::NONE) {
+        source = Source::CBR;
+    }
+    LOG_AUDIO_DEBUG("Frame index: CBR %u kbps, %u ms", firstFrame.bitrateKbps, (unsigned)durationMs);
+}
+
+// Locate the first valid frame at or after 'from' (confirmed by the following frame)
+bool Mp3FrameIndex::findFirstFrame(fs::File& f, uint32_t from, uint32_t& frameOffset, FrameHeader& header) {
+    uint8_t buf[kHeaderProbeSize];
+    uint32_t limit = min(dataEnd, from + kMaxSyncSearchBytes);
+    uint32_t offset = from;
+
+    while (offset + 4 <= limit) {
+        size_t chunk = min((size_t)(limit - offset), sizeof(buf));
+        if (!readAt(f, offset, buf, chunk)) {
+            return false;
+        }
+
+        for (size_t i = 0; i + 4 <= chunk; i++) {
+            if (buf[i] != 0xFF || !parseFrameHeader(buf + i, header)) {
+                continue;
+            }
+            // Confirm with the next header to avoid false syncs inside audio data
+            uint32_t candidate = offset + i;
+            uint32_t next = candidate + header.frameSize;
+            FrameHeader nextHeader;
+            uint8_t nextBytes[4];
+            if (next + 4 > dataEnd ||
+                (readAt(f, next, nextBytes, sizeof(nextBytes)) && parseFrameHeader(nextBytes, nextHeader) &&
+                 nextHeader.sampleRate == header.sampleRate && nextHeader.layer == header.layer)) {
+                frameOffset = candidate;
+                return true;
+            }
+        }
+
+        // Overlap by 3 bytes so headers straddling chunks are not missed
+        offset += (chunk > 3) ? chunk - 3 : chunk;
+    }
+    return false;
+}
+
+// Positioned read
+bool Mp3FrameIndex::readAt(fs::File& f, uint32_t offset, uint8_t* buf, size_t len) {
+    if (!f.seek(offset)) {
+        return false;
+    }
+    return f.read(buf, len) == len;
+}
+
+uint32_t Mp3FrameIndex::readBigEndian32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+uint16_t Mp3FrameIndex::readBigEndian16(const uint8_t* p) {
+    return (uint16_t)(((uint16_t)p[0] << 8) | p[1]);
+}
@@ -0,0 +1,192 @@
+#include "OutputRouter.h"
+#include "DAC_Manager.h"
+#include "Audio_Manager.h"
+#include "Logger.h"
+
+// Define static constexpr members
+constexpr uint16_t OutputRouter::DEBOUNCE_MS;
+constexpr uint16_t OutputRouter::RAMP_MS;
+constexpr uint16_t OutputRouter::AMP_SETTLE_MS;
+constexpr uint16_t OutputRouter::DRAIN_TIMEOUT_MS;
+constexpr uint8_t OutputRouter::SPEAKER_VOLUME;
+
+// Static instance for ISR access
+OutputRouter* OutputRouter::instance = nullptr;
+
+// ISR function - only timestamps the edge, update() does the rest
+void IRAM_ATTR OutputRouter::detectISR() {
+    OutputRouter* self = instance;
+    if (!self) {
+        return;
+    }
+
+    uint32_t now = millis();
+    if (!self->edgePending.exchange(true, std::memory_order_acq_rel)) {
+        self->firstEdgeMs.store(now, std::memory_order_relaxed);
+    }
+    self->lastEdgeMs.store(now, std::memory_order_release);
+    self->edgeCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Constructor
+OutputRouter::OutputRouter(DAC_Manager& dac, Audio_Manager& audio, uint8_t detectPin, uint8_t ampShutdownPin)
+    : dac(dac), audio(audio), detectPin(detectPin), ampShutdownPin(ampShutdownPin), initialized(false),
+      edgePending(false), firstEdgeMs(0), lastEdgeMs(0), edgeCount(0),
+      route(Route::SPEAKER), targetRoute(Route::SPEAKER), state(State::IDLE), stateStartMs(0), requestMs(0),
+      switchCount(0), lastSwitchLatencyMs(0), maxSwitchLatencyMs(0) {
+    instance = this;
+}
+
+// Destructor
+OutputRouter::~OutputRouter() {
+    if (initialized) {
+        detachInterrupt(digitalPinToInterrupt(detectPin));
+    }
+    instance = nullptr;
+}
+
+// Attach the interrupt and apply the current route without ramps
+bool OutputRouter::begin() {
+    pinMode(detectPin, INPUT_PULLUP);
+    pinMode(ampShutdownPin, OUTPUT);
+
+    route = readDetect();
+    targetRoute = route;
+    applyRoute(route);
+    audio.setOutputGain(1.0f);
+
+    attachInterrupt(digitalPinToInterrupt(detectPin), detectISR, CHANGE);
+    initialized = true;
+
+    LOG_INFO("[HP-DET] Initial route: %s (GPIO%d: %d)", getRouteName(route), detectPin, digitalRead(detectPin));
+    return true;
+}
+
+// Headphones pull the detect line low
+OutputRouter::Route OutputRouter::readDetect() const {
+    return digitalRead(detectPin) == LOW ? Route::HEADPHONES : Route::SPEAKER;
+}
+
+const char* OutputRouter::getRouteName(Route r) {
+    return r == Route::HEADPHONES ? "HEADPHONES" : "SPEAKER";
+}
+
+// Step debounce and the transition state machine
+void OutputRouter::update() {
+    if (!initialized) {
+        return;
+    }
+
+    const uint32_t now = millis();
+
+    // Debounce: act once the line has been quiet for DEBOUNCE_MS
+    if (edgePending.load(std::memory_order_acquire) &&
+        now - lastEdgeMs.load(std::memory_order_acquire) >= DEBOUNCE_MS) {
+        uint32_t edgeMs = firstEdgeMs.load(std::memory_order_relaxed);
+        edgePending.store(false, std::memory_order_release);
+
+        Route detected = readDetect();
+        if (detected != targetRoute) {
+            targetRoute = detected;
+            requestMs = edgeMs;
+            LOG_DEBUG("[HP-DET] Jack -> %s (debounced after %lu ms)", getRouteName(detected),
+                      (unsigned long)(now - edgeMs));
+        }
+    }
+
+    switch (state) {
+        case State::IDLE:
+            if (targetRoute != route) {
+                startTransition(now);
+            }
+            break;
+
+        case State::RAMP_DOWN:
+            // Wait until the DAC plays the zero-gain frames, not just until they are written
+            if (audio.isPlaying() && !audio.isOutputSilent()) {
+                if (now - stateStartMs < DRAIN_TIMEOUT_MS) {
+                    break;
+                }
+                LOG_WARN("[HP-DET] Output not silent after %u ms, switching anyway", DRAIN_TIMEOUT_MS);
+            }
+            // Silent now: mute, switch and un-mute in one go
+            audio.setOutputGain(0.0f);
+            route = targetRoute;
+            applyRoute(route);
+            enterState(route == Route::SPEAKER ? State::SETTLE : State::RAMP_UP, now);
+            break;
+
+        case State::SETTLE:
+            if (now - stateStartMs >= AMP_SETTLE_MS) {
+                enterState(State::RAMP_UP, now);
+            }
+            break;
+
+        case State::RAMP_UP:
+            if (audio.isPlaying() && audio.isOutputRamping()) {
+                break;
+            }
+            finishTransition(now);
+            break;
+    }
+}
+
+// Begin a route change (instant when nothing is playing)
+void OutputRouter::startTransition(uint32_t now) {
+    if (!audio.isPlaying()) {
+        route = targetRoute;
+        applyRoute(route);
+        audio.setOutputGain(1.0f);
+        finishTransition(now);
+        return;
+    }
+    enterState(State::RAMP_DOWN, now);
+}
+
+void OutputRouter::enterState(State newState, uint32_t now) {
+    state = newState;
+    stateStartMs = now;
+
+    if (newState == State::RAMP_DOWN) {
+        audio.rampOutputGain(0.0f, RAMP_MS);
+    } else if (newState == State::RAMP_UP) {
+        audio.rampOutputGain(1.0f, RAMP_MS);
+    }
+}
+
+// Back at full volume on the new route
+void OutputRouter::finishTransition(uint32_t now) {
+    audio.setOutputGain(1.0f);
+    state = State::IDLE;
+
+    lastSwitchLatencyMs = now - requestMs;
+    if (lastSwitchLatencyMs > maxSwitchLatencyMs) {
+        maxSwitchLatencyMs = lastSwitchLatencyMs;
+    }
+    switchCount++;
+
+    LOG_INFO("[HP-DET] ROUTE -> %s (%lu ms after jack change)", getRouteName(route),
+             (unsigned long)lastSwitchLatencyMs);
+}
+
+// Drive the codec and the external amplifier for a route. Going to the
+// speaker the codec is enabled before the amp; leaving it the amp goes first.
+void OutputRouter::applyRoute(Route newRoute) {
+    if (newRoute == Route::HEADPHONES) {
+        digitalWrite(ampShutdownPin, LOW);
+        dac.setSpeakerVolume(0);
+        dac.enableSpeaker(false);
+    } else {
+        dac.setSpeakerVolume(SPEAKER_VOLUME);
+        dac.enableSpeaker(true);
+        digitalWrite(ampShutdownPin, HIGH);
+    }
+}
+
+// Print statistics
+void OutputRouter::printStats() const {
+    LOG_INFO("[HP-DET] Route %s, %lu switches, latency last %lu ms / max %lu ms, %lu jack edges",
+             getRouteName(route), (unsigned long)switchCount,
+             (unsigned long)lastSwitchLatencyMs, (unsigned long)maxSwitchLatencyMs,
+             (unsigned long)getEdgeCount());
+}
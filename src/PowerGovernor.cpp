@@ -0,0 +1,257 @@
+#include "PowerGovernor.h"
+#include "Logger.h"
+#include "esp_sleep.h"
+#include "driver/gpio.h"
+
+// Define static constexpr members
+constexpr uint32_t PowerGovernor::ACTIVE_CPU_MHZ;
+constexpr uint32_t PowerGovernor::IDLE_CPU_MHZ;
+constexpr uint32_t PowerGovernor::IDLE_HOLDOFF_MS;
+constexpr uint32_t PowerGovernor::LOOP_DELAY_MS;
+constexpr uint32_t PowerGovernor::MIN_SLEEP_MS;
+constexpr uint32_t PowerGovernor::MAX_SLEEP_MS;
+constexpr uint8_t PowerGovernor::MAX_WAKE_PINS;
+constexpr float PowerGovernor::ACTIVE_CURRENT_MA;
+constexpr float PowerGovernor::IDLE_CURRENT_MA;
+constexpr float PowerGovernor::LIGHT_SLEEP_CURRENT_MA;
+constexpr float PowerGovernor::DEFAULT_CAPACITY_MAH;
+
+// Constructor
+PowerGovernor::PowerGovernor()
+    : mode(Mode::ACTIVE), currentCpuMhz(0), lastActivityMs(0), lastAccountMs(0),
+      deepSleepTimeoutMs(0), deepSleepCallback(nullptr), batteryCapacityMah(DEFAULT_CAPACITY_MAH),
+      wakePinCount(0), deepSleepWakePin(-1),
+      activeMs(0), idleMs(0), sleepMs(0),
+      lightSleepCount(0), gpioWakeCount(0) {
+    lastError[0] = '\0';
+}
+
+// Log the wake-up cause and start accounting
+bool PowerGovernor::begin() {
+    if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_EXT0) {
+        LOG_POWER_INFO("Woke from deep sleep (encoder)");
+    }
+
+    currentCpuMhz = getCpuFrequencyMhz();
+    lastActivityMs = millis();
+    lastAccountMs = lastActivityMs;
+    mode = Mode::ACTIVE;
+    LOG_POWER_INFO("Governor ready: %lu MHz, %u wake pin(s)", (unsigned long)currentCpuMhz, wakePinCount);
+    return true;
+}
+
+// Add a light sleep GPIO wake pin
+bool PowerGovernor::addWakePin(uint8_t pin) {
+    if (wakePinCount >= MAX_WAKE_PINS) {
+        setLastError("Too many wake pins");
+        return false;
+    }
+    wakePins[wakePinCount++] = pin;
+    return true;
+}
+
+// Set the deep sleep (ext0) wake pin
+void PowerGovernor::setDeepSleepWakePin(uint8_t pin) {
+    deepSleepWakePin = pin;
+}
+
+// Set the deep sleep timeout (settings: sleepTimeout)
+void PowerGovernor::setDeepSleepTimeout(uint32_t timeoutMs) {
+    deepSleepTimeoutMs = timeoutMs;
+    LOG_POWER_INFO("Deep sleep after %lu s idle", (unsigned long)(timeoutMs / 1000));
+}
+
+// Set the battery capacity used for the runtime estimate
+void PowerGovernor::setBatteryCapacity(float capacityMah) {
+    if (capacityMah > 0.0f) {
+        batteryCapacityMah = capacityMah;
+    }
+}
+
+// Input was seen - restart the idle timers
+void PowerGovernor::notifyActivity() {
+    lastActivityMs = millis();
+}
+
+// Pick the mode for this iteration
+void PowerGovernor::update(bool busy) {
+    uint32_t now = millis();
+    accountTime(now);
+
+    if (busy) {
+        lastActivityMs = now;
+        if (mode != Mode::ACTIVE) {
+            LOG_POWER_DEBUG("%s -> ACTIVE", getModeName(mode));
+        }
+        mode = Mode::ACTIVE;
+        setCpuMhz(ACTIVE_CPU_MHZ);
+        return;
+    }
+
+    uint32_t idleFor = now - lastActivityMs;
+    if (deepSleepTimeoutMs > 0 && idleFor >= deepSleepTimeoutMs) {
+        enterDeepSleep();
+        return;
+    }
+
+    Mode newMode = idleFor >= IDLE_HOLDOFF_MS ? Mode::LIGHT_SLEEP : Mode::IDLE;
+    if (newMode != mode) {
+        LOG_POWER_DEBUG("%s -> %s", getModeName(mode), getModeName(newMode));
+        mode = newMode;
+    }
+    setCpuMhz(IDLE_CPU_MHZ);
+}
+
+// Light-sleep until the next poll or delay as before
+void PowerGovernor::idleDelay(uint32_t sleepBudgetMs) {
+    if (mode != Mode::LIGHT_SLEEP || sleepBudgetMs < MIN_SLEEP_MS) {
+        delay(LOOP_DELAY_MS);
+        return;
+    }
+
+    accountTime(millis());
+    uint32_t slept = lightSleep(sleepBudgetMs > MAX_SLEEP_MS ? MAX_SLEEP_MS : sleepBudgetMs);
+    sleepMs += slept;
+    lastAccountMs = millis();
+}
+
+// Change the CPU clock only when it differs
+void PowerGovernor::setCpuMhz(uint32_t mhz) {
+    if (mhz == currentCpuMhz) {
+        return;
+    }
+    if (!setCpuFrequencyMhz(mhz)) {
+        setLastError("CPU frequency change failed");
+        LOG_POWER_WARN("Could not set CPU to %lu MHz", (unsigned long)mhz);
+        return;
+    }
+    currentCpuMhz = mhz;
+}
+
+// Add the time since the last call to the current mode (awake time only)
+void PowerGovernor::accountTime(uint32_t now) {
+    uint32_t elapsed = now - lastAccountMs;
+    lastAccountMs = now;
+    if (mode == Mode::ACTIVE) {
+        activeMs += elapsed;
+    } else {
+        idleMs += elapsed;
+    }
+}
+
+// One light sleep; returns the time actually slept
+uint32_t PowerGovernor::lightSleep(uint32_t durationMs) {
+    // Finish pending UART output, it stops while the APB clock is gated
+    Serial.flush();
+
+    esp_sleep_enable_timer_wakeup((uint64_t)durationMs * 1000ULL);
+
+    // Wake on the level opposite to the current one. The pin interrupt is
+    // disabled while the level trigger is armed so it cannot fire repeatedly.
+    for (uint8_t i = 0; i < wakePinCount; i++) {
+        gpio_num_t pin = (gpio_num_t)wakePins[i];
+        gpio_intr_disable(pin);
+        gpio_wakeup_enable(pin, digitalRead(wakePins[i]) ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+    }
+    if (wakePinCount > 0) {
+        esp_sleep_enable_gpio_wakeup();
+    }
+
+    uint32_t start = millis();
+    esp_err_t result = esp_light_sleep_start();
+    uint32_t slept = millis() - start;
+
+    // Restore the edge interrupts used by the encoder and jack detect
+    for (uint8_t i = 0; i < wakePinCount; i++) {
+        gpio_num_t pin = (gpio_num_t)wakePins[i];
+        gpio_wakeup_disable(pin);
+        gpio_set_intr_type(pin, GPIO_INTR_ANYEDGE);
+        gpio_intr_enable(pin);
+    }
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
+
+    if (result != ESP_OK) {
+        setLastError("Light sleep rejected");
+        return 0;
+    }
+
+    lightSleepCount++;
+    if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO) {
+        gpioWakeCount++;
+        notifyActivity();
+    }
+    return slept;
+}
+
+// Save state via the callback and deep-sleep until the encoder moves
+void PowerGovernor::enterDeepSleep() {
+    LOG_POWER_INFO("Idle for %lu s - entering deep sleep", (unsigned long)((millis() - lastActivityMs) / 1000));
+    printStats();
+
+    if (deepSleepCallback) {
+        deepSleepCallback();
+    }
+
+    flushDeferredLogs();
+    Serial.flush();
+
+    if (deepSleepWakePin >= 0) {
+        esp_sleep_enable_ext0_wakeup((gpio_num_t)deepSleepWakePin, digitalRead(deepSleepWakePin) ? 0 : 1);
+    } else {
+        LOG_POWER_WARN("No deep sleep wake pin - only reset will wake the device");
+    }
+    esp_deep_sleep_start();
+}
+
+// Get mode name
+const char* PowerGovernor::getModeName(Mode m) {
+    switch (m) {
+        case Mode::ACTIVE: return "ACTIVE";
+        case Mode::IDLE: return "IDLE";
+        case Mode::LIGHT_SLEEP: return "LIGHT_SLEEP";
+    }
+    return "UNKNOWN";
+}
+
+// Average current for the given time split
+float PowerGovernor::estimateCurrentMa(uint32_t activeTimeMs, uint32_t idleTimeMs, uint32_t sleepTimeMs) {
+    float total = (float)activeTimeMs + (float)idleTimeMs + (float)sleepTimeMs;
+    if (total <= 0.0f) {
+        return ACTIVE_CURRENT_MA;
+    }
+    return (activeTimeMs * ACTIVE_CURRENT_MA + idleTimeMs * IDLE_CURRENT_MA +
+            sleepTimeMs * LIGHT_SLEEP_CURRENT_MA) / total;
+}
+
+// Average current since boot
+float PowerGovernor::getAverageCurrentMa() const {
+    return estimateCurrentMa(activeMs, idleMs, sleepMs);
+}
+
+// Runtime on a full battery at the average current since boot
+float PowerGovernor::getEstimatedRuntimeHours() const {
+    return batteryCapacityMah / getAverageCurrentMa();
+}
+
+// Print statistics
+void PowerGovernor::printStats() const {
+    uint32_t total = activeMs + idleMs + sleepMs;
+    LOG_POWER_INFO("Mode %s @ %lu MHz | active %lu s, idle %lu s, sleep %lu s (%.0f%%), %lu sleeps, %lu GPIO wakes",
+                   getModeName(mode), (unsigned long)currentCpuMhz,
+                   (unsigned long)(activeMs / 1000), (unsigned long)(idleMs / 1000), (unsigned long)(sleepMs / 1000),
+                   total > 0 ? 100.0f * sleepMs / total : 0.0f,
+                   (unsigned long)lightSleepCount, (unsigned long)gpioWakeCount);
+    LOG_POWER_INFO("Average %.1f mA, estimated runtime %.1f h (%.0f mAh)",
+                   getAverageCurrentMa(), getEstimatedRuntimeHours(), batteryCapacityMah);
+}
+
+// Get last error message
+const char* PowerGovernor::getLastError() const {
+    return lastError;
+}
+
+// Set last error message
+void PowerGovernor::setLastError(const char* error) const {
+    strncpy(lastError, error, sizeof(lastError) - 1);
+    lastError[sizeof(lastError) - 1] = '\0';
+}
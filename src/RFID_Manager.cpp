@@ -1,6 +1,12 @@
 #include "RFID_Manager.h"
 #include "Logger.h"
 
+// Define static constexpr members
+constexpr size_t RFID_Manager::UID_STRING_SIZE;
+constexpr uint8_t RFID_Manager::RECORD_FIRST_PAGE;
+constexpr uint8_t RFID_Manager::RECORD_FIRST_BLOCK;
+constexpr uint8_t RFID_Manager::RECORD_TRAILER_BLOCK;
+
 // Constructor
 RFID_Manager::RFID_Manager(uint8_t sclk, uint8_t miso, uint8_t mosi, uint8_t ss) 
     : mfrc522(ss, MFRC522_RST_PIN) {
@@ -12,11 +18,17 @@ RFID_Manager::RFID_Manager(uint8_t sclk, uint8_t miso, uint8_t mosi, uint8_t ss)
     initialized = false;
     tagPresent = false;
     lastDetectedUIDSize = 0;
-    lastDetectedUIDString = "";
+    lastDetectedUIDString[0] = '\0';
     debounceCounter = 0;
     lastTagCheck = 0;
     audioCallback = nullptr;
     audioControlEnabled = false;
+    pollCount = 0;
+    uidFormatCount = 0;
+    tagRecordsEnabled = false;
+    tagRecordValid = false;
+    tagRecordPath[0] = '\0';
+    tagRecordReadUs = 0;
 }
 
 // Initialize RFID system
@@ -76,15 +88,190 @@ bool RFID_Manager::compareUid(const byte* uid, const byte* candidate, byte len)
     return true;
 }
 
-// Convert UID to string representation
-String RFID_Manager::uidToString(const byte* uid, byte len) {
-    String uidString = "";
-    for (byte i = 0; i < len; i++) {
-        if (uid[i] < 0x10) uidString += "0";
-        uidString += String(uid[i], HEX);
-        if (i != len - 1) uidString += ":";
+// Format a UID as lowercase "aa:bb:cc:dd" into out (no heap)
+void RFID_Manager::formatUid(const byte* uid, byte len, char* out, size_t outSize) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    size_t pos = 0;
+    for (byte i = 0; i < len && pos + 3 <= outSize; i++) {
+        if (i > 0) out[pos++] = ':';
+        out[pos++] = HEX_DIGITS[uid[i] >> 4];
+        out[pos++] = HEX_DIGITS[uid[i] & 0x0F];
+    }
+    out[pos < outSize ? pos : outSize - 1] = '\0';
+}
+
+// Store a new UID and its string form
+void RFID_Manager::rememberUid(const byte* uid, byte len) {
+    if (len > sizeof(lastDetectedUID)) {
+        len = sizeof(lastDetectedUID);
+    }
+    memcpy(lastDetectedUID, uid, len);
+    lastDetectedUIDSize = len;
+    formatUid(uid, len, lastDetectedUIDString, sizeof(lastDetectedUIDString));
+    uidFormatCount++;
+}
+
+// Seed the remembered UID from its string form ("aa:bb:cc:dd")
+bool RFID_Manager::expectTag(const char* uidString) {
+    if (!uidString) {
+        return false;
+    }
+    
+    byte uid[sizeof(lastDetectedUID)];
+    byte size = 0;
+    const char* p = uidString;
+    while (*p && size < sizeof(uid)) {
+        char* end = nullptr;
+        unsigned long value = strtoul(p, &end, 16);
+        if (end == p || value > 0xFF) {
+            return false;
+        }
+        uid[size++] = (byte)value;
+        p = (*end == ':') ? end + 1 : end;
+    }
+    if (size == 0 || *p != '\0') {
+        return false;
     }
-    return uidString;
+    
+    rememberUid(uid, size);
+    tagPresent = false;
+    LOG_RFID_DEBUG("Expecting tag %s", lastDetectedUIDString);
+    return true;
+}
+
+// ============================================================================
+// TAG RECORDS
+// ============================================================================
+
+bool RFID_Manager::isClassic(MFRC522::PICC_Type type) {
+    return type == MFRC522::PICC_TYPE_MIFARE_MINI || type == MFRC522::PICC_TYPE_MIFARE_1K ||
+           type == MFRC522::PICC_TYPE_MIFARE_4K;
+}
+
+// Classic cards need sector 1 authenticated; NTAG/Ultralight pages are open
+bool RFID_Manager::beginRecordAccess(MFRC522::PICC_Type type) {
+    if (type == MFRC522::PICC_TYPE_MIFARE_UL) {
+        return true;
+    }
+    if (!isClassic(type)) {
+        return false;
+    }
+    MFRC522::MIFARE_Key key;
+    memset(key.keyByte, 0xFF, sizeof(key.keyByte));
+    return mfrc522.PCD_Authenticate(MFRC522::PICC_CMD_MF_AUTH_KEY_A, RECORD_TRAILER_BLOCK,
+                                    &key, &mfrc522.uid) == MFRC522::STATUS_OK;
+}
+
+// Read 16 record bytes (one Classic block or four NTAG pages)
+bool RFID_Manager::readRecordBlock(MFRC522::PICC_Type type, uint8_t index, uint8_t* out) {
+    byte buffer[TagRecord::BLOCK_SIZE + 2];   // Data plus CRC
+    byte size = sizeof(buffer);
+    const byte address = isClassic(type) ? RECORD_FIRST_BLOCK + index : RECORD_FIRST_PAGE + index * 4;
+    if (mfrc522.MIFARE_Read(address, buffer, &size) != MFRC522::STATUS_OK) {
+        return false;
+    }
+    memcpy(out, buffer, TagRecord::BLOCK_SIZE);
+    return true;
+}
+
+// Write 16 record bytes
+bool RFID_Manager::writeRecordBlock(MFRC522::PICC_Type type, uint8_t index, const uint8_t* data) {
+    byte buffer[TagRecord::BLOCK_SIZE];
+    memcpy(buffer, data, sizeof(buffer));
+    if (isClassic(type)) {
+        return mfrc522.MIFARE_Write(RECORD_FIRST_BLOCK + index, buffer, sizeof(buffer)) == MFRC522::STATUS_OK;
+    }
+    for (uint8_t page = 0; page < 4; page++) {
+        if (mfrc522.MIFARE_Ultralight_Write(RECORD_FIRST_PAGE + index * 4 + page, buffer + page * 4, 4) != MFRC522::STATUS_OK) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Read the record of the tag selected by the last PICC_ReadCardSerial().
+// A blank tag costs one block read.
+void RFID_Manager::readTagRecord() {
+    tagRecordValid = false;
+    tagRecordPath[0] = '\0';
+    tagRecordReadUs = 0;
+    if (!tagRecordsEnabled) {
+        return;
+    }
+    
+    const uint32_t startUs = micros();
+    const MFRC522::PICC_Type type = MFRC522::PICC_GetType(mfrc522.uid.sak);
+    uint8_t data[TagRecord::RECORD_SIZE];
+    size_t length = 0;
+    if (beginRecordAccess(type) && readRecordBlock(type, 0, data)) {
+        length = TagRecord::BLOCK_SIZE;
+        const size_t used = TagRecord::usedSize(data);
+        while (length < used && readRecordBlock(type, length / TagRecord::BLOCK_SIZE, data + length)) {
+            length += TagRecord::BLOCK_SIZE;
+        }
+        tagRecordValid = used > 0 && TagRecord::decode(data, length, tagRecordPath, sizeof(tagRecordPath));
+    }
+    if (isClassic(type)) {
+        mfrc522.PCD_StopCrypto1();
+    }
+    tagRecordReadUs = micros() - startUs;
+    
+    if (tagRecordValid) {
+        LOG_RFID_INFO("Tag record: %s (read in %lu us)", tagRecordPath, (unsigned long)tagRecordReadUs);
+    } else {
+        tagRecordPath[0] = '\0';
+        LOG_RFID_DEBUG("No tag record (%lu us)", (unsigned long)tagRecordReadUs);
+    }
+}
+
+// Select the remembered tag again (it may have gone idle since the last poll)
+bool RFID_Manager::reselectTag() {
+    for (uint8_t attempt = 0; attempt < 2; attempt++) {
+        byte atqa[2];
+        byte size = sizeof(atqa);
+        if (mfrc522.PICC_WakeupA(atqa, &size) == MFRC522::STATUS_OK && mfrc522.PICC_ReadCardSerial()) {
+            return mfrc522.uid.size == lastDetectedUIDSize &&
+                   compareUid(mfrc522.uid.uidByte, lastDetectedUID, lastDetectedUIDSize);
+        }
+    }
+    return false;
+}
+
+// Write a folder record to the tag on the reader
+bool RFID_Manager::writeTagRecord(const char* path) {
+    if (!initialized || !tagPresent) {
+        return false;
+    }
+    
+    uint8_t data[TagRecord::RECORD_SIZE];
+    if (!TagRecord::encode(path, data)) {
+        LOG_RFID_WARN("No tag record for %s (longer than %u characters)", path ? path : "",
+                      (unsigned)TagRecord::MAX_PATH_LENGTH);
+        return false;
+    }
+    if (!reselectTag()) {
+        LOG_RFID_WARN("Tag %s not reachable for writing", lastDetectedUIDString);
+        return false;
+    }
+    
+    const uint32_t startUs = micros();
+    const MFRC522::PICC_Type type = MFRC522::PICC_GetType(mfrc522.uid.sak);
+    bool written = beginRecordAccess(type);
+    for (uint8_t index = 0; written && index < TagRecord::RECORD_SIZE / TagRecord::BLOCK_SIZE; index++) {
+        written = writeRecordBlock(type, index, data + index * TagRecord::BLOCK_SIZE);
+    }
+    if (isClassic(type)) {
+        mfrc522.PCD_StopCrypto1();
+    }
+    
+    if (!written) {
+        LOG_RFID_WARN("Writing tag record failed (card type %u)", (unsigned)type);
+        return false;
+    }
+    strcpy(tagRecordPath, path);
+    tagRecordValid = true;
+    LOG_RFID_INFO("Tag record written: %s (%lu us)", path, (unsigned long)(micros() - startUs));
+    return true;
 }
 
 // Set audio control callback
@@ -106,42 +293,37 @@ void RFID_Manager::update() {
         // Check for tag presence
         bool currentlyDetected = mfrc522.PICC_IsNewCardPresent() && mfrc522.PICC_ReadCardSerial();
         
+        pollCount++;
+        
         if (currentlyDetected) {
             // Tag detected - reset debounce counter
             debounceCounter = 0;
             
-            // Convert current UID to string for comparison
-            String currentUIDString = uidToString(mfrc522.uid.uidByte, mfrc522.uid.size);
-            
-            // Check if this is the same tag as before (even if tag was previously removed)
+            // Compare raw bytes first; the UID is only formatted when it changes
             bool isSameTag = false;
             if (lastDetectedUIDSize > 0 && mfrc522.uid.size == lastDetectedUIDSize) {
                 isSameTag = compareUid(mfrc522.uid.uidByte, lastDetectedUID, mfrc522.uid.size);
             }
             
             if (!isSameTag) {
-                // New or different tag detected
-                Serial.println("Sending UID to audio control\n");
-                
-                // Store the newly detected tag details
-                memcpy(lastDetectedUID, mfrc522.uid.uidByte, mfrc522.uid.size);
-                lastDetectedUIDSize = mfrc522.uid.size;
-                lastDetectedUIDString = currentUIDString;
+                // New or different tag detected - read its record while it is selected
+                rememberUid(mfrc522.uid.uidByte, mfrc522.uid.size);
+                readTagRecord();
                 tagPresent = true;
                 
-                Serial.printf("[RFID] New tag detected: %s\n", currentUIDString.c_str());
+                LOG_RFID_INFO("New tag detected: %s", lastDetectedUIDString);
                 
                 // Call audio control callback if enabled
                 if (audioControlEnabled && audioCallback) {
-                    audioCallback(currentUIDString.c_str(), true, true, false);
+                    audioCallback(lastDetectedUIDString, true, true, false);
                 }
             } else if (!tagPresent) {
                 // Same tag re-inserted (was previously removed)
-                Serial.printf("[RFID] Same tag re-inserted: %s\n", currentUIDString.c_str());
+                LOG_RFID_INFO("Same tag re-inserted: %s", lastDetectedUIDString);
                 
                 // Call audio control callback for resume/pause logic
                 if (audioControlEnabled && audioCallback) {
-                    audioCallback(currentUIDString.c_str(), true, false, true);
+                    audioCallback(lastDetectedUIDString, true, false, true);
                 }
                 
                 // Update tag presence state
@@ -156,7 +338,7 @@ void RFID_Manager::update() {
             if (debounceCounter >= DEBOUNCE_THRESHOLD) {
                 // No card detected for DEBOUNCE_THRESHOLD iterations
                 if (tagPresent) {
-                    Serial.println("No card detected, resetting tag state\n");
+                    LOG_RFID_INFO("No card detected, resetting tag state");
                     
                     // Call audio control callback for tag removal
                     if (audioControlEnabled && audioCallback) {
@@ -175,6 +357,16 @@ void RFID_Manager::update() {
     }
 }
 
+// Put the reader into soft power-down (antenna off) before deep sleep
+void RFID_Manager::powerDown() {
+    if (!initialized) {
+        return;
+    }
+    mfrc522.PCD_SoftPowerDown();
+    tagPresent = false;
+    LOG_RFID_INFO("Reader powered down");
+}
+
 // Print current RFID status
 void RFID_Manager::printStatus() {
     if (!initialized) {
@@ -189,6 +381,7 @@ void RFID_Manager::printStatus() {
     } else {
         Serial.printf("[RFID] No tag present (Audio control: %s)\n", audioControlEnabled ? "ENABLED" : "DISABLED");
     }
+    Serial.printf("[RFID] %lu polls, %lu UID formats\n", (unsigned long)pollCount, (unsigned long)uidFormatCount);
 }
 
 // Print the stored tag UID
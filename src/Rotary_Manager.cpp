@@ -2,13 +2,51 @@
 #include "Logger.h"
 #include "AiEsp32RotaryEncoder.h"
 
+// Define static constexpr members
+constexpr uint8_t Rotary_Manager::STEPS_PER_DETENT;
+constexpr uint16_t Rotary_Manager::DEFAULT_COALESCE_MS;
+constexpr size_t Rotary_Manager::MAX_CURVE_STEPS;
+
 // Static instance for ISR access
 Rotary_Manager* Rotary_Manager::instance = nullptr;
 
-// ISR function
+namespace {
+
+// Quadrature transition table indexed by (previous AB << 2) | current AB.
+// Invalid transitions (both pins changed, i.e. bounce) count as 0. Kept in
+// DRAM so the ISR can run while flash cache is disabled.
+DRAM_ATTR const int8_t kQuadratureTable[16] = {
+     0, -1,  1,  0,
+     1,  0,  0, -1,
+    -1,  0,  0,  1,
+     0,  1, -1,  0
+};
+
+// Default curve: slow turns are 1% per detent, a fast spin covers the full
+// range in roughly one turn of the knob
+const RotaryAccelerationStep kDefaultCurve[] = {
+    {0,  1},
+    {12, 2},
+    {25, 4},
+    {40, 6}
+};
+
+} // namespace
+
+// ISR function - decode quadrature and hand the delta to update()
 void IRAM_ATTR Rotary_Manager::readEncoderISR() {
-    if (instance && instance->encoder) {
-        instance->encoder->readEncoder_ISR();
+    Rotary_Manager* self = instance;
+    if (!self) {
+        return;
+    }
+
+    uint8_t state = (digitalRead(self->clkPin) << 1) | digitalRead(self->dtPin);
+    int8_t step = kQuadratureTable[(self->lastPinState << 2) | state];
+    self->lastPinState = state;
+
+    if (step != 0) {
+        self->pendingSteps.fetch_add(step, std::memory_order_relaxed);
+        self->isrEventCount.fetch_add(1, std::memory_order_relaxed);
     }
 }
 
@@ -16,9 +54,16 @@ void IRAM_ATTR Rotary_Manager::readEncoderISR() {
 Rotary_Manager::Rotary_Manager(uint8_t clk_pin, uint8_t dt_pin, uint8_t button_pin, uint8_t vcc_pin)
     : clkPin(clk_pin), dtPin(dt_pin), buttonPin(button_pin), vccPin(vcc_pin),
       encoder(nullptr), currentVolume(0.5f), minVolume(0.0f), maxVolume(1.0f),
-      encoderValue(50), lastEncoderValue(50), accelerationEnabled(true),
-      accelerationValue(250), boundariesSet(false), volumeChangeCallback(nullptr) {
-    
+      encoderValue(50), lastEncoderValue(50), minEncoderValue(0), maxEncoderValue(100),
+      circleValues(false), boundariesSet(false), pendingSteps(0), isrEventCount(0),
+      lastPinState(0), stepRemainder(0), coalesceIntervalMs(DEFAULT_COALESCE_MS), lastApplyTime(0),
+      lastDetentTime(0),
+      accelerationEnabled(true), accelerationCurveSize(0), rateWindowStart(0), rateWindowEvents(0),
+      eventsPerSecond(0), callbackCount(0), callbacksPerSecond(0), rateWindowCallbacks(0),
+      volumeChangeCallback(nullptr) {
+
+    setAccelerationCurve(kDefaultCurve, sizeof(kDefaultCurve) / sizeof(kDefaultCurve[0]));
+
     // Set static instance for ISR access
     instance = this;
 }
@@ -35,40 +80,34 @@ Rotary_Manager::~Rotary_Manager() {
 // Initialization
 bool Rotary_Manager::begin() {
     // Create encoder instance
-    encoder = new AiEsp32RotaryEncoder(clkPin, dtPin, buttonPin, vccPin, 4); // 4 steps per detent
-    
+    encoder = new AiEsp32RotaryEncoder(clkPin, dtPin, buttonPin, vccPin, STEPS_PER_DETENT);
+
     if (!encoder) {
         LOG_ROTARY_ERROR("Failed to create rotary encoder instance!");
         return false;
     }
-    
-    // Initialize encoder
+
+    // Initialize encoder (pin modes); the library's own counter is unused
     encoder->begin();
-    
+    lastPinState = (digitalRead(clkPin) << 1) | digitalRead(dtPin);
+
     // Setup with ISR
     setup();
-    
+
     // Set default boundaries (0-100)
     setBoundaries(0, 100, false);
-    
-    // Set acceleration - use a more conservative value to prevent skipping
-    if (accelerationEnabled) {
-        encoder->setAcceleration(50); // Reduced from 250 to 50 for smoother control
-    } else {
-        encoder->disableAcceleration();
-    }
-    
-    Serial.println("Rotary encoder: Conservative acceleration enabled");
-    Serial.println("Rotary encoder: Boundaries set to 0-100 (no wrap-around)");
-    
+
     // Set initial encoder value based on current volume
     encoderValue = (int16_t)(currentVolume * 100.0f);
-    encoder->setEncoderValue(encoderValue);
     lastEncoderValue = encoderValue;
-    
-    Serial.printf("Rotary encoder initialized on pins CLK:%d, DT:%d, BTN:%d\n", clkPin, dtPin, buttonPin);
-    Serial.printf("Initial volume: %.2f (encoder value: %d)\n", currentVolume, encoderValue);
-    
+    lastApplyTime = millis();
+    lastDetentTime = lastApplyTime;
+    rateWindowStart = lastApplyTime;
+
+    LOG_ROTARY_INFO("Rotary encoder initialized on pins CLK:%d, DT:%d, BTN:%d (coalesce %u ms)",
+                    clkPin, dtPin, buttonPin, coalesceIntervalMs);
+    LOG_ROTARY_INFO("Initial volume: %.2f (encoder value: %d)", currentVolume, encoderValue);
+
     return true;
 }
 
@@ -83,17 +122,14 @@ void Rotary_Manager::setup() {
 void Rotary_Manager::setVolume(float volume) {
     // Clamp volume to valid range
     volume = constrain(volume, minVolume, maxVolume);
-    
+
     if (volume != currentVolume) {
         currentVolume = volume;
         encoderValue = (int16_t)(volume * 100.0f);
-        
-        if (encoder) {
-            encoder->setEncoderValue(encoderValue);
-        }
-        
-        Serial.printf("Volume set to: %.2f (encoder: %d)\n", currentVolume, encoderValue);
-        
+        lastEncoderValue = encoderValue;
+
+        LOG_ROTARY_DEBUG("Volume set to: %.2f (encoder: %d)", currentVolume, encoderValue);
+
         // Call callback if set
         if (volumeChangeCallback) {
             volumeChangeCallback(currentVolume);
@@ -110,7 +146,7 @@ float Rotary_Manager::getVolume() const {
 void Rotary_Manager::setVolumeRange(float min_vol, float max_vol) {
     minVolume = min_vol;
     maxVolume = max_vol;
-    
+
     // Ensure current volume is within new range
     if (currentVolume < minVolume) {
         setVolume(minVolume);
@@ -119,104 +155,132 @@ void Rotary_Manager::setVolumeRange(float min_vol, float max_vol) {
     }
 }
 
-// Set acceleration
-void Rotary_Manager::setAcceleration(uint16_t acceleration) {
-    accelerationValue = acceleration;
-    if (encoder) {
-        encoder->setAcceleration(acceleration);
+// Replace the acceleration curve (points must be sorted by rate)
+void Rotary_Manager::setAccelerationCurve(const RotaryAccelerationStep* curve, size_t count) {
+    if (!curve || count == 0) {
+        return;
+    }
+    accelerationCurveSize = min(count, MAX_CURVE_STEPS);
+    for (size_t i = 0; i < accelerationCurveSize; i++) {
+        accelerationCurve[i] = curve[i];
     }
 }
 
 // Enable acceleration
 void Rotary_Manager::enableAcceleration() {
     accelerationEnabled = true;
-    if (encoder) {
-        encoder->setAcceleration(accelerationValue);
-    }
 }
 
 // Disable acceleration
 void Rotary_Manager::disableAcceleration() {
     accelerationEnabled = false;
-    if (encoder) {
-        encoder->disableAcceleration();
-    }
 }
 
 // Set conservative mode (disable acceleration for precise control)
 void Rotary_Manager::setConservativeMode(bool enabled) {
     if (enabled) {
-        Serial.println("Rotary encoder: Conservative mode enabled (no acceleration)");
+        LOG_ROTARY_INFO("Conservative mode enabled (no acceleration)");
         disableAcceleration();
     } else {
-        Serial.println("Rotary encoder: Conservative mode disabled (acceleration enabled)");
+        LOG_ROTARY_INFO("Conservative mode disabled (acceleration enabled)");
         enableAcceleration();
     }
 }
 
 // Set boundaries
 void Rotary_Manager::setBoundaries(int16_t min_val, int16_t max_val, bool circle) {
-    if (encoder) {
-        encoder->setBoundaries(min_val, max_val, circle);
-        boundariesSet = true;
-    }
+    minEncoderValue = min_val;
+    maxEncoderValue = max_val;
+    circleValues = circle;
+    boundariesSet = true;
+}
+
+// Set the volume coalescing interval
+void Rotary_Manager::setCoalesceInterval(uint16_t intervalMs) {
+    coalesceIntervalMs = intervalMs;
 }
 
 // Update function (call in main loop)
 void Rotary_Manager::update() {
     if (!encoder) return;
-    
-    // Check for button click
-    //if (encoder->isEncoderButtonClicked()) {
-    //    Serial.println("Rotary encoder button clicked!");
-    //    // Could be used for mute/unmute or other functions
-    //}
-    
-    // Check for encoder value changes
-    int16_t encoderDelta = encoder->encoderChanged();
-    
-    if (encoderDelta != 0) {
-        // Get new encoder value
-        int16_t newEncoderValue = encoder->readEncoder();
-        
-        // Validate the new value is within reasonable bounds
-        if (newEncoderValue < 0 || newEncoderValue > 100) {
-            Serial.printf("Invalid encoder value detected: %d, clamping to valid range\n", newEncoderValue);
-            // Clamp to valid range and reset encoder
-            newEncoderValue = constrain(newEncoderValue, 0, 100);
-            encoder->setEncoderValue(newEncoderValue);
-        }
-        
-        // Check if the change is reasonable (not a huge jump)
-        int16_t change = abs(newEncoderValue - encoderValue);
-        if (change > 20) { // If change is more than 20 steps, it's likely an error
-            Serial.printf("Large encoder jump detected: %d -> %d (change: %d), ignoring\n", 
-                        encoderValue, newEncoderValue, change);
-            // Reset to last known good value
-            encoder->setEncoderValue(encoderValue);
-            return;
+
+    uint32_t now = millis();
+    updateRates(now);
+
+    uint32_t elapsed = now - lastApplyTime;
+    if (elapsed < coalesceIntervalMs) {
+        return;
+    }
+
+    // Collect everything the ISR has counted since the last block
+    stepRemainder += pendingSteps.exchange(0, std::memory_order_relaxed);
+    int32_t detents = stepRemainder / STEPS_PER_DETENT;
+    lastApplyTime = now;
+    if (detents == 0) {
+        return;
+    }
+    stepRemainder -= detents * STEPS_PER_DETENT;
+
+    // Turning speed is measured against the previous movement, so a single
+    // click after a pause is never accelerated
+    if (accelerationEnabled) {
+        uint32_t sinceLastDetent = max<uint32_t>(now - lastDetentTime, coalesceIntervalMs);
+        uint32_t detentsPerSecond = (uint32_t)abs(detents) * 1000 / sinceLastDetent;
+        detents *= multiplierFor(detentsPerSecond);
+    }
+    lastDetentTime = now;
+
+    applyEncoderValue(encoderValue + detents);
+}
+
+// Apply a new (unclamped) encoder value and issue one volume callback
+void Rotary_Manager::applyEncoderValue(int32_t value) {
+    if (circleValues) {
+        int32_t span = maxEncoderValue - minEncoderValue + 1;
+        value = minEncoderValue + ((value - minEncoderValue) % span + span) % span;
+    } else {
+        value = constrain(value, (int32_t)minEncoderValue, (int32_t)maxEncoderValue);
+    }
+
+    encoderValue = (int16_t)value;
+    float newVolume = constrain(encoderValue / 100.0f, minVolume, maxVolume);
+
+    // Update volume if changed (no logging here - this runs while spinning)
+    if (newVolume != currentVolume) {
+        currentVolume = newVolume;
+        callbackCount++;
+        rateWindowCallbacks++;
+
+        if (volumeChangeCallback) {
+            volumeChangeCallback(currentVolume);
         }
-        
-        // Update encoder value
-        encoderValue = newEncoderValue;
-        
-        // Calculate new volume
-        float newVolume = encoderValue / 100.0f;
-        
-        // Update volume if changed
-        if (newVolume != currentVolume) {
-            currentVolume = newVolume;
-            Serial.printf("Volume changed: %.2f (encoder: %d, delta: %d)\n", 
-                        currentVolume, encoderValue, encoderDelta);
-            
-            // Call callback if set
-            if (volumeChangeCallback) {
-                volumeChangeCallback(currentVolume);
-            }
+    }
+
+    lastEncoderValue = encoderValue;
+}
+
+// Step multiplier for the current turning speed
+uint8_t Rotary_Manager::multiplierFor(uint32_t detentsPerSecond) const {
+    uint8_t multiplier = 1;
+    for (size_t i = 0; i < accelerationCurveSize; i++) {
+        if (detentsPerSecond >= accelerationCurve[i].minDetentsPerSecond) {
+            multiplier = accelerationCurve[i].multiplier;
         }
-        
-        lastEncoderValue = encoderValue;
     }
+    return max<uint8_t>(multiplier, 1);
+}
+
+// Roll the once-per-second event rate counters
+void Rotary_Manager::updateRates(uint32_t now) {
+    if (now - rateWindowStart < 1000) {
+        return;
+    }
+    uint32_t total = isrEventCount.load(std::memory_order_relaxed);
+    eventsPerSecond = total - rateWindowEvents;
+    rateWindowEvents = total;
+    callbacksPerSecond = rateWindowCallbacks;
+    rateWindowCallbacks = 0;
+    rateWindowStart = now;
 }
 
 // Set volume change callback
@@ -239,9 +303,16 @@ bool Rotary_Manager::isButtonClicked() const {
 
 // Reset encoder
 void Rotary_Manager::reset() {
-    if (encoder) {
-        encoder->reset();
-        encoderValue = (int16_t)(currentVolume * 100.0f);
-        lastEncoderValue = encoderValue;
-    }
+    pendingSteps.store(0, std::memory_order_relaxed);
+    stepRemainder = 0;
+    encoderValue = (int16_t)(currentVolume * 100.0f);
+    lastEncoderValue = encoderValue;
+}
+
+// Print diagnostic counters
+void Rotary_Manager::printStats() const {
+    LOG_ROTARY_INFO("Events: %lu total, %lu/s | Volume updates: %lu total, %lu/s | Acceleration: %s",
+                    (unsigned long)getTotalEvents(), (unsigned long)eventsPerSecond,
+                    (unsigned long)callbackCount, (unsigned long)callbacksPerSecond,
+                    accelerationEnabled ? "on" : "off");
 }
@@ -0,0 +1,129 @@
+#include "SessionStore.h"
+#include "Logger.h"
+
+// Define static constexpr members
+constexpr const char* SessionStore::kNamespace;
+constexpr const char* SessionStore::kRecordKey;
+constexpr uint8_t SessionStore::kRecordVersion;
+
+// Constructor
+SessionStore::SessionStore()
+    : initialized(false), valid(false), writeCount(0), skippedWriteCount(0) {
+    memset(&record, 0, sizeof(record));
+    lastError[0] = '\0';
+}
+
+// Open NVS and load the last session
+bool SessionStore::begin() {
+    if (!prefs.begin(kNamespace, false)) {
+        setLastError("Failed to open NVS namespace");
+        LOG_SESSION_ERROR("Failed to open NVS namespace '%s'", kNamespace);
+        return false;
+    }
+    initialized = true;
+
+    StoredRecord stored;
+    size_t length = prefs.getBytesLength(kRecordKey);
+    if (length != sizeof(stored)) {
+        if (length > 0) {
+            LOG_SESSION_WARN("Stored session has unexpected size %u, ignoring", (unsigned)length);
+        }
+        return true;
+    }
+
+    if (prefs.getBytes(kRecordKey, &stored, sizeof(stored)) != sizeof(stored) ||
+        stored.version != kRecordVersion) {
+        LOG_SESSION_WARN("Stored session is unreadable or from another version, ignoring");
+        return true;
+    }
+
+    // Never trust strings read back from flash to be terminated
+    stored.session.uid[sizeof(stored.session.uid) - 1] = '\0';
+    stored.session.folder[sizeof(stored.session.folder) - 1] = '\0';
+
+    record = stored.session;
+    valid = record.uid[0] != '\0' && record.folder[0] != '\0';
+    if (valid) {
+        LOG_SESSION_INFO("Last session: %s -> %s, track %ld @ %lu bytes (%lu of %lu s), volume %.2f",
+                         record.uid, record.folder, (long)record.trackIndex,
+                         (unsigned long)record.byteOffset, (unsigned long)(record.positionMs / 1000),
+                         (unsigned long)(record.durationMs / 1000), record.volume);
+    }
+    return true;
+}
+
+// Save a session record, skipping the write when nothing changed
+bool SessionStore::save(const SessionRecord& session) {
+    if (!initialized) {
+        setLastError("Session store not initialized");
+        return false;
+    }
+
+    StoredRecord stored;
+    memset(&stored, 0, sizeof(stored));
+    stored.version = kRecordVersion;
+    strncpy(stored.session.uid, session.uid, sizeof(stored.session.uid) - 1);
+    strncpy(stored.session.folder, session.folder, sizeof(stored.session.folder) - 1);
+    stored.session.trackIndex = session.trackIndex;
+    stored.session.byteOffset = session.byteOffset;
+    stored.session.volume = session.volume;
+    stored.session.positionMs = session.positionMs;
+    stored.session.durationMs = session.durationMs;
+
+    if (valid && memcmp(&stored.session, &record, sizeof(record)) == 0) {
+        skippedWriteCount++;
+        return true;
+    }
+
+    if (prefs.putBytes(kRecordKey, &stored, sizeof(stored)) != sizeof(stored)) {
+        setLastError("Failed to write session to NVS");
+        LOG_SESSION_ERROR("Failed to write session to NVS");
+        return false;
+    }
+
+    record = stored.session;
+    valid = record.uid[0] != '\0' && record.folder[0] != '\0';
+    writeCount++;
+    LOG_SESSION_DEBUG("Saved session: %s track %ld @ %lu bytes (%lu of %lu ms)",
+                      record.folder, (long)record.trackIndex, (unsigned long)record.byteOffset,
+                      (unsigned long)record.positionMs, (unsigned long)record.durationMs);
+    return true;
+}
+
+// Forget the stored session
+bool SessionStore::clear() {
+    valid = false;
+    memset(&record, 0, sizeof(record));
+    if (!initialized) {
+        return true;
+    }
+    if (!prefs.remove(kRecordKey) && prefs.isKey(kRecordKey)) {
+        setLastError("Failed to remove session from NVS");
+        return false;
+    }
+    return true;
+}
+
+// Print the stored session
+void SessionStore::printSession() const {
+    if (!valid) {
+        LOG_SESSION_INFO("No stored session");
+        return;
+    }
+    LOG_SESSION_INFO("Session: uid=%s folder=%s track=%ld offset=%lu position=%lu/%lu ms volume=%.2f (writes %lu, skipped %lu)",
+                     record.uid, record.folder, (long)record.trackIndex,
+                     (unsigned long)record.byteOffset, (unsigned long)record.positionMs,
+                     (unsigned long)record.durationMs, record.volume,
+                     (unsigned long)writeCount, (unsigned long)skippedWriteCount);
+}
+
+// Get last error message
+const char* SessionStore::getLastError() const {
+    return lastError;
+}
+
+// Set last error message
+void SessionStore::setLastError(const char* error) const {
+    strncpy(lastError, error, sizeof(lastError) - 1);
+    lastError[sizeof(lastError) - 1] = '\0';
+}
@@ -0,0 +1,314 @@
+#include "SettingsSchema.h"
+#include "JsonStreamWriter.h"
+#include <math.h>
+#include <stdlib.h>
+
+// Define static constexpr members
+constexpr SettingDescriptor SettingsSchema::fields[];
+constexpr size_t SettingsSchema::FIELD_COUNT;
+constexpr uint8_t SettingsSchema::FLOAT_DECIMALS;
+constexpr size_t SettingsSchema::MAX_KEY_LENGTH;
+
+// ============================================================================
+// FIELD ACCESS
+// ============================================================================
+
+static float* floatField(Settings& settings, const SettingDescriptor& field) {
+    return (float*)((uint8_t*)&settings + field.offset);
+}
+
+static int* intField(Settings& settings, const SettingDescriptor& field) {
+    return (int*)((uint8_t*)&settings + field.offset);
+}
+
+static char* stringField(Settings& settings, const SettingDescriptor& field) {
+    return (char*)((uint8_t*)&settings + field.offset);
+}
+
+static const void* fieldPtr(const Settings& settings, const SettingDescriptor& field) {
+    return (const uint8_t*)&settings + field.offset;
+}
+
+// Constructor with default values
+Settings::Settings() {
+    SettingsSchema::applyDefaults(*this);
+}
+
+// ============================================================================
+// TABLE DRIVEN OPERATIONS
+// ============================================================================
+
+// Set every field to its default
+void SettingsSchema::applyDefaults(Settings& settings) {
+    for (const SettingDescriptor& field : fields) {
+        switch (field.type) {
+            case SettingType::FLOAT: *floatField(settings, field) = field.defaultValue; break;
+            case SettingType::INT: *intField(settings, field) = (int)field.defaultValue; break;
+            case SettingType::STRING: memset(stringField(settings, field), 0, field.size); break;
+        }
+    }
+}
+
+// Pull numbers into their bounds and keep the default volume within the max
+void SettingsSchema::clamp(Settings& settings) {
+    for (const SettingDescriptor& field : fields) {
+        switch (field.type) {
+            case SettingType::FLOAT: {
+                float* value = floatField(settings, field);
+                *value = isnan(*value) ? field.defaultValue : constrain(*value, field.minValue, field.maxValue);
+                break;
+            }
+            case SettingType::INT: {
+                int* value = intField(settings, field);
+                *value = constrain(*value, (int)field.minValue, (int)field.maxValue);
+                break;
+            }
+            case SettingType::STRING:
+                stringField(settings, field)[field.size - 1] = '\0';
+                break;
+        }
+    }
+    settings.defaultVolume = constrain(settings.defaultVolume, 0.0f, settings.maxVolume);
+}
+
+// Check bounds and the volume relation without changing anything
+bool SettingsSchema::validate(const Settings& settings, const char** failedField) {
+    for (const SettingDescriptor& field : fields) {
+        bool valid = true;
+        switch (field.type) {
+            case SettingType::FLOAT: {
+                const float value = *(const float*)fieldPtr(settings, field);
+                valid = !isnan(value) && value >= field.minValue && value <= field.maxValue;
+                break;
+            }
+            case SettingType::INT: {
+                const int value = *(const int*)fieldPtr(settings, field);
+                valid = value >= (int)field.minValue && value <= (int)field.maxValue;
+                break;
+            }
+            case SettingType::STRING:
+                valid = memchr(fieldPtr(settings, field), '\0', field.size) != nullptr;
+                break;
+        }
+        if (!valid) {
+            if (failedField) *failedField = field.name;
+            return false;
+        }
+    }
+
+    if (settings.defaultVolume > settings.maxVolume) {
+        if (failedField) *failedField = "defaultVolume";
+        return false;
+    }
+    return true;
+}
+
+// Dirty bits of the fields that differ between a and b
+uint8_t SettingsSchema::diff(const Settings& a, const Settings& b) {
+    uint8_t changed = 0;
+    for (const SettingDescriptor& field : fields) {
+        const bool same = field.type == SettingType::STRING
+            ? strncmp((const char*)fieldPtr(a, field), (const char*)fieldPtr(b, field), field.size) == 0
+            : memcmp(fieldPtr(a, field), fieldPtr(b, field), field.size) == 0;
+        if (!same) {
+            changed |= field.dirtyBit;
+        }
+    }
+    return changed;
+}
+
+// Descriptor by JSON name
+const SettingDescriptor* SettingsSchema::find(const char* name) {
+    for (const SettingDescriptor& field : fields) {
+        if (strcmp(field.name, name) == 0) {
+            return &field;
+        }
+    }
+    return nullptr;
+}
+
+// Add every field to the open object
+void SettingsSchema::write(JsonStreamWriter& json, const Settings& settings) {
+    for (const SettingDescriptor& field : fields) {
+        switch (field.type) {
+            case SettingType::FLOAT:
+                json.add(field.name, (double)*(const float*)fieldPtr(settings, field), FLOAT_DECIMALS);
+                break;
+            case SettingType::INT:
+                json.add(field.name, *(const int*)fieldPtr(settings, field));
+                break;
+            case SettingType::STRING:
+                json.add(field.name, (const char*)fieldPtr(settings, field));
+                break;
+        }
+    }
+}
+
+// ============================================================================
+// JSON READER
+// ============================================================================
+// Just enough JSON for a flat settings object: strings (with escapes),
+// numbers and literals as values; nested values of unknown keys are skipped.
+
+namespace {
+
+class JsonCursor {
+public:
+    explicit JsonCursor(const char* text) : p(text) {}
+
+    void skipSpace() {
+        while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') p++;
+    }
+
+    bool consume(char c) {
+        skipSpace();
+        if (*p != c) return false;
+        p++;
+        return true;
+    }
+
+    char peek() {
+        skipSpace();
+        return *p;
+    }
+
+    // Read a quoted string into out (truncated to outSize - 1, may be null)
+    bool readString(char* out, size_t outSize) {
+        if (!consume('"')) return false;
+        size_t length = 0;
+        while (*p && *p != '"') {
+            char c = *p++;
+            char utf8[3];
+            size_t count = 1;
+            utf8[0] = c;
+            if (c == '\\') {
+                c = *p++;
+                switch (c) {
+                    case 'n': utf8[0] = '\n'; break;
+                    case 'r': utf8[0] = '\r'; break;
+                    case 't': utf8[0] = '\t'; break;
+                    case 'b': utf8[0] = '\b'; break;
+                    case 'f': utf8[0] = '\f'; break;
+                    case '"': case '\\': case '/': utf8[0] = c; break;
+                    case 'u': {
+                        char hex[5] = { 0 };
+                        for (uint8_t i = 0; i < 4; i++) {
+                            if (!isxdigit((unsigned char)*p)) return false;
+                            hex[i] = *p++;
+                        }
+                        const unsigned long code = strtoul(hex, nullptr, 16);
+                        count = encodeUtf8(code, utf8);
+                        break;
+                    }
+                    default: return false;
+                }
+            }
+            for (size_t i = 0; i < count; i++) {
+                if (out && length + 1 < outSize) out[length] = utf8[i];
+                length++;
+            }
+        }
+        if (*p != '"') return false;
+        p++;
+        if (out && outSize > 0) out[length < outSize ? length : outSize - 1] = '\0';
+        return true;
+    }
+
+    bool readNumber(float& out) {
+        skipSpace();
+        char* end = nullptr;
+        out = strtof(p, &end);
+        if (end == p) return false;
+        p = end;
+        return true;
+    }
+
+    // Skip any value (used for unknown keys and rejected fields)
+    bool skipValue() {
+        const char c = peek();
+        if (c == '"') return readString(nullptr, 0);
+        if (c == '{' || c == '[') {
+            int depth = 0;
+            do {
+                const char d = peek();
+                if (d == '"') {
+                    if (!readString(nullptr, 0)) return false;
+                    continue;
+                }
+                if (d == '\0') return false;
+                if (d == '{' || d == '[') depth++;
+                if (d == '}' || d == ']') depth--;
+                p++;
+            } while (depth > 0);
+            return true;
+        }
+        const char* start = p;
+        while (*p && *p != ',' && *p != '}' && *p != ']' && *p != ' ' && *p != '\n' && *p != '\r' && *p != '\t') p++;
+        return p != start;
+    }
+
+private:
+    const char* p;
+
+    static size_t encodeUtf8(unsigned long code, char* out) {
+        if (code < 0x80) {
+            out[0] = (char)code;
+            return 1;
+        }
+        if (code < 0x800) {
+            out[0] = (char)(0xC0 | (code >> 6));
+            out[1] = (char)(0x80 | (code & 0x3F));
+            return 2;
+        }
+        out[0] = (char)(0xE0 | (code >> 12));
+        out[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (code & 0x3F));
+        return 3;
+    }
+};
+
+} // namespace
+
+bool SettingsSchema::parse(const char* text, Settings& settings, uint8_t* fieldsSet, const char** rejected) {
+    if (fieldsSet) *fieldsSet = 0;
+    if (rejected) *rejected = nullptr;
+    if (!text) return false;
+
+    JsonCursor cursor(text);
+    if (!cursor.consume('{')) return false;
+    if (cursor.consume('}')) return true;
+
+    do {
+        char key[MAX_KEY_LENGTH];
+        if (!cursor.readString(key, sizeof(key)) || !cursor.consume(':')) {
+            return false;
+        }
+
+        const SettingDescriptor* field = find(key);
+        const char next = cursor.peek();
+        bool applied = false;
+        if (field && field->type == SettingType::STRING && next == '"') {
+            applied = cursor.readString(stringField(settings, *field), field->size);
+            if (!applied) return false;
+        } else if (field && field->type != SettingType::STRING && (next == '-' || isdigit((unsigned char)next))) {
+            float value = 0.0f;
+            if (!cursor.readNumber(value)) return false;
+            if (field->type == SettingType::FLOAT) {
+                *floatField(settings, *field) = value;
+            } else {
+                *intField(settings, *field) = (int)lroundf(value);
+            }
+            applied = true;
+        } else if (!cursor.skipValue()) {
+            return false;
+        }
+
+        if (applied) {
+            if (fieldsSet) *fieldsSet |= field->dirtyBit;
+        } else if (field && rejected && !*rejected) {
+            *rejected = field->name;
+        }
+    } while (cursor.consume(','));
+
+    return cursor.consume('}');
+}
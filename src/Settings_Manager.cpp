@@ -1,48 +1,123 @@
 #include "Settings_Manager.h"
+#include "JsonStreamWriter.h"
 #include "Logger.h"
 #include <SD_MMC.h>
 
 // Define static constexpr members
-constexpr float Settings_Manager::DEFAULT_VOLUME;
-constexpr float Settings_Manager::DEFAULT_MAX_VOLUME;
-constexpr int Settings_Manager::DEFAULT_SLEEP_TIMEOUT;
-constexpr int Settings_Manager::DEFAULT_BATTERY_INTERVAL;
 constexpr size_t Settings_Manager::MAX_JSON_SIZE;
+constexpr uint32_t Settings_Manager::FLUSH_DELAY_MS;
+constexpr const char* Settings_Manager::kMirrorNamespace;
+constexpr const char* Settings_Manager::kMirrorKey;
+constexpr uint8_t Settings_Manager::kMirrorVersion;
+
+static const uint32_t FNV_OFFSET_BASIS = 2166136261UL;
+
+// FNV-1a over a byte range, continuing from hash
+static uint32_t fnv1a(const uint8_t* data, size_t length, uint32_t hash = FNV_OFFSET_BASIS) {
+    for (size_t i = 0; i < length; i++) {
+        hash ^= data[i];
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+// Print sink that only hashes - lets the serialized content be compared
+// with the file without buffering it
+class HashPrint : public Print {
+public:
+    uint32_t hash = FNV_OFFSET_BASIS;
+    size_t write(uint8_t c) override { hash = fnv1a(&c, 1, hash); return 1; }
+    size_t write(const uint8_t* data, size_t length) override { hash = fnv1a(data, length, hash); return length; }
+};
 
 // Constructor
 Settings_Manager::Settings_Manager(const char* file_path) 
     : settingsFilePath(file_path), fileSystem(nullptr), 
-      settingsLoaded(false), fileExists(false) {
+      settingsLoaded(false), fileExists(false),
+      dirtyFields(0), lastChangeMs(0), contentHash(0),
+      mirrorOpen(false), mirrorLoaded(false), mirrorLoadUs(0), fileLoadUs(0) {
     
     // Initialize error buffer
     strcpy(lastError, "No error");
     
     // Initialize with default values
     resetToDefaults();
+    memset((void*)&mirror, 0, sizeof(mirror));
+}
+
+// Read the settings mirrored in NVS (no SD access)
+bool Settings_Manager::loadMirror() {
+    const uint32_t startUs = micros();
+    if (!openMirror()) {
+        return false;
+    }
+    
+    MirrorRecord stored;
+    memset((void*)&stored, 0, sizeof(stored));
+    if (prefs.getBytesLength(kMirrorKey) != sizeof(stored) ||
+        prefs.getBytes(kMirrorKey, &stored, sizeof(stored)) != sizeof(stored) ||
+        stored.version != kMirrorVersion) {
+        LOG_SETTINGS_INFO("No usable NVS mirror - settings come from the SD card");
+        return false;
+    }
+    
+    // Never trust strings read back from flash to be terminated
+    stored.settings.wifiSSID[sizeof(stored.settings.wifiSSID) - 1] = '\0';
+    stored.settings.wifiPassword[sizeof(stored.settings.wifiPassword) - 1] = '\0';
+    
+    memcpy((void*)&mirror, &stored, sizeof(mirror));   // Keep padding for memcmp
+    currentSettings = stored.settings;
+    contentHash = stored.jsonHash;
+    settingsLoaded = true;
+    mirrorLoaded = true;
+    mirrorLoadUs = micros() - startUs;
+    LOG_SETTINGS_INFO("Settings from NVS mirror in %lu us", (unsigned long)mirrorLoadUs);
+    return true;
 }
 
 // Initialize settings manager
 bool Settings_Manager::begin(void* fs) {
     LOG_SETTINGS_INFO("Initializing Settings Manager...");
     LOG_SETTINGS_DEBUG("Settings file: %s", settingsFilePath);
+    const uint32_t startUs = micros();
     
     // Check if settings file exists
     fileExists = SD_MMC.exists(settingsFilePath);
     
     if (fileExists) {
+        // Mirror still describes the file - keep the settings read from NVS
+        if (mirrorLoaded && fileMatchesMirror()) {
+            fileLoadUs = micros() - startUs;
+            LOG_SETTINGS_INFO("Settings file matches the NVS mirror - JSON parse skipped (%lu us)",
+                              (unsigned long)fileLoadUs);
+            return true;
+        }
+        
         Serial.println("Settings file found, attempting to load...");
         if (loadSettings()) {
+            writeMirror();
+            fileLoadUs = micros() - startUs;
             Serial.println("Settings loaded successfully!");
+            LOG_SETTINGS_INFO("Settings parsed from SD in %lu us", (unsigned long)fileLoadUs);
             return true;
         } else {
             Serial.printf("Failed to load settings: %s\n", getLastError());
-            Serial.println("Creating new settings file with defaults...");
+            fileExists = false;   // Unreadable - replaced below, the backup is kept
         }
     } else {
-        Serial.println("No settings file found, creating defaults...");
+        Serial.println("No settings file found");
+    }
+    
+    // A save interrupted between its renames leaves the new settings in the
+    // temp file and the previous ones in the backup
+    const String tempPath = String(settingsFilePath) + ".tmp";
+    if (restoreFromBackup(tempPath.c_str()) || restoreFromBackup()) {
+        fileLoadUs = micros() - startUs;
+        return true;
     }
     
     // Create default settings file
+    Serial.println("Creating new settings file with defaults...");
     if (createDefaultSettings()) {
         Serial.println("Default settings file created successfully!");
         return true;
@@ -73,25 +148,19 @@ bool Settings_Manager::loadSettings() {
         return false;
     }
     
-    uint8_t* jsonBuffer = new uint8_t[fileSize + 1];
-    if (!jsonBuffer) {
-        setLastError("Failed to allocate memory for JSON");
-        file.close();
-        return false;
-    }
-    
-    size_t bytesRead = file.read(jsonBuffer, fileSize);
+    char jsonBuffer[MAX_JSON_SIZE + 1];
+    size_t bytesRead = file.read((uint8_t*)jsonBuffer, fileSize);
     file.close();
     jsonBuffer[bytesRead] = '\0';
+    const uint32_t fileHash = fnv1a((const uint8_t*)jsonBuffer, bytesRead);
     
-    // Parse JSON - convert uint8_t* to const char*
-    bool success = parseJsonDocument((const char*)jsonBuffer);
-    
-    // Clean up
-    delete[] jsonBuffer;
+    // Parse JSON in place (no heap)
+    bool success = parseJsonDocument(jsonBuffer);
     
     if (success) {
         settingsLoaded = true;
+        contentHash = fileHash;
+        dirtyFields = 0;
         Serial.println("Settings parsed successfully");
         printSettings();
     }
@@ -99,42 +168,175 @@ bool Settings_Manager::loadSettings() {
     return success;
 }
 
-// Save settings to file
+// Save settings to file. The new content goes to a temp file first; only
+// when it differs from the current file is the old file rotated to the backup.
 bool Settings_Manager::saveSettings() {
-    Serial.println("Saving settings to file...");
-    
-    // Create backup first
-    if (fileExists) {
-        backupSettings();
-    }
-    
-    // Serialize settings to JSON
-    char jsonBuffer[MAX_JSON_SIZE];
-    if (!serializeToJson(jsonBuffer, MAX_JSON_SIZE)) {
-        setLastError("Failed to serialize settings to JSON");
-        return false;
+    HashPrint hasher;
+    writeJson(hasher);
+    if (fileExists && hasher.hash == contentHash) {
+        LOG_SETTINGS_DEBUG("Settings unchanged - nothing written");
+        dirtyFields = 0;
+        return true;
     }
     
-    // Write to file
-    File file = SD_MMC.open(settingsFilePath, "w");
+    LOG_SETTINGS_INFO("Saving settings to file...");
+    String tempPath = String(settingsFilePath) + ".tmp";
+    File file = SD_MMC.open(tempPath, "w");
     if (!file) {
         setLastError("Failed to open settings file for writing");
         return false;
     }
     
-    size_t bytesWritten = file.print(jsonBuffer);
+    size_t bytesWritten = writeJson(file);
     file.close();
     
     if (bytesWritten == 0) {
         setLastError("Failed to write settings to file");
+        SD_MMC.remove(tempPath);
+        return false;
+    }
+    
+    // Rotate: current file becomes the backup, temp file becomes current.
+    // The current file is only given up once the backup holds it.
+    if (fileExists) {
+        if (!backupSettings()) {
+            LOG_SETTINGS_WARN("Backup failed, settings file kept: %s", getLastError());
+            SD_MMC.remove(tempPath);
+            return false;
+        }
+    } else if (SD_MMC.exists(settingsFilePath)) {
+        SD_MMC.remove(settingsFilePath);   // Unreadable file (see begin())
+    }
+    if (!SD_MMC.rename(tempPath, settingsFilePath)) {
+        setLastError("Failed to rename settings temp file");
         return false;
     }
     
     fileExists = true;
-    Serial.println("Settings saved successfully!");
+    contentHash = hasher.hash;
+    dirtyFields = 0;
+    LOG_SETTINGS_INFO("Settings saved (%u bytes)", (unsigned)bytesWritten);
+    writeMirror();
+    return true;
+}
+
+// Open the NVS namespace once
+bool Settings_Manager::openMirror() {
+    if (!mirrorOpen) {
+        mirrorOpen = prefs.begin(kMirrorNamespace, false);
+        if (!mirrorOpen) {
+            LOG_SETTINGS_WARN("Failed to open NVS namespace '%s'", kMirrorNamespace);
+        }
+    }
+    return mirrorOpen;
+}
+
+// Store the current settings and the file they match (skipped if identical)
+bool Settings_Manager::writeMirror() {
+    if (!openMirror()) {
+        return false;
+    }
+    
+    MirrorRecord next;
+    memset((void*)&next, 0, sizeof(next));
+    next.version = kMirrorVersion;
+    next.jsonHash = contentHash;
+    if (!readFileStamp(next.jsonSize, next.jsonMtime)) {
+        return false;
+    }
+    next.settings = currentSettings;
+    
+    if (mirrorLoaded && memcmp(&next, &mirror, sizeof(next)) == 0) {
+        return true;
+    }
+    
+    if (prefs.putBytes(kMirrorKey, &next, sizeof(next)) != sizeof(next)) {
+        LOG_SETTINGS_WARN("Failed to write NVS mirror");
+        return false;
+    }
+    memcpy((void*)&mirror, &next, sizeof(mirror));
+    mirrorLoaded = true;
+    LOG_SETTINGS_DEBUG("NVS mirror updated (%u bytes)", (unsigned)sizeof(next));
+    return true;
+}
+
+// Size and last write time of the settings file
+bool Settings_Manager::readFileStamp(uint32_t& size, uint32_t& mtime) const {
+    File file = SD_MMC.open(settingsFilePath, "r");
+    if (!file) {
+        return false;
+    }
+    size = file.size();
+    mtime = (uint32_t)file.getLastWrite();
+    file.close();
+    return true;
+}
+
+// True if the SD file is the one the mirror was taken from. Size and mtime
+// are checked first; if they moved (e.g. copied back unchanged) the content
+// hash decides and the stamp in the mirror is refreshed.
+bool Settings_Manager::fileMatchesMirror() {
+    uint32_t size = 0;
+    uint32_t mtime = 0;
+    if (!readFileStamp(size, mtime)) {
+        return false;
+    }
+    if (size == mirror.jsonSize && mtime == mirror.jsonMtime) {
+        return true;
+    }
+    if (size > MAX_JSON_SIZE) {
+        return false;
+    }
+    
+    uint8_t buffer[MAX_JSON_SIZE];
+    File file = SD_MMC.open(settingsFilePath, "r");
+    if (!file) {
+        return false;
+    }
+    size_t bytesRead = file.read(buffer, size);
+    file.close();
+    if (fnv1a(buffer, bytesRead) != mirror.jsonHash) {
+        LOG_SETTINGS_INFO("Settings file changed since it was mirrored");
+        return false;
+    }
+    
+    writeMirror();
     return true;
 }
 
+// Write pending changes once they have been quiet for FLUSH_DELAY_MS
+void Settings_Manager::update(bool flushNow) {
+    if (dirtyFields == 0) {
+        return;
+    }
+    if (flushNow || millis() - lastChangeMs >= FLUSH_DELAY_MS) {
+        flush();
+    }
+}
+
+// Write pending changes now
+bool Settings_Manager::flush() {
+    if (dirtyFields == 0) {
+        return true;
+    }
+    LOG_SETTINGS_DEBUG("Flushing dirty fields 0x%02x", dirtyFields);
+    if (!saveSettings()) {
+        LOG_SETTINGS_ERROR("Deferred save failed: %s", getLastError());
+        lastChangeMs = millis();   // Retry after another FLUSH_DELAY_MS
+        return false;
+    }
+    return true;
+}
+
+// Remember changed fields and restart the flush delay
+void Settings_Manager::markDirty(uint8_t fields) {
+    if (fields == 0) {
+        return;
+    }
+    dirtyFields |= fields;
+    lastChangeMs = millis();
+}
+
 // Create default settings file
 bool Settings_Manager::createDefaultSettings() {
     Serial.println("Creating default settings...");
@@ -151,26 +353,31 @@ bool Settings_Manager::createDefaultSettings() {
     return false;
 }
 
-// Set default volume
+// Setters go through the schema table like the file and /api/settings, so
+// the bounds live in one place
+
+// Set default volume (at most maxVolume)
 void Settings_Manager::setDefaultVolume(float volume) {
-    currentSettings.defaultVolume = constrain(volume, 0.0f, currentSettings.maxVolume);
+    Settings next = currentSettings;
+    next.defaultVolume = volume;
+    applySettings(next);
     Serial.printf("Default volume set to: %.2f\n", currentSettings.defaultVolume);
 }
 
-// Set maximum volume
+// Set maximum volume (lowers the default volume if needed)
 void Settings_Manager::setMaxVolume(float volume) {
-    currentSettings.maxVolume = constrain(volume, 0.0f, 1.0f);
-    // Ensure default volume does not exceed max
-    if (currentSettings.defaultVolume > currentSettings.maxVolume) {
-        currentSettings.defaultVolume = currentSettings.maxVolume;
-    }
+    Settings next = currentSettings;
+    next.maxVolume = volume;
+    applySettings(next);
     Serial.printf("Max volume set to: %.2f\n", currentSettings.maxVolume);
 }
 
 // Set WiFi SSID
 void Settings_Manager::setWifiSSID(const char* ssid) {
     if (ssid && strlen(ssid) < sizeof(currentSettings.wifiSSID)) {
-        strcpy(currentSettings.wifiSSID, ssid);
+        Settings next = currentSettings;
+        strcpy(next.wifiSSID, ssid);
+        applySettings(next);
         Serial.printf("WiFi SSID set to: %s\n", currentSettings.wifiSSID);
     } else {
         Serial.println("Invalid WiFi SSID (too long or null)");
@@ -180,59 +387,60 @@ void Settings_Manager::setWifiSSID(const char* ssid) {
 // Set WiFi password
 void Settings_Manager::setWifiPassword(const char* password) {
     if (password && strlen(password) < sizeof(currentSettings.wifiPassword)) {
-        strcpy(currentSettings.wifiPassword, password);
+        Settings next = currentSettings;
+        strcpy(next.wifiPassword, password);
+        applySettings(next);
         Serial.printf("WiFi password set to: %s\n", currentSettings.wifiPassword);
     } else {
         Serial.println("Invalid WiFi password (too long or null)");
     }
 }
 
-// Set sleep timeout
+// Set sleep timeout (0 = never)
 void Settings_Manager::setSleepTimeout(int minutes) {
-    currentSettings.sleepTimeout = constrain(minutes, 1, 1440); // 1 min to 24 hours
+    Settings next = currentSettings;
+    next.sleepTimeout = minutes;
+    applySettings(next);
     Serial.printf("Sleep timeout set to: %d minutes\n", currentSettings.sleepTimeout);
 }
 
 // Set battery check interval
 void Settings_Manager::setBatteryCheckInterval(int minutes) {
-    currentSettings.batteryCheckInterval = constrain(minutes, 1, 60); // 1 min to 1 hour
+    Settings next = currentSettings;
+    next.batteryCheckInterval = minutes;
+    applySettings(next);
     Serial.printf("Battery check interval set to: %d minutes\n", currentSettings.batteryCheckInterval);
 }
 
+// Enable folder records on RFID tags
+void Settings_Manager::setTagRecords(bool enable) {
+    Settings next = currentSettings;
+    next.tagRecords = enable ? 1 : 0;
+    applySettings(next);
+    Serial.printf("Tag records %s\n", enable ? "enabled" : "disabled");
+}
+
 // Update all settings at once
 void Settings_Manager::updateSettings(const Settings& newSettings) {
-    currentSettings = newSettings;
-    // Enforce sane volume bounds after bulk update
-    currentSettings.maxVolume = constrain(currentSettings.maxVolume, 0.0f, 1.0f);
-    currentSettings.defaultVolume = constrain(currentSettings.defaultVolume, 0.0f, currentSettings.maxVolume);
+    applySettings(newSettings);
     Serial.println("All settings updated");
     printSettings();
 }
 
+// Enforce the schema bounds on next, then take it and mark the fields that changed
+void Settings_Manager::applySettings(Settings next) {
+    SettingsSchema::clamp(next);
+    markDirty(SettingsSchema::diff(next, currentSettings));
+    currentSettings = next;
+}
+
 // Validate settings
 bool Settings_Manager::validateSettings() const {
-    // Check volume range
-    if (currentSettings.maxVolume < 0.0f || currentSettings.maxVolume > 1.0f) {
-        return false;
-    }
-    if (currentSettings.defaultVolume < 0.0f || currentSettings.defaultVolume > currentSettings.maxVolume) {
-        return false;
-    }
-    
-    // Check timeout values
-    if (currentSettings.sleepTimeout < 1 || currentSettings.batteryCheckInterval < 1) {
-        return false;
-    }
-    
-    // Check string lengths
-    if (strlen(currentSettings.wifiSSID) >= sizeof(currentSettings.wifiSSID)) {
-        return false;
-    }
-    
-    if (strlen(currentSettings.wifiPassword) >= sizeof(currentSettings.wifiPassword)) {
+    const char* field = nullptr;
+    if (!SettingsSchema::validate(currentSettings, &field)) {
+        LOG_SETTINGS_WARN("Invalid setting: %s", field);
         return false;
     }
-    
     return true;
 }
 
@@ -245,6 +453,7 @@ void Settings_Manager::printSettings() const {
     Serial.printf("WiFi Password: %s\n", currentSettings.wifiPassword[0] ? "***" : "<not set>");
     Serial.printf("Sleep Timeout: %d minutes\n", currentSettings.sleepTimeout);
     Serial.printf("Battery Check Interval: %d minutes\n", currentSettings.batteryCheckInterval);
+    Serial.printf("Tag Records: %s\n", currentSettings.tagRecords ? "on" : "off");
     Serial.println("========================\n");
 }
 
@@ -254,41 +463,26 @@ void Settings_Manager::resetToDefaults() {
     Serial.println("Settings reset to defaults");
 }
 
-// Backup settings
+// Backup settings - moves the current file to backupPath (a rename, no copy).
+// saveSettings() calls this only when the new content differs.
 bool Settings_Manager::backupSettings(const char* backupPath) {
-    if (!fileExists) {
+    if (!fileExists || !SD_MMC.exists(settingsFilePath)) {
         Serial.println("No settings file to backup");
         return true;
     }
     
-    File sourceFile = SD_MMC.open(settingsFilePath, "r");
-    if (!sourceFile) {
-        setLastError("Failed to open source file for backup");
+    if (SD_MMC.exists(backupPath) && !SD_MMC.remove(backupPath)) {
+        setLastError("Failed to remove old backup file");
         return false;
     }
     
-    File backupFile = SD_MMC.open(backupPath, "w");
-    if (!backupFile) {
-        setLastError("Failed to create backup file");
-        sourceFile.close();
+    if (!SD_MMC.rename(settingsFilePath, backupPath)) {
+        setLastError("Failed to move settings file to backup");
         return false;
     }
     
-    // Copy file content
-    size_t bytesCopied = 0;
-    while (sourceFile.available()) {
-        int byte = sourceFile.read();
-        if (byte != -1) {
-            backupFile.write(byte);
-            bytesCopied++;
-        }
-    }
-    
-    sourceFile.close();
-    backupFile.close();
-    
-    Serial.printf("Settings backed up to: %s (%d bytes)\n", backupPath, bytesCopied);
-    return bytesCopied > 0;
+    LOG_SETTINGS_DEBUG("Previous settings kept in %s", backupPath);
+    return true;
 }
 
 // Restore from backup
@@ -300,16 +494,20 @@ bool Settings_Manager::restoreFromBackup(const char* backupPath) {
     
     // Load from backup
     const char* originalPath = settingsFilePath;
+    const bool originalExists = fileExists;
     settingsFilePath = backupPath;
+    fileExists = true;
     
     bool success = loadSettings();
     
     // Restore original path
     settingsFilePath = originalPath;
+    fileExists = originalExists;
     
     if (success) {
-        Serial.println("Settings restored from backup successfully!");
-        // Save to main settings file
+        Serial.printf("Settings restored from %s\n", backupPath);
+        // Save to main settings file (the hash is the backup's - force the write)
+        contentHash = 0;
         return saveSettings();
     }
     
@@ -321,80 +519,33 @@ const char* Settings_Manager::getLastError() const {
     return lastError;
 }
 
-// Parse JSON document
+// Parse JSON document - fields missing from the file keep their defaults
 bool Settings_Manager::parseJsonDocument(const char* jsonString) {
-    StaticJsonDocument<MAX_JSON_SIZE> doc;
-    
-    DeserializationError error = deserializeJson(doc, jsonString);
-    if (error) {
-        setLastError(error.c_str());
+    Settings parsed;
+    const char* rejected = nullptr;
+    if (!SettingsSchema::parse(jsonString, parsed, nullptr, &rejected)) {
+        setLastError("Settings file must contain a JSON object");
         return false;
     }
-    
-    // Validate JSON structure
-    if (!validateJsonStructure(doc)) {
-        return false;
-    }
-    
-    // Extract values
-    if (doc.containsKey("defaultVolume")) {
-        currentSettings.defaultVolume = doc["defaultVolume"] | DEFAULT_VOLUME;
-    }
-    
-    if (doc.containsKey("maxVolume")) {
-        currentSettings.maxVolume = doc["maxVolume"] | DEFAULT_MAX_VOLUME;
-    } else {
-        currentSettings.maxVolume = DEFAULT_MAX_VOLUME;
-    }
-
-    // Clamp volumes and ensure default does not exceed max
-    currentSettings.maxVolume = constrain(currentSettings.maxVolume, 0.0f, 1.0f);
-    currentSettings.defaultVolume = constrain(currentSettings.defaultVolume, 0.0f, currentSettings.maxVolume);
-    
-    if (doc.containsKey("wifiSSID")) {
-        strcpy(currentSettings.wifiSSID, doc["wifiSSID"] | "");
-    }
-    
-    if (doc.containsKey("wifiPassword")) {
-        strcpy(currentSettings.wifiPassword, doc["wifiPassword"] | "");
-    }
-    
-    if (doc.containsKey("sleepTimeout")) {
-        currentSettings.sleepTimeout = doc["sleepTimeout"] | DEFAULT_SLEEP_TIMEOUT;
-    }
-    
-    if (doc.containsKey("batteryCheckInterval")) {
-        currentSettings.batteryCheckInterval = doc["batteryCheckInterval"] | DEFAULT_BATTERY_INTERVAL;
+    if (rejected) {
+        LOG_SETTINGS_WARN("Ignoring '%s' (wrong type) - using the default", rejected);
     }
     
+    // Clamp values and ensure default volume does not exceed max
+    SettingsSchema::clamp(parsed);
+    currentSettings = parsed;
     return true;
 }
 
-// Serialize to JSON
-bool Settings_Manager::serializeToJson(char* buffer, size_t bufferSize) const {
-    StaticJsonDocument<MAX_JSON_SIZE> doc;
-    
-    doc["defaultVolume"] = currentSettings.defaultVolume;
-    doc["maxVolume"] = currentSettings.maxVolume;
-    doc["wifiSSID"] = currentSettings.wifiSSID;
-    doc["wifiPassword"] = currentSettings.wifiPassword;
-    doc["sleepTimeout"] = currentSettings.sleepTimeout;
-    doc["batteryCheckInterval"] = currentSettings.batteryCheckInterval;
-    
-    size_t bytesWritten = serializeJsonPretty(doc, buffer, bufferSize);
-    return bytesWritten > 0;
-}
-
-// Validate JSON structure
-bool Settings_Manager::validateJsonStructure(JsonDocument& doc) const {
-    // Check if it's an object
-    if (!doc.is<JsonObject>()) {
-        setLastError("Settings file must contain a JSON object");
-        return false;
-    }
-    
-    // All fields are optional, so no validation needed
-    return true;
+// Serialize the current settings (pretty) - returns the bytes written
+size_t Settings_Manager::writeJson(Print& out) const {
+    JsonStreamWriter json(out);
+    json.setPretty(true);
+    json.beginObject();
+    SettingsSchema::write(json, currentSettings);
+    json.endObject();
+    json.flush();
+    return json.getBytesWritten();
 }
 
 // Set last error
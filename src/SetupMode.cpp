@@ -5,9 +5,10 @@
 SetupMode::SetupMode() 
     : currentState(SetupState::IDLE), isActive(false),
       mappingStore(nullptr), sdScanner(nullptr), rfidManager(nullptr), buttonManager(nullptr),
-      currentPathIndex(0), contentRoot("/test_music"), assignedCount(0), skippedCount(0), totalProcessed(0),
+      currentPathIndex(0), contentRoot("/test_music"), autoAssign(false), autoIgnoredCount(0), assignedCount(0), skippedCount(0), totalProcessed(0),
       setupStartTime(0), lastRfidRead(0), lastButtonCheck(0),
       encoderPressed(false), encoderPressStart(0), lastButtonAction(SetupButtonAction::NONE), lastButtonState(BUTTON_NONE) {
+    autoLastUid[0] = '\0';
 }
 
 // Initialize setup mode
@@ -54,6 +55,7 @@ void SetupMode::enter() {
     
     LOG_SETUP_INFO("=== ENTERING SETUP MODE ===");
     isActive = true;
+    autoAssign = false;
     currentState = SetupState::SETUP_INIT;
     setupStartTime = millis();
     currentPathIndex = 0;
@@ -66,6 +68,25 @@ void SetupMode::enter() {
     assignedCount = 0;
     skippedCount = 0;
     totalProcessed = 0;
+    
+    // A button still held from the entry gesture is not an action
+    lastButtonState = buttonManager->getCurrentButton();
+    encoderPressed = false;
+}
+
+// Enter setup mode in auto-assign mode: unassigned folders (sorted) are
+// paired with cards in the order they are tapped, and the whole session
+// is written with one commitBatch() when it ends
+void SetupMode::enterAutoAssign() {
+    enter();
+    if (!isActive) return;
+    
+    LOG_SETUP_INFO("Auto-assign: tap cards in folder order (Play=save, Back=undo, Next=skip folder, long-press=discard)");
+    autoAssign = true;
+    autoItems.clear();
+    autoFolderIndexes.clear();
+    autoLastUid[0] = '\0';
+    autoIgnoredCount = 0;
 }
 
 // Exit setup mode
@@ -73,6 +94,12 @@ void SetupMode::exit() {
     LOG_SETUP_INFO("=== EXITING SETUP MODE ===");
     isActive = false;
     currentState = SetupState::IDLE;
+    if (!autoItems.empty()) {
+        LOG_SETUP_WARN("Auto-assign: %u pairs discarded", (unsigned)autoItems.size());
+        autoItems.clear();
+        autoFolderIndexes.clear();
+    }
+    autoAssign = false;
     
     // Re-enable RFID audio control
     rfidManager->enableAudioControl(true);
@@ -105,6 +132,12 @@ void SetupMode::loop() {
         case SetupState::WAIT_FOR_CARD_REMOVAL:
             stepWaitForCardRemoval();
             break;
+        case SetupState::AUTO_ASSIGN:
+            stepAutoAssign();
+            break;
+        case SetupState::AUTO_COMMIT:
+            stepAutoCommit();
+            break;
         case SetupState::RFID_SETUP_SUMMARY:
             stepSummary();
             break;
@@ -131,15 +164,17 @@ void SetupMode::stepInit() {
         return;
     }
     
-    // Scan SD directories (non-recursive, one level deep)
-    if (!sdScanner->listAudioDirs(SD_MMC, contentRoot, unassignedPaths)) {
+    // Scan SD directories (non-recursive, one level deep; cached after the
+    // first session)
+    if (!catalog.scan(*sdScanner, SD_MMC, contentRoot)) {
         LOG_SETUP_ERROR("Failed to scan SD directories");
         exit();
         return;
     }
     
-    // Compute unassigned paths
-    computeUnassignedPaths();
+    // Unassigned paths: sorted merge with the store's paths
+    catalog.refresh(*mappingStore);
+    catalog.copyUnassigned(unassignedPaths);
     
     if (unassignedPaths.empty()) {
         LOG_SETUP_INFO("No unassigned directories found");
@@ -149,6 +184,14 @@ void SetupMode::stepInit() {
     
     LOG_SETUP_INFO("Found %d unassigned directories", unassignedPaths.size());
     
+    if (autoAssign) {
+        autoItems.reserve(unassignedPaths.size());
+        autoFolderIndexes.reserve(unassignedPaths.size());
+        showPrompt("Tap card for: " + unassignedPaths[currentPathIndex]);
+        currentState = SetupState::AUTO_ASSIGN;
+        return;
+    }
+    
     // Move to first unassigned directory
     currentState = SetupState::PROMPT_PRESENT_TAG;
 }
@@ -191,7 +234,11 @@ void SetupMode::stepConfirmOverwrite() {
     SetupButtonAction action = getButtonAction();
     if (action == SetupButtonAction::PLAY_OK) {
         // Confirm overwrite
-        if (mappingStore->rebind(currentUid, currentFolder)) {
+        String previous;
+        mappingStore->getPathFor(currentUid, previous);
+        const bool rebound = mappingStore->rebind(currentUid, currentFolder);
+        catalog.applyChange(*mappingStore, currentFolder, previous);
+        if (rebound) {
             assignedCount++;
             totalProcessed++;
             showStatus("Assigned to " + currentFolder + " - Remove card and press Play/Pause to continue");
@@ -221,6 +268,102 @@ void SetupMode::stepWaitForCardRemoval() {
     }
 }
 
+// ============================================================================
+// AUTO-ASSIGN
+// ============================================================================
+// No debounce reads, prompts or removal wait: a card is taken as soon as
+// the RFID manager reports a UID different from the last one accepted, so
+// the next card can follow straight away. Nothing touches the SD card
+// until stepAutoCommit().
+
+void SetupMode::stepAutoAssign() {
+    if (currentPathIndex >= unassignedPaths.size()) {
+        showStatus("All folders paired - saving");
+        currentState = SetupState::AUTO_COMMIT;
+        return;
+    }
+    
+    if (!rfidManager->isTagPresent()) {
+        autoLastUid[0] = '\0';   // A re-tap of the same card is seen (and ignored) again
+        return;
+    }
+    
+    const char* uid = rfidManager->getLastDetectedUIDCStr();
+    if (uid[0] == '\0' || strcmp(uid, autoLastUid) == 0) {
+        return;   // Same card still on the reader
+    }
+    strncpy(autoLastUid, uid, sizeof(autoLastUid) - 1);
+    autoLastUid[sizeof(autoLastUid) - 1] = '\0';
+    handleAutoUid(uid);
+}
+
+// Pair the tapped card with the current folder
+void SetupMode::handleAutoUid(const char* uid) {
+    for (const BatchItem& item : autoItems) {
+        if (item.uid == uid) {
+            autoIgnoredCount++;
+            showStatus(String("Card already paired with ") + item.path + " - ignored");
+            return;
+        }
+    }
+    
+    String existingPath;
+    if (mappingStore->getPathFor(uid, existingPath)) {
+        autoIgnoredCount++;
+        showStatus("Card already used by: " + existingPath + " - ignored");
+        return;
+    }
+    
+    const String& folder = unassignedPaths[currentPathIndex];
+    autoItems.push_back(BatchItem(uid, folder));
+    autoFolderIndexes.push_back(currentPathIndex++);
+    assignedCount++;
+    totalProcessed++;
+    LOG_SETUP_INFO("%u: %s -> %s", (unsigned)autoItems.size(), uid, folder.c_str());
+    
+    if (currentPathIndex < unassignedPaths.size()) {
+        showPrompt("Tap card for: " + unassignedPaths[currentPathIndex]);
+    }
+}
+
+// One mapping file write for the whole session
+void SetupMode::stepAutoCommit() {
+    if (autoItems.empty()) {
+        showStatus("Nothing to save");
+        currentState = SetupState::RFID_SETUP_SUMMARY;
+        return;
+    }
+    
+    const unsigned long startMs = millis();
+    const bool written = mappingStore->commitBatch(autoItems, false);
+    const unsigned long commitMs = millis() - startMs;
+    catalog.refresh(*mappingStore);
+    
+    int committed = 0;
+    for (const BatchItem& item : autoItems) {
+        if (item.status == BatchStatus::ASSIGNED) {
+            committed++;
+        } else if (item.status != BatchStatus::UNCHANGED) {
+            LOG_SETUP_WARN("Not saved: %s -> %s (%s)", item.uid.c_str(), item.path.c_str(),
+                           MappingStore::getBatchStatusName(item.status));
+        }
+    }
+    
+    if (written) {
+        LOG_SETUP_INFO("Auto-assign: %d of %u pairs saved in one write (%lu ms), %d taps ignored",
+                       committed, (unsigned)autoItems.size(), commitMs, autoIgnoredCount);
+    } else {
+        LOG_SETUP_ERROR("Auto-assign: mapping write failed - nothing saved");
+        committed = 0;
+    }
+    skippedCount += assignedCount - committed;
+    assignedCount = committed;
+    
+    autoItems.clear();
+    autoFolderIndexes.clear();
+    currentState = SetupState::RFID_SETUP_SUMMARY;
+}
+
 // Show summary and exit
 void SetupMode::stepSummary() {
     LOG_SETUP_INFO("=== SETUP SUMMARY ===");
@@ -256,7 +399,9 @@ void SetupMode::handleUid(const String& uid) {
     } else {
         // New UID - assign immediately
         Mapping mapping(uid, currentFolder);
-        if (mappingStore->append(mapping)) {
+        const bool appended = mappingStore->append(mapping);
+        catalog.applyChange(*mappingStore, currentFolder);
+        if (appended) {
             assignedCount++;
             totalProcessed++;
             showStatus("Assigned to " + currentFolder + " - Remove card and press Play/Pause to continue");
@@ -270,6 +415,11 @@ void SetupMode::handleUid(const String& uid) {
 
 // Handle button actions
 void SetupMode::handleButtonAction(SetupButtonAction action) {
+    if (autoAssign) {
+        handleAutoButtonAction(action);
+        return;
+    }
+    
     switch (action) {
         case SetupButtonAction::PLAY_OK:
             // Confirm action or advance to next stage
@@ -323,11 +473,67 @@ void SetupMode::handleButtonAction(SetupButtonAction action) {
     }
 }
 
+// Buttons while auto-assigning
+void SetupMode::handleAutoButtonAction(SetupButtonAction action) {
+    if (currentState != SetupState::AUTO_ASSIGN) {
+        if (action == SetupButtonAction::LONG_PRESS) {
+            exit();
+        }
+        return;
+    }
+    
+    switch (action) {
+        case SetupButtonAction::PLAY_OK:
+            // End the session and save
+            currentState = SetupState::AUTO_COMMIT;
+            break;
+            
+        case SetupButtonAction::BACK_PREV:
+            // Undo the last pair - its folder is up again, and so are the
+            // folders skipped after it
+            if (!autoItems.empty()) {
+                showStatus("Undone: " + autoItems.back().path);
+                const size_t folderIndex = autoFolderIndexes.back();
+                const int skippedSince = (int)(currentPathIndex - folderIndex - 1);
+                autoItems.pop_back();
+                autoFolderIndexes.pop_back();
+                currentPathIndex = folderIndex;
+                skippedCount -= skippedSince;
+                assignedCount--;
+                totalProcessed -= skippedSince + 1;
+                autoLastUid[0] = '\0';
+                showPrompt("Tap card for: " + unassignedPaths[currentPathIndex]);
+            }
+            break;
+            
+        case SetupButtonAction::NEXT:
+            // Leave the current folder unassigned
+            if (currentPathIndex < unassignedPaths.size()) {
+                skippedCount++;
+                totalProcessed++;
+                showStatus("Skipped: " + unassignedPaths[currentPathIndex]);
+                currentPathIndex++;
+                if (currentPathIndex < unassignedPaths.size()) {
+                    showPrompt("Tap card for: " + unassignedPaths[currentPathIndex]);
+                }
+            }
+            break;
+            
+        case SetupButtonAction::LONG_PRESS:
+            // Abort - pairs are discarded by exit()
+            exit();
+            break;
+            
+        default:
+            break;
+    }
+}
+
 // Get button action from hardware
 SetupButtonAction SetupMode::getButtonAction() {
     if (!buttonManager) return SetupButtonAction::NONE;
     
-    // Check for long press on encoder (simplified - integrate with your Rotary_Manager if needed)
+    // Long press on the encoder button
     if (encoderPressed) {
         if (millis() - encoderPressStart > LONG_PRESS_THRESHOLD) {
             encoderPressed = false;
@@ -342,9 +548,14 @@ SetupButtonAction SetupMode::getButtonAction() {
     if (currentButton != lastButtonState) {
         lastButtonState = currentButton;
         lastButtonCheck = millis();
+        encoderPressed = false;
         
         // Map button types to setup actions
         switch (currentButton) {
+            case BUTTON_ENCODER:
+                encoderPressed = true;   // LONG_PRESS once held past LONG_PRESS_THRESHOLD
+                encoderPressStart = millis();
+                break;
             case BUTTON_PLAY_PAUSE:
                 return SetupButtonAction::PLAY_OK;
             case BUTTON_PREVIOUS:
@@ -368,9 +579,9 @@ bool SetupMode::waitForRfid(String& uid, unsigned long timeout) {
     
     // Check if RFID is present
     if (rfidManager->isTagPresent()) {
-        String currentUid = rfidManager->getLastDetectedUIDString();
+        const char* currentUid = rfidManager->getLastDetectedUIDCStr();
         
-        if (currentUid != lastUid) {
+        if (lastUid != currentUid) {
             // New UID detected
             lastUid = currentUid;
             lastReadTime = millis();
@@ -398,20 +609,6 @@ bool SetupMode::waitForRfid(String& uid, unsigned long timeout) {
     return false;
 }
 
-// Compute unassigned paths
-void SetupMode::computeUnassignedPaths() {
-    std::vector<String> unassigned;
-    
-    for (const String& path : unassignedPaths) {
-        String dummy;
-        if (!mappingStore->getUidFor(path, dummy)) {
-            unassigned.push_back(path);
-        }
-    }
-    
-    unassignedPaths = unassigned;
-}
-
 // Show prompt message
 void SetupMode::showPrompt(const String& message) {
     LOG_SETUP_INFO("%s", message.c_str());
@@ -431,6 +628,8 @@ String SetupMode::getCurrentStateName() const {
         case SetupState::READ_UID: return "READ_UID";
         case SetupState::CONFIRM_OVERWRITE: return "CONFIRM_OVERWRITE";
         case SetupState::WAIT_FOR_CARD_REMOVAL: return "WAIT_FOR_CARD_REMOVAL";
+        case SetupState::AUTO_ASSIGN: return "AUTO_ASSIGN";
+        case SetupState::AUTO_COMMIT: return "AUTO_COMMIT";
         case SetupState::RFID_SETUP_SUMMARY: return "RFID_SETUP_SUMMARY";
         default: return "UNKNOWN";
     }
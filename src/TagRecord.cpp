@@ -0,0 +1,74 @@
+#include "TagRecord.h"
+
+// Define static constexpr members
+constexpr uint8_t TagRecord::kMagic0;
+constexpr uint8_t TagRecord::kMagic1;
+constexpr uint8_t TagRecord::kVersion;
+constexpr size_t TagRecord::BLOCK_SIZE;
+constexpr size_t TagRecord::RECORD_SIZE;
+constexpr size_t TagRecord::HEADER_SIZE;
+constexpr size_t TagRecord::CHECK_SIZE;
+constexpr size_t TagRecord::MAX_PATH_LENGTH;
+
+// FNV-1a over the header and path
+static uint32_t recordHash(const uint8_t* data, size_t length) {
+    uint32_t hash = 2166136261UL;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= data[i];
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+bool TagRecord::encode(const char* path, uint8_t* out) {
+    if (!path || !out) {
+        return false;
+    }
+    const size_t length = strlen(path);
+    if (length == 0 || length > MAX_PATH_LENGTH || path[0] != '/') {
+        return false;
+    }
+
+    memset(out, 0, RECORD_SIZE);
+    out[0] = kMagic0;
+    out[1] = kMagic1;
+    out[2] = kVersion;
+    out[3] = (uint8_t)length;
+    memcpy(out + HEADER_SIZE, path, length);
+
+    const uint32_t hash = recordHash(out, HEADER_SIZE + length);
+    uint8_t* check = out + HEADER_SIZE + length;
+    for (size_t i = 0; i < CHECK_SIZE; i++) {
+        check[i] = (uint8_t)(hash >> (8 * i));
+    }
+    return true;
+}
+
+size_t TagRecord::usedSize(const uint8_t* firstBlock) {
+    if (firstBlock[0] != kMagic0 || firstBlock[1] != kMagic1 || firstBlock[2] != kVersion ||
+        firstBlock[3] == 0 || firstBlock[3] > MAX_PATH_LENGTH) {
+        return 0;
+    }
+    return HEADER_SIZE + firstBlock[3] + CHECK_SIZE;
+}
+
+bool TagRecord::decode(const uint8_t* data, size_t length, char* path, size_t pathSize) {
+    const size_t used = length >= BLOCK_SIZE ? usedSize(data) : 0;
+    if (used == 0 || used > length) {
+        return false;
+    }
+
+    const size_t pathLength = data[3];
+    const uint8_t* check = data + HEADER_SIZE + pathLength;
+    uint32_t stored = 0;
+    for (size_t i = 0; i < CHECK_SIZE; i++) {
+        stored |= (uint32_t)check[i] << (8 * i);
+    }
+    if (stored != recordHash(data, HEADER_SIZE + pathLength) || pathLength + 1 > pathSize) {
+        return false;
+    }
+
+    memcpy(path, data + HEADER_SIZE, pathLength);
+    path[pathLength] = '\0';
+    return path[0] == '/';
+}
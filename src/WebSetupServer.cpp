@@ -2,431 +2,183 @@
 #include "Logger.h"
 #include "Settings_Manager.h"
 #include "Battery_Manager.h"
+#include "PowerGovernor.h"
+#include "JsonStreamWriter.h"
+#include "SettingsSchema.h"
+#include "WebAssets.h"   // Generated from web/ by scripts/embed_web_assets.py
 #include <ArduinoJson.h>
+#include <memory>
 
 static const char* kApSsid = "setup";   // open network as requested
 
-// Single-page UI with vibrant Game Boy Color-inspired palette
-static const char* kIndexHtml PROGMEM = R"HTML(
-<!DOCTYPE html>
-<html>
-<head>
-<meta charset="UTF-8">
-<meta name="viewport" content="width=device-width,initial-scale=1.0">
-<title>Radio Gaga Setup</title>
-<style>
-:root {
-  --bg1: #0b122c;
-  --bg2: #193e7a;
-  --card: rgba(8, 12, 28, 0.9);
-  --stroke: rgba(255, 255, 255, 0.12);
-  --text: #f6f8ff;
-  --muted: #c2cffc;
-  --primary: #1ee7ff;
-  --primary-dark: #0aa0ff;
-  --accent: #7aff59;
-  --accent-2: #ff7af5;
-}
-* { box-sizing: border-box; }
-body {
-  margin: 0;
-  font-family: "Inter", system-ui, -apple-system, sans-serif;
-  background:
-    radial-gradient(1200px at 12% 18%, rgba(255,122,245,0.12), transparent 55%),
-    radial-gradient(900px at 88% 10%, rgba(122,255,89,0.10), transparent 52%),
-    linear-gradient(135deg, var(--bg1), var(--bg2));
-  color: var(--text);
-  min-height: 100vh;
-  display: flex;
-  justify-content: center;
-}
-.wrap { width: 100%; max-width: 480px; padding: 18px 16px 28px; }
-.header { display: flex; align-items: center; gap: 10px; margin-bottom: 14px; }
-.logo {
-  width: 42px; height: 42px; border-radius: 12px;
-  background: linear-gradient(135deg, var(--accent), var(--accent-2));
-  display: flex; align-items: center; justify-content: center;
-  font-weight: 800; color: #0a1633;
-  box-shadow: 0 6px 20px rgba(0,0,0,0.28), 0 0 0 2px rgba(10,16,35,0.6);
-}
-h1 { margin: 0; font-size: 19px; letter-spacing: .2px; }
-.topline { display: flex; align-items: center; justify-content: space-between; gap: 10px; }
-.battery { padding: 8px 10px; border-radius: 10px; border: 1px solid var(--stroke); background: rgba(255,255,255,.06); font-weight: 800; font-size: 13px; color: var(--text); min-width: 86px; text-align: center; box-shadow: inset 0 0 0 1px rgba(255,255,255,.03); }
-.badge {
-  background: linear-gradient(135deg, var(--primary), var(--accent));
-  color: #081025;
-  padding: 4px 10px; border-radius: 999px; font-size: 12px; font-weight: 800;
-  box-shadow: 0 6px 12px rgba(0,0,0,0.18);
-}
-.card { background: var(--card); border: 1px solid var(--stroke); border-radius: 14px; padding: 14px; box-shadow: 0 12px 28px rgba(0,0,0,.25); backdrop-filter: blur(6px); margin-bottom: 14px; }
-.label { font-size: 13px; color: var(--muted); margin: 0 0 6px; }
-.folder { display: flex; align-items: center; justify-content: space-between; padding: 12px 12px; border-radius: 12px; border: 1px solid var(--stroke); background: rgba(255,255,255,.05); color: var(--text); margin-bottom: 10px; cursor: pointer; transition: transform .08s ease, box-shadow .12s ease, border-color .12s ease; border-left: 4px solid var(--accent); }
-.folder:hover { transform: translateY(-2px); box-shadow: 0 10px 18px rgba(0,0,0,.25); border-color: rgba(122,255,89,0.5); }
-.folder-title { font-weight: 800; font-size: 15px; line-height: 1.2; letter-spacing: .2px; }
-.folder-arrow { color: var(--muted); font-size: 14px; }
-.status { font-size: 14px; line-height: 1.4; color: var(--text); padding: 10px 12px; border-radius: 10px; background: rgba(255,255,255,.06); border: 1px solid var(--stroke); min-height: 42px; box-shadow: inset 0 0 0 1px rgba(255,255,255,.03); }
-.actions { display: flex; gap: 10px; margin-top: 10px; }
-button { border: none; border-radius: 10px; padding: 12px 14px; font-size: 15px; font-weight: 800; cursor: pointer; transition: transform .08s ease, box-shadow .12s ease; width: 100%; letter-spacing: .2px; }
-button:active { transform: translateY(1px); }
-.btn-primary { background: linear-gradient(135deg, var(--primary), var(--primary-dark)); color: #001429; box-shadow: 0 10px 20px rgba(10,160,255,.35); }
-.btn-ghost { background: rgba(255,255,255,.1); color: var(--text); border: 1px solid var(--stroke); }
-.btn-link { background: rgba(255,255,255,.04); color: var(--text); border: 1px solid var(--stroke); box-shadow: 0 8px 16px rgba(0,0,0,.12); }
-.btn-danger { background: linear-gradient(135deg, #ff5f6d, #c70039); color: #fff; box-shadow: 0 10px 20px rgba(255,95,109,.35); border: 1px solid rgba(255,255,255,.1); }
-.hidden { display: none; }
-#modal { position: fixed; inset: 0; background: rgba(5,10,24,.7); display: none; align-items: center; justify-content: center; padding: 16px; }
-#modalContent { background: var(--card); border: 1px solid var(--stroke); border-radius: 14px; padding: 16px; max-width: 360px; width: 100%; box-shadow: 0 16px 30px rgba(0,0,0,.35); }
-#modalText { font-size: 15px; color: var(--text); margin-bottom: 12px; }
-#modalActions { display: flex; gap: 10px; }
-@media (max-width: 480px) {
-  .wrap { padding: 16px 12px 24px; }
-  .folder { padding: 12px 10px; }
-  button { font-size: 14px; }
-}
-</style>
-</head>
-<body>
-<div class="wrap">
-  <div class="header">
-    <div class="logo">RG</div>
-    <div style="flex:1">
-      <div class="badge">Radio Gaga Setup</div>
-      <div class="topline">
-        <h1>Choose folder & tag</h1>
-        <div class="battery" id="battery">--%</div>
-      </div>
-    </div>
-  </div>
-  <div class="card">
-    <div class="label">Folders</div>
-    <div id="folders"></div>
-  </div>
-  <div class="card">
-    <div class="label">Status</div>
-    <div class="status" id="status">Pick a folder to begin.</div>
-    <div class="actions hidden" id="actions">
-      <button class="btn-primary" id="doneBtn">Done</button>
-    </div>
-  </div>
-  <button class="btn-link" id="settingsBtn">Settings</button>
-  <button class="btn-danger" id="exitBtn">Exit Web Setup</button>
-</div>
-<div id="modal">
-  <div id="modalContent">
-    <div id="modalText"></div>
-    <div id="modalActions">
-      <button class="btn-primary" id="reassignBtn">Reassign</button>
-      <button class="btn-ghost" id="cancelBtn">Cancel</button>
-    </div>
-  </div>
-</div>
-<script>
-let t=null,f="",u="";
-const S=e=>document.getElementById("status").innerText=e,
-      A=e=>document.getElementById("actions").classList.toggle("hidden",!e),
-      M=e=>{document.getElementById("modalText").innerText=e;document.getElementById("modal").style.display="flex"},
-      C=()=>document.getElementById("modal").style.display="none";
-async function L(){
-  const e=await fetch("/folders"),n=await e.json(),d=document.getElementById("folders");
-  if(d.innerHTML="",!n.folders||!n.folders.length){d.innerHTML='<div class="status">No unassigned folders found.</div>';A(!0);return;}
-  n.folders.forEach(e=>{
-    const n=document.createElement("div");
-    n.className="folder";
-    n.innerHTML='<span class="folder-title">'+e+'</span><span class="folder-arrow">›</span>';
-    n.onclick=()=>E(e);
-    d.appendChild(n);
-  });
-}
-async function E(e){
-  await fetch("/select",{method:"POST",headers:{"Content-Type":"application/x-www-form-urlencoded"},body:"folder="+encodeURIComponent(e)});
-  f=e;S("Waiting for tag for "+e+"...");A(!1);g();
-}
-function g(){t&&clearInterval(t);t=setInterval(T,600);}
-async function T(){
-  const e=await fetch("/tag"),n=await e.json();
-  if("tag_detected"===n.status){u=n.uid;clearInterval(t);S("Tag "+u+" detected, assigning...");y(!1);}
-}
-async function B(){
-  try{
-    const e=await fetch("/api/battery"),n=await e.json(),d=document.getElementById("battery");
-    if(n.status==="ok"&&typeof n.percentage==="number"){d.innerText=`${n.percentage.toFixed(0)}%`;d.title=n.voltage?`Voltage: ${n.voltage.toFixed(2)}V`:"";}
-    else{d.innerText="N/A";}
-  }catch(e){document.getElementById("battery").innerText="N/A";}
-}
-async function y(e){
-  const n=`uid=${encodeURIComponent(u)}&folder=${encodeURIComponent(f)}&force=${e?"1":"0"}`,
-        d=await fetch("/assign",{method:"POST",headers:{"Content-Type":"application/x-www-form-urlencoded"},body:n}),
-        o=await d.json();
-  if("assigned"===o.status||"already_assigned_same"===o.status){S("Assigned to "+f+".");A(!0);}
-  else if("conflict"===o.status){M("This cassette is already assigned to "+o.folder+". Reassign?");}
-  else {S("Error: "+(o.message||"unknown"));A(!0);}
-}
-document.getElementById("reassignBtn").onclick=async()=>{
-  C();
-  const e=`uid=${encodeURIComponent(u)}&folder=${encodeURIComponent(f)}`,
-        n=await fetch("/reassign",{method:"POST",headers:{"Content-Type":"application/x-www-form-urlencoded"},body:e}),
-        d=await n.json();
-  "reassigned"===d.status?S("Reassigned to "+f+"."):S("Reassign failed: "+(d.message||"unknown"));
-  A(!0);
-};
-document.getElementById("cancelBtn").onclick=async()=>{
-  C();S("Choose another folder.");u="";await L();
-};
-document.getElementById("doneBtn").onclick=async()=>{
-  await fetch("/done",{method:"POST"});S("Done. You can close this page.");
-};
-document.getElementById("settingsBtn").onclick=()=>{window.location.href="/settings";};
-document.getElementById("exitBtn").onclick=async()=>{
-  S("Exiting setup...");
-  try{
-    await fetch("/done",{method:"POST"});
-    S("Stopping web setup and WiFi...");
-  }catch(e){
-    S("Stopping web setup...");
-  }
-};
-L();
-B();setInterval(B,10000);
-</script>
-</body>
-</html>
-)HTML";
-
-// Settings UI page
-static const char* kSettingsHtml PROGMEM = R"HTML(
-<!DOCTYPE html>
-<html>
-<head>
-<meta charset="UTF-8">
-<meta name="viewport" content="width=device-width,initial-scale=1.0">
-<title>Radio Gaga Settings</title>
-<style>
-:root {
-  --bg1: #0b122c;
-  --bg2: #193e7a;
-  --card: rgba(8, 12, 28, 0.9);
-  --stroke: rgba(255, 255, 255, 0.12);
-  --text: #f6f8ff;
-  --muted: #c2cffc;
-  --primary: #1ee7ff;
-  --primary-dark: #0aa0ff;
-  --accent: #7aff59;
-  --accent-2: #ff7af5;
-}
-* { box-sizing: border-box; }
-body {
-  margin: 0;
-  font-family: "Inter", system-ui, -apple-system, sans-serif;
-  background:
-    radial-gradient(1200px at 12% 18%, rgba(255,122,245,0.12), transparent 55%),
-    radial-gradient(900px at 88% 10%, rgba(122,255,89,0.10), transparent 52%),
-    linear-gradient(135deg, var(--bg1), var(--bg2));
-  color: var(--text);
-  min-height: 100vh;
-  display: flex;
-  justify-content: center;
-}
-.wrap { width: 100%; max-width: 520px; padding: 20px 16px 32px; }
-.header { display: flex; align-items: center; gap: 12px; margin-bottom: 14px; }
-.logo {
-  width: 44px; height: 44px; border-radius: 12px;
-  background: linear-gradient(135deg, var(--accent), var(--accent-2));
-  display: flex; align-items: center; justify-content: center;
-  font-weight: 800; color: #0a1633;
-  box-shadow: 0 6px 20px rgba(0,0,0,0.28), 0 0 0 2px rgba(10,16,35,0.6);
-}
-h1 { margin: 0; font-size: 20px; letter-spacing: .2px; }
-.sub { color: var(--muted); font-size: 13px; margin-top: 2px; }
-.card { background: var(--card); border: 1px solid var(--stroke); border-radius: 14px; padding: 14px; box-shadow: 0 12px 28px rgba(0,0,0,.25); backdrop-filter: blur(6px); margin-bottom: 14px; }
-.label { font-size: 13px; color: var(--muted); margin: 0 0 6px; font-weight: 700; letter-spacing: .2px; }
-.field { display: flex; flex-direction: column; gap: 8px; margin-bottom: 12px; }
-.field input[type="text"],
-.field input[type="password"],
-.field input[type="number"] {
-  padding: 10px 12px;
-  border-radius: 10px;
-  border: 1px solid var(--stroke);
-  background: rgba(255,255,255,.06);
-  color: var(--text);
-  font-size: 14px;
-}
-.slider-row { display: flex; align-items: center; gap: 10px; }
-input[type="range"] { flex: 1; accent-color: var(--primary); }
-.value-pill { min-width: 54px; text-align: center; padding: 8px 10px; border-radius: 10px; border: 1px solid var(--stroke); background: rgba(255,255,255,.06); font-weight: 800; }
-.actions { display: flex; gap: 10px; margin-top: 12px; }
-button { border: none; border-radius: 10px; padding: 12px 14px; font-size: 15px; font-weight: 800; cursor: pointer; transition: transform .08s ease, box-shadow .12s ease; width: 100%; letter-spacing: .2px; }
-button:active { transform: translateY(1px); }
-.btn-primary { background: linear-gradient(135deg, var(--primary), var(--primary-dark)); color: #001429; box-shadow: 0 10px 20px rgba(10,160,255,.35); }
-.btn-ghost { background: rgba(255,255,255,.1); color: var(--text); border: 1px solid var(--stroke); }
-.status { font-size: 14px; line-height: 1.4; color: var(--text); padding: 10px 12px; border-radius: 10px; background: rgba(255,255,255,.06); border: 1px solid var(--stroke); min-height: 42px; box-shadow: inset 0 0 0 1px rgba(255,255,255,.03); }
-.row { display: grid; grid-template-columns: repeat(auto-fit,minmax(220px,1fr)); gap: 10px; }
-@media (max-width: 480px) { .wrap { padding: 16px 12px 26px; } }
-</style>
-</head>
-<body>
-<div class="wrap">
-  <div class="header">
-    <div class="logo">RG</div>
-    <div>
-      <h1>Settings</h1>
-      <div class="sub">Adjust device defaults and limits</div>
-    </div>
-  </div>
-  <div class="card">
-    <div class="field">
-      <div class="label">Default volume</div>
-      <div class="slider-row">
-        <input type="range" id="defaultVolume" min="0" max="1" step="0.01">
-        <div class="value-pill" id="defaultVolumeValue">--</div>
-      </div>
-    </div>
-    <div class="field">
-      <div class="label">Max volume</div>
-      <div class="slider-row">
-        <input type="range" id="maxVolume" min="0" max="1" step="0.01">
-        <div class="value-pill" id="maxVolumeValue">--</div>
-      </div>
-    </div>
-  </div>
-  <div class="card">
-    <div class="row">
-      <div class="field">
-        <div class="label">WiFi SSID</div>
-        <input type="text" id="wifiSSID" placeholder="Network name">
-      </div>
-      <div class="field">
-        <div class="label">WiFi Password</div>
-        <input type="password" id="wifiPassword" placeholder="Password">
-      </div>
-    </div>
-    <div class="row">
-      <div class="field">
-        <div class="label">Sleep timeout (minutes)</div>
-        <input type="number" id="sleepTimeout" min="1" max="1440">
-      </div>
-      <div class="field">
-        <div class="label">Battery check interval (minutes)</div>
-        <input type="number" id="batteryCheckInterval" min="1" max="60">
-      </div>
-    </div>
-  </div>
-  <div class="card">
-    <div class="label">Status</div>
-    <div class="status" id="status">Loading...</div>
-    <div class="actions">
-      <button class="btn-ghost" id="backBtn">Back</button>
-      <button class="btn-primary" id="saveBtn">Save settings</button>
-    </div>
-  </div>
-</div>
-<script>
-const statusEl=document.getElementById("status");
-const inputs={
-  defaultVolume:document.getElementById("defaultVolume"),
-  maxVolume:document.getElementById("maxVolume"),
-  wifiSSID:document.getElementById("wifiSSID"),
-  wifiPassword:document.getElementById("wifiPassword"),
-  sleepTimeout:document.getElementById("sleepTimeout"),
-  batteryCheckInterval:document.getElementById("batteryCheckInterval")
-};
-const pills={
-  defaultVolume:document.getElementById("defaultVolumeValue"),
-  maxVolume:document.getElementById("maxVolumeValue")
+// Define static constexpr members
+constexpr size_t WebSetupServer::MAX_BODY_SIZE;
+constexpr size_t WebSetupServer::MAX_BATCH_BODY_SIZE;
+constexpr size_t WebSetupServer::MAX_BATCH_ITEMS;
+constexpr uint32_t WebSetupServer::STOP_DELAY_MS;
+constexpr uint32_t WebSetupServer::LOCK_TIMEOUT_MS;
+constexpr uint8_t WebSetupServer::MAX_LOCK_RETRIES;
+
+// ============================================================================
+// FOLDER LIST SOURCE
+// ============================================================================
+// Produces the /folders body for a chunked response. AsyncTCP asks for one
+// chunk at a time (up to the free TCP window); folders are staged into
+// `pending` only until that much is available, so memory stays bounded by one
+// chunk plus one folder path however many folders the card holds. While
+// the state lock is busy AsyncTCP is told to ask again; after
+// MAX_LOCK_RETRIES in a row the list is closed with an "error" field, so
+// the page never takes a cut-off list for the whole card.
+
+class WebSetupServer::FolderListSource : public Print {
+public:
+    explicit FolderListSource(WebSetupServer& owner)
+        : owner(owner), json(*this), index(0), cursor(0), lockRetries(0), started(false), done(false), startUs(micros()) {}
+
+    size_t write(uint8_t c) override {
+        pending += (char)c;
+        return 1;
+    }
+
+    size_t write(const uint8_t* data, size_t length) override {
+        pending.concat((const char*)data, length);
+        return length;
+    }
+
+    // Fill callback - returns 0 once the document is complete,
+    // RESPONSE_TRY_AGAIN while the lock is busy and nothing is staged
+    size_t fill(uint8_t* buffer, size_t maxLen) {
+        while (pending.length() < maxLen && !done) {
+            if (!stageNext()) {
+                break;
+            }
+        }
+        if (pending.length() == 0 && !done) {
+            return RESPONSE_TRY_AGAIN;
+        }
+
+        size_t count = pending.length() < maxLen ? pending.length() : maxLen;
+        memcpy(buffer, pending.c_str(), count);
+        pending.remove(0, count);
+
+        if (count == 0) {
+            LOG_DEBUG("[WEB-SETUP] /folders: %u folders, %u bytes, %lu us, min free heap %lu",
+                      (unsigned)index, (unsigned)json.getBytesWritten(),
+                      (unsigned long)(micros() - startUs), (unsigned long)ESP.getMinFreeHeap());
+        }
+        return count;
+    }
+
+private:
+    WebSetupServer& owner;
+    JsonStreamWriter json;   // Writes into this object
+    String pending;
+    size_t index;            // Folders sent
+    size_t cursor;           // Position in the catalog
+    uint8_t lockRetries;     // Lock timeouts in a row
+    bool started;
+    bool done;
+    uint32_t startUs;
+
+    // Stage the header, the next folder or the footer; false if the lock
+    // timed out and nothing was staged
+    bool stageNext() {
+        if (!started) {
+            json.beginObject();
+            json.beginArray("folders");
+            started = true;
+        } else {
+            String folder;
+            if (!owner.lock()) {
+                if (++lockRetries < MAX_LOCK_RETRIES) {
+                    LOG_WARN("[WEB-SETUP] /folders: state lock busy, retrying");
+                    return false;
+                }
+                LOG_ERROR("[WEB-SETUP] /folders: state lock busy, list cut off after %u folders", (unsigned)index);
+                json.endArray();
+                json.add("error", "busy");
+                json.endObject();
+                done = true;
+                json.flush();
+                return true;
+            }
+            lockRetries = 0;
+            const bool haveFolder = owner.catalog.nextUnassigned(cursor, folder);
+            owner.unlock();
+
+            if (haveFolder) {
+                json.add(nullptr, folder);
+                index++;
+            } else {
+                json.endArray();
+                json.endObject();
+                done = true;
+            }
+        }
+        json.flush();
+        return true;
+    }
 };
-function setStatus(msg){statusEl.innerText=msg;}
-function clamp(v,min,max){return Math.max(min,Math.min(max,v));}
-function bindSliders(){
-  inputs.defaultVolume.oninput=()=>{
-    const max=parseFloat(inputs.maxVolume.value||1);
-    inputs.defaultVolume.value=clamp(parseFloat(inputs.defaultVolume.value||0),0,max);
-    pills.defaultVolume.innerText=(parseFloat(inputs.defaultVolume.value)*100).toFixed(0)+"%";
-  };
-  inputs.maxVolume.oninput=()=>{
-    inputs.maxVolume.value=clamp(parseFloat(inputs.maxVolume.value||1),0,1);
-    if(parseFloat(inputs.defaultVolume.value)>parseFloat(inputs.maxVolume.value)){
-      inputs.defaultVolume.value=inputs.maxVolume.value;
-    }
-    pills.maxVolume.innerText=(parseFloat(inputs.maxVolume.value)*100).toFixed(0)+"%";
-    pills.defaultVolume.innerText=(parseFloat(inputs.defaultVolume.value)*100).toFixed(0)+"%";
-  };
-}
-async function loadSettings(){
-  setStatus("Loading...");
-  try{
-    const res=await fetch("/api/settings");
-    const data=await res.json();
-    if(data.error){setStatus(data.error);return;}
-    inputs.defaultVolume.value=data.defaultVolume ?? 0.2;
-    inputs.maxVolume.value=data.maxVolume ?? 1.0;
-    inputs.wifiSSID.value=data.wifiSSID || "";
-    inputs.wifiPassword.value=data.wifiPassword || "";
-    inputs.sleepTimeout.value=data.sleepTimeout ?? 15;
-    inputs.batteryCheckInterval.value=data.batteryCheckInterval ?? 1;
-    pills.defaultVolume.innerText=(parseFloat(inputs.defaultVolume.value)*100).toFixed(0)+"%";
-    pills.maxVolume.innerText=(parseFloat(inputs.maxVolume.value)*100).toFixed(0)+"%";
-    setStatus("Ready.");
-  }catch(err){
-    setStatus("Failed to load settings.");
-  }
-}
-async function saveSettings(){
-  setStatus("Saving...");
-  const payload={
-    defaultVolume:parseFloat(inputs.defaultVolume.value||0),
-    maxVolume:parseFloat(inputs.maxVolume.value||1),
-    wifiSSID:inputs.wifiSSID.value||"",
-    wifiPassword:inputs.wifiPassword.value||"",
-    sleepTimeout:parseInt(inputs.sleepTimeout.value||0,10),
-    batteryCheckInterval:parseInt(inputs.batteryCheckInterval.value||0,10)
-  };
-  try{
-    const res=await fetch("/api/settings",{method:"POST",headers:{"Content-Type":"application/json"},body:JSON.stringify(payload)});
-    const data=await res.json();
-    if(data.status==="ok"){setStatus("Settings saved.");}
-    else{setStatus(data.error||"Save failed.");}
-  }catch(err){
-    setStatus("Save failed.");
-  }
-}
-document.getElementById("saveBtn").onclick=saveSettings;
-document.getElementById("backBtn").onclick=()=>{window.location.href="/";};
-bindSliders();
-loadSettings();
-</script>
-</body>
-</html>
-)HTML";
+
+// ============================================================================
+// LIFECYCLE
+// ============================================================================
 
 WebSetupServer::WebSetupServer()
     : server(80),
+      events("/events"),
+      stateLock(nullptr),
+      routesRegistered(false),
       active(false),
       waitingForTag(false),
+      tagEventSent(false),
       selectedFolder(""),
       lastUid(""),
+      tagPresent(false),
+      recordPending(false),
+      pendingRecordPath(""),
+      settingsPending(false),
+      stopRequested(false),
+      stopRequestedMs(0),
       contentRoot("/"),
       mappingStore(nullptr),
       sdScanner(nullptr),
       rfidManager(nullptr),
       settingsManager(nullptr),
-      batteryManager(nullptr) {}
+      batteryManager(nullptr),
+      powerGovernor(nullptr),
+      assetBytesSaved(0) {
+    tagUid[0] = '\0';
+    pendingRecordUid[0] = '\0';
+}
 
-bool WebSetupServer::begin(MappingStore* store, SdScanner* scanner, RFID_Manager* rfid, const String& root, Settings_Manager* settings, Battery_Manager* battery) {
+bool WebSetupServer::begin(MappingStore* store, SdScanner* scanner, RFID_Manager* rfid, const String& root, Settings_Manager* settings, Battery_Manager* battery, PowerGovernor* power) {
     mappingStore = store;
     sdScanner = scanner;
     rfidManager = rfid;
     contentRoot = root;
     settingsManager = settings;
     batteryManager = battery;
+    powerGovernor = power;
 
     if (!mappingStore || !sdScanner || !rfidManager) {
         LOG_ERROR("[WEB-SETUP] Invalid components");
         return false;
     }
 
+    if (!stateLock) {
+        stateLock = xSemaphoreCreateMutex();
+        if (!stateLock) {
+            LOG_ERROR("[WEB-SETUP] Failed to create state lock");
+            return false;
+        }
+    }
+
     return true;
 }
 
 bool WebSetupServer::start() {
-    if (!mappingStore || !sdScanner || !rfidManager) {
+    if (!mappingStore || !sdScanner || !rfidManager || !stateLock) {
         LOG_ERROR("[WEB-SETUP] Not initialized");
         return false;
     }
@@ -435,12 +187,12 @@ bool WebSetupServer::start() {
         return true;
     }
 
-    // Load mappings and folders
+    // Load mappings and folders (the server is not running yet)
     if (!mappingStore->loadAll()) {
         LOG_ERROR("[WEB-SETUP] Failed to load mapping store");
         return false;
     }
-    refreshFolders();
+    refreshFolders(true);
 
     // Bring up AP
     WiFi.mode(WIFI_AP);
@@ -449,31 +201,43 @@ bool WebSetupServer::start() {
         return false;
     }
 
-    // Disable audio control during setup
+    // Cards are captured for assignment instead of starting playback
     rfidManager->enableAudioControl(false);
 
-    registerRoutes();
-    server.begin();
-    active = true;
     waitingForTag = false;
+    tagEventSent = false;
     selectedFolder = "";
     lastUid = "";
+    stopRequested = false;
 
-    LOG_INFO("[WEB-SETUP] SoftAP '%s' started, web server running", kApSsid);
+    if (!routesRegistered) {
+        registerRoutes();
+        routesRegistered = true;
+    }
+    server.begin();
+    active = true;
+
+    LOG_INFO("[WEB-SETUP] SoftAP '%s' started, async web server running", kApSsid);
     return true;
 }
 
 void WebSetupServer::stop() {
     if (!active) return;
 
-    server.stop();
+    events.close();
+    server.end();
     WiFi.softAPdisconnect(true);
     WiFi.mode(WIFI_OFF);
 
-    waitingForTag = false;
-    selectedFolder = "";
-    lastUid = "";
-    unassignedFolders.clear();
+    if (lock()) {
+        waitingForTag = false;
+        tagEventSent = false;
+        selectedFolder = "";
+        lastUid = "";
+        catalog.clear();
+        unlock();
+    }
+    stopRequested = false;
     active = false;
 
     // Re-enable audio control
@@ -482,83 +246,272 @@ void WebSetupServer::stop() {
     LOG_INFO("[WEB-SETUP] Stopped web setup and AP");
 }
 
+// Main loop side: deferred stop and the RFID snapshot for the handlers
 void WebSetupServer::loop() {
+    if (settingsPending) {
+        applyPendingSettings();
+    }
     if (!active) return;
-    server.handleClient();
-}
 
-void WebSetupServer::registerRoutes() {
-    server.on("/", HTTP_GET, [this]() { handleRoot(); });
-    server.on("/settings", HTTP_GET, [this]() { handleSettingsPage(); });
-    server.on("/api/settings", HTTP_GET, [this]() { handleSettingsJson(); });
-    server.on("/api/settings", HTTP_POST, [this]() { handleSettingsSave(); });
-    server.on("/api/battery", HTTP_GET, [this]() { handleBattery(); });
-    server.on("/folders", HTTP_GET, [this]() { handleFolders(); });
-    server.on("/select", HTTP_POST, [this]() { handleSelect(); });
-    server.on("/tag", HTTP_GET, [this]() { handleTag(); });
-    server.on("/assign", HTTP_POST, [this]() { handleAssign(); });
-    server.on("/reassign", HTTP_POST, [this]() { handleReassign(); });
-    server.on("/done", HTTP_POST, [this]() { handleDone(); });
+    if (stopRequested && millis() - stopRequestedMs >= STOP_DELAY_MS) {
+        stop();
+        return;
+    }
+    publishTag();
+    if (recordPending) {
+        writePendingRecord();
+    }
 }
 
-void WebSetupServer::sendJson(int statusCode, const String& body) {
-    server.send(statusCode, "application/json", body);
+bool WebSetupServer::lock() {
+    return stateLock && xSemaphoreTake(stateLock, pdMS_TO_TICKS(LOCK_TIMEOUT_MS)) == pdTRUE;
 }
 
-void WebSetupServer::handleRoot() {
-    server.send_P(200, "text/html", kIndexHtml);
+void WebSetupServer::unlock() {
+    xSemaphoreGive(stateLock);
 }
 
-void WebSetupServer::handleSettingsPage() {
-    server.send_P(200, "text/html", kSettingsHtml);
+void WebSetupServer::registerRoutes() {
+    // Pages are gzipped at build time and revalidated by ETag
+    for (size_t i = 0; i < kWebAssetCount; i++) {
+        const WebAsset* asset = &kWebAssets[i];
+        server.on(asset->path, HTTP_GET, [this, asset](AsyncWebServerRequest* request) { handleAsset(request, *asset); });
+    }
+    server.on("/api/settings", HTTP_GET, [this](AsyncWebServerRequest* request) { handleSettingsJson(request); });
+    server.on("/api/settings", HTTP_POST, [this](AsyncWebServerRequest* request) { handleSettingsSave(request); },
+              nullptr, [](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+                  collectBody(request, data, len, index, total, MAX_BODY_SIZE);
+              });
+    server.on("/api/assign/batch", HTTP_POST, [this](AsyncWebServerRequest* request) { handleAssignBatch(request); },
+              nullptr, [](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+                  collectBody(request, data, len, index, total, MAX_BATCH_BODY_SIZE);
+              });
+    server.on("/api/battery", HTTP_GET, [this](AsyncWebServerRequest* request) { handleBattery(request); });
+    server.on("/folders", HTTP_GET, [this](AsyncWebServerRequest* request) { handleFolders(request); });
+    server.on("/select", HTTP_POST, [this](AsyncWebServerRequest* request) { handleSelect(request); });
+    server.on("/tag", HTTP_GET, [this](AsyncWebServerRequest* request) { handleTag(request); });   // Polling fallback for /events
+    server.on("/assign", HTTP_POST, [this](AsyncWebServerRequest* request) { handleAssign(request); });
+    server.on("/reassign", HTTP_POST, [this](AsyncWebServerRequest* request) { handleReassign(request); });
+    server.on("/done", HTTP_POST, [this](AsyncWebServerRequest* request) { handleDone(request); });
+
+    // A page opening the stream while a card is already on the reader gets it at once
+    events.onConnect([this](AsyncEventSourceClient* client) {
+        char message[64];
+        bool send = false;
+        if (lock()) {
+            if (waitingForTag && tagPresent) {
+                snprintf(message, sizeof(message), "{\"status\":\"tag_detected\",\"uid\":\"%s\"}", tagUid);
+                lastUid = tagUid;
+                tagEventSent = true;
+                send = true;
+            }
+            unlock();
+        }
+        if (send) {
+            client->send(message, "tag", millis());
+        }
+    });
+    server.addHandler(&events);
 }
 
-void WebSetupServer::handleFolders() {
-    refreshFolders();
-    String json = "{\"folders\":[";
-    for (size_t i = 0; i < unassignedFolders.size(); ++i) {
-        json += "\"" + unassignedFolders[i] + "\"";
-        if (i + 1 < unassignedFolders.size()) json += ",";
+// ============================================================================
+// TAG DETECTION
+// ============================================================================
+
+// Copy the reader state for the handlers and push the tag once per selection
+void WebSetupServer::publishTag() {
+    const bool present = rfidManager->isTagPresent();
+    const char* uid = present ? rfidManager->getLastDetectedUIDCStr() : "";
+
+    char message[64];
+    bool send = false;
+    if (!lock()) {
+        return;
+    }
+    tagPresent = present && uid[0] != '\0';
+    strncpy(tagUid, uid, sizeof(tagUid) - 1);
+    tagUid[sizeof(tagUid) - 1] = '\0';
+
+    if (waitingForTag && !tagEventSent && tagPresent && events.count() > 0) {
+        snprintf(message, sizeof(message), "{\"status\":\"tag_detected\",\"uid\":\"%s\"}", tagUid);
+        lastUid = tagUid;
+        tagEventSent = true;
+        send = true;
+    }
+    unlock();
+
+    if (send) {
+        events.send(message, "tag", millis());
+        LOG_DEBUG("[WEB-SETUP] Pushed tag %s", uid);
     }
-    json += "]}";
-    sendJson(200, json);
 }
 
-void WebSetupServer::handleSelect() {
-    String folder = server.arg("folder");
-    if (folder.isEmpty()) {
-        sendJson(400, "{\"error\":\"folder required\"}");
+// Queue the folder record if the assigned card is the one on the reader
+// (stateLock held)
+void WebSetupServer::queueTagRecord(const String& uid, const String& folder) {
+    if (!rfidManager->isTagRecordsEnabled() || !tagPresent) {
         return;
     }
-    selectedFolder = folder;
-    waitingForTag = true;
-    lastUid = "";
-    sendJson(200, "{\"status\":\"waiting_tag\"}");
+    String current = tagUid;
+    if (!normalizeUid(current) || current != uid) {
+        return;
+    }
+    strncpy(pendingRecordUid, tagUid, sizeof(pendingRecordUid) - 1);
+    pendingRecordUid[sizeof(pendingRecordUid) - 1] = '\0';
+    pendingRecordPath = folder;
+    recordPending = true;
 }
 
-void WebSetupServer::handleTag() {
-    // Ensure latest RFID state even if main loop is busy serving clients
-    if (rfidManager) {
-        rfidManager->update();
+// Main loop side: RFID is only driven from here
+void WebSetupServer::writePendingRecord() {
+    char uid[RFID_Manager::UID_STRING_SIZE];
+    String path;
+    if (!lock()) {
+        return;
+    }
+    strcpy(uid, pendingRecordUid);
+    path = pendingRecordPath;
+    pendingRecordUid[0] = '\0';
+    pendingRecordPath = "";
+    recordPending = false;
+    unlock();
+
+    if (!rfidManager->isTagPresent() || strcmp(uid, rfidManager->getLastDetectedUIDCStr()) != 0) {
+        LOG_WARN("[WEB-SETUP] Card %s left the reader - no tag record written", uid);
+        return;
+    }
+    if (!rfidManager->writeTagRecord(path.c_str())) {
+        LOG_WARN("[WEB-SETUP] Tag record not written - card %s keeps using the mapping", uid);
     }
+}
 
-    if (!waitingForTag) {
-        sendJson(200, "{\"status\":\"no_selection\"}");
+// Hand posted settings to Settings_Manager on the main loop; its update()
+// writes them once they settle
+void WebSetupServer::applyPendingSettings() {
+    if (!lock()) {
         return;
     }
+    settingsManager->updateSettings(pendingSettings);
+    const Settings applied = settingsManager->getSettings();
+    settingsPending = false;
+    unlock();
+
+    // Apply the new timeouts and tag record mode right away
+    if (batteryManager) {
+        batteryManager->setReadingInterval((unsigned long)applied.batteryCheckInterval * 60000UL);
+    }
+    if (powerGovernor) {
+        powerGovernor->setDeepSleepTimeout((uint32_t)applied.sleepTimeout * 60000UL);
+    }
+    rfidManager->setTagRecordsEnabled(applied.tagRecords != 0);
+}
 
-    if (rfidManager->isTagPresent()) {
-        String uid = rfidManager->getLastDetectedUIDString();
-        if (uid.length() > 0) {
+void WebSetupServer::handleTag(AsyncWebServerRequest* request) {
+    String uid;
+    bool waiting = false;
+    if (lock()) {
+        waiting = waitingForTag;
+        if (waiting && tagPresent) {
+            uid = tagUid;
             lastUid = uid;
-            String resp = "{\"status\":\"tag_detected\",\"uid\":\"" + uid + "\"}";
-            sendJson(200, resp);
+        }
+        unlock();
+    }
+
+    if (!waiting) {
+        sendJson(request, 200, "{\"status\":\"no_selection\"}");
+    } else if (uid.length() > 0) {
+        sendStatus(request, 200, "tag_detected", "uid", uid);
+    } else {
+        sendJson(request, 200, "{\"status\":\"waiting\"}");
+    }
+}
+
+// ============================================================================
+// RESPONSES
+// ============================================================================
+
+void WebSetupServer::sendJson(AsyncWebServerRequest* request, int statusCode, const char* body) {
+    request->send(statusCode, "application/json", body);
+}
+
+// Status plus one string field, escaped (folder paths may contain quotes)
+void WebSetupServer::sendStatus(AsyncWebServerRequest* request, int statusCode, const char* status, const char* key, const String& value) {
+    AsyncResponseStream* response = request->beginResponseStream("application/json");
+    response->setCode(statusCode);
+    {
+        JsonStreamWriter json(*response);
+        json.beginObject();
+        json.add("status", status);
+        json.add(key, value);
+        json.endObject();
+    }
+    request->send(response);
+}
+
+// Serve a pre-compressed page. "no-cache" lets the browser keep it but ask
+// again each time, so a firmware update is picked up on the next load.
+void WebSetupServer::handleAsset(AsyncWebServerRequest* request, const WebAsset& asset) {
+    if (request->hasHeader("If-None-Match")) {
+        const String& ifNoneMatch = request->header("If-None-Match");
+        if (ifNoneMatch.indexOf(asset.etag) >= 0 || ifNoneMatch == "*") {
+            AsyncWebServerResponse* response = request->beginResponse(304);
+            response->addHeader("ETag", asset.etag);
+            response->addHeader("Cache-Control", "no-cache");
+            request->send(response);
+            assetBytesSaved += asset.rawLength;
+            LOG_DEBUG("[WEB-SETUP] %s: 304, saved %u bytes (total %lu)",
+                      asset.path, (unsigned)asset.rawLength, (unsigned long)assetBytesSaved);
             return;
         }
     }
-    sendJson(200, "{\"status\":\"waiting\"}");
+
+    AsyncWebServerResponse* response = request->beginResponse(200, asset.contentType, asset.data, asset.length);
+    response->addHeader("Content-Encoding", "gzip");
+    response->addHeader("ETag", asset.etag);
+    response->addHeader("Cache-Control", "no-cache");
+    request->send(response);
+    assetBytesSaved += asset.rawLength - asset.length;
+    LOG_DEBUG("[WEB-SETUP] %s: %u bytes gzip, saved %u bytes (total %lu)",
+              asset.path, (unsigned)asset.length, (unsigned)(asset.rawLength - asset.length),
+              (unsigned long)assetBytesSaved);
+}
+
+// GET /folders[?rescan=1] - the card is only scanned again on request
+void WebSetupServer::handleFolders(AsyncWebServerRequest* request) {
+    refreshFolders(request->arg("rescan") == "1");
+
+    // Chunked - the response size grows with the card
+    std::shared_ptr<FolderListSource> source(new FolderListSource(*this));
+    AsyncWebServerResponse* response = request->beginChunkedResponse("application/json",
+        [source](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+            return source->fill(buffer, maxLen);
+        });
+    request->send(response);
+}
+
+void WebSetupServer::handleSelect(AsyncWebServerRequest* request) {
+    const String& folder = request->arg("folder");
+    if (folder.isEmpty()) {
+        sendJson(request, 400, "{\"error\":\"folder required\"}");
+        return;
+    }
+    if (!lock()) {
+        sendJson(request, 503, "{\"error\":\"busy\"}");
+        return;
+    }
+    selectedFolder = folder;
+    waitingForTag = true;
+    tagEventSent = false;
+    lastUid = "";
+    unlock();
+    sendJson(request, 200, "{\"status\":\"waiting_tag\"}");
 }
 
+// ============================================================================
+// MAPPINGS
+// ============================================================================
+
 bool WebSetupServer::normalizeUid(String& uid) const {
     if (uid.isEmpty()) return false;
     uid.toUpperCase();
@@ -579,18 +532,23 @@ bool WebSetupServer::reassignMapping(const String& uid, const String& folder, St
     return mappingStore->rebind(uid, folder);
 }
 
-void WebSetupServer::handleAssign() {
-    String uid = server.arg("uid");
-    String folder = server.arg("folder");
-    bool force = server.arg("force") == "1";
+void WebSetupServer::handleAssign(AsyncWebServerRequest* request) {
+    String uid = request->arg("uid");
+    const String& folder = request->arg("folder");
+    bool force = request->arg("force") == "1";
 
     if (uid.isEmpty() || folder.isEmpty()) {
-        sendJson(400, "{\"error\":\"uid and folder required\"}");
+        sendJson(request, 400, "{\"error\":\"uid and folder required\"}");
         return;
     }
 
     if (!normalizeUid(uid)) {
-        sendJson(400, "{\"error\":\"invalid uid\"}");
+        sendJson(request, 400, "{\"error\":\"invalid uid\"}");
+        return;
+    }
+
+    if (!lock()) {
+        sendJson(request, 503, "{\"error\":\"busy\"}");
         return;
     }
 
@@ -598,174 +556,323 @@ void WebSetupServer::handleAssign() {
     if (mappingStore->getPathFor(uid, existingPath)) {
         if (existingPath == folder) {
             waitingForTag = false;
-            sendJson(200, "{\"status\":\"already_assigned_same\"}");
+            queueTagRecord(uid, folder);   // Cards mapped before records were on
+            unlock();
+            sendJson(request, 200, "{\"status\":\"already_assigned_same\"}");
             return;
         }
         if (!force) {
-            String resp = "{\"status\":\"conflict\",\"folder\":\"" + existingPath + "\"}";
-            sendJson(200, resp);
+            unlock();
+            sendStatus(request, 200, "conflict", "folder", existingPath);
             return;
         }
         String previous;
-        if (reassignMapping(uid, folder, previous)) {
+        bool reassigned = reassignMapping(uid, folder, previous);
+        catalog.applyChange(*mappingStore, folder, previous);
+        if (reassigned) {
             waitingForTag = false;
-            sendJson(200, "{\"status\":\"reassigned\",\"previous\":\"" + previous + "\"}");
+            queueTagRecord(uid, folder);
+        }
+        unlock();
+        if (reassigned) {
+            sendStatus(request, 200, "reassigned", "previous", previous);
         } else {
-            sendJson(500, "{\"error\":\"reassign failed\"}");
+            sendJson(request, 500, "{\"error\":\"reassign failed\"}");
         }
         return;
     }
 
-    if (appendMapping(uid, folder)) {
+    bool appended = appendMapping(uid, folder);
+    catalog.applyChange(*mappingStore, folder);
+    if (appended) {
         waitingForTag = false;
-        sendJson(200, "{\"status\":\"assigned\"}");
+        queueTagRecord(uid, folder);
+    }
+    unlock();
+    if (appended) {
+        sendJson(request, 200, "{\"status\":\"assigned\"}");
     } else {
-        sendJson(500, "{\"error\":\"append failed\"}");
+        sendJson(request, 500, "{\"error\":\"append failed\"}");
     }
 }
 
-void WebSetupServer::handleReassign() {
-    String uid = server.arg("uid");
-    String folder = server.arg("folder");
+void WebSetupServer::handleReassign(AsyncWebServerRequest* request) {
+    String uid = request->arg("uid");
+    const String& folder = request->arg("folder");
     if (uid.isEmpty() || folder.isEmpty()) {
-        sendJson(400, "{\"error\":\"uid and folder required\"}");
+        sendJson(request, 400, "{\"error\":\"uid and folder required\"}");
         return;
     }
     if (!normalizeUid(uid)) {
-        sendJson(400, "{\"error\":\"invalid uid\"}");
+        sendJson(request, 400, "{\"error\":\"invalid uid\"}");
+        return;
+    }
+    if (!lock()) {
+        sendJson(request, 503, "{\"error\":\"busy\"}");
         return;
     }
 
     String previous;
-    if (reassignMapping(uid, folder, previous)) {
+    bool reassigned = reassignMapping(uid, folder, previous);
+    catalog.applyChange(*mappingStore, folder, previous);
+    if (reassigned) {
         waitingForTag = false;
-        sendJson(200, "{\"status\":\"reassigned\",\"previous\":\"" + previous + "\"}");
+        queueTagRecord(uid, folder);
+    }
+    unlock();
+    if (reassigned) {
+        sendStatus(request, 200, "reassigned", "previous", previous);
     } else {
-        sendJson(500, "{\"error\":\"reassign failed\"}");
+        sendJson(request, 500, "{\"error\":\"reassign failed\"}");
     }
 }
 
-void WebSetupServer::handleDone() {
-    sendJson(200, "{\"status\":\"ok\"}");
-    // Give the response a brief moment to flush before stopping AP
-    delay(150);
-    stop();
-}
+// Many assignments with one mapping file rewrite:
+//   {"items":[{"uid":"04A1..","folder":"/Music/A","force":false},...],"atomic":false}
+// Items are checked against the stored mappings and each other; "atomic"
+// commits nothing if any item is rejected. The reply lists a status per item
+// (same names as /assign) and the time spent validating and writing.
+void WebSetupServer::handleAssignBatch(AsyncWebServerRequest* request) {
+    if (request->contentLength() > MAX_BATCH_BODY_SIZE) {
+        sendJson(request, 413, "{\"error\":\"Payload too large\"}");
+        return;
+    }
 
-void WebSetupServer::handleBattery() {
-    StaticJsonDocument<128> doc;
-    if (!batteryManager || !batteryManager->isInitialized()) {
-        doc["status"] = "unavailable";
-    } else {
-        doc["status"] = "ok";
-        doc["percentage"] = batteryManager->getBatteryPercentage();
-        doc["voltage"] = batteryManager->getBatteryVoltage();
+    // Parse in place - strings stay in the request body
+    char* body = (char*)request->_tempObject;
+    DynamicJsonDocument doc(JSON_ARRAY_SIZE(MAX_BATCH_ITEMS) + MAX_BATCH_ITEMS * JSON_OBJECT_SIZE(3) + JSON_OBJECT_SIZE(2));
+    if (!body || deserializeJson(doc, body)) {
+        sendJson(request, 400, "{\"error\":\"Invalid JSON payload\"}");
+        return;
     }
-    String body;
-    serializeJson(doc, body);
-    sendJson(200, body);
-}
 
-void WebSetupServer::handleSettingsJson() {
-    StaticJsonDocument<256> doc;
-    if (!settingsManager) {
-        doc["error"] = "Settings unavailable";
-        String body;
-        serializeJson(doc, body);
-        sendJson(500, body);
+    JsonArrayConst list = doc["items"];
+    if (list.isNull() || list.size() == 0) {
+        sendJson(request, 400, "{\"error\":\"items required\"}");
         return;
     }
+    if (list.size() > MAX_BATCH_ITEMS) {
+        sendJson(request, 413, "{\"error\":\"Too many items\"}");
+        return;
+    }
+    const bool atomic = doc["atomic"] | false;
+
+    std::vector<BatchItem> items;
+    items.reserve(list.size());
+    for (JsonObjectConst entry : list) {
+        items.push_back(BatchItem(entry["uid"] | "", entry["folder"] | "", entry["force"] | false));
+    }
 
-    const Settings& s = settingsManager->getSettings();
-    doc["defaultVolume"] = s.defaultVolume;
-    doc["maxVolume"] = s.maxVolume;
-    doc["wifiSSID"] = s.wifiSSID;
-    doc["wifiPassword"] = s.wifiPassword;
-    doc["sleepTimeout"] = s.sleepTimeout;
-    doc["batteryCheckInterval"] = s.batteryCheckInterval;
+    if (!lock()) {
+        sendJson(request, 503, "{\"error\":\"busy\"}");
+        return;
+    }
+    const uint32_t startUs = micros();
+    const bool written = mappingStore->commitBatch(items, atomic);
+    const uint32_t commitUs = micros() - startUs;
+    catalog.refresh(*mappingStore);   // Many paths changed - one merge
+    waitingForTag = false;
+    unlock();
+
+    size_t committed = 0;
+    size_t rejected = 0;
+    for (const BatchItem& item : items) {
+        if (item.status == BatchStatus::ASSIGNED || item.status == BatchStatus::REASSIGNED) {
+            committed++;
+        } else if (item.status != BatchStatus::UNCHANGED) {
+            rejected++;
+        }
+    }
+    LOG_INFO("[WEB-SETUP] Batch assign: %u items, %u committed, %u rejected in %lu ms",
+             (unsigned)items.size(), (unsigned)committed, (unsigned)rejected, (unsigned long)(commitUs / 1000));
+
+    AsyncResponseStream* response = request->beginResponseStream("application/json");
+    response->setCode(written ? 200 : 500);
+    {
+        JsonStreamWriter json(*response);
+        json.beginObject();
+        json.add("status", !written ? "write_failed" : rejected == 0 ? "ok" : committed > 0 ? "partial" : "rejected");
+        json.add("committed", (unsigned int)committed);
+        json.add("rejected", (unsigned int)rejected);
+        json.add("commitMs", commitUs / 1000.0, 1);
+        json.beginArray("items");
+        for (const BatchItem& item : items) {
+            json.beginObject();
+            json.add("uid", item.uid);
+            json.add("folder", item.path);
+            json.add("status", MappingStore::getBatchStatusName(item.status));
+            if (item.previous.length() > 0) {
+                json.add(item.status == BatchStatus::PATH_CONFLICT ? "owner" : "previous", item.previous);
+            }
+            json.endObject();
+        }
+        json.endArray();
+        json.endObject();
+    }
+    request->send(response);
+}
 
-    String body;
-    serializeJson(doc, body);
-    sendJson(200, body);
+// The server cannot be stopped from its own task - loop() does it once the
+// response has had STOP_DELAY_MS to go out
+void WebSetupServer::handleDone(AsyncWebServerRequest* request) {
+    sendJson(request, 200, "{\"status\":\"ok\"}");
+    stopRequestedMs = millis();
+    stopRequested = true;
 }
 
-void WebSetupServer::handleSettingsSave() {
-    StaticJsonDocument<256> errorDoc;
+// ============================================================================
+// BATTERY AND SETTINGS
+// ============================================================================
+
+// Latest reading, runtime estimate and the sample ring, served from RAM (no
+// I2C). Samples are [seconds since boot, mV, SOC in 0.01 %, decode load 0-255].
+void WebSetupServer::handleBattery(AsyncWebServerRequest* request) {
+    if (!batteryManager || !batteryManager->isInitialized()) {
+        sendJson(request, 200, "{\"status\":\"unavailable\"}");
+        return;
+    }
+
+    // The main loop keeps appending readings - work on a copy
+    BatterySample samples[Battery_Manager::HISTORY_SIZE];
+    const uint8_t count = batteryManager->copySamples(samples, Battery_Manager::HISTORY_SIZE);
+
+    AsyncResponseStream* response = request->beginResponseStream("application/json");
+    {
+        JsonStreamWriter json(*response);
+        json.beginObject();
+        json.add("status", "ok");
+        json.add("percentage", batteryManager->getBatteryPercentage());
+        json.add("voltage", batteryManager->getBatteryVoltage(), 3);
+        json.add("intervalS", batteryManager->getReadingInterval() / 1000);
+        json.add("remainingMin", batteryManager->getRemainingMinutes(1.0f), 0);
+        json.add("idleRemainingMin", batteryManager->getRemainingMinutes(0.0f), 0);
+        json.beginArray("samples");
+        for (uint8_t i = 0; i < count; i++) {
+            json.beginArray();
+            json.add(nullptr, (unsigned long)samples[i].timeS);
+            json.add(nullptr, (unsigned int)samples[i].millivolts);
+            json.add(nullptr, (unsigned int)samples[i].socCenti);
+            json.add(nullptr, (unsigned int)samples[i].decodeLoad);
+            json.endArray();
+        }
+        json.endArray();
+        json.endObject();
+    }
+    request->send(response);
+}
+
+void WebSetupServer::handleSettingsJson(AsyncWebServerRequest* request) {
     if (!settingsManager) {
-        errorDoc["error"] = "Settings unavailable";
-        String body; serializeJson(errorDoc, body);
-        sendJson(500, body);
+        sendJson(request, 500, "{\"error\":\"Settings unavailable\"}");
         return;
     }
 
-    StaticJsonDocument<512> doc;
-    DeserializationError err = deserializeJson(doc, server.arg("plain"));
-    if (err) {
-        errorDoc["error"] = "Invalid JSON payload";
-        String body; serializeJson(errorDoc, body);
-        sendJson(400, body);
+    // Settings are changed by the main loop; answer from a copy (or from
+    // the ones still waiting for loop())
+    if (!lock()) {
+        sendJson(request, 503, "{\"error\":\"busy\"}");
         return;
     }
+    const Settings current = settingsPending ? pendingSettings : settingsManager->getSettings();
+    unlock();
 
-    Settings next = settingsManager->getSettings();
-    if (doc.containsKey("defaultVolume")) {
-        next.defaultVolume = doc["defaultVolume"];
+    AsyncResponseStream* response = request->beginResponseStream("application/json");
+    {
+        JsonStreamWriter json(*response);
+        json.beginObject();
+        SettingsSchema::write(json, current);
+        json.endObject();
     }
-    if (doc.containsKey("maxVolume")) {
-        next.maxVolume = doc["maxVolume"];
+    request->send(response);
+}
+
+// Body callback: collect the POST body into _tempObject (freed with the
+// request). Bodies over the route's limit are not stored and get a 413.
+void WebSetupServer::collectBody(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total, size_t limit) {
+    if (total > limit) {
+        return;
     }
-    if (doc.containsKey("wifiSSID")) {
-        const char* ssid = doc["wifiSSID"] | "";
-        strncpy(next.wifiSSID, ssid, sizeof(next.wifiSSID) - 1);
-        next.wifiSSID[sizeof(next.wifiSSID) - 1] = '\0';
+    if (index == 0) {
+        request->_tempObject = malloc(total + 1);
     }
-    if (doc.containsKey("wifiPassword")) {
-        const char* pwd = doc["wifiPassword"] | "";
-        strncpy(next.wifiPassword, pwd, sizeof(next.wifiPassword) - 1);
-        next.wifiPassword[sizeof(next.wifiPassword) - 1] = '\0';
+    char* body = (char*)request->_tempObject;
+    if (!body || index + len > total) {
+        return;
     }
-    if (doc.containsKey("sleepTimeout")) {
-        next.sleepTimeout = doc["sleepTimeout"];
+    memcpy(body + index, data, len);
+    if (index + len == total) {
+        body[total] = '\0';
     }
-    if (doc.containsKey("batteryCheckInterval")) {
-        next.batteryCheckInterval = doc["batteryCheckInterval"];
+}
+
+void WebSetupServer::handleSettingsSave(AsyncWebServerRequest* request) {
+    if (!settingsManager) {
+        sendJson(request, 500, "{\"error\":\"Settings unavailable\"}");
+        return;
     }
 
-    settingsManager->updateSettings(next);
-    if (!settingsManager->validateSettings()) {
-        errorDoc["error"] = "Validation failed";
-        String body; serializeJson(errorDoc, body);
-        sendJson(400, body);
+    if (request->contentLength() > MAX_BODY_SIZE) {
+        sendJson(request, 413, "{\"error\":\"Payload too large\"}");
         return;
     }
 
-    if (!settingsManager->saveSettings()) {
-        errorDoc["error"] = "Save failed";
-        String body; serializeJson(errorDoc, body);
-        sendJson(500, body);
+    const char* body = (const char*)request->_tempObject;
+    if (!body) {
+        sendJson(request, 400, "{\"error\":\"Invalid JSON payload\"}");
         return;
     }
 
-    StaticJsonDocument<64> okDoc;
-    okDoc["status"] = "ok";
-    String body; serializeJson(okDoc, body);
-    sendJson(200, body);
-}
+    if (!lock()) {
+        sendJson(request, 503, "{\"error\":\"busy\"}");
+        return;
+    }
 
-void WebSetupServer::refreshFolders() {
-    std::vector<String> allPaths;
-    if (!sdScanner->listAudioDirs(SD_MMC, contentRoot, allPaths)) {
-        LOG_ERROR("[WEB-SETUP] Failed to list audio dirs");
-        unassignedFolders.clear();
+    // Apply the body to a copy; nothing changes unless the result validates
+    Settings next = settingsPending ? pendingSettings : settingsManager->getSettings();
+    const char* rejected = nullptr;
+    const char* invalid = nullptr;
+    const char* errorBody = nullptr;
+    int statusCode = 200;
+    if (!SettingsSchema::parse(body, next, nullptr, &rejected)) {
+        errorBody = "{\"error\":\"Invalid JSON payload\"}";
+        statusCode = 400;
+    } else if (rejected || !SettingsSchema::validate(next, &invalid)) {
+        LOG_WARN("[WEB-SETUP] Settings field rejected: %s", rejected ? rejected : invalid);
+        errorBody = "{\"error\":\"Validation failed\"}";
+        statusCode = 400;
+    } else {
+        // No SD access from this task: loop() applies them, the main loop writes
+        pendingSettings = next;
+        settingsPending = true;
+    }
+    unlock();
+
+    if (errorBody) {
+        sendJson(request, statusCode, errorBody);
         return;
     }
 
-    unassignedFolders.clear();
-    for (const String& path : allPaths) {
-        String dummy;
-        if (!mappingStore->getUidFor(path, dummy)) {
-            unassignedFolders.push_back(path);
+    sendJson(request, 200, "{\"status\":\"ok\"}");
+}
+
+// Scan outside the lock (only when asked or not cached), then bring the
+// assigned flags up to date under it
+void WebSetupServer::refreshFolders(bool rescan) {
+    std::vector<String> paths;
+    bool scannedNow = false;
+    if (rescan || !catalog.isScanned(contentRoot)) {
+        if (!sdScanner->listAudioDirs(SD_MMC, contentRoot, paths)) {
+            LOG_ERROR("[WEB-SETUP] Failed to list audio dirs");
+        } else {
+            scannedNow = true;
+        }
+    }
+
+    if (lock()) {
+        if (scannedNow) {
+            catalog.setFolders(contentRoot, paths);
         }
+        catalog.refresh(*mappingStore);
+        unlock();
     }
 }
-
@@ -19,7 +19,13 @@
 #include "Battery_Manager.h"
 #include "SdScanner.h"
 #include "MappingStore.h"
+#include "SetupMode.h"
 #include "WebSetupServer.h"
+#include "BootOrchestrator.h"
+#include "SessionStore.h"
+#include "OutputRouter.h"
+#include "PowerGovernor.h"
+#include "LedRenderer.h"
 #include "Logger.h"
 #include <WiFi.h>
 
@@ -68,15 +74,24 @@ Rotary_Manager rotaryManager(ROTARY_CLK_PIN, ROTARY_DT_PIN, -1);  // clk_pin, dt
 Settings_Manager settingsManager("/settings.json");  // settings file path
 RFID_Manager rfidManager(SPI_SCLK, SPI_MISO, SPI_MOSI, SPI_SS);  // sclk, miso, mosi, ss
 Battery_Manager batteryManager; // Battery manager instance
+SessionStore sessionStore;      // Last session (NVS) for instant-on resume
 
 // Setup components
 SdScanner sdScanner;
 MappingStore mappingStore;
 WebSetupServer webSetupServer;
+SetupMode setupMode;            // Card auto-assign, started by holding Play/Pause with no card
 
 // Forward declaration for external triggers (e.g., config button) to start the captive portal
 static void startCaptivePortal();
 
+// Forward declarations (session resume, deep sleep, background boot completion)
+static void saveSession();
+static void prepareDeepSleep();
+static void completeBoot();
+static bool g_bootComplete = false;
+static BootOrchestrator bootOrchestrator;
+
 // ============================================================================
 // AUDIO MANAGER CONFIGURATION
 // ============================================================================
@@ -101,102 +116,49 @@ Audio_Manager audioManager("/test_music", "mp3", FileSelectionMode::BUILTIN);  /
 // GLOBAL HEADPHONE/SPEAKER ROUTING
 // ============================================================================
 
-// Headphone routing is now handled by DAC_Manager.updateHeadphoneRouting()
-// The old global variables and constants have been removed
-
-// --- Simple GPIO-based headphone detection using GPIO33
-static const uint8_t HP_GPIO_PIN = 33;  // GPIO33 connected to DAC MIC pin
-static const uint16_t HP_READ_INTERVAL = 100;  // Read every 100ms
-static const uint8_t HP_CONSECUTIVE_READS = 3;  // Need 3 consecutive readings to confirm change
-
-static bool g_currentHPState = false;     // Current headphone state (true=headphones, false=speaker)
-static bool g_targetHPState = false;      // Target state we're moving toward
-static uint8_t g_consecutiveCount = 0;    // Count of consecutive readings in target state
-static uint32_t g_lastHPRead = 0;         // Last time we read the GPIO
-static bool g_lastGPIOReading = false;    // Previous GPIO reading to detect changes
-
-static void applyRoute(bool hp) {
-  LOG_DEBUG("[HP-DET] applyRoute called with hp=%s", hp ? "true" : "false");
-  
-  // Disable speaker when headphones are present, enable when they're not
-  bool speakerShouldBeEnabled = !hp;
-  LOG_DEBUG("[HP-DET] Speaker should be %s", speakerShouldBeEnabled ? "ENABLED" : "DISABLED");
-
-  // Control external speaker amplifier shutdown (PAM8302A on SPEAKER_SD_PIN)
-  digitalWrite(SPEAKER_SD_PIN, speakerShouldBeEnabled ? HIGH : LOW);
-  LOG_DEBUG("[HP-DET] PAM8302A SD (GPIO%d) set to %s", SPEAKER_SD_PIN,
-            speakerShouldBeEnabled ? "HIGH (ON)" : "LOW (SHUTDOWN)");
-
-  // Also set speaker volume to 0 when disabled to ensure it's really off
-  if (!speakerShouldBeEnabled) {
-    dacManager.setSpeakerVolume(0);
-    LOG_DEBUG("[HP-DET] Speaker volume set to 0 for complete muting");
-  } else {
-    audioManager.pausePlayback();  // Pause audio playback when switching routes
-    delay(250);  // Small delay to ensure audio stops before changing route
-    // Restore speaker volume to default when enabling speaker output
-    dacManager.setSpeakerVolume(6); // Restore normal volume
-    LOG_DEBUG("[HP-DET] Speaker volume restored to 6");
-  }
+// Jack detect on GPIO33 (connected to DAC MIC pin, LOW = headphones in).
+// Route changes are interrupt-driven and ramped by OutputRouter.
+static const uint8_t HP_GPIO_PIN = 33;
 
-  dacManager.enableSpeaker(speakerShouldBeEnabled);
-  
-  LOG_INFO("[HP-DET] ROUTE -> %s (Speaker: %s)", 
-           hp ? "HEADPHONES" : "SPEAKER",
-           speakerShouldBeEnabled ? "ON" : "OFF");
-}
+OutputRouter outputRouter(dacManager, audioManager, HP_GPIO_PIN, SPEAKER_SD_PIN);
 
-static void updateOutputRoute(bool force = false) {
-  const uint32_t now = millis();
-  
-  // Read GPIO at regular intervals
-  if (now - g_lastHPRead >= HP_READ_INTERVAL) {
-    g_lastHPRead = now;
-    
-    // Read GPIO33 (0=headphones in, 1=headphones out)
-    bool gpioReading = !digitalRead(HP_GPIO_PIN); // Invert: 0 becomes true (headphones), 1 becomes false (speaker)
-    
-    // Only start counting if there's a change from previous reading
-    if (gpioReading != g_lastGPIOReading) {
-      // Reset count and update target state
-      g_consecutiveCount = 1;
-      g_targetHPState = gpioReading;
-      LOG_DEBUG("[HP-DET] GPIO33: %d -> %s (Starting count: %d/3)", 
-                digitalRead(HP_GPIO_PIN), 
-                gpioReading ? "HEADPHONES" : "SPEAKER",
-                g_consecutiveCount);
-    } else if (gpioReading == g_targetHPState && g_consecutiveCount < HP_CONSECUTIVE_READS) {
-      // Continue counting if same state and not yet reached 3
-      g_consecutiveCount++;
-      LOG_DEBUG("[HP-DET] Consecutive count: %d/3 for %s", 
-                g_consecutiveCount,
-                g_targetHPState ? "HEADPHONES" : "SPEAKER");
-    }
-    
-    // Update previous reading
-    g_lastGPIOReading = gpioReading;
-    
-    // If we have enough consecutive readings, apply the change
-    if (g_consecutiveCount >= HP_CONSECUTIVE_READS && g_targetHPState != g_currentHPState) {
-      g_currentHPState = g_targetHPState;
-      applyRoute(g_currentHPState);
-      LOG_INFO("[HP-DET] State confirmed: %s after %d consecutive readings", 
-               g_currentHPState ? "HEADPHONES" : "SPEAKER", HP_CONSECUTIVE_READS);
-    }
+// ============================================================================
+// POWER MANAGEMENT
+// ============================================================================
+// CPU clock follows playback; between RFID polls the idle loop light-sleeps.
+// After settings.sleepTimeout minutes without input the device deep-sleeps and
+// the encoder wakes it (the next boot resumes the saved session).
+
+PowerGovernor powerGovernor;
+
+// RFID poll period; also the longest light sleep between loop iterations
+static const uint32_t RFID_POLL_MS = 100;
+
+// Play/Pause held this long with no card on the reader starts auto-assign
+static const uint32_t AUTO_ASSIGN_HOLD_MS = 2000;
+
+// Pending settings are written without the usual delay below this charge
+static const float SETTINGS_FLUSH_BATTERY_PERCENT = 5.0f;
+
+// ============================================================================
+// LOOP STALL MONITOR
+// ============================================================================
+// Loop iterations (excluding the trailing delay) longer than LOOP_STALL_MS
+// risk draining the I2S buffers; the time above the threshold is summed.
+
+static const uint32_t LOOP_STALL_MS = 20;
+
+static uint32_t g_loopStallCount = 0;
+static uint32_t g_loopStalledMs = 0;
+static uint32_t g_loopMaxMs = 0;
+
+static void recordLoopDuration(uint32_t durationMs) {
+  if (durationMs > g_loopMaxMs) {
+    g_loopMaxMs = durationMs;
   }
-  
-  // Force initial route on first call
-  if (force) {
-    // Read current GPIO state and set initial route
-    bool initialHP = !digitalRead(HP_GPIO_PIN);
-    g_currentHPState = initialHP;
-    g_targetHPState = initialHP;
-    g_lastGPIOReading = initialHP;
-    g_consecutiveCount = HP_CONSECUTIVE_READS; // Start with confirmed state
-    
-    applyRoute(g_currentHPState);
-    LOG_INFO("[HP-DET] Initial route: %s (GPIO33: %d)", 
-             g_currentHPState ? "HEADPHONES" : "SPEAKER", digitalRead(HP_GPIO_PIN));
+  if (durationMs > LOOP_STALL_MS) {
+    g_loopStallCount++;
+    g_loopStalledMs += durationMs - LOOP_STALL_MS;
   }
 }
 
@@ -204,8 +166,9 @@ static void updateOutputRoute(bool force = false) {
 // GLOBAL VARIABLES
 // ============================================================================
 
-// WLED array
+// WLED array and the renderer that owns it
 CRGB leds[NUM_LEDS];
+LedRenderer ledRenderer(leds, NUM_LEDS);
 
 // SD card status (legacy - now handled by SD_Manager)
 bool sdCardMounted = false;
@@ -213,29 +176,6 @@ bool sdCardMounted = false;
 // DAC status
 bool dacInitialized = false;
 
-// ============================================================================
-// LED FUNCTIONS
-// ============================================================================
-
-// Function to flash red LED 3 times for unknown RFID cards
-void flashRedLED(int times = 3, int flashDuration = 200, int pauseDuration = 150) {
-    for (int i = 0; i < times; i++) {
-        // Flash red
-        leds[0] = CRGB::Red;
-        FastLED.show();
-        delay(flashDuration);
-        
-        // Turn off
-        leds[0] = CRGB::Black;
-        FastLED.show();
-        
-        // Pause between flashes (except after last flash)
-        if (i < times - 1) {
-            delay(pauseDuration);
-        }
-    }
-}
-
 // ============================================================================
 // BUTTON HANDLING FUNCTIONS
 // ============================================================================
@@ -260,7 +200,7 @@ void handleButtonPress(ButtonType buttonType) {
 
     if (tagPresent) {
         LOG_DEBUG("RFID tag present: %s - buttons enabled",
-                            rfidManager.getLastDetectedUIDString().c_str());
+                            rfidManager.getLastDetectedUIDCStr());
     } else if (audioActive) {
         LOG_INFO("Tag not detected, but audio is active - allowing transport control");
     }
@@ -284,6 +224,8 @@ void handleButtonPress(ButtonType buttonType) {
         if (audioManager.isPlaying()) {
           if (!audioManager.pausePlayback()) {
             LOG_ERROR("Failed to pause: %s", audioManager.getLastError());
+          } else {
+            saveSession();
           }
         } else {
           if (!audioManager.resumePlayback()) {
@@ -316,10 +258,175 @@ void handleButtonPress(ButtonType buttonType) {
       break;
   }
 }
+
+// ============================================================================
+// IN-TRACK SCRUB (HELD NEXT/PREVIOUS)
+// ============================================================================
+
+// A short press on Next/Previous changes track on release. Holding the button
+// instead seeks within the current track, with a step that grows the longer
+// the button is held (useful for long audiobook chapters).
+static const uint32_t SCRUB_HOLD_MS = 600;            // Hold time before scrubbing starts
+static const uint32_t SCRUB_STEP_INTERVAL_MS = 200;   // One seek step every 200ms
+
+struct ScrubRate {
+  uint32_t scrubbingMs;  // Rate applies once scrubbing has lasted this long
+  int32_t stepMs;        // Seek distance per step
+};
+
+static const ScrubRate kScrubRates[] = {
+  {0,     2000},   // 10x
+  {3000,  5000},   // 25x
+  {6000,  15000},  // 75x
+  {10000, 30000},  // 150x
+};
+
+static bool g_scrubActive = false;       // Scrub happened during the current hold
+static uint32_t g_lastScrubStep = 0;
+
+static bool isScrubButton(ButtonType button) {
+  return button == BUTTON_NEXT || button == BUTTON_PREVIOUS;
+}
+
+static void updateScrub(ButtonType button, uint32_t heldMs) {
+  if (heldMs < SCRUB_HOLD_MS || !audioManager.isPlaying()) {
+    return;
+  }
+
+  const uint32_t now = millis();
+  if (g_scrubActive && now - g_lastScrubStep < SCRUB_STEP_INTERVAL_MS) {
+    return;
+  }
+  if (!g_scrubActive) {
+    g_scrubActive = true;
+    LOG_INFO("Scrub %s started", button == BUTTON_NEXT ? "forward" : "backward");
+  }
+  g_lastScrubStep = now;
+
+  const uint32_t scrubbingMs = heldMs - SCRUB_HOLD_MS;
+  int32_t stepMs = kScrubRates[0].stepMs;
+  for (const ScrubRate& rate : kScrubRates) {
+    if (scrubbingMs >= rate.scrubbingMs) {
+      stepMs = rate.stepMs;
+    }
+  }
+  if (button == BUTTON_PREVIOUS) {
+    stepMs = -stepMs;
+  }
+
+  if (!audioManager.seekRelativeMs(stepMs)) {
+    LOG_WARN("Scrub step failed: %s", audioManager.getLastError());
+    return;
+  }
+  LOG_DEBUG("Scrub step %+ld ms -> %lu ms (seek %lu us)", (long)stepMs,
+            (unsigned long)audioManager.getPositionMs(), (unsigned long)audioManager.getLastSeekLatencyUs());
+}
+
+// ============================================================================
+// SESSION RESUME
+// ============================================================================
+// The last session (tag, folder, track, position, volume) is saved to NVS
+// on pause/stop. At boot playback resumes from it as soon as the SD card and
+// the codec are up, before the rest of init has finished. The card on the
+// reader then only confirms the session; if it does not show up within
+// RESUME_CONFIRM_TIMEOUT_MS of the reader polling, playback is paused again.
+
+static const uint32_t RESUME_CONFIRM_TIMEOUT_MS = 1500;  // Several RFID polls + debounce
+
+static String g_sessionUid;                 // Card that owns the current playback
+static bool g_resumeAwaitingTag = false;    // Resumed from NVS, card not seen yet
+static bool g_resumeAudioPending = false;   // First resumed buffer not written yet
+static bool g_resumedAtBoot = false;
+static uint32_t g_resumeConfirmDeadline = 0;
+
+// Save the current playback position as the last session
+static void saveSession() {
+  const int trackIndex = audioManager.getCurrentTrackIndex();
+  if (g_sessionUid.length() == 0 || trackIndex < 0) {
+    return;
+  }
+
+  SessionRecord session;
+  memset(&session, 0, sizeof(session));
+  strncpy(session.uid, g_sessionUid.c_str(), sizeof(session.uid) - 1);
+  strncpy(session.folder, audioManager.getAudioFolder().c_str(), sizeof(session.folder) - 1);
+  session.trackIndex = trackIndex;
+  session.byteOffset = audioManager.getCurrentByteOffset();
+  session.volume = audioManager.getVolume();
+  session.positionMs = audioManager.getPositionMs();
+  session.durationMs = audioManager.getDurationMs();
+
+  if (!sessionStore.save(session)) {
+    LOG_WARN("[RESUME] Failed to save session: %s", sessionStore.getLastError());
+  }
+}
+
+// Quiet everything that draws current before deep sleep
+static void prepareDeepSleep() {
+  saveSession();
+  settingsManager.flush();
+  audioManager.stopPlayback();
+  digitalWrite(SPEAKER_SD_PIN, LOW);
+  dacManager.enableSpeaker(false);
+  rfidManager.powerDown();
+  ledRenderer.blank();
+}
+
+// Start playback from the stored session (boot critical path)
+static bool resumeLastSession() {
+  if (!sessionStore.hasSession()) {
+    return false;
+  }
+
+  const SessionRecord& session = sessionStore.getSession();
+  audioManager.setVolume(session.volume);
+  if (!audioManager.resumeTrack(session.folder, session.trackIndex, session.byteOffset)) {
+    LOG_WARN("[RESUME] Could not resume %s: %s", session.folder, audioManager.getLastError());
+    sessionStore.clear();
+    return false;
+  }
+
+  g_sessionUid = session.uid;
+  g_resumedAtBoot = true;
+  g_resumeAwaitingTag = true;
+  g_resumeAudioPending = true;
+  rfidManager.expectTag(session.uid);  // Same card must not restart the folder
+  LOG_INFO("[RESUME] Resuming %s for card %s", session.folder, session.uid);
+  return true;
+}
+
+// Returns true if this tag event is the resumed card confirming the session
+static bool confirmResumedTag(const char* uid) {
+  if (!g_resumeAwaitingTag) {
+    return false;
+  }
+  g_resumeAwaitingTag = false;
+
+  if (g_sessionUid == uid) {
+    LOG_INFO("[RESUME] Card %s confirmed resumed session", uid);
+    return true;
+  }
+  LOG_INFO("[RESUME] Different card %s presented - leaving resumed session", uid);
+  return false;
+}
+
+// Pause the resumed playback if its card never showed up
+static void updateResumeConfirmation() {
+  if (!g_resumeAwaitingTag || (int32_t)(millis() - g_resumeConfirmDeadline) < 0) {
+    return;
+  }
+  g_resumeAwaitingTag = false;
+  LOG_INFO("[RESUME] Card not on reader - pausing resumed playback");
+  if (audioManager.isPlaying() && audioManager.pausePlayback()) {
+    saveSession();
+  }
+}
+
 // ============================================================================
 // DEBUG FUNCTIONS
 // ============================================================================
 
+#if LOG_COMPILE_LEVEL >= 3
 void listAllSDContents(const char* path, int depth = 0) {
     File root = SD_MMC.open(path);
     if (!root) {
@@ -375,6 +482,7 @@ void listAllSDContents(const char* path, int depth = 0) {
     
     root.close();
 }
+#endif // LOG_COMPILE_LEVEL >= 3
 
 // Convenience helper to start the captive portal/web setup from other triggers
 static void startCaptivePortal() {
@@ -396,26 +504,35 @@ void loop() {
     static bool prevWebSetupActive = false;
     static uint32_t lastWebSetupStopMs = 0;
     static bool webSetupJustStopped = false;
+    const uint32_t loopStartMs = millis();
+    
+    // Finish the background boot stages once they are done
+    if (!g_bootComplete && bootOrchestrator.isFinished()) {
+        completeBoot();
+    }
     
     // Update button states
     buttonManager.update();
     
-    // Update RFID detection (needed for both normal mode and setup mode)
+    // Update RFID detection (needed for both normal mode and setup mode).
+    // The reader is owned by its boot stage until that stage finishes.
     static uint32_t lastRFID = 0;
-    if (millis() - lastRFID >= 100) { // 10 Hz max
+    if (bootOrchestrator.isStageFinished("rfid") && millis() - lastRFID >= RFID_POLL_MS) { // 10 Hz max
         rfidManager.update();
         lastRFID = millis();
     }
+    if (g_bootComplete) {
+        updateResumeConfirmation();
+    }
 
-    // If web setup is active, serve HTTP and skip normal player logic
+    // Web setup is served from the AsyncTCP task; the player keeps running.
+    // loop() hands it the current tag and performs a stop requested by /done.
+    webSetupServer.loop();
     const bool webSetupActive = webSetupServer.isActive();
     if (webSetupActive) {
-        webSetupServer.loop();
         prevWebSetupActive = true;
         webSetupJustStopped = false;
-        return;
-    }
-    if (prevWebSetupActive && !webSetupActive) {
+    } else if (prevWebSetupActive) {
         lastWebSetupStopMs = millis();
         prevWebSetupActive = false;
         webSetupJustStopped = true;
@@ -423,13 +540,39 @@ void loop() {
         delay(10);
     }
     
+    // Card auto-assign: Play/Pause held with no card and nothing playing.
+    // While it runs the buttons belong to SetupMode. A long press released
+    // inside the session must not open the portal afterwards, and the
+    // release that opened the portal must not count again once it closes.
+    static bool autoAssignHoldArmed = true;
+    static bool portalGestureBlocked = false;
+    if (buttonManager.getCurrentButton() == BUTTON_NONE) {
+        autoAssignHoldArmed = true;
+    }
+    if (g_bootComplete && !webSetupActive && !setupMode.isSetupActive() && autoAssignHoldArmed &&
+        buttonManager.getCurrentButton() == BUTTON_PLAY_PAUSE &&
+        buttonManager.getPressDuration() >= AUTO_ASSIGN_HOLD_MS &&
+        !rfidManager.isTagPresent() && !audioManager.isPlaying()) {
+        autoAssignHoldArmed = false;
+        LOG_INFO("Play/Pause held without a card - starting auto-assign");
+        setupMode.enterAutoAssign();
+    }
+    if (setupMode.isSetupActive()) {
+        setupMode.loop();
+        portalGestureBlocked = true;
+    } else if (buttonManager.getButtonState() == BUTTON_PRESSED) {
+        portalGestureBlocked = false;
+    }
+
     // Enter setup mode on encoder long press release
-    if (buttonManager.getButtonState() == BUTTON_RELEASED_LONG &&
+    if (g_bootComplete && !webSetupActive && !portalGestureBlocked &&
+        buttonManager.getButtonState() == BUTTON_RELEASED_LONG &&
         buttonManager.getLastButton() == BUTTON_ENCODER) {
         // Prevent immediate re-entry right after stopping via web exit
         if (webSetupJustStopped || millis() - lastWebSetupStopMs < 2000) {
             return;
         }
+        portalGestureBlocked = true;
         LOG_INFO("Encoder long press detected - starting Web Setup server");
         if (!webSetupServer.start()) {
             LOG_ERROR("Failed to start Web Setup server");
@@ -438,28 +581,36 @@ void loop() {
     }
     webSetupJustStopped = false;
 
-    // check whether to send audio to speaker or headphones
-    static uint32_t lastPoll = 0;
-
-    // Update headphone detection every 250ms 
-    static uint32_t lastHeadphoneCheck = 0;
-    if (millis() - lastHeadphoneCheck >= 250) {
-        updateOutputRoute(false);
-        lastHeadphoneCheck = millis();
-    }
+    // Step headphone/speaker route changes (non-blocking)
+    outputRouter.update();
 
     // Update button states (throttled to prevent audio interference)
     static uint32_t lastBtn = 0;
     static ButtonType lastButtonState = BUTTON_NONE;
     static bool buttonProcessed = false;
+    static ButtonType pendingSkip = BUTTON_NONE;  // Next/Previous waiting for release
     
-    if (millis() - lastBtn >= 2) { // 500 Hz max
+    if (!setupMode.isSetupActive() && millis() - lastBtn >= 2) { // 500 Hz max
         
         // Check for button presses and handle them with debouncing
         ButtonType currentButton = buttonManager.getCurrentButton();
         
+        // Next/Previous released (or replaced by another button) without
+        // scrubbing - treat it as a normal track change
+        if (pendingSkip != BUTTON_NONE && currentButton != pendingSkip) {
+            if (!g_scrubActive) {
+                LOG_DEBUG("Processing button release: %d", pendingSkip);
+                handleButtonPress(pendingSkip);
+            } else {
+                LOG_INFO("Scrub ended");
+            }
+            pendingSkip = BUTTON_NONE;
+            g_scrubActive = false;
+        }
+        
         if (currentButton != BUTTON_NONE) {
             // Button is pressed
+            powerGovernor.notifyActivity();
             if (lastButtonState != currentButton) {
                 // New button pressed - reset debounce
                 lastButtonState = currentButton;
@@ -469,10 +620,19 @@ void loop() {
             
             // Only process if button was just pressed (not held)
             if (!buttonProcessed && buttonManager.isButtonPressed(currentButton)) {
-                LOG_DEBUG("Processing button press: %d", currentButton);
-                handleButtonPress(currentButton);
+                if (isScrubButton(currentButton)) {
+                    // Decide between track change and scrub once we know how long it is held
+                    pendingSkip = currentButton;
+                } else {
+                    LOG_DEBUG("Processing button press: %d", currentButton);
+                    handleButtonPress(currentButton);
+                }
                 buttonProcessed = true;
             }
+            
+            if (pendingSkip == currentButton) {
+                updateScrub(currentButton, buttonManager.getPressDuration());
+            }
         } else {
             // No button pressed - reset state
             if (lastButtonState != BUTTON_NONE) {
@@ -487,19 +647,41 @@ void loop() {
     
     // Update rotary encoder (throttled to prevent audio interference)
     static uint32_t lastRotary = 0;
+    static uint32_t lastRotaryEvents = 0;
     if (millis() - lastRotary >= 2) { // 500 Hz max
         rotaryManager.update();
         lastRotary = millis();
+        
+        if (rotaryManager.getTotalEvents() != lastRotaryEvents) {
+            lastRotaryEvents = rotaryManager.getTotalEvents();
+            powerGovernor.notifyActivity();
+        }
     }
     
-    // Update battery monitoring (throttled to prevent interference)
-    if (batteryManager.isInitialized()) {
-        batteryManager.update(); // This handles the 5-second timing internally
+    // Battery and settings belong to the background "services" stage until
+    // boot completes
+    if (g_bootComplete) {
+        // Update battery monitoring (throttled to prevent interference)
+        if (batteryManager.isInitialized()) {
+            // Reads every settings.batteryCheckInterval; decode time weights the runtime estimate
+            batteryManager.update(audioManager.isPlaying());
+        }
+
+        // Write changed settings once they settle, at once if the battery is about to give out
+        const bool batteryNearlyEmpty = batteryManager.isInitialized() &&
+                                        batteryManager.getBatteryPercentage() <= SETTINGS_FLUSH_BATTERY_PERCENT;
+        settingsManager.update(batteryNearlyEmpty);
     }
 
     // Handle audio playback after controls to keep UI responsive even if copy() runs long
     if (audioManager.isInitialized()) {
         audioManager.update();
+        
+        // First resumed buffer has reached I2S - report cold-boot-to-audio
+        if (g_resumeAudioPending && audioManager.isPlaying()) {
+            g_resumeAudioPending = false;
+            bootOrchestrator.markFirstAudio();
+        }
     }
     
     // Debug: Print status occasionally
@@ -507,6 +689,16 @@ void loop() {
     if (millis() - lastDebug > 5000) { // Every 5 seconds
         //Serial.printf("Encoder status: value=%d, volume=%.2f\n", 
         //            rotaryManager.getEncoderValue(), rotaryManager.getVolume());
+        if (getLogLevel() >= LogLevel::DEBUG) {
+            rotaryManager.printStats();
+            dacManager.printStats();
+            outputRouter.printStats();
+            powerGovernor.printStats();
+            ledRenderer.printStats();
+            LOG_DEBUG("Loop: %lu stalls > %lu ms, %lu ms stalled, max %lu ms",
+                      (unsigned long)g_loopStallCount, (unsigned long)LOOP_STALL_MS,
+                      (unsigned long)g_loopStalledMs, (unsigned long)g_loopMaxMs);
+        }
         
         // Print audio status
         if (audioManager.isInitialized()) {
@@ -520,111 +712,72 @@ void loop() {
         lastDebug = millis();
     }
     
-    // Keep WLED green to show system is working
+    // Status LED: blue with a tag, green without, pulsing blue while the setup
+    // portal is open, red if a system failed. Battery warnings and flashes are
+    // layered on top by the renderer, which only pushes changed frames.
     if (sdManager.isMounted() && dacInitialized && audioManager.isInitialized()) {
-        if (rfidManager.isTagPresent()) {
-            leds[0] = CRGB::Blue;  // Blue when RFID tag is present
+        if (webSetupActive) {
+            ledRenderer.setBase(LedPattern::pulse(CRGB::Blue, 2000));
+        } else if (setupMode.isSetupActive()) {
+            ledRenderer.setBase(LedPattern::pulse(CRGB::Green, 1000));
         } else {
-            leds[0] = CRGB::Green; // Green when all systems are ready but no tag
-        }
-        
-        // Add battery status indication (blink pattern)
-        static uint32_t lastBatteryBlink = 0;
-        static bool batteryBlinkState = false;
-        
-        if (batteryManager.isInitialized()) {
-            unsigned long currentMillis = millis();
-            if (currentMillis - lastBatteryBlink >= 2000) { // Every 2 seconds
-                lastBatteryBlink = currentMillis;
-                batteryBlinkState = !batteryBlinkState;
-                
-                // Show battery level with blink pattern
-                if (batteryBlinkState) {
-                    float batteryLevel = batteryManager.getBatteryPercentage();
-                    if (batteryLevel > 50.0f) {
-                        // Battery good - keep current color
-                    } else if (batteryLevel > 20.0f) {
-                        // Battery low - blink yellow
-                        leds[0] = CRGB::Yellow;
-                    } else {
-                        // Battery critical - blink red
-                        leds[0] = CRGB::Red;
-                    }
-                }
-            }
+            ledRenderer.setBase(LedPattern::solid(rfidManager.isTagPresent() ? CRGB::Blue : CRGB::Green));
         }
+        ledRenderer.setBatteryLevel(g_bootComplete && batteryManager.isInitialized() ?
+                                    batteryManager.getBatteryPercentage() : -1.0f);
     } else {
-        leds[0] = CRGB::Red;    // Red if any system failed
+        ledRenderer.setBase(LedPattern::solid(CRGB::Red));
     }
-    FastLED.show();
+    ledRenderer.render();
+    
+    // Full clock while decoding, switching or serving setup, reduced clock otherwise
+    const bool busy = !g_bootComplete || audioManager.isPlaying() ||
+                      outputRouter.isSwitching() || g_scrubActive || webSetupActive ||
+                      setupMode.isSetupActive();
+    powerGovernor.update(busy);
     
-    // Small delay for button responsiveness
-    delay(10);
+    recordLoopDuration(millis() - loopStartMs);
+    
+    // Small delay for button responsiveness; light sleep until the next RFID poll when idle
+    // (not while an LED flash is running, its frames need the loop)
+    const uint32_t sinceRfid = millis() - lastRFID;
+    const bool canSleep = sinceRfid < RFID_POLL_MS && !ledRenderer.isFlashing();
+    powerGovernor.idleDelay(canSleep ? RFID_POLL_MS - sinceRfid : 0);
 }
 
 // ============================================================================
-// MAIN SETUP FUNCTION
+// BOOT STAGES
 // ============================================================================
-
-void setup() {
-    Serial.begin(115200);
-    AudioLogger::instance().begin(Serial, AudioLogger::Warning);
-    
-    // Initialize logging system
-    initLogger(LogLevel::INFO);  // Set to DEBUG for development, INFO for normal operation
-    
-    // Reset system
-    delay(100);
-
-    // Keep WiFi off until AP setup is explicitly started
-    WiFi.disconnect(true, true);
-    WiFi.mode(WIFI_OFF);
-    LOG_INFO("WiFi disabled at startup; AP will enable WiFi on demand");
-
-    // Initialize WLED
-    FastLED.addLeds<WS2812B, WLED_PIN, GRB>(leds, NUM_LEDS);
-    FastLED.setBrightness(BRIGHTNESS);
-    
-    // Start with LED off
-    leds[0] = CRGB::Black;
-    FastLED.show();
-
-    // Enable internal pull-ups for 4-bit mode pins (from your working script)
-    gpio_pullup_en(GPIO_NUM_2);   // DAT0
-    gpio_pullup_en(GPIO_NUM_15);  // CMD
-    gpio_pullup_dis(GPIO_NUM_14);  // CLK
-    
-    // Configure external speaker amplifier SD pin (PAM8302A)
-    pinMode(SPEAKER_SD_PIN, OUTPUT);
-    digitalWrite(SPEAKER_SD_PIN, LOW); // start with speaker amplifier in shutdown to avoid pops
-    LOG_INFO("PAM8302A SD (GPIO%d) configured as OUTPUT, initial state SHUTDOWN (LOW)", SPEAKER_SD_PIN);
-    
-    // Configure GPIO33 as input for headphone detection
-    pinMode(33, INPUT_PULLUP);
-    LOG_INFO("GPIO33 configured as input with pull-up for headphone detection");
-
-    // Initialize SD Manager first (needed for audio)
+// Independent hardware bring-up, run concurrently by the BootOrchestrator.
+// Wave 1 (sd, codec, rfid) is what audio needs; setup() waits only for sd and
+// codec, then resumes the last session. Wave 2 (services) finishes while the
+// loop is already playing and is completed by completeBoot().
+// The fuel gauge shares Wire with the codec; Wire locks per transaction, so
+// the two may interleave. The codec's page register is only touched by the
+// codec stage and, once setup() has waited for it, by the main task.
+
+static const uint32_t BOOT_STAGE_TIMEOUT_MS = 10000;
+static const uint32_t HP_SETTLE_STABLE_MS = 30;      // Jack-detect must hold this long
+static const uint32_t HP_SETTLE_TIMEOUT_MS = 650;    // Previous fixed wait (500 + 150 ms)
+static const float FALLBACK_VOLUME = 0.35f;
+
+// SD card mount (needed to resume)
+static bool bootStageSD() {
     LOG_INFO("Initializing SD Manager...");
     if (!sdManager.begin()) {
         LOG_ERROR("Failed to initialize SD Manager!");
-        leds[0] = CRGB::Red;
-        FastLED.show();
-        while(1) delay(1000);
+        return false;
     }
     sdCardMounted = true;
+    return true;
+}
 
-    // DEBUG: List all files and directories on SD card
-    LOG_DEBUG("=== DEBUG: SD CARD CONTENTS ===");
-    listAllSDContents("/");
-    LOG_DEBUG("=== END DEBUG: SD CARD CONTENTS ===");
-
-    // Initialize DAC Manager
+// Codec (needed to resume)
+static bool bootStageCodec() {
     LOG_INFO("Initializing DAC Manager...");
     if (!dacManager.begin()) {
         LOG_ERROR("Failed to initialize DAC Manager!");
-        leds[0] = CRGB::Red;
-        FastLED.show();
-        while(1) delay(1000);
+        return false;
     }
     dacInitialized = true;
     
@@ -632,9 +785,7 @@ void setup() {
     LOG_INFO("Configuring DAC...");
     if (!dacManager.configure(true, true, 6, 6)) {  // headphone_detection, speaker_output, hp_vol, spk_vol
         LOG_ERROR("Failed to configure DAC!");
-        leds[0] = CRGB::Red;
-        FastLED.show();
-        while(1) delay(1000);
+        return false;
     }
     
     // Explicitly disable speaker at startup to ensure known state
@@ -642,113 +793,243 @@ void setup() {
     dacManager.enableSpeaker(false);
     dacManager.setSpeakerVolume(0);
     LOG_INFO("Speaker disabled and muted at startup");
-    
-    // Wait for DAC and headphone detection to stabilize
-    LOG_INFO("Waiting for DAC and headphone detection to stabilize...");
-    delay(500);  // Give headphone detection circuit time to settle
-    
-    // Default to speaker OFF until we read a real status
-    dacManager.enableSpeaker(false);
+    return true;
+}
 
-    // Give the jack-detect block a moment to settle
-    delay(150);
-    
-    // First routing decision using simple GPIO-based headphone detection system
-    updateOutputRoute(true);
-    
-    // Initialize RFID Manager
+// RFID reader including its self-test
+static bool bootStageRFID() {
     if (!rfidManager.begin(true)) {  // Enable self-test
         LOG_ERROR("Failed to initialize RFID Manager");
-        return;
+        return false;
     }
     LOG_INFO("RFID MFRC522 initialized successfully!");
+    return true;
+}
+
+// Everything else that only needs the card, plus the fuel gauge
+static bool bootStageServices() {
+#if LOG_COMPILE_LEVEL >= 3
+    // DEBUG: List all files and directories on SD card (walks the whole card)
+    if (getLogLevel() >= LogLevel::DEBUG) {
+        LOG_DEBUG("=== DEBUG: SD CARD CONTENTS ===");
+        listAllSDContents("/");
+        LOG_DEBUG("=== END DEBUG: SD CARD CONTENTS ===");
+    }
+#endif
 
     // Initialize storage components for mapping
     if (!sdScanner.begin(SD_MMC)) {
         LOG_ERROR("Failed to initialize SD Scanner");
-        return;
+        return false;
     }
     
     if (!mappingStore.begin(SD_MMC, "/lookup.ndjson")) {
         LOG_ERROR("Failed to initialize Mapping Store");
-        return;
+        return false;
+    }
+    
+    LOG_INFO("Initializing Settings Manager...");
+    if (!settingsManager.begin()) {
+        LOG_ERROR("Failed to initialize Settings Manager!");
+        return false;
+    }
+    
+    LOG_INFO("Initializing Battery Manager...");
+    if (!batteryManager.begin()) {
+        LOG_WARN("Failed to initialize Battery Manager!");
+        LOG_WARN("Continuing without battery monitoring...");
+    } else {
+        LOG_INFO("Battery Manager initialized successfully!");
     }
+    return true;
+}
+
+// Wait until the headphone detect GPIO has held one level for HP_SETTLE_STABLE_MS
+static void waitForHeadphoneDetectStable() {
+    const uint32_t start = millis();
+    uint32_t stableSince = start;
+    int lastLevel = digitalRead(HP_GPIO_PIN);
     
-    // Set up RFID audio control callback
-    rfidManager.setAudioControlCallback([](const char* uid, bool tagPresent, bool isNewTag, bool isSameTag) {
-        // Suppress audio control during web setup
-        if (webSetupServer.isActive()) {
-            LOG_DEBUG("[RFID-AUDIO] Web setup active - audio control suppressed");
+    while (millis() - start < HP_SETTLE_TIMEOUT_MS) {
+        int level = digitalRead(HP_GPIO_PIN);
+        if (level != lastLevel) {
+            lastLevel = level;
+            stableSince = millis();
+        } else if (millis() - stableSince >= HP_SETTLE_STABLE_MS) {
+            LOG_DEBUG("[HP-DET] Jack detect stable after %lu ms", (unsigned long)(millis() - start));
             return;
         }
-        
-        if (tagPresent) {
-            if (isNewTag) {
-                LOG_INFO("[RFID-AUDIO] New tag detected: %s - Looking up music folder", uid);
+        delay(2);
+    }
+    LOG_WARN("[HP-DET] Jack detect still changing after %lu ms", (unsigned long)HP_SETTLE_TIMEOUT_MS);
+}
+
+// ============================================================================
+// RFID AUDIO CONTROL
+// ============================================================================
+
+// Folder for a new tag: its record if it has one and the folder exists here,
+// otherwise the mapping file. Logs what the record saved against the lookup.
+static bool resolveTagFolder(const char* uid, String& musicPath) {
+    if (rfidManager.hasTagRecord()) {
+        const char* recordPath = rfidManager.getTagRecordPath();
+        if (SD_MMC.exists(recordPath)) {
+            musicPath = recordPath;
+            LOG_INFO("[RFID-AUDIO] Folder from tag record: %s (tag read +%lu us, mapping lookup skipped)",
+                     recordPath, (unsigned long)rfidManager.getTagRecordReadUs());
+            return true;
+        }
+        LOG_WARN("[RFID-AUDIO] Tag record folder %s not on this card - using the mapping", recordPath);
+    }
+    
+    const uint32_t startUs = micros();
+    const bool found = mappingStore.getPathFor(uid, musicPath);
+    if (found) {
+        LOG_INFO("[RFID-AUDIO] Found mapping: %s -> %s (lookup %lu us)", uid, musicPath.c_str(),
+                 (unsigned long)(micros() - startUs));
+    }
+    return found;
+}
+
+static void handleRfidAudioEvent(const char* uid, bool tagPresent, bool isNewTag, bool isSameTag) {
+    powerGovernor.notifyActivity();
+    
+    // Suppress audio control during web setup
+    if (webSetupServer.isActive()) {
+        LOG_DEBUG("[RFID-AUDIO] Web setup active - audio control suppressed");
+        return;
+    }
+    
+    // The card of a resumed session only confirms it
+    if (tagPresent && confirmResumedTag(uid)) {
+        return;
+    }
+    
+    if (tagPresent) {
+        if (isNewTag) {
+            LOG_INFO("[RFID-AUDIO] New tag detected: %s - Looking up music folder", uid);
+            
+            // The tag's own record first (read with the UID), then the mapping file
+            String musicPath;
+            if (resolveTagFolder(uid, musicPath)) {
                 
-                // Look up the music folder path for this UID
-                String musicPath;
-                if (mappingStore.getPathFor(uid, musicPath)) {
-                    LOG_INFO("[RFID-AUDIO] Found mapping: %s -> %s", uid, musicPath.c_str());
-                    
-                    // Change audio source to the mapped folder
-                    if (audioManager.changeAudioSource(musicPath.c_str())) {
-                        LOG_INFO("[RFID-AUDIO] Audio source changed to %s", musicPath.c_str());
-                        if (audioManager.restartFromFirstFile()) {
-                            LOG_INFO("[RFID-AUDIO] Audio started successfully");
-                        } else {
-                            LOG_ERROR("[RFID-AUDIO] Failed to start audio: %s", audioManager.getLastError());
-                        }
-                    } else {
-                        LOG_ERROR("[RFID-AUDIO] Failed to change audio source to %s: %s", musicPath.c_str(), audioManager.getLastError());
-                    }
-                } else {
-                    LOG_WARN("[RFID-AUDIO] No mapping found for UID: %s - flashing red LED", uid);
-                    
-                    // Flash red LED 3 times for unknown RFID card
-                    flashRedLED(3, 200, 150);
-                }
-            } else if (isSameTag) {
-                LOG_INFO("[RFID-AUDIO] Same tag re-inserted: %s - Toggling audio playback", uid);
-                if (audioManager.isPlaying()) {
-                    if (audioManager.pausePlayback()) {
-                        LOG_INFO("[RFID-AUDIO] Audio paused");
+                // Change audio source to the mapped folder
+                if (audioManager.changeAudioSource(musicPath.c_str())) {
+                    LOG_INFO("[RFID-AUDIO] Audio source changed to %s", musicPath.c_str());
+                    if (audioManager.restartFromFirstFile()) {
+                        g_sessionUid = uid;
+                        LOG_INFO("[RFID-AUDIO] Audio started successfully");
                     } else {
-                        LOG_ERROR("[RFID-AUDIO] Failed to pause audio: %s", audioManager.getLastError());
+                        LOG_ERROR("[RFID-AUDIO] Failed to start audio: %s", audioManager.getLastError());
                     }
                 } else {
-                    if (audioManager.resumePlayback()) {
-                        LOG_INFO("[RFID-AUDIO] Audio resumed");
-                    } else {
-                        LOG_ERROR("[RFID-AUDIO] Failed to resume audio: %s", audioManager.getLastError());
-                    }
+                    LOG_ERROR("[RFID-AUDIO] Failed to change audio source to %s: %s", musicPath.c_str(), audioManager.getLastError());
                 }
+            } else {
+                LOG_WARN("[RFID-AUDIO] No mapping found for UID: %s - flashing red LED", uid);
+                
+                // Flash red LED 3 times for unknown RFID card (rendered by the loop)
+                ledRenderer.flash(CRGB::Red, 3, 200, 150);
             }
-        } else {
-            LOG_INFO("[RFID-AUDIO] Tag removed - Pausing audio playback");
+        } else if (isSameTag) {
+            LOG_INFO("[RFID-AUDIO] Same tag re-inserted: %s - Toggling audio playback", uid);
             if (audioManager.isPlaying()) {
                 if (audioManager.pausePlayback()) {
-                    LOG_INFO("[RFID-AUDIO] Audio paused due to tag removal");
+                    LOG_INFO("[RFID-AUDIO] Audio paused");
+                    saveSession();
                 } else {
                     LOG_ERROR("[RFID-AUDIO] Failed to pause audio: %s", audioManager.getLastError());
                 }
+            } else {
+                if (audioManager.resumePlayback()) {
+                    LOG_INFO("[RFID-AUDIO] Audio resumed");
+                } else {
+                    LOG_ERROR("[RFID-AUDIO] Failed to resume audio: %s", audioManager.getLastError());
+                }
             }
         }
-    });
+    } else {
+        LOG_INFO("[RFID-AUDIO] Tag removed - Pausing audio playback");
+        if (audioManager.isPlaying()) {
+            if (audioManager.pausePlayback()) {
+                LOG_INFO("[RFID-AUDIO] Audio paused due to tag removal");
+                saveSession();
+            } else {
+                LOG_ERROR("[RFID-AUDIO] Failed to pause audio: %s", audioManager.getLastError());
+            }
+        }
+    }
+}
+
+// ============================================================================
+// MAIN SETUP FUNCTION
+// ============================================================================
+
+void setup() {
+    Serial.begin(115200);
+    AudioLogger::instance().begin(Serial, AudioLogger::Warning);
     
-    // Enable RFID audio control
-    rfidManager.enableAudioControl(true);
-    LOG_INFO("[RFID-AUDIO] RFID audio control enabled");
+    // Initialize logging system
+    initLogger(LogLevel::INFO);  // Set to DEBUG for development (also raise LOG_COMPILE_LEVEL in platformio.ini)
     
-    // Initialize Battery Manager
-    LOG_INFO("Initializing Battery Manager...");
-    if (!batteryManager.begin()) {
-        LOG_WARN("Failed to initialize Battery Manager!");
-        LOG_WARN("Continuing without battery monitoring...");
-    } else {
-        LOG_INFO("Battery Manager initialized successfully!");
+    // Keep WiFi off until AP setup is explicitly started
+    WiFi.disconnect(true, true);
+    WiFi.mode(WIFI_OFF);
+    LOG_INFO("WiFi disabled at startup; AP will enable WiFi on demand");
+
+    // Initialize WLED
+    FastLED.addLeds<WS2812B, WLED_PIN, GRB>(leds, NUM_LEDS);
+    FastLED.setBrightness(BRIGHTNESS);
+    
+    // Start with LED off
+    ledRenderer.render();
+
+    // Enable internal pull-ups for 4-bit mode pins (from your working script)
+    gpio_pullup_en(GPIO_NUM_2);   // DAT0
+    gpio_pullup_en(GPIO_NUM_15);  // CMD
+    gpio_pullup_dis(GPIO_NUM_14);  // CLK
+    
+    // Configure external speaker amplifier SD pin (PAM8302A)
+    pinMode(SPEAKER_SD_PIN, OUTPUT);
+    digitalWrite(SPEAKER_SD_PIN, LOW); // start with speaker amplifier in shutdown to avoid pops
+    LOG_INFO("PAM8302A SD (GPIO%d) configured as OUTPUT, initial state SHUTDOWN (LOW)", SPEAKER_SD_PIN);
+    
+    // Configure GPIO33 as input for headphone detection
+    pinMode(33, INPUT_PULLUP);
+    LOG_INFO("GPIO33 configured as input with pull-up for headphone detection");
+
+    // Last session is in NVS, which is available immediately
+    if (!sessionStore.begin()) {
+        LOG_WARN("Session store unavailable: %s", sessionStore.getLastError());
+    }
+    
+    // Settings mirrored in NVS; the services stage reconciles them with the SD file
+    settingsManager.loadMirror();
+    rfidManager.setTagRecordsEnabled(settingsManager.getTagRecords());   // Before the first card is read
+
+    // Bring up SD, codec and RFID concurrently, but only wait for the audio path
+    LOG_INFO("Starting parallel boot stages...");
+    bootOrchestrator.addStage("sd", bootStageSD, true);
+    bootOrchestrator.addStage("codec", bootStageCodec, true);
+    bootOrchestrator.addStage("rfid", bootStageRFID, false);
+    bootOrchestrator.start();
+    if (!bootOrchestrator.waitFor("sd", BOOT_STAGE_TIMEOUT_MS) ||
+        !bootOrchestrator.waitFor("codec", BOOT_STAGE_TIMEOUT_MS)) {
+        LOG_ERROR("Boot failed: %s", bootOrchestrator.getLastError());
+        bootOrchestrator.printReport();
+        ledRenderer.setBase(LedPattern::solid(CRGB::Red));
+        ledRenderer.render();
+        while(1) delay(1000);
     }
     
+    // Default to speaker OFF until we read a real status, then wait for the
+    // jack-detect line to settle instead of sleeping a fixed time
+    dacManager.enableSpeaker(false);
+    waitForHeadphoneDetectStable();
+    
+    // First routing decision, then jack changes are interrupt-driven
+    outputRouter.begin();
+    
     // Initialize Audio Manager
     LOG_INFO("Initializing Audio Manager...");
     LOG_INFO("Audio Manager Mode: %s", 
@@ -757,73 +1038,54 @@ void setup() {
     if (!audioManager.begin()) {
         LOG_ERROR("Failed to initialize Audio Manager!");
         LOG_ERROR("Audio Manager Error: %s", audioManager.getLastError());
-        leds[0] = CRGB::Red;
-        FastLED.show();
+        ledRenderer.setBase(LedPattern::solid(CRGB::Red));
+        ledRenderer.render();
         while(1) delay(1000);
     }
     
+    // I2S is clocking now, so the codec PLL can lock and the DACs power up
+    if (!dacManager.waitForDacPowerUp()) {
+        LOG_WARN("DAC power-up flags not set after I2S start, continuing");
+    }
+    
     // Print Audio Manager status after initialization
     LOG_INFO("Audio Manager initialized successfully!");
     audioManager.printAudioStatus();
     
-    // RFID will control audio playback - don't start automatically
-    LOG_INFO("Audio Manager ready - waiting for RFID tag to start playback");
+    // Resume the last session straight away; the first buffer is written by
+    // the first loop() iteration. Otherwise RFID starts playback as before.
+    float initialVolume = settingsManager.isMirrorLoaded() ? settingsManager.getDefaultVolume() : FALLBACK_VOLUME;
+    if (resumeLastSession()) {
+        initialVolume = sessionStore.getSession().volume;
+    } else {
+        LOG_INFO("Audio Manager ready - waiting for RFID tag to start playback");
+    }
+    audioManager.setVolume(initialVolume);
     
     // Initialize Button Manager
     LOG_INFO("Initializing Button Manager...");
     if (!buttonManager.begin()) {
         LOG_ERROR("Failed to initialize Button Manager!");
-        leds[0] = CRGB::Red;
-        FastLED.show();
+        ledRenderer.setBase(LedPattern::solid(CRGB::Red));
+        ledRenderer.render();
         while(1) delay(1000);
     }
     
     LOG_INFO("Button Manager initialized");
     
-    // Initialize Settings Manager
-    LOG_INFO("Initializing Settings Manager...");
-    if (!settingsManager.begin()) {
-        LOG_ERROR("Failed to initialize Settings Manager!");
-        leds[0] = CRGB::Red;
-        FastLED.show();
-        while(1) delay(1000);
-    }
-
-    // Initialize Web Setup server (open AP, starts on-demand) after settings/battery are ready
-    if (!webSetupServer.begin(&mappingStore, &sdScanner, &rfidManager, "/", &settingsManager, &batteryManager)) {
-        LOG_ERROR("Failed to initialize Web Setup server");
-    }
-    LOG_INFO("Scan an RFID card to see the UID!");
-
-    // Determine initial volume from settings (or fallback) and
-    // apply it directly to the Audio Manager so it is effective
-    // even before any encoder movement.
-    float initialVolume = 0.35f; // Fallback default
-    if (settingsManager.isSettingsLoaded()) {
-        initialVolume = settingsManager.getDefaultVolume();
-        LOG_INFO("Initial volume loaded from settings: %.2f", initialVolume);
-    } else {
-        LOG_INFO("Settings not loaded, using fallback initial volume: %.2f", initialVolume);
-    }
-
-    // Apply initial volume directly to the audio pipeline
-    audioManager.setVolume(initialVolume);
-    LOG_INFO("Audio Manager volume set to initial value: %.2f", initialVolume);
-    
     // Initialize Rotary Encoder
     LOG_INFO("Initializing Rotary Encoder...");
     if (!rotaryManager.begin()) {
         LOG_ERROR("Failed to initialize Rotary Encoder!");
-        leds[0] = CRGB::Red;
-        FastLED.show();
+        ledRenderer.setBase(LedPattern::solid(CRGB::Red));
+        ledRenderer.render();
         while(1) delay(1000);
     }
     
     // Set up volume control callback to sync with audio manager
     rotaryManager.setVolumeChangeCallback([](float newVolume) {
-        // Update audio manager volume
+        // Update audio manager volume (coalesced, at most once per audio block)
         audioManager.setVolume(newVolume);
-        LOG_DEBUG("Volume changed to: %.2f (synced with audio)", newVolume);
     });
     
     // Sync rotary encoder position and internal volume with the
@@ -834,11 +1096,78 @@ void setup() {
     // Enable conservative mode to prevent encoder skipping
     rotaryManager.setConservativeMode(true);
     
+    // Power governor: encoder and jack detect wake light sleep, encoder CLK
+    // (RTC GPIO) wakes deep sleep. The sleep timeout is applied in completeBoot().
+    powerGovernor.addWakePin(ROTARY_CLK_PIN);
+    powerGovernor.addWakePin(ROTARY_DT_PIN);
+    powerGovernor.addWakePin(HP_GPIO_PIN);
+    powerGovernor.setDeepSleepWakePin(ROTARY_CLK_PIN);
+    powerGovernor.setDeepSleepCallback(prepareDeepSleep);
+    powerGovernor.begin();
+    
+    // Scanner, mappings, settings and battery finish in the background
+    bootOrchestrator.addStage("services", bootStageServices, true, 8192);
+    bootOrchestrator.start();
+    LOG_INFO("Setup done - %s, services finishing in background",
+             g_resumedAtBoot ? "resuming last session" : "waiting for RFID tag");
+}
+
+// Second half of boot: runs from loop() once every background stage is done
+static void completeBoot() {
+    if (!bootOrchestrator.waitAll(0)) {
+        LOG_ERROR("Boot failed: %s", bootOrchestrator.getLastError());
+        bootOrchestrator.printReport();
+        audioManager.stopPlayback();
+        ledRenderer.setBase(LedPattern::solid(CRGB::Red));
+        ledRenderer.render();
+        while(1) delay(1000);
+    }
+    g_bootComplete = true;
+    
+    // Without a resumed session the volume comes from settings
+    if (!g_resumedAtBoot) {
+        float initialVolume = FALLBACK_VOLUME;
+        if (settingsManager.isSettingsLoaded()) {
+            initialVolume = settingsManager.getDefaultVolume();
+            LOG_INFO("Initial volume loaded from settings: %.2f", initialVolume);
+        } else {
+            LOG_INFO("Settings not loaded, using fallback initial volume: %.2f", initialVolume);
+        }
+        audioManager.setVolume(initialVolume);
+        rotaryManager.setVolume(initialVolume);
+    }
+    
+    // Idle timeouts from settings (minutes)
+    if (settingsManager.isSettingsLoaded()) {
+        powerGovernor.setDeepSleepTimeout((uint32_t)settingsManager.getSleepTimeout() * 60000UL);
+        batteryManager.setReadingInterval((unsigned long)settingsManager.getBatteryCheckInterval() * 60000UL);
+        rfidManager.setTagRecordsEnabled(settingsManager.getTagRecords());
+    }
+    
+    // Set up RFID audio control callback (mappings are loaded now)
+    rfidManager.setAudioControlCallback(handleRfidAudioEvent);
+    rfidManager.enableAudioControl(true);
+    LOG_INFO("[RFID-AUDIO] RFID audio control enabled");
+    
+    // The reader has been polling silently; act on a card that is already there
+    if (rfidManager.isTagPresent()) {
+        handleRfidAudioEvent(rfidManager.getLastDetectedUIDCStr(), true, true, false);
+    }
+    g_resumeConfirmDeadline = millis() + RESUME_CONFIRM_TIMEOUT_MS;
+    
+    // Initialize Web Setup server (open AP, starts on-demand) after settings/battery are ready
+    if (!webSetupServer.begin(&mappingStore, &sdScanner, &rfidManager, "/", &settingsManager, &batteryManager, &powerGovernor)) {
+        LOG_ERROR("Failed to initialize Web Setup server");
+    }
+    if (!setupMode.begin(&mappingStore, &sdScanner, &rfidManager, &buttonManager, "/")) {
+        LOG_ERROR("Failed to initialize setup mode");
+    }
+    LOG_INFO("Scan an RFID card to see the UID!");
+    
     LOG_INFO("Setup complete! Ready to play audio.");
+    bootOrchestrator.markReady();
     
     // Success - turn LED green
-    leds[0] = CRGB::Green;
-    FastLED.show();
-    
-    delay(2000); // Keep green for 2 seconds
-}
\ No newline at end of file
+    ledRenderer.setBase(LedPattern::solid(CRGB::Green));
+    ledRenderer.render();
+}